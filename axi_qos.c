@@ -0,0 +1,268 @@
+/*
+ ******************************************************************************
+ * File              : axi_qos.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : AXI interconnect QoS per master and bus stress benchmark
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 30, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * The AXI SRAM is reached through the AXI interconnect of the D1 domain,
+ * clocked by HCLK (240 MHz with HPRE /2). Each initiator port has a 4-bit
+ * read and write QoS in the GPV (Reference Manual, Page 111), the target
+ * port serves the highest value first, equal values round robin. All ports
+ * are 0 after reset, so a long DMA2D or MDMA copy gets the same share as the
+ * LTDC, whose FIFO underruns when its line fetch waits too long.
+ *
+ * AXI_QoS_Benchmark() loads the AXI SRAM with three masters at once for a
+ * number of LTDC refreshes under each profile:
+ *
+ *   MDMA channel 3  64 KB block copies of the back buffer onto itself
+ *   DMA2D           memory to memory blit of the lower half onto itself
+ *   CPU             one uncached read of a back buffer line per loop
+ *
+ * The copies write back what they read, the picture is not changed. The
+ * results are the LTDC underruns of the window, the CPU read latency (CPU
+ * cycles of one read on the bus) and the MDMA and DMA2D throughput. The QoS in
+ * force before the benchmark is restored at the end.
+ *
+ * Display_Init() and Cycle_Counter_Init() must have been called. MDMA
+ * channel 0 is used by the CRC engine, 1 and 2 by the JPEG codec.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "axi_qos.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+#define AXI_QOS_GPV_BASE            ( 0x51000000UL )
+#define AXI_QOS_READ(port)          ( *(volatile uint32_t *)(AXI_QOS_GPV_BASE + 0x42100UL + 0x1000UL * (port)) )
+#define AXI_QOS_WRITE(port)         ( *(volatile uint32_t *)(AXI_QOS_GPV_BASE + 0x42104UL + 0x1000UL * (port)) )
+#define AXI_QOS_MASK                ( 0xFUL )
+
+#define AXI_QOS_MDMA_CHANNEL        ( MDMA_Channel3 )
+#define AXI_QOS_MDMA_BLOCK          ( 65536UL )     // Bytes per software request, BNDT is 17 bits
+#define AXI_QOS_MDMA_SIZE_DWORD     ( 3UL )         // 64-bit AXI beats
+#define AXI_QOS_MDMA_TLEN_128       ( 127UL << MDMA_CTCR_TLEN_Pos )
+
+#define AXI_QOS_LINE                ( 32U )         // D-cache line
+#define AXI_QOS_WINDOW_MAX_S        ( 4U )          // Cycle counter wraps after 8.9 s at 480 MHz
+
+/************************** Local Variables ****************************/
+
+/* Port order of AXI_QoS_Port_t:      D2   CPU SDMMC MDMA DMA2D LTDC */
+const AXI_QoS_Profile_t AXI_QoS_Default =
+{
+	"default",
+	{  0U,  0U,  0U,  0U,  0U,  0U },
+	{  0U,  0U,  0U,  0U,  0U,  0U }
+};
+
+/* The LTDC line fetch first, the CPU ahead of the bulk copies */
+const AXI_QoS_Profile_t AXI_QoS_Display_First =
+{
+	"display first",
+	{  4U,  8U,  4U,  1U,  2U, 14U },
+	{  4U,  8U,  4U,  1U,  2U,  0U }
+};
+
+/* The CPU first, the LTDC still ahead of the copies */
+const AXI_QoS_Profile_t AXI_QoS_CPU_First =
+{
+	"cpu first",
+	{  6U, 14U,  4U,  1U,  1U, 10U },
+	{  6U, 14U,  4U,  1U,  1U,  0U }
+};
+
+/****************************** Functions ******************************/
+
+void AXI_QoS_Apply(const AXI_QoS_Profile_t *profile)
+{
+	for (uint32_t port = 0U; port < AXI_QOS_PORTS; port++)
+	{
+		AXI_QOS_READ(port)  = profile->read[port]  & AXI_QOS_MASK ;
+		AXI_QOS_WRITE(port) = profile->write[port] & AXI_QOS_MASK ;
+	}
+	__DSB();
+}
+
+/* QoS in force, the name is left as given */
+void AXI_QoS_Get(AXI_QoS_Profile_t *profile)
+{
+	for (uint32_t port = 0U; port < AXI_QOS_PORTS; port++)
+	{
+		profile->read[port]  = (uint8_t)(AXI_QOS_READ(port)  & AXI_QOS_MASK);
+		profile->write[port] = (uint8_t)(AXI_QOS_WRITE(port) & AXI_QOS_MASK);
+	}
+}
+
+/* One block copy of the start of the back buffer onto itself */
+static void MDMA_Start_Copy(const uint16_t *buffer)
+{
+	MDMA_Channel_TypeDef *ch = AXI_QOS_MDMA_CHANNEL;
+
+	/* Step 1: Channel disabled, all flags cleared */
+	ch->CCR  &= ~ MDMA_CCR_EN ;
+	ch->CIFCR = MDMA_CIFCR_CTEIF | MDMA_CIFCR_CCTCIF | MDMA_CIFCR_CBRTIF |
+	            MDMA_CIFCR_CBTIF | MDMA_CIFCR_CLTCIF ;
+
+	/* Step 2: Double word reads and writes with increment, one block per
+	 * software request, no interrupt: the benchmark polls CTCIF
+	 */
+	ch->CTCR   = MDMA_CTCR_SINC_1 | MDMA_CTCR_DINC_1 |
+	             (AXI_QOS_MDMA_SIZE_DWORD << MDMA_CTCR_SSIZE_Pos ) |
+	             (AXI_QOS_MDMA_SIZE_DWORD << MDMA_CTCR_DSIZE_Pos ) |
+	             (AXI_QOS_MDMA_SIZE_DWORD << MDMA_CTCR_SINCOS_Pos) |
+	             (AXI_QOS_MDMA_SIZE_DWORD << MDMA_CTCR_DINCOS_Pos) |
+	             AXI_QOS_MDMA_TLEN_128 | MDMA_CTCR_TRGM_0 | MDMA_CTCR_SWRM ;
+	ch->CBNDTR = AXI_QOS_MDMA_BLOCK ;
+	ch->CSAR   = (uint32_t)buffer ;
+	ch->CDAR   = (uint32_t)buffer ;
+	ch->CBRUR  = 0U ;
+	ch->CLAR   = 0U ;
+	ch->CTBR   = 0U ;
+	ch->CMAR   = 0U ;
+	ch->CMDR   = 0U ;
+
+	/* Step 3: Enable, then request */
+	ch->CCR = MDMA_CCR_PL_0 ;
+	ch->CCR |= MDMA_CCR_EN ;
+	ch->CCR |= MDMA_CCR_SWRQ ;
+}
+
+/* Cycles of one read of a back buffer line on the AXI bus, the cost of the
+ * measurement taken off. The D-cache is off in this project, every read
+ * goes to AXI SRAM; with the D-cache on, the line is invalidated first.
+ */
+static uint32_t CPU_Read_Latency(const volatile uint32_t *line)
+{
+	uint32_t t0, empty, read;
+
+	/* Step 1: Not served from the D-cache */
+	if (SCB->CCR & SCB_CCR_DC_Msk)
+	{
+		SCB_InvalidateDCache_by_Addr((uint32_t *)line, AXI_QOS_LINE);
+	}
+
+	/* Step 2: Cost of the cycle counter reads and the barrier alone */
+	t0 = Cycle_Counter_Get();
+	__DSB();
+	empty = Cycle_Counter_Get() - t0;
+
+	/* Step 3: One read */
+	t0 = Cycle_Counter_Get();
+	(void)*line;
+	__DSB();
+	read = Cycle_Counter_Get() - t0;
+
+	return (read > empty) ? (read - empty) : 0U;
+}
+
+static void Run_Window(const Display_Panel_t *panel, uint32_t frames, AXI_QoS_Bench_t *result)
+{
+	MDMA_Channel_TypeDef *ch     = AXI_QOS_MDMA_CHANNEL;
+	uint16_t             *buffer = Display_Back_Buffer();
+	uint32_t              bytes  = (uint32_t)panel->width * panel->height * DISPLAY_BYTES_PER_PIXEL;
+	uint16_t              half   = panel->height / 2U;
+	uint32_t              line   = 0U;
+	uint32_t              probes = 0U;
+	uint64_t              latency_sum = 0U, mdma_bytes = 0U, elapsed = 0U;
+	uint32_t              dma2d_bytes;
+	uint64_t              timeout = (uint64_t)SystemCoreClock * AXI_QOS_WINDOW_MAX_S;
+	uint32_t              last, now;
+	Display_Stats_t       stats;
+
+	Display_Measure(&stats);
+	result->frames          = stats.refreshes;
+	result->ltdc_underruns  = stats.fifo_underruns;
+	result->cpu_latency_max = 0U;
+	dma2d_bytes             = stats.dma2d_bytes;
+
+	MDMA_Start_Copy(buffer);
+	last = Cycle_Counter_Get();
+
+	while ((stats.refreshes - result->frames < frames) && (elapsed < timeout))
+	{
+		uint32_t sample;
+
+		if (ch->CISR & MDMA_CISR_CTCIF)
+		{
+			mdma_bytes += 2U * AXI_QOS_MDMA_BLOCK;
+			MDMA_Start_Copy(buffer);
+		}
+		if (!(DMA2D->CR & DMA2D_CR_START))
+		{
+			Display_Blit(buffer + (uint32_t)half * panel->width, panel->width, 0U, half, panel->width,
+			             panel->height - half);
+		}
+
+		sample = CPU_Read_Latency((const volatile uint32_t *)((uint8_t *)buffer + line));
+		latency_sum += sample;
+		probes++;
+		if (sample > result->cpu_latency_max)
+		{
+			result->cpu_latency_max = sample;
+		}
+		line = (line + 4U * AXI_QOS_LINE) % bytes;
+
+		now      = Cycle_Counter_Get();
+		elapsed += now - last;
+		last     = now;
+
+		Display_Measure(&stats);
+	}
+
+	/* Let the copies finish before the next profile */
+	while (!(ch->CISR & MDMA_CISR_CTCIF)) {}
+	ch->CCR &= ~ MDMA_CCR_EN ;
+	Display_DMA2D_Wait();
+
+	result->frames          = stats.refreshes - result->frames;
+	result->ltdc_underruns  = stats.fifo_underruns - result->ltdc_underruns;
+	result->cpu_latency_avg = probes ? (uint32_t)(latency_sum / probes) : 0U;
+	result->mdma_kbps       = elapsed ? (uint32_t)((mdma_bytes * SystemCoreClock) / elapsed / 1000U) : 0U;
+	result->dma2d_kbps      = elapsed ? (uint32_t)(((uint64_t)(stats.dma2d_bytes - dma2d_bytes) * SystemCoreClock) / elapsed / 1000U) : 0U;
+}
+
+/* Runs the stress load for frames LTDC refreshes under each profile */
+void AXI_QoS_Benchmark(const Display_Panel_t *panel, const AXI_QoS_Profile_t * const *profiles, uint32_t count,
+                       uint32_t frames, AXI_QoS_Bench_t *results)
+{
+	AXI_QoS_Profile_t saved = { "saved", { 0U }, { 0U } };
+	uint16_t         *buffer = Display_Back_Buffer();
+
+	AXI_QoS_Get(&saved);
+	RCC->AHB3ENR |= RCC_AHB3ENR_MDMAEN ;
+
+	/* The copies write memory behind the D-cache */
+	Display_DMA2D_Wait();
+	SCB_CleanDCache_by_Addr((uint32_t *)buffer, (int32_t)((uint32_t)panel->width * panel->height * DISPLAY_BYTES_PER_PIXEL));
+
+	for (uint32_t i = 0U; i < count; i++)
+	{
+		AXI_QoS_Apply(profiles[i]);
+		results[i].name = profiles[i]->name;
+		Run_Window(panel, frames, &results[i]);
+	}
+
+	AXI_QoS_Apply(&saved);
+}
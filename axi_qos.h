@@ -0,0 +1,77 @@
+/*
+ ******************************************************************************
+ * File              : axi_qos.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : AXI interconnect QoS per master and bus stress benchmark
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 30, 2026
+ ******************************************************************************/
+
+#ifndef _AXI_QOS_H_
+#define _AXI_QOS_H_
+
+#include "stm32h7xx.h"
+#include "ltdc_display.h"
+
+/*************************** Macros ************************************/
+
+#define AXI_QOS_PORTS               ( 6U )
+#define AXI_QOS_MAX                 ( 15U )     // 4-bit QoS, higher wins
+
+/*************************** Types *************************************/
+
+/* AXI interconnect initiator ports INI1..INI6, Reference Manual, Page 104 */
+typedef enum
+{
+	AXI_QOS_D2_AHB = 0 ,  // D2 masters (DMA1, DMA2, SDMMC2, Ethernet, USB) through the AHB bridge
+	AXI_QOS_CPU        ,  // Cortex-M7 AXIM
+	AXI_QOS_SDMMC1     ,
+	AXI_QOS_MDMA       ,
+	AXI_QOS_DMA2D      ,
+	AXI_QOS_LTDC
+} AXI_QoS_Port_t;
+
+typedef struct
+{
+	const char *name ;
+	uint8_t     read[AXI_QOS_PORTS]  ;  // AR_QOS, 0..15
+	uint8_t     write[AXI_QOS_PORTS] ;  // AW_QOS, 0..15
+} AXI_QoS_Profile_t;
+
+typedef struct
+{
+	const char *name              ;  // Profile measured
+	uint32_t    frames            ;  // LTDC refreshes in the window
+	uint32_t    ltdc_underruns    ;
+	uint32_t    cpu_latency_avg   ;  // CPU cycles per uncached AXI SRAM read
+	uint32_t    cpu_latency_max   ;
+	uint32_t    mdma_kbps         ;  // MDMA copy load, read + write
+	uint32_t    dma2d_kbps        ;  // DMA2D copy load, read + write
+} AXI_QoS_Bench_t;
+
+/************************ Function prototypes ***************************/
+extern const AXI_QoS_Profile_t AXI_QoS_Default ;
+extern const AXI_QoS_Profile_t AXI_QoS_Display_First ;
+extern const AXI_QoS_Profile_t AXI_QoS_CPU_First ;
+
+void AXI_QoS_Apply(const AXI_QoS_Profile_t *profile) ;
+void AXI_QoS_Get(AXI_QoS_Profile_t *profile) ;
+void AXI_QoS_Benchmark(const Display_Panel_t *panel, const AXI_QoS_Profile_t * const *profiles, uint32_t count,
+                       uint32_t frames, AXI_QoS_Bench_t *results) ;
+
+#endif /* _AXI_QOS_H_ */
@@ -0,0 +1,340 @@
+/*
+ ******************************************************************************
+ * File              : clock_plan.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Shortest legal transition between two clock profiles
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 2, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * No register access in this file. Clock_Profile_Apply() always runs the
+ * whole sequence: sys_ck to the oscillator, PLL1 off, VOS, flash, PLL1
+ * lock, prescalers, sys_ck back to PLL1. Most changes need much less.
+ *
+ * The planner looks at the clock tree as six parts, each either at its
+ * current or at its target value: sys_ck source (oscillator or PLL1), PLL1
+ * (current set-up locked, off, target set-up locked), VOS, flash wait
+ * states and the prescalers. That is 64 states. A step moves one part, and
+ * is taken only if the clock tree after it passes
+ * Clock_Profile_Check_Limits(), the same rules as a profile:
+ *
+ *   - sys_ck, hclk and the APB clocks within the VOS limits
+ *   - enough flash wait states for hclk at the VOS in force
+ *   - PLL1 dividers written only when PLL1 is off, so only while sys_ck
+ *     runs from the oscillator (Reference Manual, Page 402)
+ *   - FRACN1 alone can change with PLL1 locked and in use
+ *
+ * The cheapest path from the current to the target state (Dijkstra, costs
+ * CLOCK_PLAN_US_x, fewer steps on a tie) is the plan. Parts already equal
+ * start at their target. Typical results:
+ *
+ *   prescalers only      PRESCALERS (with FLASH before or after)
+ *   FRACN only           FRACN, VOS/FLASH on the safe side of it
+ *   faster, new PLL1     VOS, FLASH, SYSCLK_OSC, PLL1_OFF, PLL1_ON, ...
+ *   slower, new PLL1     SYSCLK_OSC, PLL1_OFF, PLL1_ON, SYSCLK_PLL1, FLASH, VOS
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "clock_plan.h"
+
+/*************************** Macros ************************************/
+
+// State bits, a set bit is a part at its target value
+#define STATE_SW_PLL1               ( 0x01U )   // sys_ck from PLL1, else from the oscillator
+#define STATE_PLL_SHIFT             ( 1U )
+#define STATE_PLL_MASK              ( 0x06U )
+#define STATE_VOS                   ( 0x08U )
+#define STATE_FLASH                 ( 0x10U )
+#define STATE_PRESC                 ( 0x20U )
+#define STATES                      ( 64U )
+
+#define STATE_PLL(s)                ( (uint8_t)(((s) & STATE_PLL_MASK) >> STATE_PLL_SHIFT) )
+#define STATE_WITH_PLL(s, p)        ( (uint8_t)(((s) & ~STATE_PLL_MASK) | ((p) << STATE_PLL_SHIFT)) )
+
+#define PLL_FROM                    ( 0U )      // Current set-up, locked
+#define PLL_OFF                     ( 1U )
+#define PLL_TO                      ( 2U )      // Target set-up, locked
+
+#define STATE_GOAL                  ( STATE_SW_PLL1 | (PLL_TO << STATE_PLL_SHIFT) | STATE_VOS | STATE_FLASH | STATE_PRESC )
+#define NO_STATE                    ( 0xFFU )
+
+/****************************** Functions ******************************/
+
+uint8_t Clock_Plan_Same_PLL1(const ClockProfile_t *a, const ClockProfile_t *b, uint8_t ignore_fracn)
+{
+	return (a->pll_src == b->pll_src) && (a->divm1 == b->divm1) && (a->divn1 == b->divn1) &&
+	       (a->divp1 == b->divp1) && (a->divq1 == b->divq1) && (a->divr1 == b->divr1) &&
+	       (a->pll1rge == b->pll1rge) && (a->pll1vcosel == b->pll1vcosel) &&
+	       ((a->pll_src != CLOCK_PROFILE_PLLSRC_HSE) || (a->hse_hz == b->hse_hz)) &&
+	       (ignore_fracn || (a->fracn1 == b->fracn1));
+}
+
+uint8_t Clock_Plan_Same_Prescalers(const ClockProfile_t *a, const ClockProfile_t *b)
+{
+	return (a->d1cpre == b->d1cpre) && (a->hpre == b->hpre) && (a->d1ppre == b->d1ppre) &&
+	       (a->d2ppre1 == b->d2ppre1) && (a->d2ppre2 == b->d2ppre2) && (a->d3ppre == b->d3ppre);
+}
+
+/* Oscillator sys_ck runs from during a PLL1 change: the one the target PLL1
+ * needs, HSI for a CSI source (same as Clock_Profile_Apply)
+ */
+static uint32_t Osc_Hz(const ClockProfile_t *to)
+{
+	return (to->pll_src == CLOCK_PROFILE_PLLSRC_HSE) ? to->hse_hz : 64000000UL;
+}
+
+uint32_t Clock_Plan_Step_Cost(uint8_t step, const ClockProfile_t *from, const ClockProfile_t *to)
+{
+	uint32_t us;
+
+	switch (step)
+	{
+		case CLOCK_STEP_SYSCLK_OSC:
+			us = CLOCK_PLAN_US_SWITCH;
+			if ((to->pll_src == CLOCK_PROFILE_PLLSRC_HSE) && (from->pll_src != CLOCK_PROFILE_PLLSRC_HSE))
+			{
+				us += CLOCK_PLAN_US_HSE_START;
+			}
+			if ((to->pll_src == CLOCK_PROFILE_PLLSRC_CSI) && (from->pll_src != CLOCK_PROFILE_PLLSRC_CSI))
+			{
+				us += CLOCK_PLAN_US_CSI_START;
+			}
+			return us;
+		case CLOCK_STEP_SYSCLK_PLL1: return CLOCK_PLAN_US_SWITCH;
+		case CLOCK_STEP_PLL1_ON:     return CLOCK_PLAN_US_PLL_LOCK;
+		case CLOCK_STEP_FRACN:       return CLOCK_PLAN_US_FRACN;
+		case CLOCK_STEP_VOS:         return CLOCK_PLAN_US_VOS;
+		default:                     return CLOCK_PLAN_US_REGISTER;
+	}
+}
+
+/* Clock tree of a state against the VOS and flash rules */
+static uint8_t State_Legal(const ClockProfile_t *from, const ClockProfile_t *to, uint8_t state)
+{
+	ClockProfile_t      mix = (state & STATE_PRESC) ? *to : *from;
+	ClockProfile_Freq_t freq;
+	uint32_t            sys_hz;
+
+	mix.vos              = ((state & STATE_VOS)   ? to : from)->vos;
+	mix.flash_latency    = ((state & STATE_FLASH) ? to : from)->flash_latency;
+	mix.flash_wrhighfreq = ((state & STATE_FLASH) ? to : from)->flash_wrhighfreq;
+
+	if (state & STATE_SW_PLL1)
+	{
+		if ((STATE_PLL(state) == PLL_OFF) ||
+		    (Clock_Profile_Frequencies((STATE_PLL(state) == PLL_TO) ? to : from, &freq) != CLOCK_PROFILE_OK))
+		{
+			return 0U;
+		}
+		sys_hz = freq.pll1_p_hz;
+	}
+	else
+	{
+		sys_hz = Osc_Hz(to);
+	}
+
+	freq.sysclk_hz = sys_hz         / mix.d1cpre;
+	freq.hclk_hz   = freq.sysclk_hz / mix.hpre;
+	freq.pclk3_hz  = freq.hclk_hz   / mix.d1ppre;
+	freq.pclk1_hz  = freq.hclk_hz   / mix.d2ppre1;
+	freq.pclk2_hz  = freq.hclk_hz   / mix.d2ppre2;
+	freq.pclk4_hz  = freq.hclk_hz   / mix.d3ppre;
+
+	return Clock_Profile_Check_Limits(&mix, &freq) == CLOCK_PROFILE_OK;
+}
+
+/* State after step, NO_STATE if the step does not apply */
+static uint8_t Next_State(const ClockProfile_t *from, const ClockProfile_t *to, uint8_t state, uint8_t step)
+{
+	uint8_t pll = STATE_PLL(state);
+
+	switch (step)
+	{
+		case CLOCK_STEP_SYSCLK_OSC:
+			return (state & STATE_SW_PLL1) ? (uint8_t)(state & ~STATE_SW_PLL1) : NO_STATE;
+		case CLOCK_STEP_SYSCLK_PLL1:
+			return (!(state & STATE_SW_PLL1) && (pll != PLL_OFF)) ? (uint8_t)(state | STATE_SW_PLL1) : NO_STATE;
+		case CLOCK_STEP_PLL1_OFF:
+			return (!(state & STATE_SW_PLL1) && (pll == PLL_FROM)) ? STATE_WITH_PLL(state, PLL_OFF) : NO_STATE;
+		case CLOCK_STEP_PLL1_ON:
+			return (pll == PLL_OFF) ? STATE_WITH_PLL(state, PLL_TO) : NO_STATE;
+		case CLOCK_STEP_FRACN:
+			return ((pll == PLL_FROM) && Clock_Plan_Same_PLL1(from, to, 1U)) ? STATE_WITH_PLL(state, PLL_TO) : NO_STATE;
+		case CLOCK_STEP_VOS:
+			return (state & STATE_VOS)   ? NO_STATE : (uint8_t)(state | STATE_VOS);
+		case CLOCK_STEP_FLASH:
+			return (state & STATE_FLASH) ? NO_STATE : (uint8_t)(state | STATE_FLASH);
+		case CLOCK_STEP_PRESCALERS:
+			return (state & STATE_PRESC) ? NO_STATE : (uint8_t)(state | STATE_PRESC);
+		default:
+			return NO_STATE;
+	}
+}
+
+/* from and to as clock trees: everything of Clock_Profile_Validate() but
+ * the container, Clock_Profile_Default has no CRC
+ */
+static uint8_t Profile_Legal(const ClockProfile_t *profile)
+{
+	ClockProfile_t copy = *profile;
+
+	Clock_Profile_Seal(&copy);
+	return Clock_Profile_Validate(&copy) == CLOCK_PROFILE_OK;
+}
+
+ClockPlan_Status_t Clock_Plan_Compute(const ClockProfile_t *from, const ClockProfile_t *to, ClockPlan_t *plan)
+{
+	uint32_t dist[STATES];
+	uint8_t  prev[STATES], prev_step[STATES], done[STATES];
+	uint8_t  start = STATE_SW_PLL1, state, n;
+
+	memset(plan, 0, sizeof(*plan));
+	if (!Profile_Legal(from) || !Profile_Legal(to))
+	{
+		return CLOCK_PLAN_ERR_PROFILE;
+	}
+
+	/* Step 1: Parts already equal start at their target value */
+	start |= Clock_Plan_Same_PLL1(from, to, 0U) ? (uint8_t)(PLL_TO << STATE_PLL_SHIFT) : 0U;
+	start |= (from->vos == to->vos) ? STATE_VOS : 0U;
+	start |= ((from->flash_latency == to->flash_latency) &&
+	          (from->flash_wrhighfreq == to->flash_wrhighfreq)) ? STATE_FLASH : 0U;
+	start |= Clock_Plan_Same_Prescalers(from, to) ? STATE_PRESC : 0U;
+
+	/* Step 2: Cheapest path, cost in us x 16 plus one per step */
+	for (uint32_t s = 0U; s < STATES; s++)
+	{
+		dist[s] = UINT32_MAX;
+		prev[s] = NO_STATE;
+		done[s] = 0U;
+	}
+	dist[start] = 0U;
+
+	for (;;)
+	{
+		uint32_t best = UINT32_MAX;
+
+		state = NO_STATE;
+		for (uint8_t s = 0U; s < STATES; s++)
+		{
+			if (!done[s] && (dist[s] < best))
+			{
+				best  = dist[s];
+				state = s;
+			}
+		}
+		if ((state == NO_STATE) || (state == STATE_GOAL))
+		{
+			break;
+		}
+		done[state] = 1U;
+
+		for (uint8_t step = 0U; step < CLOCK_STEP_COUNT; step++)
+		{
+			uint8_t  next = Next_State(from, to, state, step);
+			uint32_t d;
+
+			if ((next == NO_STATE) || done[next] || !State_Legal(from, to, next))
+			{
+				continue;
+			}
+			d = dist[state] + Clock_Plan_Step_Cost(step, from, to) * 16U + 1U;
+			if (d < dist[next])
+			{
+				dist[next]      = d;
+				prev[next]      = state;
+				prev_step[next] = step;
+			}
+		}
+	}
+
+	if (dist[STATE_GOAL] == UINT32_MAX)
+	{
+		return CLOCK_PLAN_ERR_NO_PATH;
+	}
+
+	/* Step 3: Walk back from the goal */
+	n = 0U;
+	for (state = STATE_GOAL; state != start; state = prev[state])
+	{
+		n++;
+	}
+	plan->count = n;
+	for (state = STATE_GOAL; state != start; state = prev[state])
+	{
+		plan->steps[--n] = prev_step[state];
+		plan->cost_us   += Clock_Plan_Step_Cost(prev_step[state], from, to);
+	}
+	plan->pll_src_change = (from->pll_src != to->pll_src);
+
+	return CLOCK_PLAN_OK;
+}
+
+/* The fixed sequence of Clock_Profile_Apply(), for comparison */
+ClockPlan_Status_t Clock_Plan_Full(const ClockProfile_t *from, const ClockProfile_t *to, ClockPlan_t *plan)
+{
+	static const uint8_t Full[] =
+	{
+		CLOCK_STEP_SYSCLK_OSC, CLOCK_STEP_PLL1_OFF, CLOCK_STEP_VOS, CLOCK_STEP_FLASH,
+		CLOCK_STEP_PLL1_ON, CLOCK_STEP_PRESCALERS, CLOCK_STEP_SYSCLK_PLL1
+	};
+
+	memset(plan, 0, sizeof(*plan));
+	if (!Profile_Legal(from) || !Profile_Legal(to))
+	{
+		return CLOCK_PLAN_ERR_PROFILE;
+	}
+	for (uint8_t i = 0U; i < sizeof(Full); i++)
+	{
+		plan->steps[plan->count++] = Full[i];
+		plan->cost_us += Clock_Plan_Step_Cost(Full[i], from, to);
+	}
+	plan->pll_src_change = (from->pll_src != to->pll_src);
+	return CLOCK_PLAN_OK;
+}
+
+const char *Clock_Plan_Step_Name(uint8_t step)
+{
+	switch (step)
+	{
+		case CLOCK_STEP_SYSCLK_OSC:  return "sysclk-osc";
+		case CLOCK_STEP_PLL1_OFF:    return "pll1-off";
+		case CLOCK_STEP_PLL1_ON:     return "pll1-on";
+		case CLOCK_STEP_SYSCLK_PLL1: return "sysclk-pll1";
+		case CLOCK_STEP_FRACN:       return "fracn";
+		case CLOCK_STEP_VOS:         return "vos";
+		case CLOCK_STEP_FLASH:       return "flash";
+		case CLOCK_STEP_PRESCALERS:  return "prescalers";
+		default:                     return "unknown";
+	}
+}
+
+const char *Clock_Plan_Status_Name(ClockPlan_Status_t status)
+{
+	switch (status)
+	{
+		case CLOCK_PLAN_OK:          return "ok";
+		case CLOCK_PLAN_ERR_PROFILE: return "profile not legal";
+		case CLOCK_PLAN_ERR_NO_PATH: return "no legal sequence";
+		case CLOCK_PLAN_ERR_BUSY:    return "PLL2 or PLL3 running";
+		default:                     return "unknown";
+	}
+}
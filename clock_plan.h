@@ -0,0 +1,99 @@
+/*
+ ******************************************************************************
+ * File              : clock_plan.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Shortest legal transition between two clock profiles
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 2, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Portable like clock_profile_blob.c: the planner is compiled into the
+ * firmware (Clock_Profile_Transition in clock_profile.c runs the steps) and
+ * into tools/clock_plan_tool.c, which checks every plan on a register model
+ * of the clock tree.
+ *
+ ******************************************************************************/
+
+#ifndef _CLOCK_PLAN_H_
+#define _CLOCK_PLAN_H_
+
+#include <stdint.h>
+#include "clock_profile.h"
+
+/*************************** Macros ************************************/
+
+#define CLOCK_PLAN_MAX_STEPS        ( 8U )
+
+/* Estimated duration of each step in microseconds. Datasheet DS12110:
+ * HSE start-up 2 ms typical, PLL lock 50 to 150 us, the VOS change is
+ * given by VOSRDY. The register writes are rounded up to 1 us.
+ */
+#define CLOCK_PLAN_US_SWITCH        ( 1U )
+#define CLOCK_PLAN_US_HSE_START     ( 2000U )
+#define CLOCK_PLAN_US_CSI_START     ( 10U )
+#define CLOCK_PLAN_US_PLL_LOCK      ( 150U )
+#define CLOCK_PLAN_US_FRACN         ( 10U )
+#define CLOCK_PLAN_US_VOS           ( 100U )
+#define CLOCK_PLAN_US_REGISTER      ( 1U )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	CLOCK_STEP_SYSCLK_OSC = 0 ,  // sys_ck from the oscillator of the target PLL1 source
+	CLOCK_STEP_PLL1_OFF       ,
+	CLOCK_STEP_PLL1_ON        ,  // Target source, dividers and ranges, wait for lock
+	CLOCK_STEP_SYSCLK_PLL1    ,
+	CLOCK_STEP_FRACN          ,  // New FRACN1 latched by PLL1FRACEN, PLL1 stays locked
+	CLOCK_STEP_VOS            ,
+	CLOCK_STEP_FLASH          ,  // LATENCY and WRHIGHFREQ
+	CLOCK_STEP_PRESCALERS     ,  // D1CPRE, HPRE and APB prescalers
+	CLOCK_STEP_COUNT
+} ClockPlan_Step_t;
+
+typedef enum
+{
+	CLOCK_PLAN_OK = 0      ,
+	CLOCK_PLAN_ERR_PROFILE ,  // Current or target clock tree not legal
+	CLOCK_PLAN_ERR_NO_PATH ,  // No legal sequence, not expected for legal profiles
+	CLOCK_PLAN_ERR_BUSY       // PLLSRC change with PLL2 or PLL3 running (firmware only)
+} ClockPlan_Status_t;
+
+typedef struct
+{
+	uint8_t  steps[CLOCK_PLAN_MAX_STEPS] ;  // ClockPlan_Step_t, in order
+	uint8_t  count          ;
+	uint8_t  pll_src_change ;  // PLLSRC is shared: PLL2 and PLL3 must be off
+	uint32_t cost_us        ;  // Sum of the step estimates
+} ClockPlan_t;
+
+/************************ Function prototypes ***************************/
+ClockPlan_Status_t Clock_Plan_Compute(const ClockProfile_t *from, const ClockProfile_t *to, ClockPlan_t *plan) ;
+ClockPlan_Status_t Clock_Plan_Full(const ClockProfile_t *from, const ClockProfile_t *to, ClockPlan_t *plan) ;
+uint32_t           Clock_Plan_Step_Cost(uint8_t step, const ClockProfile_t *from, const ClockProfile_t *to) ;
+uint8_t            Clock_Plan_Same_PLL1(const ClockProfile_t *a, const ClockProfile_t *b, uint8_t ignore_fracn) ;
+uint8_t            Clock_Plan_Same_Prescalers(const ClockProfile_t *a, const ClockProfile_t *b) ;
+const char        *Clock_Plan_Step_Name(uint8_t step) ;
+const char        *Clock_Plan_Status_Name(ClockPlan_Status_t status) ;
+
+/* Firmware only, clock_profile.c */
+ClockPlan_Status_t Clock_Profile_Transition(const ClockProfile_t *profile, ClockPlan_t *plan) ;
+
+#endif /* _CLOCK_PLAN_H_ */
@@ -0,0 +1,445 @@
+/*
+ ******************************************************************************
+ * File              : clock_profile.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Apply a validated clock profile, fall back to default
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 18, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Clock_Profile_Apply() follows the same steps as SystemClock_Config() but
+ * takes every value from the profile instead of from macros. The sequence is
+ * also safe when called again at run time: the system clock is first moved
+ * to the PLL1 source oscillator, so VOS and flash wait states can be changed
+ * in any direction before PLL1 is locked again.
+ *
+ * Clock_Profile_Transition() runs the same steps, only those the plan of
+ * clock_plan.c needs and in its order, from the active profile.
+ *
+ * HSE mode: with an external clock (HSE_BYPASS, HSE_DIGITAL) on OSC_IN
+ * there is no crystal to settle, HSERDY follows HSEON within a few clock
+ * edges. The crystal start-up (tSU(HSE), 2 ms typical in the datasheet) is
+ * the longest wait of the boot. The STM32H743 has no HSEEXT bit: DIGITAL is
+ * the same as BYPASS unless the device header defines RCC_CR_HSEEXT.
+ *
+ * Step profiler: each step of Clock_Profile_Apply() is timed with the DWT
+ * cycle counter, converted with the CPU clock in force when the step starts.
+ * Cycle_Counter_Init() must have been called, else the times read 0.
+ * A step that switches the system clock is converted at the old clock, its
+ * wait is spent there. Clock_Profile_Step_Ns() gives the last run, indexed
+ * by step number minus one.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "clock_profile.h"
+#include "system_clock_config.h"
+#include "clock_plan.h"
+#include "kernel_clock.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+// D3CR VOS[1:0] encoding, Reference Manual, Page 319: VOS1 = 11, VOS2 = 10, VOS3 = 01
+#define PWR_D3CR_VOS_LEVEL(vos)     ( (uint32_t)(((vos) == 0U) ? 3U : (4U - (vos))) << PWR_D3CR_VOS_Pos )
+
+#if defined(RCC_CR_HSEEXT)
+#define RCC_CR_HSE_MODE             ( RCC_CR_HSEBYP | RCC_CR_HSEEXT )
+#else
+#define RCC_CR_HSE_MODE             ( RCC_CR_HSEBYP )
+#endif
+
+/************************** Local Variables ****************************/
+
+static const ClockProfile_t *Active_Profile = &Clock_Profile_Default;
+static uint32_t              Step_Ns[CLOCK_PROFILE_APPLY_STEPS] ;
+static uint32_t              Step_Start ;
+static uint32_t              Step_Hz ;
+
+/* D1CPRE[3:0] and HPRE[3:0] encoding, Reference Manual, Page 394
+ * 0xxx: not divided, 1000: /2, 1001: /4, ... 1011: /16, 1100: /64 ... 1111: /512
+ */
+uint32_t Clock_Profile_Core_Prescaler_Bits(uint16_t div)
+{
+	uint32_t bits = 8U;
+
+	if (div <= 1U)
+	{
+		return 0U;
+	}
+	for (uint16_t d = 2U; d < div; d <<= 1)
+	{
+		if (d != 16U)  // There is no division by 32
+		{
+			bits++;
+		}
+	}
+	return bits;
+}
+
+/* D1PPRE, D2PPRE1, D2PPRE2, D3PPRE encoding, Reference Manual, Page 394
+ * 0xx: not divided, 100: /2, 101: /4, 110: /8, 111: /16
+ */
+static uint32_t Apb_Prescaler_Bits(uint8_t div)
+{
+	uint32_t bits = 4U;
+
+	if (div <= 1U)
+	{
+		return 0U;
+	}
+	for (uint8_t d = 2U; d < div; d <<= 1)
+	{
+		bits++;
+	}
+	return bits;
+}
+
+/* HSE on in the given mode, Reference Manual, RCC_CR.
+ * HSEBYP (and HSEEXT) can only be written with HSEON clear: a running HSE
+ * keeps its mode, it may clock the system or PLL2/PLL3.
+ */
+void Clock_Profile_HSE_On(uint8_t hse_mode)
+{
+	uint32_t mode = 0U;
+
+	if (RCC->CR & RCC_CR_HSERDY)
+	{
+		return;
+	}
+
+	if (hse_mode != CLOCK_PROFILE_HSE_CRYSTAL)
+	{
+		mode |= RCC_CR_HSEBYP;
+	}
+#if defined(RCC_CR_HSEEXT)
+	if (hse_mode == CLOCK_PROFILE_HSE_DIGITAL)
+	{
+		mode |= RCC_CR_HSEEXT;
+	}
+#endif
+
+	RCC->CR &= ~ RCC_CR_HSEON ;
+	RCC->CR  = (RCC->CR & ~ RCC_CR_HSE_MODE) | mode ;
+	RCC->CR |= RCC_CR_HSEON ;
+	while(! (RCC->CR & RCC_CR_HSERDY) ) {}
+}
+
+/* Step profiler, time of the step just done, then start the next one */
+static void Step_Done(uint8_t step)
+{
+	uint32_t now = Cycle_Counter_Get();
+
+	if ((step != 0U) && (Step_Hz != 0U))
+	{
+		Step_Ns[step - 1U] = (uint32_t)(((uint64_t)(now - Step_Start) * 1000000000ULL) / Step_Hz);
+	}
+	Step_Hz    = Kernel_Clock_Hz(KERNEL_CLOCK_CPU);
+	Step_Start = Cycle_Counter_Get();
+}
+
+/* Start the PLL1 source oscillator of the profile and run the system from it.
+ * CSI feeds PLL1 only, the system runs from HSI meanwhile.
+ */
+static void Sysclk_Oscillator(const ClockProfile_t *profile)
+{
+	if (profile->pll_src == CLOCK_PROFILE_PLLSRC_HSE)
+	{
+		Clock_Profile_HSE_On(profile->hse_mode);
+
+		RCC->CFGR = (RCC->CFGR & ~ RCC_CFGR_SW) | RCC_CFGR_SW_HSE ;
+		while( (RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_HSE ) {}
+	}
+	else
+	{
+		if (profile->pll_src == CLOCK_PROFILE_PLLSRC_CSI)
+		{
+			RCC->CR |= RCC_CR_CSION;
+			while(! (RCC->CR & RCC_CR_CSIRDY) ) {}
+		}
+		RCC->CR |= RCC_CR_HSION;
+		while(! (RCC->CR & RCC_CR_HSIRDY) ) {}
+
+		RCC->CFGR = (RCC->CFGR & ~ RCC_CFGR_SW) | RCC_CFGR_SW_HSI ;
+		while( (RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_HSI ) {}
+	}
+}
+
+static void PLL1_Off(void)
+{
+	RCC->CR &= ~ RCC_CR_PLL1ON ;
+	while( (RCC->CR & RCC_CR_PLL1RDY) != 0 ) {}
+}
+
+/* Voltage scaling, Reference Manual, Page 279
+ * VOS0 is VOS1 plus ODEN in SYSCFG_PWRCR: ODEN is cleared before leaving
+ * VOS0 and set after VOS1 is reached.
+ */
+static void VOS_Set(uint8_t vos)
+{
+	if (vos != 0U)
+	{
+		SYSCFG->PWRCR &= ~ SYSCFG_PWRCR_ODEN ;
+	}
+	PWR->D3CR = (PWR->D3CR & ~ PWR_D3CR_VOS_Msk) | PWR_D3CR_VOS_LEVEL(vos) ;
+	while(! (PWR->D3CR & PWR_D3CR_VOSRDY) ) {}
+
+	if (vos == 0U)
+	{
+		SYSCFG->PWRCR |= SYSCFG_PWRCR_ODEN ;
+		while(! (PWR->D3CR & PWR_D3CR_VOSRDY) ) {}
+	}
+}
+
+/* Flash wait states, Reference Manual, Page 166.
+ * Read back to make sure the value is taken.
+ */
+static void Flash_Set(const ClockProfile_t *profile)
+{
+	FLASH->ACR = (FLASH->ACR & ~ (FLASH_ACR_LATENCY_Msk | FLASH_ACR_WRHIGHFREQ_Msk)) |
+	             ((uint32_t)profile->flash_latency    << FLASH_ACR_LATENCY_Pos) |
+	             ((uint32_t)profile->flash_wrhighfreq << FLASH_ACR_WRHIGHFREQ_Pos) ;
+	while( (FLASH->ACR & FLASH_ACR_LATENCY_Msk) != ((uint32_t)profile->flash_latency << FLASH_ACR_LATENCY_Pos) ) {}
+}
+
+/* PLL1 source, dividers and ranges, then lock. PLL1 must be off. */
+static void PLL1_Lock(const ClockProfile_t *profile)
+{
+	uint32_t reg;
+
+	/* Source and DIVM1, Reference Manual, Page 397 */
+	reg  = RCC->PLLCKSELR & ~ (RCC_PLLCKSELR_PLLSRC_Msk | RCC_PLLCKSELR_DIVM1_Msk) ;
+	reg |= ((uint32_t)profile->pll_src << RCC_PLLCKSELR_PLLSRC_Pos) |
+	       ((uint32_t)profile->divm1   << RCC_PLLCKSELR_DIVM1_Pos ) ;
+	RCC->PLLCKSELR = reg ;
+
+	/* DIVN1, DIVP1, DIVQ1, DIVR1, Reference Manual, Page 402
+	 * Every field holds the division value minus one
+	 */
+	RCC->PLL1DIVR = (((uint32_t)profile->divn1 - 1U) << RCC_PLL1DIVR_N1_Pos) |
+	                (((uint32_t)profile->divp1 - 1U) << RCC_PLL1DIVR_P1_Pos) |
+	                (((uint32_t)profile->divq1 - 1U) << RCC_PLL1DIVR_Q1_Pos) |
+	                (((uint32_t)profile->divr1 - 1U) << RCC_PLL1DIVR_R1_Pos) ;
+
+	/* Fractional part, latched by the 0 to 1 transition of PLL1FRACEN */
+	RCC->PLLCFGR  &= ~ RCC_PLLCFGR_PLL1FRACEN ;
+	RCC->PLL1FRACR = (uint32_t)profile->fracn1 << RCC_PLL1FRACR_FRACN1_Pos ;
+
+	/* Input range, VCO range and outputs, Reference Manual, Page 401 */
+	reg  = RCC->PLLCFGR & ~ (RCC_PLLCFGR_PLL1RGE_Msk | RCC_PLLCFGR_PLL1VCOSEL) ;
+	reg |= ((uint32_t)profile->pll1rge << RCC_PLLCFGR_PLL1RGE_Pos) ;
+	if (profile->pll1vcosel != 0U)
+	{
+		reg |= RCC_PLLCFGR_PLL1VCOSEL ;
+	}
+	reg |= RCC_PLLCFGR_DIVP1EN | RCC_PLLCFGR_DIVQ1EN | RCC_PLLCFGR_DIVR1EN | RCC_PLLCFGR_PLL1FRACEN ;
+	RCC->PLLCFGR = reg ;
+
+	/* Enable PLL1 and wait for lock */
+	RCC->CR |= RCC_CR_PLL1ON ;
+	while(! (RCC->CR & RCC_CR_PLL1RDY) ) {}
+}
+
+/* New FRACN1 with PLL1 locked: the fractional part can change on the fly,
+ * the VCO follows without losing lock (Reference Manual, PLL1FRACR).
+ */
+static void PLL1_Fracn(uint16_t fracn1)
+{
+	RCC->PLLCFGR  &= ~ RCC_PLLCFGR_PLL1FRACEN ;
+	RCC->PLL1FRACR = (uint32_t)fracn1 << RCC_PLL1FRACR_FRACN1_Pos ;
+	RCC->PLLCFGR  |= RCC_PLLCFGR_PLL1FRACEN ;
+}
+
+/* Domain prescalers, Reference Manual, Page 394 and 395 */
+static void Prescalers_Set(uint16_t d1cpre, uint16_t hpre, uint8_t d1ppre, uint8_t d2ppre1, uint8_t d2ppre2, uint8_t d3ppre)
+{
+	RCC->D1CFGR = (RCC->D1CFGR & ~ (RCC_D1CFGR_D1CPRE_Msk | RCC_D1CFGR_HPRE_Msk | RCC_D1CFGR_D1PPRE_Msk)) |
+	              (Clock_Profile_Core_Prescaler_Bits(d1cpre) << RCC_D1CFGR_D1CPRE_Pos) |
+	              (Clock_Profile_Core_Prescaler_Bits(hpre)   << RCC_D1CFGR_HPRE_Pos  ) |
+	              (Apb_Prescaler_Bits(d1ppre)  << RCC_D1CFGR_D1PPRE_Pos) ;
+
+	RCC->D2CFGR = (RCC->D2CFGR & ~ (RCC_D2CFGR_D2PPRE1_Msk | RCC_D2CFGR_D2PPRE2_Msk)) |
+	              (Apb_Prescaler_Bits(d2ppre1) << RCC_D2CFGR_D2PPRE1_Pos) |
+	              (Apb_Prescaler_Bits(d2ppre2) << RCC_D2CFGR_D2PPRE2_Pos) ;
+
+	RCC->D3CFGR = (RCC->D3CFGR & ~ RCC_D3CFGR_D3PPRE_Msk) |
+	              (Apb_Prescaler_Bits(d3ppre)  << RCC_D3CFGR_D3PPRE_Pos) ;
+}
+
+/* Select PLL1 as system clock (pll1_p_ck) */
+static void Sysclk_PLL1(void)
+{
+	RCC->CFGR = (RCC->CFGR & ~ RCC_CFGR_SW) | RCC_CFGR_SW_PLL1 ;
+	while( (RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL1 ) {}
+}
+
+#define MAX_DIV(a, b)   ( ((a) > (b)) ? (a) : (b) )
+
+void Clock_Profile_Apply(const ClockProfile_t *profile)
+{
+	Step_Done(0U);
+
+	/* Step 1: Supply configuration, same as SystemClock_Config()
+	 * PWR_CR3 can only be written once after reset, later writes are ignored
+	 */
+	PWR->CR3 |= (PWR_CR3_SCUEN | PWR_CR3_LDOEN | PWR_CR3_BYPASS );
+
+	RCC->APB4ENR |= RCC_APB4ENR_SYSCFGEN ;
+
+	Step_Done(1U);
+
+	/* Step 2: Start the PLL1 source oscillator and run the system from it */
+	Sysclk_Oscillator(profile);
+
+	Step_Done(2U);
+
+	/* Step 3: Disable PLL1 and wait until it is unlocked */
+	PLL1_Off();
+
+	Step_Done(3U);
+
+	/* Step 4: Voltage scaling, the system runs from an oscillator,
+	 * so VOS can go up or down
+	 */
+	VOS_Set(profile->vos);
+
+	Step_Done(4U);
+
+	/* Step 5: Flash wait states for the target AXI clock */
+	Flash_Set(profile);
+
+	Step_Done(5U);
+
+	/* Step 6: PLL1 source, dividers, FRACN1 and ranges, wait for lock */
+	PLL1_Lock(profile);
+
+	Step_Done(6U);
+
+	/* Step 7: Domain prescalers */
+	Prescalers_Set(profile->d1cpre, profile->hpre, profile->d1ppre,
+	               profile->d2ppre1, profile->d2ppre2, profile->d3ppre);
+
+	Step_Done(7U);
+
+	/* Step 8: Select PLL1 as system clock */
+	Sysclk_PLL1();
+	Step_Done(8U);
+
+	Active_Profile = profile;
+}
+
+/* From the active profile to profile with the shortest legal sequence of
+ * clock_plan.c. The steps that leave a part of the clock tree unchanged are
+ * skipped: a prescaler or FRACN1 change does not stop PLL1, and the
+ * peripherals clocked by PLL2, PLL3 or the kernel muxes keep running.
+ * The profile must stay valid while active, as for Clock_Profile_Apply().
+ * Timebase_Clock_Changed() must be called after, as after Apply.
+ */
+ClockPlan_Status_t Clock_Profile_Transition(const ClockProfile_t *profile, ClockPlan_t *plan)
+{
+	const ClockProfile_t *from = Active_Profile;
+	ClockPlan_Status_t    status;
+
+	/* Step 1: Plan from the profile in force */
+	status = Clock_Plan_Compute(from, profile, plan);
+	if (status != CLOCK_PLAN_OK)
+	{
+		return status;
+	}
+
+	/* Step 2: PLLSRC is common to the three PLLs, Reference Manual, Page 397:
+	 * it can only change with PLL2 and PLL3 off
+	 */
+	if (plan->pll_src_change && ((RCC->CR & (RCC_CR_PLL2ON | RCC_CR_PLL3ON)) != 0U))
+	{
+		return CLOCK_PLAN_ERR_BUSY;
+	}
+
+	RCC->APB4ENR |= RCC_APB4ENR_SYSCFGEN ;
+
+	/* Step 3: Run the steps in the planned order */
+	for (uint8_t i = 0U; i < plan->count; i++)
+	{
+		switch (plan->steps[i])
+		{
+			case CLOCK_STEP_SYSCLK_OSC:  Sysclk_Oscillator(profile); break;
+			case CLOCK_STEP_PLL1_OFF:    PLL1_Off();                 break;
+			case CLOCK_STEP_PLL1_ON:     PLL1_Lock(profile);         break;
+			case CLOCK_STEP_SYSCLK_PLL1: Sysclk_PLL1();              break;
+			case CLOCK_STEP_FRACN:       PLL1_Fracn(profile->fracn1); break;
+			case CLOCK_STEP_VOS:         VOS_Set(profile->vos);      break;
+			case CLOCK_STEP_FLASH:       Flash_Set(profile);         break;
+
+			/* Through the slower of both: no clock is above either profile
+			 * between the writes of D1CFGR, D2CFGR and D3CFGR
+			 */
+			case CLOCK_STEP_PRESCALERS:
+				Prescalers_Set(MAX_DIV(from->d1cpre, profile->d1cpre), MAX_DIV(from->hpre, profile->hpre),
+				               MAX_DIV(from->d1ppre, profile->d1ppre), MAX_DIV(from->d2ppre1, profile->d2ppre1),
+				               MAX_DIV(from->d2ppre2, profile->d2ppre2), MAX_DIV(from->d3ppre, profile->d3ppre));
+				Prescalers_Set(profile->d1cpre, profile->hpre, profile->d1ppre,
+				               profile->d2ppre1, profile->d2ppre2, profile->d3ppre);
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	Active_Profile = profile;
+	return CLOCK_PLAN_OK;
+}
+
+/* Validate the blob in the profile sector and apply it.
+ * An erased sector reads 0xFF and fails on the magic number.
+ * On any error the built-in default is programmed by SystemClock_Config().
+ */
+ClockProfile_Status_t Clock_Profile_Boot(void)
+{
+	const ClockProfile_t  *flash_profile = (const ClockProfile_t *)CLOCK_PROFILE_FLASH_ADDR;
+	ClockProfile_Status_t  status;
+
+	status = Clock_Profile_Validate(flash_profile);
+
+	if (status == CLOCK_PROFILE_OK)
+	{
+		Clock_Profile_Apply(flash_profile);
+	}
+	else
+	{
+		SystemClock_Config();
+		Active_Profile = &Clock_Profile_Default;
+	}
+
+	return status;
+}
+
+/* Time of each step of the last Clock_Profile_Apply(), in ns,
+ * CLOCK_PROFILE_APPLY_STEPS entries
+ */
+const uint32_t *Clock_Profile_Step_Ns(void)
+{
+	return Step_Ns;
+}
+
+const ClockProfile_t *Clock_Profile_Active(void)
+{
+	return Active_Profile;
+}
@@ -0,0 +1,165 @@
+/*
+ ******************************************************************************
+ * File              : clock_profile.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Binary clock profile stored in flash and applied at boot
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 18, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * A clock profile is a 48-byte little-endian blob holding the same values that
+ * SystemClock_Config() bakes into macros (DIVM1, DIVN1, DIVP1 ... prescalers).
+ * The blob is written into the last flash sector of bank 2 and is checked at
+ * boot. A blob with a wrong magic, version, length, CRC or an illegal clock
+ * tree is rejected and the built-in default (SystemClock_Config) is used.
+ *
+ * This header does not include stm32h7xx.h so that the host tool in
+ * tools/clock_profile_tool.c can share the validator with the firmware.
+ *
+ ******************************************************************************/
+
+#ifndef _CLOCK_PROFILE_H_
+#define _CLOCK_PROFILE_H_
+
+#include <stdint.h>
+
+/*************************** Macros ************************************/
+
+#define CLOCK_PROFILE_MAGIC         ( 0x50434B43UL )  // "CKCP" read as little-endian
+#define CLOCK_PROFILE_VERSION       (         1U   )
+#define CLOCK_PROFILE_SIZE          (        48U   )  // Size of the blob in bytes
+
+// Bank 2, sector 7 (128 Kbytes), Reference Manual, Page 153
+#define CLOCK_PROFILE_FLASH_ADDR    ( 0x081E0000UL )
+
+// Clock sources of PLL1, same encoding as PLLSRC[1:0] in RCC_PLLCKSELR
+#define CLOCK_PROFILE_PLLSRC_HSI    ( 0U )
+#define CLOCK_PROFILE_PLLSRC_CSI    ( 1U )
+#define CLOCK_PROFILE_PLLSRC_HSE    ( 2U )
+
+// HSE circuit, HSEBYP and HSEEXT in RCC_CR. Written while the HSE is off,
+// a running HSE keeps its mode.
+#define CLOCK_PROFILE_HSE_CRYSTAL   ( 0U )  // Crystal or resonator, HSERDY after the oscillator settles
+#define CLOCK_PROFILE_HSE_BYPASS    ( 1U )  // External clock on OSC_IN (canned oscillator), HSEBYP
+#define CLOCK_PROFILE_HSE_DIGITAL   ( 2U )  // External square clock, HSEBYP and HSEEXT where the part has it
+
+// HSE of the board, used by SystemClock_Config() and Clock_Profile_Default
+#ifndef CLOCK_PROFILE_HSE_BOARD
+#define CLOCK_PROFILE_HSE_BOARD     ( CLOCK_PROFILE_HSE_CRYSTAL )   // OpenH743-C: 25 MHz crystal
+#endif
+
+// Clock_Profile_Apply() steps timed by the step profiler
+#define CLOCK_PROFILE_APPLY_STEPS   ( 8U )
+
+// Datasheet DS12110, Table 23, maximum frequencies per voltage scaling
+#define CLOCK_PROFILE_SYSCLK_MAX_VOS0   ( 480000000UL )
+#define CLOCK_PROFILE_SYSCLK_MAX_VOS1   ( 400000000UL )
+#define CLOCK_PROFILE_SYSCLK_MAX_VOS2   ( 300000000UL )
+#define CLOCK_PROFILE_SYSCLK_MAX_VOS3   ( 200000000UL )
+
+/*************************** Types *************************************/
+
+/* Every divider is stored as its real division value (DIVN = 192 is 192),
+ * not as the register encoding, so that a blob can be read by a human.
+ * vos is the voltage scaling level 0..3, VOS0 means VOS1 plus ODEN.
+ */
+typedef struct
+{
+	uint32_t magic       ;  // CLOCK_PROFILE_MAGIC
+	uint16_t version     ;  // CLOCK_PROFILE_VERSION
+	uint16_t length      ;  // CLOCK_PROFILE_SIZE
+	uint32_t profile_id  ;  // Free identifier chosen by the generator
+	uint32_t hse_hz      ;  // HSE crystal frequency on the board
+
+	uint8_t  vos         ;  // 0: VOS0 ... 3: VOS3
+	uint8_t  pll_src     ;  // CLOCK_PROFILE_PLLSRC_x
+	uint8_t  divm1       ;  // 1..63
+	uint8_t  pll1rge     ;  // PLL1RGE[1:0], 0: 1-2 MHz ... 3: 8-16 MHz
+	uint16_t divn1       ;  // 4..512
+	uint16_t fracn1      ;  // 0..8191, 0 disables the fractional part
+	uint8_t  divp1       ;  // 2..128, even only
+	uint8_t  divq1       ;  // 1..128
+	uint8_t  divr1       ;  // 1..128
+	uint8_t  pll1vcosel  ;  // 0: wide VCO range, 1: medium VCO range
+
+	uint16_t d1cpre      ;  // 1, 2, 4, 8, 16, 64, 128, 256, 512
+	uint16_t hpre        ;  // 1, 2, 4, 8, 16, 64, 128, 256, 512
+	uint8_t  d1ppre      ;  // 1, 2, 4, 8, 16
+	uint8_t  d2ppre1     ;  // 1, 2, 4, 8, 16
+	uint8_t  d2ppre2     ;  // 1, 2, 4, 8, 16
+	uint8_t  d3ppre      ;  // 1, 2, 4, 8, 16
+
+	uint8_t  flash_latency    ;  // LATENCY[3:0] wait states
+	uint8_t  flash_wrhighfreq ;  // WRHIGHFREQ[1:0]
+	uint8_t  hse_mode         ;  // CLOCK_PROFILE_HSE_x, 0 (crystal) in blobs made before
+	uint8_t  reserved[5]      ;  // Must be 0
+
+	uint32_t crc         ;  // CRC-32 (IEEE 802.3) of all bytes above
+} ClockProfile_t;
+
+typedef enum
+{
+	CLOCK_PROFILE_OK = 0     ,
+	CLOCK_PROFILE_ERR_MAGIC  ,
+	CLOCK_PROFILE_ERR_VERSION,
+	CLOCK_PROFILE_ERR_LENGTH ,
+	CLOCK_PROFILE_ERR_CRC    ,
+	CLOCK_PROFILE_ERR_RANGE  ,  // A divider or prescaler value is not legal
+	CLOCK_PROFILE_ERR_PLL    ,  // PLL1 input or VCO frequency out of range
+	CLOCK_PROFILE_ERR_FREQ   ,  // A domain clock exceeds the VOS limit
+	CLOCK_PROFILE_ERR_FLASH     // Not enough flash wait states
+} ClockProfile_Status_t;
+
+/* Frequencies of the clock tree described by a profile, in Hz */
+typedef struct
+{
+	uint32_t vco_hz      ;
+	uint32_t pll1_p_hz   ;
+	uint32_t pll1_q_hz   ;
+	uint32_t pll1_r_hz   ;
+	uint32_t sysclk_hz   ;  // sys_d1cpre_ck, CPU clock
+	uint32_t hclk_hz     ;  // rcc_hclk3, AXI and AHB clock
+	uint32_t pclk1_hz    ;
+	uint32_t pclk2_hz    ;
+	uint32_t pclk3_hz    ;
+	uint32_t pclk4_hz    ;
+} ClockProfile_Freq_t;
+
+/************************ Function prototypes ***************************/
+
+/* Portable part, clock_profile_blob.c (firmware and host tool) */
+uint32_t              Clock_Profile_CRC32(const void *data, uint32_t length) ;
+void                  Clock_Profile_Seal(ClockProfile_t *profile) ;
+ClockProfile_Status_t Clock_Profile_Frequencies(const ClockProfile_t *profile, ClockProfile_Freq_t *freq) ;
+ClockProfile_Status_t Clock_Profile_Validate(const ClockProfile_t *profile) ;
+ClockProfile_Status_t Clock_Profile_Check_Limits(const ClockProfile_t *profile, const ClockProfile_Freq_t *freq) ;
+const char           *Clock_Profile_Status_Name(ClockProfile_Status_t status) ;
+
+extern const ClockProfile_t Clock_Profile_Default ;
+
+/* Target part, clock_profile.c */
+void                  Clock_Profile_Apply(const ClockProfile_t *profile) ;
+ClockProfile_Status_t Clock_Profile_Boot(void) ;
+const ClockProfile_t *Clock_Profile_Active(void) ;
+uint32_t              Clock_Profile_Core_Prescaler_Bits(uint16_t div) ;
+void                  Clock_Profile_HSE_On(uint8_t hse_mode) ;
+const uint32_t       *Clock_Profile_Step_Ns(void) ;
+
+#endif /* _CLOCK_PROFILE_H_ */
@@ -0,0 +1,324 @@
+/*
+ ******************************************************************************
+ * File              : clock_profile_blob.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Clock profile validator shared by firmware and host tool
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 18, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * No register access in this file. It is compiled into the firmware and into
+ * tools/clock_profile_tool.c, so a blob accepted by the host tool is accepted
+ * by the board and the other way round.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include "clock_profile.h"
+
+/* The layout of the blob is part of the format, catch any padding change */
+typedef char Clock_Profile_Size_Check[(sizeof(ClockProfile_t) == CLOCK_PROFILE_SIZE) ? 1 : -1];
+
+/* Built-in default, the same clock tree as SystemClock_Config()
+ * HSE = 25 MHz, DIVM1 = 5 -> ref1_ck = 5 MHz, DIVN1 = 192 -> VCO = 960 MHz
+ * DIVP1 = 2 -> sys_ck = 480 MHz, HPRE = 2 -> rcc_hclk3 = 240 MHz
+ * The CRC is left at 0, the default is never read back from flash.
+ */
+const ClockProfile_t Clock_Profile_Default =
+{
+	.magic            = CLOCK_PROFILE_MAGIC    ,
+	.version          = CLOCK_PROFILE_VERSION  ,
+	.length           = CLOCK_PROFILE_SIZE     ,
+	.profile_id       = 0U                     ,
+	.hse_hz           = 25000000UL             ,
+	.vos              = 0U                     ,
+	.pll_src          = CLOCK_PROFILE_PLLSRC_HSE,
+	.divm1            = 5U                     ,
+	.pll1rge          = 2U                     ,
+	.divn1            = 192U                   ,
+	.fracn1           = 0U                     ,
+	.divp1            = 2U                     ,
+	.divq1            = 2U                     ,
+	.divr1            = 2U                     ,
+	.pll1vcosel       = 0U                     ,
+	.d1cpre           = 1U                     ,
+	.hpre             = 2U                     ,
+	.d1ppre           = 2U                     ,
+	.d2ppre1          = 2U                     ,
+	.d2ppre2          = 2U                     ,
+	.d3ppre           = 2U                     ,
+	.flash_latency    = 4U                     ,
+	.flash_wrhighfreq = 2U                     ,
+	.hse_mode         = CLOCK_PROFILE_HSE_BOARD ,
+	.reserved         = { 0U }                 ,
+	.crc              = 0U
+};
+
+/* Reference Manual, Table 17, FLASH recommended number of wait states
+ * Upper AXI clock limit in MHz for 0, 1, 2 ... wait states, and the
+ * matching WRHIGHFREQ value, one row per voltage scaling level.
+ */
+static const uint16_t Flash_Max_Mhz[4][5] =
+{
+	{ 70U, 140U, 185U, 210U, 240U },  // VOS0
+	{ 70U, 140U, 185U, 210U, 225U },  // VOS1
+	{ 55U, 110U, 165U, 225U,   0U },  // VOS2, 0: no limit
+	{ 45U,  90U, 135U, 180U, 225U }   // VOS3
+};
+
+static const uint8_t Flash_Wrhighfreq[4][5] =
+{
+	{ 0U, 1U, 1U, 2U, 2U },
+	{ 0U, 1U, 1U, 2U, 2U },
+	{ 0U, 1U, 1U, 2U, 0U },
+	{ 0U, 0U, 1U, 1U, 2U }
+};
+
+static const uint32_t Sysclk_Max_Hz[4] =
+{
+	CLOCK_PROFILE_SYSCLK_MAX_VOS0, CLOCK_PROFILE_SYSCLK_MAX_VOS1,
+	CLOCK_PROFILE_SYSCLK_MAX_VOS2, CLOCK_PROFILE_SYSCLK_MAX_VOS3
+};
+
+/* CRC-32, polynomial 0x04C11DB7 reflected (0xEDB88320), init and final
+ * XOR 0xFFFFFFFF. Bitwise on purpose: the blob is 44 bytes, a table would
+ * cost 1 Kbyte of flash for nothing.
+ */
+uint32_t Clock_Profile_CRC32(const void *data, uint32_t length)
+{
+	const uint8_t *p   = (const uint8_t *)data;
+	uint32_t       crc = 0xFFFFFFFFUL;
+
+	while (length--)
+	{
+		crc ^= *p++;
+		for (uint32_t bit = 0U; bit < 8U; bit++)
+		{
+			crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+		}
+	}
+	return ~crc;
+}
+
+void Clock_Profile_Seal(ClockProfile_t *profile)
+{
+	profile->magic   = CLOCK_PROFILE_MAGIC;
+	profile->version = CLOCK_PROFILE_VERSION;
+	profile->length  = CLOCK_PROFILE_SIZE;
+	profile->crc     = Clock_Profile_CRC32(profile, offsetof(ClockProfile_t, crc));
+}
+
+/* D1CPRE and HPRE: 1, 2, 4, 8, 16, 64, 128, 256, 512 (no division by 32) */
+static int Is_Core_Prescaler(uint16_t div)
+{
+	return (div == 1U)  || (div == 2U)   || (div == 4U)   || (div == 8U) ||
+	       (div == 16U) || (div == 64U)  || (div == 128U) || (div == 256U) ||
+	       (div == 512U);
+}
+
+/* D1PPRE, D2PPRE1, D2PPRE2, D3PPRE: 1, 2, 4, 8, 16 */
+static int Is_Apb_Prescaler(uint8_t div)
+{
+	return (div == 1U) || (div == 2U) || (div == 4U) || (div == 8U) || (div == 16U);
+}
+
+ClockProfile_Status_t Clock_Profile_Frequencies(const ClockProfile_t *profile, ClockProfile_Freq_t *freq)
+{
+	uint32_t src_hz;
+	uint64_t vco;
+
+	switch (profile->pll_src)
+	{
+		case CLOCK_PROFILE_PLLSRC_HSI: src_hz = 64000000UL;      break;
+		case CLOCK_PROFILE_PLLSRC_CSI: src_hz =  4000000UL;      break;
+		case CLOCK_PROFILE_PLLSRC_HSE: src_hz = profile->hse_hz; break;
+		default:                       return CLOCK_PROFILE_ERR_RANGE;
+	}
+
+	if ((profile->divm1 == 0U) || (profile->divp1 == 0U) ||
+	    (profile->divq1 == 0U) || (profile->divr1 == 0U) ||
+	    (profile->d1cpre == 0U) || (profile->hpre == 0U) ||
+	    (profile->d1ppre == 0U) || (profile->d2ppre1 == 0U) ||
+	    (profile->d2ppre2 == 0U) || (profile->d3ppre == 0U))
+	{
+		return CLOCK_PROFILE_ERR_RANGE;
+	}
+
+	/* Reference Manual, Page 363
+	 * VCO = ref1_ck x (DIVN1 + FRACN1 / 2^13)
+	 */
+	vco = ((uint64_t)src_hz * (((uint64_t)profile->divn1 << 13) + profile->fracn1)) /
+	      ((uint64_t)profile->divm1 << 13);
+
+	freq->vco_hz    = (uint32_t)vco;
+	freq->pll1_p_hz = freq->vco_hz    / profile->divp1;
+	freq->pll1_q_hz = freq->vco_hz    / profile->divq1;
+	freq->pll1_r_hz = freq->vco_hz    / profile->divr1;
+	freq->sysclk_hz = freq->pll1_p_hz / profile->d1cpre;
+	freq->hclk_hz   = freq->sysclk_hz / profile->hpre;
+	freq->pclk3_hz  = freq->hclk_hz   / profile->d1ppre;
+	freq->pclk1_hz  = freq->hclk_hz   / profile->d2ppre1;
+	freq->pclk2_hz  = freq->hclk_hz   / profile->d2ppre2;
+	freq->pclk4_hz  = freq->hclk_hz   / profile->d3ppre;
+
+	return CLOCK_PROFILE_OK;
+}
+
+/* Domain clocks of freq against the VOS level and the flash wait states of
+ * profile. freq does not have to come from the PLL1 fields of profile: the
+ * transition planner checks every intermediate clock tree with it.
+ */
+ClockProfile_Status_t Clock_Profile_Check_Limits(const ClockProfile_t *profile, const ClockProfile_Freq_t *freq)
+{
+	uint32_t hclk_mhz;
+
+	if ((profile->vos > 3U) || (profile->flash_latency > 7U))
+	{
+		return CLOCK_PROFILE_ERR_RANGE;
+	}
+
+	/* Step 1: Domain clocks against the VOS limits, Datasheet Table 23
+	 * rcc_hclk3 is at most sys_ck / 2 and APB clocks at most sys_ck / 4
+	 */
+	if ((freq->sysclk_hz > Sysclk_Max_Hz[profile->vos]) ||
+	    (freq->hclk_hz   > Sysclk_Max_Hz[profile->vos] / 2U) ||
+	    (freq->pclk1_hz  > Sysclk_Max_Hz[profile->vos] / 4U) ||
+	    (freq->pclk2_hz  > Sysclk_Max_Hz[profile->vos] / 4U) ||
+	    (freq->pclk3_hz  > Sysclk_Max_Hz[profile->vos] / 4U) ||
+	    (freq->pclk4_hz  > Sysclk_Max_Hz[profile->vos] / 4U))
+	{
+		return CLOCK_PROFILE_ERR_FREQ;
+	}
+
+	/* Step 2: Flash wait states for the AXI clock, Reference Manual, Table 17 */
+	/* More than 4 wait states is always legal, just slow */
+	hclk_mhz = (freq->hclk_hz + 999999UL) / 1000000UL;
+	if (profile->flash_latency <= 4U)
+	{
+		uint16_t max_mhz = Flash_Max_Mhz[profile->vos][profile->flash_latency];
+
+		if (((max_mhz != 0U) && (max_mhz < hclk_mhz)) ||
+		    (Flash_Wrhighfreq[profile->vos][profile->flash_latency] > profile->flash_wrhighfreq))
+		{
+			return CLOCK_PROFILE_ERR_FLASH;
+		}
+	}
+
+	return CLOCK_PROFILE_OK;
+}
+
+ClockProfile_Status_t Clock_Profile_Validate(const ClockProfile_t *profile)
+{
+	static const uint32_t Ref_Min_Hz[4] = {  1000000UL, 2000000UL, 4000000UL,  8000000UL };
+	static const uint32_t Ref_Max_Hz[4] = {  2000000UL, 4000000UL, 8000000UL, 16000000UL };
+	ClockProfile_Freq_t   freq;
+	ClockProfile_Status_t status;
+	uint32_t              ref_hz;
+
+	/* Step 1: Container, magic, version, length and CRC */
+	if (profile->magic != CLOCK_PROFILE_MAGIC)
+	{
+		return CLOCK_PROFILE_ERR_MAGIC;
+	}
+	if (profile->version != CLOCK_PROFILE_VERSION)
+	{
+		return CLOCK_PROFILE_ERR_VERSION;
+	}
+	if (profile->length != CLOCK_PROFILE_SIZE)
+	{
+		return CLOCK_PROFILE_ERR_LENGTH;
+	}
+	if (profile->crc != Clock_Profile_CRC32(profile, offsetof(ClockProfile_t, crc)))
+	{
+		return CLOCK_PROFILE_ERR_CRC;
+	}
+
+	/* Step 2: Register field ranges, Reference Manual, Page 397 to 402 */
+	if ((profile->vos > 3U) || (profile->pll1rge > 3U) || (profile->pll1vcosel > 1U) ||
+	    (profile->divm1 < 1U) || (profile->divm1 > 63U) ||
+	    (profile->divn1 < 4U) || (profile->divn1 > 512U) || (profile->fracn1 > 8191U) ||
+	    (profile->divp1 < 2U) || (profile->divp1 > 128U) || ((profile->divp1 & 1U) != 0U) ||
+	    (profile->divq1 < 1U) || (profile->divq1 > 128U) ||
+	    (profile->divr1 < 1U) || (profile->divr1 > 128U) ||
+	    (!Is_Core_Prescaler(profile->d1cpre)) || (!Is_Core_Prescaler(profile->hpre)) ||
+	    (!Is_Apb_Prescaler(profile->d1ppre))  || (!Is_Apb_Prescaler(profile->d2ppre1)) ||
+	    (!Is_Apb_Prescaler(profile->d2ppre2)) || (!Is_Apb_Prescaler(profile->d3ppre)) ||
+	    (profile->flash_latency > 7U) || (profile->flash_wrhighfreq > 3U) ||
+	    (profile->hse_mode > CLOCK_PROFILE_HSE_DIGITAL))
+	{
+		return CLOCK_PROFILE_ERR_RANGE;
+	}
+	for (uint32_t i = 0U; i < sizeof(profile->reserved); i++)
+	{
+		if (profile->reserved[i] != 0U)
+		{
+			return CLOCK_PROFILE_ERR_RANGE;
+		}
+	}
+
+	status = Clock_Profile_Frequencies(profile, &freq);
+	if (status != CLOCK_PROFILE_OK)
+	{
+		return status;
+	}
+
+	/* Step 3: PLL1 input and VCO ranges, Reference Manual, Page 401
+	 * Medium VCO range (150 to 420 MHz) needs ref1_ck between 1 and 2 MHz,
+	 * wide VCO range (192 to 960 MHz) needs ref1_ck above 2 MHz.
+	 */
+	ref_hz = ((profile->pll_src == CLOCK_PROFILE_PLLSRC_HSE) ? profile->hse_hz :
+	          (profile->pll_src == CLOCK_PROFILE_PLLSRC_CSI) ? 4000000UL : 64000000UL) / profile->divm1;
+
+	if ((ref_hz < Ref_Min_Hz[profile->pll1rge]) || (ref_hz > Ref_Max_Hz[profile->pll1rge]))
+	{
+		return CLOCK_PROFILE_ERR_PLL;
+	}
+	if (profile->pll1vcosel == 0U)
+	{
+		if ((profile->pll1rge == 0U) || (freq.vco_hz < 192000000UL) || (freq.vco_hz > 960000000UL))
+		{
+			return CLOCK_PROFILE_ERR_PLL;
+		}
+	}
+	else if ((freq.vco_hz < 150000000UL) || (freq.vco_hz > 420000000UL))
+	{
+		return CLOCK_PROFILE_ERR_PLL;
+	}
+
+	/* Step 4: Domain clocks and flash wait states */
+	return Clock_Profile_Check_Limits(profile, &freq);
+}
+
+const char *Clock_Profile_Status_Name(ClockProfile_Status_t status)
+{
+	switch (status)
+	{
+		case CLOCK_PROFILE_OK:          return "ok";
+		case CLOCK_PROFILE_ERR_MAGIC:   return "bad magic";
+		case CLOCK_PROFILE_ERR_VERSION: return "unsupported version";
+		case CLOCK_PROFILE_ERR_LENGTH:  return "bad length";
+		case CLOCK_PROFILE_ERR_CRC:     return "CRC mismatch";
+		case CLOCK_PROFILE_ERR_RANGE:   return "field out of range";
+		case CLOCK_PROFILE_ERR_PLL:     return "PLL1 input or VCO out of range";
+		case CLOCK_PROFILE_ERR_FREQ:    return "clock above VOS limit";
+		case CLOCK_PROFILE_ERR_FLASH:   return "too few flash wait states";
+		default:                        return "unknown";
+	}
+}
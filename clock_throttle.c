@@ -0,0 +1,322 @@
+/*
+ ******************************************************************************
+ * File              : clock_throttle.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Core and bus throttle with D1CPRE and HPRE, PLL1 locked
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 3, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * D1CPRE divides sys_ck for the CPU and everything below it (AXI, AHB, APB),
+ * Reference Manual, Page 394. Doubling it halves every D1, D2 and D3 bus
+ * clock while PLL1, VOS and the kernel clocks taken from PLL1_Q, PLL2 and
+ * PLL3 are untouched: no relock, no oscillator switch. There is no division
+ * by 32, the factor then goes to HPRE (CPU unchanged, buses halved).
+ *
+ * Clock_Throttle_Init() derives the levels from the active clock profile.
+ * Each level holds the D1CFGR fields and the fewest flash wait states for its
+ * AXI clock, checked with Clock_Profile_Check_Limits(), so a change is two
+ * register writes:
+ *
+ *   slower   D1CFGR first, then FLASH_ACR
+ *   faster   FLASH_ACR first, then D1CFGR
+ *
+ * Faster means a faster AXI clock: two levels can share the CPU clock with
+ * the /2 in D1CPRE or HPRE. The wait states are always enough for the
+ * clock in force.
+ *
+ * Modules that depend on a bus clock register a notifier, called after the
+ * change: Timebase_Clock_Changed() for TIM5 on APB1 is one of them. UART,
+ * SPI or I2C kernel clocks taken from pclk change speed with the throttle.
+ * Return to CLOCK_THROTTLE_FULL before Clock_Profile_Apply() or
+ * Clock_Profile_Transition() and call Clock_Throttle_Init() after.
+ *
+ * Clock_Throttle_Benchmark() measures with the DWT cycle counter, which runs
+ * on the CPU clock being changed. A window is converted at the slowest CPU
+ * clock it contains, the result is an upper bound.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "stm32h7xx.h"
+#include "clock_throttle.h"
+#include "clock_profile.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+#define D1CFGR_THROTTLE_MSK         ( RCC_D1CFGR_D1CPRE_Msk | RCC_D1CFGR_HPRE_Msk )
+#define FLASH_ACR_THROTTLE_MSK      ( FLASH_ACR_LATENCY_Msk | FLASH_ACR_WRHIGHFREQ_Msk )
+#define CORE_PRESCALER_MAX          ( 512U )
+#define HSI_HZ                      ( 64000000UL )
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	uint32_t d1cfgr  ;  // D1CPRE and HPRE fields
+	uint32_t acr     ;  // LATENCY and WRHIGHFREQ fields
+	uint32_t cpu_hz  ;
+	uint32_t hclk_hz ;
+	uint8_t  valid   ;
+} ClockThrottle_Step_t;
+
+/************************** Local Variables ****************************/
+
+static ClockThrottle_Step_t     Levels[CLOCK_THROTTLE_LEVELS] ;
+static ClockThrottle_Notifier_t Notifiers[CLOCK_THROTTLE_NOTIFIERS] ;
+static uint32_t                 Notifier_Count ;
+static volatile uint8_t         Level ;
+static uint8_t                  Ready ;
+
+/****************************** Functions ******************************/
+
+/* One more /2 on D1CPRE, on HPRE when D1CPRE would need /32 */
+static uint8_t Halve(ClockProfile_t *p)
+{
+	if (((p->d1cpre * 2U) != 32U) && ((p->d1cpre * 2U) <= CORE_PRESCALER_MAX))
+	{
+		p->d1cpre *= 2U;
+		return 1U;
+	}
+	if (((p->hpre * 2U) != 32U) && ((p->hpre * 2U) <= CORE_PRESCALER_MAX))
+	{
+		p->hpre *= 2U;
+		return 1U;
+	}
+	return 0U;
+}
+
+/* Fewest flash wait states for the clocks of p, the profile ones for FULL */
+static uint8_t Flash_Fit(ClockProfile_t *p, const ClockProfile_Freq_t *freq)
+{
+	for (uint8_t ws = 0U; ws <= p->flash_latency; ws++)
+	{
+		for (uint8_t wr = 0U; wr <= 2U; wr++)
+		{
+			ClockProfile_t trial = *p;
+
+			trial.flash_latency    = ws;
+			trial.flash_wrhighfreq = wr;
+			if (Clock_Profile_Check_Limits(&trial, freq) == CLOCK_PROFILE_OK)
+			{
+				*p = trial;
+				return 1U;
+			}
+		}
+	}
+	return 0U;
+}
+
+ClockThrottle_Status_t Clock_Throttle_Init(void)
+{
+	const ClockProfile_t *active = Clock_Profile_Active();
+
+	for (uint8_t level = 0U; level < CLOCK_THROTTLE_LEVELS; level++)
+	{
+		ClockThrottle_Step_t *step = &Levels[level];
+		ClockProfile_t        p    = *active;
+		ClockProfile_Freq_t   freq;
+		uint8_t               ok   = 1U;
+
+		for (uint8_t k = 0U; k < level; k++)
+		{
+			ok = ok && Halve(&p);
+		}
+		ok = ok && (Clock_Profile_Frequencies(&p, &freq) == CLOCK_PROFILE_OK);
+		if (ok && (level != CLOCK_THROTTLE_FULL))
+		{
+			ok = Flash_Fit(&p, &freq);
+		}
+
+		step->valid   = ok;
+		step->d1cfgr  = (Clock_Profile_Core_Prescaler_Bits(p.d1cpre) << RCC_D1CFGR_D1CPRE_Pos) |
+		                (Clock_Profile_Core_Prescaler_Bits(p.hpre)   << RCC_D1CFGR_HPRE_Pos  ) ;
+		step->acr     = ((uint32_t)p.flash_latency    << FLASH_ACR_LATENCY_Pos) |
+		                ((uint32_t)p.flash_wrhighfreq << FLASH_ACR_WRHIGHFREQ_Pos) ;
+		step->cpu_hz  = ok ? freq.sysclk_hz : 0U;
+		step->hclk_hz = ok ? freq.hclk_hz   : 0U;
+	}
+
+	Level = CLOCK_THROTTLE_FULL;
+	Ready = 1U;
+	return Levels[CLOCK_THROTTLE_FULL].valid ? CLOCK_THROTTLE_OK : CLOCK_THROTTLE_ERR_LEVEL;
+}
+
+static void Flash_Write(uint32_t acr)
+{
+	FLASH->ACR = (FLASH->ACR & ~ FLASH_ACR_THROTTLE_MSK) | acr ;
+	while( (FLASH->ACR & FLASH_ACR_LATENCY_Msk) != (acr & FLASH_ACR_LATENCY_Msk) ) {}
+}
+
+static void D1cfgr_Write(uint32_t d1cfgr)
+{
+	RCC->D1CFGR = (RCC->D1CFGR & ~ D1CFGR_THROTTLE_MSK) | d1cfgr ;
+	while( (RCC->D1CFGR & D1CFGR_THROTTLE_MSK) != d1cfgr ) {}
+}
+
+/* Register sequence only, interrupts masked */
+static void Switch(uint8_t level)
+{
+	const ClockThrottle_Step_t *to = &Levels[level];
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	/* Flash wait states follow hclk, not the CPU clock */
+	if (to->hclk_hz > Levels[Level].hclk_hz)
+	{
+		Flash_Write(to->acr);
+		D1cfgr_Write(to->d1cfgr);
+	}
+	else
+	{
+		D1cfgr_Write(to->d1cfgr);
+		Flash_Write(to->acr);
+	}
+
+	SystemCoreClock = to->cpu_hz ;
+	SystemD2Clock   = to->hclk_hz ;
+	Level           = level;
+
+	__set_PRIMASK(primask);
+}
+
+static void Notify(void)
+{
+	for (uint32_t i = 0U; i < Notifier_Count; i++)
+	{
+		Notifiers[i]();
+	}
+}
+
+ClockThrottle_Status_t Clock_Throttle_Set(ClockThrottle_Level_t level)
+{
+	if (!Ready)
+	{
+		return CLOCK_THROTTLE_ERR_INIT;
+	}
+	if ((level >= CLOCK_THROTTLE_LEVELS) || !Levels[level].valid)
+	{
+		return CLOCK_THROTTLE_ERR_LEVEL;
+	}
+	if (level != Level)
+	{
+		Switch(level);
+		Notify();
+	}
+	return CLOCK_THROTTLE_OK;
+}
+
+ClockThrottle_Level_t Clock_Throttle_Get(void)
+{
+	return (ClockThrottle_Level_t)Level;
+}
+
+/* CPU clock of a level, 0 if the level cannot be reached */
+uint32_t Clock_Throttle_Hz(ClockThrottle_Level_t level)
+{
+	return (Ready && (level < CLOCK_THROTTLE_LEVELS)) ? Levels[level].cpu_hz : 0U;
+}
+
+ClockThrottle_Status_t Clock_Throttle_Register(ClockThrottle_Notifier_t notifier)
+{
+	if (Notifier_Count >= CLOCK_THROTTLE_NOTIFIERS)
+	{
+		return CLOCK_THROTTLE_ERR_FULL;
+	}
+	Notifiers[Notifier_Count++] = notifier;
+	return CLOCK_THROTTLE_OK;
+}
+
+/* Upper bound in ns of cycles counted at hz or faster */
+static uint32_t Bound_Ns(uint32_t cycles, uint32_t hz)
+{
+	return (uint32_t)(((uint64_t)cycles * 1000000000ULL + hz - 1U) / hz);
+}
+
+static void Keep_Max(uint32_t *max, uint32_t value)
+{
+	if (value > *max)
+	{
+		*max = value;
+	}
+}
+
+/* Every level change runs times, then one PLL1 relock with the same profile.
+ * Cycle_Counter_Init() must have been called. Peripherals on PLL1_Q stop
+ * during the relock.
+ */
+void Clock_Throttle_Benchmark(uint32_t runs, ClockThrottle_Bench_t *result)
+{
+	const ClockProfile_t *active = Clock_Profile_Active();
+	uint8_t  start = Level;
+	uint32_t osc_hz, t0, t1, t2;
+
+	memset(result, 0, sizeof(*result));
+	if (!Ready)
+	{
+		return;
+	}
+
+	/* Step 1: Every pair of levels, registers and notifiers timed apart */
+	for (uint32_t run = 0U; run < runs; run++)
+	{
+		for (uint8_t from = 0U; from < CLOCK_THROTTLE_LEVELS; from++)
+		{
+			for (uint8_t to = 0U; to < CLOCK_THROTTLE_LEVELS; to++)
+			{
+				uint32_t slowest;
+
+				if ((from == to) || !Levels[from].valid || !Levels[to].valid)
+				{
+					continue;
+				}
+				Clock_Throttle_Set((ClockThrottle_Level_t)from);
+				slowest = (Levels[from].cpu_hz < Levels[to].cpu_hz) ? Levels[from].cpu_hz : Levels[to].cpu_hz;
+
+				t0 = Cycle_Counter_Get();
+				Switch(to);
+				t1 = Cycle_Counter_Get();
+				Notify();
+				t2 = Cycle_Counter_Get();
+
+				Keep_Max(&result->switch_ns, Bound_Ns(t1 - t0, slowest));
+				Keep_Max(&result->notify_ns, Bound_Ns(t2 - t1, Levels[to].cpu_hz));
+			}
+		}
+	}
+
+	/* Step 2: Full reprogram of the same clock tree. The CPU runs from the
+	 * PLL1 source oscillator during the relock, the slowest clock of the window.
+	 */
+	Clock_Throttle_Set(CLOCK_THROTTLE_FULL);
+	osc_hz = ((active->pll_src == CLOCK_PROFILE_PLLSRC_HSE) ? active->hse_hz : HSI_HZ) / active->d1cpre;
+
+	t0 = Cycle_Counter_Get();
+	Clock_Profile_Apply(active);
+	t1 = Cycle_Counter_Get();
+	result->relock_ns = Bound_Ns(t1 - t0, osc_hz);
+
+	/* Step 3: Back to the level in force before */
+	Clock_Throttle_Init();
+	Notify();
+	Clock_Throttle_Set((ClockThrottle_Level_t)start);
+}
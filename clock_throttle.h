@@ -0,0 +1,70 @@
+/*
+ ******************************************************************************
+ * File              : clock_throttle.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Core and bus throttle with D1CPRE and HPRE, PLL1 locked
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 3, 2026
+ ******************************************************************************/
+
+#ifndef _CLOCK_THROTTLE_H_
+#define _CLOCK_THROTTLE_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+#define CLOCK_THROTTLE_NOTIFIERS    ( 8U )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	CLOCK_THROTTLE_FULL = 0 ,  // Dividers of the active clock profile
+	CLOCK_THROTTLE_HALF     ,  // Core, AXI, AHB and APB clocks / 2
+	CLOCK_THROTTLE_QUARTER  ,  // / 4
+	CLOCK_THROTTLE_LEVELS
+} ClockThrottle_Level_t;
+
+typedef enum
+{
+	CLOCK_THROTTLE_OK = 0     ,
+	CLOCK_THROTTLE_ERR_LEVEL  ,  // Level not computed: the profile dividers are at the end of the range
+	CLOCK_THROTTLE_ERR_INIT   ,  // Clock_Throttle_Init() not called
+	CLOCK_THROTTLE_ERR_FULL      // No free notifier slot
+} ClockThrottle_Status_t;
+
+/* Called after every level change, with the new level in force */
+typedef void (*ClockThrottle_Notifier_t)(void);
+
+typedef struct
+{
+	uint32_t switch_ns  ;  // Worst Clock_Throttle_Set() register sequence, any two levels
+	uint32_t notify_ns  ;  // Worst time in the notifiers
+	uint32_t relock_ns  ;  // Clock_Profile_Apply() of the active profile, PLL1 relock
+} ClockThrottle_Bench_t;
+
+/************************ Function prototypes ***************************/
+ClockThrottle_Status_t Clock_Throttle_Init(void) ;
+ClockThrottle_Status_t Clock_Throttle_Set(ClockThrottle_Level_t level) ;
+ClockThrottle_Level_t  Clock_Throttle_Get(void) ;
+uint32_t               Clock_Throttle_Hz(ClockThrottle_Level_t level) ;
+ClockThrottle_Status_t Clock_Throttle_Register(ClockThrottle_Notifier_t notifier) ;
+void                   Clock_Throttle_Benchmark(uint32_t runs, ClockThrottle_Bench_t *result) ;
+
+#endif /* _CLOCK_THROTTLE_H_ */
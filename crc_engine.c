@@ -0,0 +1,428 @@
+/*
+ ******************************************************************************
+ * File              : crc_engine.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Hardware CRC unit fed by CPU or MDMA
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 19, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Chapter 21, Cyclic redundancy check (CRC)
+ *
+ * The CRC unit processes a 32-bit write to CRC_DR MSB first. Data in memory
+ * is little-endian, so every word is reordered before it is processed:
+ *   - reflected CRCs (refin = 1): REV_IN = 11, bit reversal by word,
+ *     the first byte in memory ends up first and LSB first;
+ *   - normal CRCs   (refin = 0): bytes are swapped, by __REV() on the CPU
+ *     path and by the MDMA byte/half-word exchange (BEX, HEX) on the DMA path.
+ * Unaligned head and tail bytes are written as single bytes.
+ *
+ * REV_OUT is never used: the data register stays in normal form so it can be
+ * reloaded into CRC_INIT by the next update of the same context. Output
+ * reflection and the final XOR are done in CRC_Engine_Final().
+ *
+ * The CRC unit sits on AHB4 in D3. It is fed by MDMA channel 0 in block
+ * mode with software request, one block is at most 64 Kbytes so larger
+ * buffers are streamed block after block from the MDMA interrupt.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "stm32h7xx.h"
+#include "crc_engine.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+// CRC_CR POLYSIZE[1:0], Reference Manual, Page 836: 00: 32, 01: 16, 10: 8, 11: 7 bits
+#define CRC_CR_POLYSIZE_BITS(w)     ( (uint32_t)(((w) == 32U) ? 0U : ((w) == 16U) ? 1U : ((w) == 8U) ? 2U : 3U) << CRC_CR_POLYSIZE_Pos )
+#define CRC_CR_REV_IN_BYTE          ( 1UL << CRC_CR_REV_IN_Pos )
+#define CRC_CR_REV_IN_WORD          ( 3UL << CRC_CR_REV_IN_Pos )
+
+// Largest MDMA block, BNDT[16:0] in bytes, kept a multiple of 4
+#define CRC_ENGINE_MDMA_BLOCK       ( 0xFFFCU )
+
+// MDMA_CxTCR fields, Reference Manual, Page 681
+#define MDMA_SIZE_WORD              ( 2UL )
+#define MDMA_TLEN_128               ( 127UL << MDMA_CTCR_TLEN_Pos )
+
+// DTCM and ITCM are reached by the MDMA AHBS bus, everything else by AXI
+#define IS_TCM_ADDRESS(a)           ( ((a) < 0x00010000UL) || (((a) >= 0x20000000UL) && ((a) < 0x20020000UL)) )
+
+/************************** Local Variables ****************************/
+
+static volatile uint8_t     Engine_Busy      ;
+static volatile uint8_t     Engine_Error     ;
+static CRC_Ctx_t           *Dma_Ctx          ;
+static const uint8_t       *Dma_Next         ;
+static uint32_t             Dma_Remaining    ;  // Word aligned bytes left for MDMA
+static uint32_t             Dma_Block        ;  // Bytes of the block in flight
+static const uint8_t       *Dma_Tail         ;
+static uint32_t             Dma_Tail_Length  ;
+static CRC_Done_Callback_t  Dma_Done         ;
+
+static uint32_t Width_Mask(uint8_t width)
+{
+	return (width >= 32U) ? 0xFFFFFFFFUL : ((1UL << width) - 1UL);
+}
+
+void CRC_Engine_Init(void)
+{
+	/* Step 1: Clock the CRC unit (AHB4) and the MDMA (AHB3)
+	 * Reference Manual, Page 450 and 448
+	 */
+	RCC->AHB4ENR |= RCC_AHB4ENR_CRCEN ;
+	RCC->AHB3ENR |= RCC_AHB3ENR_MDMAEN ;
+
+	/* Step 2: Reset state and enable the MDMA interrupt */
+	CRC->CR = CRC_CR_RESET ;
+	CRC_ENGINE_MDMA_CHANNEL->CCR &= ~ MDMA_CCR_EN ;
+
+	Engine_Busy  = 0U;
+	Engine_Error = 0U;
+
+	NVIC_SetPriority(MDMA_IRQn, 6U);
+	NVIC_EnableIRQ(MDMA_IRQn);
+}
+
+void CRC_Engine_Begin(CRC_Ctx_t *ctx, const CRC_Params_t *params)
+{
+	ctx->params = params;
+	ctx->state  = params->init & Width_Mask(params->width);
+}
+
+/* Load a context into the CRC unit, RESET copies CRC_INIT into CRC_DR */
+static void CRC_Load(const CRC_Ctx_t *ctx)
+{
+	CRC->POL  = ctx->params->poly ;
+	CRC->INIT = ctx->state ;
+	CRC->CR   = CRC_CR_POLYSIZE_BITS(ctx->params->width) |
+	            (ctx->params->refin ? CRC_CR_REV_IN_WORD : 0U) |
+	            CRC_CR_RESET ;
+}
+
+static void CRC_Save(CRC_Ctx_t *ctx)
+{
+	ctx->state = CRC->DR & Width_Mask(ctx->params->width);
+}
+
+/* Single bytes, REV_IN = 01 (by byte) for reflected CRCs */
+static void CRC_Write_Bytes(const CRC_Params_t *params, const uint8_t *data, uint32_t length)
+{
+	if (length == 0U)
+	{
+		return;
+	}
+	if (params->refin)
+	{
+		CRC->CR = (CRC->CR & ~ CRC_CR_REV_IN) | CRC_CR_REV_IN_BYTE ;
+	}
+	while (length--)
+	{
+		*(__IO uint8_t *)&CRC->DR = *data++;
+	}
+	if (params->refin)
+	{
+		CRC->CR = (CRC->CR & ~ CRC_CR_REV_IN) | CRC_CR_REV_IN_WORD ;
+	}
+}
+
+/* CPU path, whole words with the byte order fixed as described above */
+static void CRC_Write_CPU(const CRC_Params_t *params, const uint8_t *data, uint32_t length)
+{
+	uint32_t word;
+
+	while (length >= 4U)
+	{
+		memcpy(&word, data, 4U);
+		CRC->DR = params->refin ? word : __REV(word);
+		data   += 4U;
+		length -= 4U;
+	}
+	CRC_Write_Bytes(params, data, length);
+}
+
+static void CRC_Start_Block(void)
+{
+	MDMA_Channel_TypeDef *ch = CRC_ENGINE_MDMA_CHANNEL;
+	uint32_t              ctcr;
+
+	Dma_Block = (Dma_Remaining > CRC_ENGINE_MDMA_BLOCK) ? CRC_ENGINE_MDMA_BLOCK : Dma_Remaining;
+
+	/* Step 1: Channel disabled, all flags cleared */
+	ch->CCR  &= ~ MDMA_CCR_EN ;
+	ch->CIFCR = MDMA_CIFCR_CTEIF | MDMA_CIFCR_CCTCIF | MDMA_CIFCR_CBRTIF |
+	            MDMA_CIFCR_CBTIF | MDMA_CIFCR_CLTCIF ;
+
+	/* Step 2: Word reads with increment, word writes to the fixed CRC_DR,
+	 * one block per software request
+	 */
+	ctcr = MDMA_CTCR_SINC_1 |
+	       (MDMA_SIZE_WORD << MDMA_CTCR_SSIZE_Pos ) |
+	       (MDMA_SIZE_WORD << MDMA_CTCR_DSIZE_Pos ) |
+	       (MDMA_SIZE_WORD << MDMA_CTCR_SINCOS_Pos) |
+	       MDMA_TLEN_128 | MDMA_CTCR_TRGM_0 | MDMA_CTCR_SWRM ;
+
+	if (!Dma_Ctx->params->refin)
+	{
+		ctcr |= MDMA_CTCR_BEX | MDMA_CTCR_HEX ;  // b0 b1 b2 b3 -> b3 b2 b1 b0
+	}
+	ch->CTCR   = ctcr ;
+	ch->CBNDTR = Dma_Block ;
+	ch->CSAR   = (uint32_t)Dma_Next ;
+	ch->CDAR   = (uint32_t)&CRC->DR ;
+	ch->CBRUR  = 0U ;
+	ch->CLAR   = 0U ;
+	ch->CTBR   = IS_TCM_ADDRESS((uint32_t)Dma_Next) ? MDMA_CTBR_SBUS : 0U ;
+	ch->CMAR   = 0U ;
+	ch->CMDR   = 0U ;
+
+	/* Step 3: Interrupts on completion and error, enable, then request */
+	ch->CCR = MDMA_CCR_PL_1 | MDMA_CCR_CTCIE | MDMA_CCR_TEIE ;
+	ch->CCR |= MDMA_CCR_EN ;
+	ch->CCR |= MDMA_CCR_SWRQ ;
+}
+
+static void CRC_Finish_Async(void)
+{
+	CRC_Done_Callback_t done = Dma_Done;
+	CRC_Ctx_t          *ctx  = Dma_Ctx;
+
+	CRC_Write_Bytes(ctx->params, Dma_Tail, Dma_Tail_Length);
+	CRC_Save(ctx);
+
+	Dma_Ctx     = NULL;
+	Engine_Busy = 0U;
+
+	if (done != NULL)
+	{
+		done(ctx);
+	}
+}
+
+CRC_Engine_Status_t CRC_Engine_Update_Async(CRC_Ctx_t *ctx, const void *data, uint32_t length, CRC_Done_Callback_t done)
+{
+	const uint8_t *p = (const uint8_t *)data;
+	uint32_t       head;
+
+	if (Engine_Busy)
+	{
+		return CRC_ENGINE_BUSY;
+	}
+	Engine_Busy  = 1U;
+	Engine_Error = 0U;
+
+	CRC_Load(ctx);
+
+	/* Head bytes up to the first word boundary, the MDMA needs aligned words */
+	head = (4U - ((uint32_t)p & 3U)) & 3U;
+	if (head > length)
+	{
+		head = length;
+	}
+	CRC_Write_Bytes(ctx->params, p, head);
+	p      += head;
+	length -= head;
+
+	Dma_Ctx         = ctx;
+	Dma_Done        = done;
+	Dma_Next        = p;
+	Dma_Remaining   = length & ~ 3U;
+	Dma_Tail        = p + Dma_Remaining;
+	Dma_Tail_Length = length & 3U;
+
+	if (Dma_Remaining == 0U)
+	{
+		CRC_Finish_Async();
+		return CRC_ENGINE_OK;
+	}
+
+	/* The MDMA reads memory, not the D-cache */
+	SCB_CleanDCache_by_Addr((uint32_t *)((uint32_t)p & ~ 31U), (int32_t)(Dma_Remaining + 32U));
+
+	CRC_Start_Block();
+	return CRC_ENGINE_OK;
+}
+
+CRC_Engine_Status_t CRC_Engine_Update(CRC_Ctx_t *ctx, const void *data, uint32_t length)
+{
+	if (Engine_Busy)
+	{
+		return CRC_ENGINE_BUSY;
+	}
+
+	if (length < CRC_ENGINE_DMA_THRESHOLD)
+	{
+		CRC_Load(ctx);
+		CRC_Write_CPU(ctx->params, (const uint8_t *)data, length);
+		CRC_Save(ctx);
+		return CRC_ENGINE_OK;
+	}
+
+	(void)CRC_Engine_Update_Async(ctx, data, length, NULL);
+	while (Engine_Busy) {}
+
+	return Engine_Error ? CRC_ENGINE_ERROR : CRC_ENGINE_OK;
+}
+
+uint8_t CRC_Engine_Busy(void)
+{
+	return Engine_Busy;
+}
+
+uint32_t CRC_Engine_Final(const CRC_Ctx_t *ctx)
+{
+	uint32_t result = ctx->state;
+
+	if (ctx->params->refout)
+	{
+		result = CRC_Reflect(result, ctx->params->width);
+	}
+	return (result ^ ctx->params->xorout) & Width_Mask(ctx->params->width);
+}
+
+uint32_t CRC_Engine_Compute(const CRC_Params_t *params, const void *data, uint32_t length)
+{
+	CRC_Ctx_t ctx;
+
+	CRC_Engine_Begin(&ctx, params);
+	(void)CRC_Engine_Update(&ctx, data, length);
+	return CRC_Engine_Final(&ctx);
+}
+
+/* Called from MDMA_IRQHandler for channel 0 */
+void CRC_Engine_MDMA_IRQHandler(void)
+{
+	MDMA_Channel_TypeDef *ch = CRC_ENGINE_MDMA_CHANNEL;
+
+	if (ch->CISR & MDMA_CISR_TEIF)
+	{
+		ch->CIFCR    = MDMA_CIFCR_CTEIF ;
+		ch->CCR     &= ~ MDMA_CCR_EN ;
+		Engine_Error = 1U;
+		Dma_Remaining = 0U;
+		CRC_Finish_Async();
+		return;
+	}
+
+	if (ch->CISR & MDMA_CISR_CTCIF)
+	{
+		ch->CIFCR = MDMA_CIFCR_CCTCIF | MDMA_CIFCR_CBTIF | MDMA_CIFCR_CBRTIF | MDMA_CIFCR_CLTCIF ;
+
+		Dma_Next      += Dma_Block;
+		Dma_Remaining -= Dma_Block;
+
+		if (Dma_Remaining != 0U)
+		{
+			CRC_Start_Block();
+		}
+		else
+		{
+			CRC_Finish_Async();
+		}
+	}
+}
+
+/* Every preset on "123456789" by CPU and on a misaligned 1031-byte buffer
+ * by MDMA, checked against the catalogue value and the software reference.
+ * Returns the number of failures, 0 when the CRC unit is correct.
+ */
+uint32_t CRC_Engine_Self_Test(void)
+{
+	static CRC_Soft_t soft;
+	static uint8_t    pattern[1040];
+	uint32_t          failures = 0U;
+
+	for (uint32_t i = 0U; i < sizeof(pattern); i++)
+	{
+		pattern[i] = (uint8_t)((i * 131U) ^ (i >> 3));
+	}
+
+	for (uint32_t i = 0U; i < CRC_Preset_Count; i++)
+	{
+		const CRC_Params_t *params = CRC_Presets[i];
+
+		CRC_Soft_Init(&soft, params);
+
+		if (CRC_Engine_Compute(params, "123456789", 9U) != params->check)
+		{
+			failures++;
+		}
+		if (CRC_Soft_Compute(&soft, "123456789", 9U) != params->check)
+		{
+			failures++;
+		}
+		if (CRC_Engine_Compute(params, &pattern[1], 1031U) != CRC_Soft_Compute(&soft, &pattern[1], 1031U))
+		{
+			failures++;
+		}
+	}
+	return failures;
+}
+
+static uint32_t Kbytes_Per_Second(uint32_t length, uint32_t cycles)
+{
+	if (cycles == 0U)
+	{
+		return 0U;
+	}
+	return (uint32_t)(((uint64_t)length * SystemCoreClock) / ((uint64_t)cycles * 1024U));
+}
+
+/* Same buffer through the software table, the CPU-fed and the MDMA-fed CRC
+ * unit. Cycle_Counter_Init() and SystemCoreClockUpdate() must have been called.
+ */
+void CRC_Engine_Benchmark(const CRC_Params_t *params, const void *data, uint32_t length, CRC_Engine_Bench_t *bench)
+{
+	static CRC_Soft_t soft;
+	CRC_Ctx_t         ctx;
+	uint32_t          start;
+	uint32_t          r_soft, r_cpu, r_dma;
+
+	CRC_Soft_Init(&soft, params);
+	bench->length = length;
+
+	/* Step 1: Table-driven software CRC */
+	start = Cycle_Counter_Get();
+	r_soft = CRC_Soft_Compute(&soft, data, length);
+	bench->cycles_soft = Cycle_Counter_Get() - start;
+
+	/* Step 2: CRC unit written by the CPU */
+	start = Cycle_Counter_Get();
+	CRC_Engine_Begin(&ctx, params);
+	CRC_Load(&ctx);
+	CRC_Write_CPU(params, (const uint8_t *)data, length);
+	CRC_Save(&ctx);
+	r_cpu = CRC_Engine_Final(&ctx);
+	bench->cycles_hw_cpu = Cycle_Counter_Get() - start;
+
+	/* Step 3: CRC unit fed by MDMA, the CPU only waits here */
+	start = Cycle_Counter_Get();
+	CRC_Engine_Begin(&ctx, params);
+	(void)CRC_Engine_Update_Async(&ctx, data, length, NULL);
+	while (Engine_Busy) {}
+	r_dma = CRC_Engine_Final(&ctx);
+	bench->cycles_hw_dma = Cycle_Counter_Get() - start;
+
+	bench->kbps_soft   = Kbytes_Per_Second(length, bench->cycles_soft);
+	bench->kbps_hw_cpu = Kbytes_Per_Second(length, bench->cycles_hw_cpu);
+	bench->kbps_hw_dma = Kbytes_Per_Second(length, bench->cycles_hw_dma);
+	bench->match       = (r_soft == r_cpu) && (r_cpu == r_dma);
+}
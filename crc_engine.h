@@ -0,0 +1,86 @@
+/*
+ ******************************************************************************
+ * File              : crc_engine.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Hardware CRC unit fed by CPU or MDMA
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 19, 2026
+ ******************************************************************************/
+
+#ifndef _CRC_ENGINE_H_
+#define _CRC_ENGINE_H_
+
+#include "stm32h7xx.h"
+#include "crc_soft.h"
+
+/*************************** Macros ************************************/
+
+// Buffers shorter than this are written by the CPU, the MDMA set-up costs more
+#define CRC_ENGINE_DMA_THRESHOLD    ( 256U )
+
+// MDMA channel reserved for the CRC unit
+#define CRC_ENGINE_MDMA_CHANNEL     MDMA_Channel0
+
+/*************************** Types *************************************/
+
+/* An incremental context. Several contexts can be open at the same time,
+ * the CRC unit is reprogrammed from the context on every update.
+ * state has the same form as CRC_DR (normal, not reflected).
+ */
+typedef struct
+{
+	const CRC_Params_t *params ;
+	uint32_t            state  ;
+} CRC_Ctx_t;
+
+typedef void (*CRC_Done_Callback_t)(CRC_Ctx_t *ctx) ;
+
+typedef enum
+{
+	CRC_ENGINE_OK = 0  ,
+	CRC_ENGINE_BUSY    ,  // An MDMA stream is in progress
+	CRC_ENGINE_ERROR      // MDMA transfer error
+} CRC_Engine_Status_t;
+
+typedef struct
+{
+	uint32_t length          ;  // Bytes per run
+	uint32_t cycles_soft     ;  // Table-driven software CRC
+	uint32_t cycles_hw_cpu   ;  // CRC unit written by the CPU
+	uint32_t cycles_hw_dma   ;  // CRC unit fed by MDMA, start to completion
+	uint32_t kbps_soft       ;  // Kbytes per second
+	uint32_t kbps_hw_cpu     ;
+	uint32_t kbps_hw_dma     ;
+	uint8_t  match           ;  // 1: the three results are equal
+} CRC_Engine_Bench_t;
+
+/************************ Function prototypes ***************************/
+void                CRC_Engine_Init(void) ;
+void                CRC_Engine_Begin(CRC_Ctx_t *ctx, const CRC_Params_t *params) ;
+CRC_Engine_Status_t CRC_Engine_Update(CRC_Ctx_t *ctx, const void *data, uint32_t length) ;
+CRC_Engine_Status_t CRC_Engine_Update_Async(CRC_Ctx_t *ctx, const void *data, uint32_t length, CRC_Done_Callback_t done) ;
+uint8_t             CRC_Engine_Busy(void) ;
+uint32_t            CRC_Engine_Final(const CRC_Ctx_t *ctx) ;
+uint32_t            CRC_Engine_Compute(const CRC_Params_t *params, const void *data, uint32_t length) ;
+
+uint32_t            CRC_Engine_Self_Test(void) ;
+void                CRC_Engine_Benchmark(const CRC_Params_t *params, const void *data, uint32_t length, CRC_Engine_Bench_t *bench) ;
+
+void                CRC_Engine_MDMA_IRQHandler(void) ;
+
+#endif /* _CRC_ENGINE_H_ */
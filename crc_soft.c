@@ -0,0 +1,155 @@
+/*
+ ******************************************************************************
+ * File              : crc_soft.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Table-driven software CRC, reference for the CRC unit
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 19, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * One byte-wide table per parameter set (1 Kbyte). Reflected CRCs shift
+ * right with the reflected polynomial, normal CRCs are left aligned in the
+ * 32-bit register so that widths 7 and 8 use the same code as width 32.
+ *
+ * The state is always kept in the same form as the CRC unit data register
+ * (normal, not reflected), so a context can move between the software
+ * and the hardware path.
+ *
+ ******************************************************************************/
+
+#include "crc_soft.h"
+
+/************************** Presets ************************************/
+//                                        name            w  ri ro  poly         init         xorout       check
+const CRC_Params_t CRC_32        = { "CRC-32",        32, 1, 1, 0x04C11DB7UL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xCBF43926UL };
+const CRC_Params_t CRC_32C       = { "CRC-32C",       32, 1, 1, 0x1EDC6F41UL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xE3069283UL };
+const CRC_Params_t CRC_32_MPEG2  = { "CRC-32/MPEG-2", 32, 0, 0, 0x04C11DB7UL, 0xFFFFFFFFUL, 0x00000000UL, 0x0376E6E7UL };
+const CRC_Params_t CRC_16_CCITT  = { "CRC-16/CCITT",  16, 0, 0, 0x1021UL,     0xFFFFUL,     0x0000UL,     0x29B1UL     };
+const CRC_Params_t CRC_16_MODBUS = { "CRC-16/MODBUS", 16, 1, 1, 0x8005UL,     0xFFFFUL,     0x0000UL,     0x4B37UL     };
+const CRC_Params_t CRC_8_SMBUS   = { "CRC-8/SMBUS",    8, 0, 0, 0x07UL,       0x00UL,       0x00UL,       0xF4UL       };
+const CRC_Params_t CRC_7_MMC     = { "CRC-7/MMC",      7, 0, 0, 0x09UL,       0x00UL,       0x00UL,       0x75UL       };
+
+const CRC_Params_t *const CRC_Presets[] =
+{
+	&CRC_32, &CRC_32C, &CRC_32_MPEG2, &CRC_16_CCITT, &CRC_16_MODBUS, &CRC_8_SMBUS, &CRC_7_MMC
+};
+
+const uint32_t CRC_Preset_Count = sizeof(CRC_Presets) / sizeof(CRC_Presets[0]);
+
+static uint32_t Width_Mask(uint8_t width)
+{
+	return (width >= 32U) ? 0xFFFFFFFFUL : ((1UL << width) - 1UL);
+}
+
+uint32_t CRC_Reflect(uint32_t value, uint8_t width)
+{
+	uint32_t result = 0U;
+
+	for (uint8_t i = 0U; i < width; i++)
+	{
+		result = (result << 1) | (value & 1U);
+		value >>= 1;
+	}
+	return result;
+}
+
+void CRC_Soft_Init(CRC_Soft_t *crc, const CRC_Params_t *params)
+{
+	crc->params = params;
+
+	for (uint32_t i = 0U; i < 256U; i++)
+	{
+		uint32_t r;
+
+		if (params->refin)
+		{
+			uint32_t rpoly = CRC_Reflect(params->poly, params->width);
+
+			r = i;
+			for (uint32_t bit = 0U; bit < 8U; bit++)
+			{
+				r = (r >> 1) ^ (rpoly & (0U - (r & 1U)));
+			}
+		}
+		else
+		{
+			uint32_t apoly = params->poly << (32U - params->width);
+
+			r = i << 24;
+			for (uint32_t bit = 0U; bit < 8U; bit++)
+			{
+				r = (r << 1) ^ (apoly & (0U - (r >> 31)));
+			}
+		}
+		crc->table[i] = r;
+	}
+
+	CRC_Soft_Begin(crc);
+}
+
+void CRC_Soft_Begin(CRC_Soft_t *crc)
+{
+	crc->state = crc->params->init & Width_Mask(crc->params->width);
+}
+
+void CRC_Soft_Update(CRC_Soft_t *crc, const void *data, uint32_t length)
+{
+	const uint8_t      *p     = (const uint8_t *)data;
+	const CRC_Params_t *prm   = crc->params;
+	uint32_t            r;
+
+	if (prm->refin)
+	{
+		r = CRC_Reflect(crc->state, prm->width);
+		while (length--)
+		{
+			r = (r >> 8) ^ crc->table[(r ^ *p++) & 0xFFU];
+		}
+		crc->state = CRC_Reflect(r, prm->width);
+	}
+	else
+	{
+		r = crc->state << (32U - prm->width);
+		while (length--)
+		{
+			r = (r << 8) ^ crc->table[(r >> 24) ^ *p++];
+		}
+		crc->state = r >> (32U - prm->width);
+	}
+}
+
+uint32_t CRC_Soft_Final(const CRC_Soft_t *crc)
+{
+	const CRC_Params_t *prm    = crc->params;
+	uint32_t            result = crc->state;
+
+	if (prm->refout)
+	{
+		result = CRC_Reflect(result, prm->width);
+	}
+	return (result ^ prm->xorout) & Width_Mask(prm->width);
+}
+
+uint32_t CRC_Soft_Compute(CRC_Soft_t *crc, const void *data, uint32_t length)
+{
+	CRC_Soft_Begin(crc);
+	CRC_Soft_Update(crc, data, length);
+	return CRC_Soft_Final(crc);
+}
@@ -0,0 +1,78 @@
+/*
+ ******************************************************************************
+ * File              : crc_soft.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Table-driven software CRC, reference for the CRC unit
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 19, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * CRC parameters follow the Rocksoft model (width, poly, init, refin,
+ * refout, xorout). "check" is the CRC of the ASCII string "123456789".
+ * No register access: this file is also built into tools/crc_reference_tool.c.
+ *
+ ******************************************************************************/
+
+#ifndef _CRC_SOFT_H_
+#define _CRC_SOFT_H_
+
+#include <stdint.h>
+
+typedef struct
+{
+	const char *name   ;
+	uint8_t     width  ;  // 7, 8, 16 or 32, the sizes supported by the CRC unit
+	uint8_t     refin  ;  // 1: input bytes are processed LSB first
+	uint8_t     refout ;  // 1: result is bit reversed before xorout
+	uint32_t    poly   ;  // Normal (MSB first) form, must be odd for the CRC unit
+	uint32_t    init   ;
+	uint32_t    xorout ;
+	uint32_t    check  ;
+} CRC_Params_t;
+
+typedef struct
+{
+	const CRC_Params_t *params     ;
+	uint32_t            table[256] ;
+	uint32_t            state      ;
+} CRC_Soft_t;
+
+/************************** Presets ************************************/
+extern const CRC_Params_t CRC_32           ;  // IEEE 802.3, zlib, the profile blobs
+extern const CRC_Params_t CRC_32C          ;  // Castagnoli
+extern const CRC_Params_t CRC_32_MPEG2     ;
+extern const CRC_Params_t CRC_16_CCITT     ;  // CRC-16/IBM-3740 (CCITT-FALSE)
+extern const CRC_Params_t CRC_16_MODBUS    ;
+extern const CRC_Params_t CRC_8_SMBUS      ;
+extern const CRC_Params_t CRC_7_MMC        ;
+
+extern const CRC_Params_t *const CRC_Presets[] ;
+extern const uint32_t            CRC_Preset_Count ;
+
+/************************ Function prototypes ***************************/
+uint32_t CRC_Reflect(uint32_t value, uint8_t width) ;
+
+void     CRC_Soft_Init(CRC_Soft_t *crc, const CRC_Params_t *params) ;
+void     CRC_Soft_Begin(CRC_Soft_t *crc) ;
+void     CRC_Soft_Update(CRC_Soft_t *crc, const void *data, uint32_t length) ;
+uint32_t CRC_Soft_Final(const CRC_Soft_t *crc) ;
+uint32_t CRC_Soft_Compute(CRC_Soft_t *crc, const void *data, uint32_t length) ;
+
+#endif /* _CRC_SOFT_H_ */
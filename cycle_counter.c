@@ -0,0 +1,48 @@
+/*
+ ******************************************************************************
+ * File              : cycle_counter.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : DWT cycle counter for benchmarks
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 19, 2026
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "cycle_counter.h"
+
+// DWT software lock access register, ARMv7-M Architecture Reference Manual, D1.2
+#define DWT_LAR_UNLOCK_KEY          ( 0xC5ACCE55UL )
+
+void Cycle_Counter_Init(void)
+{
+	/* Step 1: Enable the DWT and ITM blocks (TRCENA in DEMCR) */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk ;
+
+	/* Step 2: The Cortex-M7 DWT is locked after reset, unlock it */
+	DWT->LAR = DWT_LAR_UNLOCK_KEY ;
+
+	/* Step 3: Clear and start the cycle counter */
+	DWT->CYCCNT = 0U ;
+	DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk ;
+}
+
+/* SystemCoreClock must be up to date (SystemCoreClockUpdate) */
+uint32_t Cycle_Counter_To_Ns(uint32_t cycles)
+{
+	return (uint32_t)(((uint64_t)cycles * 1000000000ULL) / SystemCoreClock);
+}
@@ -0,0 +1,42 @@
+/*
+ ******************************************************************************
+ * File              : cycle_counter.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : DWT cycle counter for benchmarks
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 19, 2026
+ ******************************************************************************/
+
+#ifndef _CYCLE_COUNTER_H_
+#define _CYCLE_COUNTER_H_
+
+#include "stm32h7xx.h"
+
+void     Cycle_Counter_Init(void) ;
+uint32_t Cycle_Counter_To_Ns(uint32_t cycles) ;
+
+/* CYCCNT counts sys_d1cpre_ck cycles and wraps after 2^32 cycles
+ * (about 8.9 s at 480 MHz). A difference of two readings is correct
+ * across one wrap thanks to unsigned arithmetic.
+ */
+__STATIC_INLINE uint32_t Cycle_Counter_Get(void)
+{
+	return DWT->CYCCNT;
+}
+
+#endif /* _CYCLE_COUNTER_H_ */
@@ -0,0 +1,428 @@
+/*
+ ******************************************************************************
+ * File              : dfsdm_mic.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : DFSDM1 PDM microphone front-end with DMA buffering
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 25, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Chapter 30, Digital filter for sigma delta
+ * modulators (DFSDM)
+ *
+ * CKOUT = source / CKOUTDIV, CKOUTDIV 2..256, Reference Manual, Page 1140
+ *   source: Dfsdm1_ker_ck (DFSDM1SEL: rcc_pclk2 or sys_ck) or the audio
+ *           clock Dfsdm1_aclk, which is the SAI1 kernel clock (CKOUTSRC)
+ *
+ * PCM rate = CKOUT / (FOSR x IOSR). For every decimation that keeps CKOUT
+ * in the microphone range, Kernel_Clock_Plan() gives the closest CKOUT from
+ * the running clocks; the exact one with the largest decimation wins. With
+ * the SAI running at 48 kHz, 49.152 MHz / 16 = 3.072 MHz = 48 kHz x 64.
+ *
+ * Sinc order: the highest that keeps FOSR^order x IOSR in 32 bits, sinc5 up
+ * to FOSR 73, sinc4 up to 215, sinc3 above. The integrator takes the rest
+ * of the decimation above 215. DTRBS shifts the result down to 24 bits.
+ *
+ * Two microphones per data line, one on each CKOUT edge:
+ *   mic 0: channel 1, DATIN1 rising     mic 1: channel 0, DATIN1 falling
+ *   mic 2: channel 3, DATIN3 rising     mic 3: channel 2, DATIN3 falling
+ * Filter m converts mic m, filters 1..3 start with filter 0 (RSYNC), and
+ * DMA1 stream 2 + m moves its data to a ping-pong buffer.
+ *
+ * Pins, AF3: PD3 CKOUT, PC3 DATIN1, PC7 DATIN3. Check the schematic.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "dfsdm_mic.h"
+#include "cycle_counter.h"
+#include "dma_alloc.h"
+
+/*************************** Macros ************************************/
+
+#define DFSDM_KERNEL_CLOCK_MAX_HZ   ( 480000000UL )
+#define DFSDM_DMAREQ_FLT0           ( 101U )   // dfsdm1_dma0, Reference Manual, Page 695
+#define DFSDM_AF                    ( 3U )
+
+/************************** Local Variables ****************************/
+
+static DFSDM_Channel_TypeDef * const Channels[DFSDM_MIC_MAX] =
+{
+	DFSDM1_Channel1, DFSDM1_Channel0, DFSDM1_Channel3, DFSDM1_Channel2
+};
+
+static DFSDM_Filter_TypeDef * const Filters[DFSDM_MIC_MAX] =
+{
+	DFSDM1_Filter0, DFSDM1_Filter1, DFSDM1_Filter2, DFSDM1_Filter3
+};
+
+static DMA_Stream_TypeDef * const Streams[DFSDM_MIC_MAX] =
+{
+	DMA1_Stream2, DMA1_Stream3, DMA1_Stream4, DMA1_Stream5
+};
+
+static const DMA_Alloc_Request_t Requests[DFSDM_MIC_MAX] =
+{
+	{ "dfsdm1_flt0", 1U, DFSDM_DMAREQ_FLT0 + 0U, DMA_ALLOC_HIGH },
+	{ "dfsdm1_flt1", 1U, DFSDM_DMAREQ_FLT0 + 1U, DMA_ALLOC_HIGH },
+	{ "dfsdm1_flt2", 1U, DFSDM_DMAREQ_FLT0 + 2U, DMA_ALLOC_HIGH },
+	{ "dfsdm1_flt3", 1U, DFSDM_DMAREQ_FLT0 + 3U, DMA_ALLOC_HIGH }
+};
+
+// Channel number of each microphone, and flag offsets of streams 2..5 in LISR/HISR
+static const uint8_t Channel_Of[DFSDM_MIC_MAX]   = { 1U, 0U, 3U, 2U };
+static const uint8_t Flag_Offset[DFSDM_MIC_MAX]  = { 16U, 22U, 0U, 6U };
+
+static const IRQn_Type Stream_IRQ[DFSDM_MIC_MAX] =
+{
+	DMA1_Stream2_IRQn, DMA1_Stream3_IRQn, DMA1_Stream4_IRQn, DMA1_Stream5_IRQn
+};
+
+static const IRQn_Type Filter_IRQ[DFSDM_MIC_MAX] =
+{
+	DFSDM1_FLT0_IRQn, DFSDM1_FLT1_IRQn, DFSDM1_FLT2_IRQn, DFSDM1_FLT3_IRQn
+};
+
+static DFSDM_Mic_Config_t Config ;
+static DFSDM_Mic_Stats_t  Stats ;
+static int32_t           *Buf[DFSDM_MIC_MAX][2] ;
+
+static void DFSDM_Pins_Config(void)
+{
+	RCC->AHB4ENR |= RCC_AHB4ENR_GPIOCEN | RCC_AHB4ENR_GPIODEN ;
+
+	/* PD3 CKOUT */
+	GPIOD->MODER    = (GPIOD->MODER & ~ (3UL << 6)) | (2UL << 6) ;
+	GPIOD->OSPEEDR |= (2UL << 6) ;
+	GPIOD->AFR[0]   = (GPIOD->AFR[0] & ~ (0xFUL << 12)) | (DFSDM_AF << 12) ;
+
+	/* PC3 DATIN1, PC7 DATIN3 */
+	GPIOC->MODER    = (GPIOC->MODER & ~ ((3UL << 6) | (3UL << 14))) | (2UL << 6) | (2UL << 14) ;
+	GPIOC->AFR[0]   = (GPIOC->AFR[0] & ~ ((0xFUL << 12) | (0xFUL << 28))) |
+	                  (DFSDM_AF << 12) | (DFSDM_AF << 28) ;
+}
+
+/* DMA flags of stream 2 + mic */
+static uint32_t Dma_Flags(uint8_t mic)
+{
+	return ((mic < 2U) ? DMA1->LISR : DMA1->HISR) >> Flag_Offset[mic];
+}
+
+static void Dma_Clear(uint8_t mic, uint32_t flags)
+{
+	if (mic < 2U)
+	{
+		DMA1->LIFCR = flags << Flag_Offset[mic] ;
+	}
+	else
+	{
+		DMA1->HIFCR = flags << Flag_Offset[mic] ;
+	}
+}
+
+/* Bits needed for fosr^order x iosr, plus sign */
+static uint32_t Filter_Bits(uint32_t fosr, uint32_t order, uint32_t iosr)
+{
+	uint64_t max  = iosr;
+	uint32_t bits = 1U;
+
+	for (uint32_t i = 0U; i < order; i++)
+	{
+		max *= fosr;
+	}
+	while ((1ULL << (bits - 1U)) < max)
+	{
+		bits++;
+	}
+	return bits;
+}
+
+/* CKOUT and decimation for the PCM rate, see the comments on top */
+static uint8_t Plan_Clock(uint32_t pcm_rate)
+{
+	Kernel_Clock_Option_t options[3];
+	Kernel_Clock_Plan_t   plan;
+	uint32_t              count = 0U;
+	uint32_t              best  = UINT32_MAX;
+	uint32_t              sai   = (RCC->D2CCIP1R & RCC_D2CCIP1R_SAI1SEL) >> RCC_D2CCIP1R_SAI1SEL_Pos;
+
+	/* sel 0, 1: DFSDM1SEL with CKOUTSRC = 0, sel 2: audio clock, CKOUTSRC = 1 */
+	options[count++] = (Kernel_Clock_Option_t){ KERNEL_CLOCK_PCLK2, 0U };
+	options[count++] = (Kernel_Clock_Option_t){ KERNEL_CLOCK_SYS  , 1U };
+	if (sai <= 2U)
+	{
+		static const Kernel_Clock_t Sai_Clock[3] = { KERNEL_CLOCK_PLL1_Q, KERNEL_CLOCK_PLL2_P, KERNEL_CLOCK_PLL3_P };
+
+		options[count++] = (Kernel_Clock_Option_t){ Sai_Clock[sai], 2U };
+	}
+
+	for (uint32_t d = DFSDM_CKOUT_MAX_HZ / pcm_rate; (d >= 16U) && ((d * pcm_rate) >= DFSDM_CKOUT_MIN_HZ); d--)
+	{
+		uint32_t err;
+
+		if (!Kernel_Clock_Plan(options, count, DFSDM_KERNEL_CLOCK_MAX_HZ, d * pcm_rate, 2U, 256U, &plan))
+		{
+			continue;
+		}
+		err = (uint32_t)((plan.error_ppm < 0) ? -plan.error_ppm : plan.error_ppm);
+		if (err < best)
+		{
+			best        = err;
+			Stats.ckout = plan;
+			Stats.iosr  = 1U;
+			Stats.fosr  = (uint16_t)d;
+
+			/* Integrator above 215 so sinc4 fits in 32 bits */
+			for (uint32_t i = 2U; (Stats.fosr > 215U) && (i <= 4U); i++)
+			{
+				if ((d % i) == 0U)
+				{
+					Stats.iosr = (uint8_t)i;
+					Stats.fosr = (uint16_t)(d / i);
+				}
+			}
+		}
+		if (best == 0U)
+		{
+			break;
+		}
+	}
+	if (best == UINT32_MAX)
+	{
+		return 0U;
+	}
+
+	/* Order from FOSR alone, then lower while the integrator overflows 32 bits */
+	Stats.order    = (Stats.fosr <= 73U) ? 5U : (Stats.fosr <= 215U) ? 4U : 3U;
+	while ((Stats.order > 1U) && (Filter_Bits(Stats.fosr, Stats.order, Stats.iosr) > 31U))
+	{
+		Stats.order--;
+	}
+	Stats.shift    = (uint8_t)((Filter_Bits(Stats.fosr, Stats.order, Stats.iosr) > 24U) ?
+	                           (Filter_Bits(Stats.fosr, Stats.order, Stats.iosr) - 24U) : 0U);
+	Stats.pcm_rate = Stats.ckout.out_hz / ((uint32_t)Stats.fosr * Stats.iosr);
+	return 1U;
+}
+
+DFSDM_Mic_Status_t DFSDM_Mic_Init(const DFSDM_Mic_Config_t *config)
+{
+	if ((config->mics == 0U) || (config->mics > DFSDM_MIC_MAX) || (config->pcm_rate == 0U) ||
+	    (config->frames == 0U) || ((config->frames & 7U) != 0U) ||
+	    ((8UL * config->frames * config->mics) > DFSDM_MIC_BUFFER_SIZE) ||
+	    !Plan_Clock(config->pcm_rate))
+	{
+		return DFSDM_MIC_ERROR;
+	}
+	for (uint32_t m = 0U; m < config->mics; m++)
+	{
+		if (DMA_Alloc_Reserve(DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 2U + m), &Requests[m]) != DMA_ALLOC_OK)
+		{
+			while (m-- > 0U)
+			{
+				DMA_Alloc_Release(DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 2U + m));
+			}
+			return DFSDM_MIC_ERROR;
+		}
+	}
+	Config = *config;
+
+	for (uint32_t m = 0U; m < Config.mics; m++)
+	{
+		Buf[m][0] = (int32_t *)DFSDM_MIC_BUFFER_BASE + (2U * m) * Config.frames;
+		Buf[m][1] = Buf[m][0] + Config.frames;
+	}
+
+	/* Step 1: Bus clocks and pins, DFSDM1 on APB2, Reference Manual, Page 464 */
+	RCC->APB2ENR |= RCC_APB2ENR_DFSDM1EN ;
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN ;
+	DFSDM_Pins_Config();
+
+	/* Step 2: Kernel clock, DFSDM1SEL in RCC_D2CCIP1R, Reference Manual, Page 409 */
+	RCC->D2CCIP1R = (RCC->D2CCIP1R & ~ RCC_D2CCIP1R_DFSDM1SEL) |
+	                ((Stats.ckout.sel == 1U) ? RCC_D2CCIP1R_DFSDM1SEL : 0U) ;
+
+	/* Step 3: CKOUT in channel 0, DFSDM disabled, Reference Manual, Page 1175 */
+	DFSDM1_Channel0->CHCFGR1 &= ~ DFSDM_CHCFGR1_DFSDMEN ;
+	DFSDM1_Channel0->CHCFGR1  = (DFSDM1_Channel0->CHCFGR1 & ~ (DFSDM_CHCFGR1_CKOUTSRC | DFSDM_CHCFGR1_CKOUTDIV)) |
+	                            ((Stats.ckout.sel == 2U) ? DFSDM_CHCFGR1_CKOUTSRC : 0U) |
+	                            ((Stats.ckout.divider - 1U) << DFSDM_CHCFGR1_CKOUTDIV_Pos) ;
+
+	/* Step 4: Channels, SPI with the internal CKOUT (SPICKSEL = 01), rising
+	 * edge on the odd channel, falling edge on the even channel that takes
+	 * the pins of the next channel (CHINSEL)
+	 */
+	for (uint32_t m = 0U; m < Config.mics; m++)
+	{
+		DFSDM_Channel_TypeDef *ch = Channels[m];
+
+		ch->CHCFGR1 = (ch->CHCFGR1 & (DFSDM_CHCFGR1_DFSDMEN | DFSDM_CHCFGR1_CKOUTSRC | DFSDM_CHCFGR1_CKOUTDIV)) |
+		              (1UL << DFSDM_CHCFGR1_SPICKSEL_Pos) |
+		              ((Channel_Of[m] & 1U) ? 0U : (DFSDM_CHCFGR1_CHINSEL | (1UL << DFSDM_CHCFGR1_SITP_Pos))) ;
+		ch->CHCFGR2 = (uint32_t)Stats.shift << DFSDM_CHCFGR2_DTRBS_Pos ;
+	}
+
+	/* Step 5: Filters, continuous regular conversion with DMA, Reference Manual, Page 1184 */
+	for (uint32_t m = 0U; m < Config.mics; m++)
+	{
+		DFSDM_Filter_TypeDef *flt = Filters[m];
+
+		flt->FLTCR1  = 0U ;
+		flt->FLTFCR  = ((uint32_t)Stats.order << DFSDM_FLTFCR_FORD_Pos) |
+		               ((Stats.fosr - 1UL)    << DFSDM_FLTFCR_FOSR_Pos) |
+		               ((Stats.iosr - 1UL)    << DFSDM_FLTFCR_IOSR_Pos) ;
+		flt->FLTCR1  = ((uint32_t)Channel_Of[m] << DFSDM_FLTCR1_RCH_Pos) | DFSDM_FLTCR1_RCONT |
+		               DFSDM_FLTCR1_FAST | DFSDM_FLTCR1_RDMAEN | ((m != 0U) ? DFSDM_FLTCR1_RSYNC : 0U) ;
+		flt->FLTCR2  = DFSDM_FLTCR2_ROVRIE ;
+		flt->FLTICR  = DFSDM_FLTICR_CLRROVRF ;
+	}
+
+	/* Step 6: DMA1 stream 2 + m, 32-bit RDATAR to the ping-pong buffers.
+	 * Only the last microphone interrupts on completion, its filter ends last.
+	 */
+	for (uint32_t m = 0U; m < Config.mics; m++)
+	{
+		DMA_Stream_TypeDef *s = Streams[m];
+
+		s->CR &= ~ DMA_SxCR_EN ;
+		while( s->CR & DMA_SxCR_EN ) {}
+		Dma_Clear((uint8_t)m, 0x3DU);
+
+		s->PAR  = (uint32_t)&Filters[m]->FLTRDATAR ;
+		s->M0AR = (uint32_t)Buf[m][0] ;
+		s->M1AR = (uint32_t)Buf[m][1] ;
+		s->NDTR = Config.frames ;
+		s->FCR  = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH_0 ;
+		s->CR   = DMA_SxCR_DBM | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC |
+		          DMA_SxCR_TEIE | DMA_SxCR_DMEIE | ((m == (Config.mics - 1U)) ? DMA_SxCR_TCIE : 0U) ;
+		s->CR  |= DMA_SxCR_EN ;
+
+		NVIC_SetPriority(Stream_IRQ[m], 3U);
+		NVIC_EnableIRQ(Stream_IRQ[m]);
+		NVIC_SetPriority(Filter_IRQ[m], 4U);
+		NVIC_EnableIRQ(Filter_IRQ[m]);
+	}
+
+	/* Step 7: Enable filters, channels and the interface, then start filter 0,
+	 * the others follow it (RSYNC)
+	 */
+	for (uint32_t m = 0U; m < Config.mics; m++)
+	{
+		Filters[m]->FLTCR1  |= DFSDM_FLTCR1_DFEN ;
+		Channels[m]->CHCFGR1 |= DFSDM_CHCFGR1_CHEN ;
+	}
+	DFSDM1_Channel0->CHCFGR1 |= DFSDM_CHCFGR1_DFSDMEN ;
+	DFSDM1_Filter0->FLTCR1   |= DFSDM_FLTCR1_RSWSTART ;
+
+	return DFSDM_MIC_OK;
+}
+
+void DFSDM_Mic_Stop(void)
+{
+	DFSDM1_Channel0->CHCFGR1 &= ~ DFSDM_CHCFGR1_DFSDMEN ;
+
+	for (uint32_t m = 0U; m < Config.mics; m++)
+	{
+		Filters[m]->FLTCR1 &= ~ DFSDM_FLTCR1_DFEN ;
+		Streams[m]->CR     &= ~ DMA_SxCR_EN ;
+		NVIC_DisableIRQ(Stream_IRQ[m]);
+		NVIC_DisableIRQ(Filter_IRQ[m]);
+	}
+}
+
+void DFSDM_Mic_Get_Stats(DFSDM_Mic_Stats_t *stats)
+{
+	*stats = Stats;
+}
+
+/* Last microphone buffer k complete: all microphones have buffer k */
+static void Process_Buffer(uint32_t k)
+{
+	const int32_t *mic[DFSDM_MIC_MAX];
+	uint32_t       start = Cycle_Counter_Get();
+	uint32_t       cycles, period;
+
+	for (uint32_t m = 0U; m < Config.mics; m++)
+	{
+		int32_t *p = Buf[m][k];
+
+		/* Other streams must also be on buffer 1-k now */
+		if (((Streams[m]->CR & DMA_SxCR_CT) ? 0U : 1U) != k)
+		{
+			Stats.skew++;
+		}
+
+		/* RDATAR: data in [31:8], channel in [2:0] */
+		SCB_InvalidateDCache_by_Addr((uint32_t *)p, (int32_t)(4U * Config.frames));
+		DMA_Alloc_Account(DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 2U + m), 4U * Config.frames);
+		for (uint32_t i = 0U; i < Config.frames; i++)
+		{
+			p[i] = p[i] >> 8;
+		}
+
+		/* Shifted in place: cleaned now, so no dirty line is evicted over
+		 * the next DMA transfer into this buffer
+		 */
+		SCB_CleanDCache_by_Addr((uint32_t *)p, (int32_t)(4U * Config.frames));
+		mic[m] = p;
+	}
+
+	if (Config.process != 0)
+	{
+		Config.process(mic, Config.mics, Config.frames);
+	}
+
+	cycles = Cycle_Counter_Get() - start;
+	period = (uint32_t)(((uint64_t)SystemCoreClock * Config.frames) / Stats.pcm_rate);
+	Stats.cycles_per_sample = cycles / ((uint32_t)Config.frames * Config.mics);
+	Stats.cpu_load_permille = (period == 0U) ? 0U : (uint32_t)(((uint64_t)cycles * 1000U) / period);
+	Stats.buffers++;
+}
+
+void DFSDM_Mic_DMA_IRQHandler(uint8_t mic)
+{
+	uint32_t flags = Dma_Flags(mic);
+
+	if (flags & (DMA_LISR_TEIF0 | DMA_LISR_DMEIF0))
+	{
+		Dma_Clear(mic, DMA_LIFCR_CTEIF0 | DMA_LIFCR_CDMEIF0);
+		Stats.dma_errors++;
+	}
+
+	if (flags & DMA_LISR_TCIF0)
+	{
+		Dma_Clear(mic, DMA_LIFCR_CTCIF0);
+		Process_Buffer((Streams[mic]->CR & DMA_SxCR_CT) ? 0U : 1U);
+	}
+}
+
+/* Regular data overrun, DMA too slow, Reference Manual, Page 1166.
+ * Shared by the interrupts of the four filters
+ */
+void DFSDM_Mic_IRQHandler(void)
+{
+	for (uint32_t m = 0U; m < Config.mics; m++)
+	{
+		if (Filters[m]->FLTISR & DFSDM_FLTISR_ROVRF)
+		{
+			Filters[m]->FLTICR = DFSDM_FLTICR_CLRROVRF ;
+			Stats.overruns++;
+		}
+	}
+}
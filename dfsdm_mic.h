@@ -0,0 +1,92 @@
+/*
+ ******************************************************************************
+ * File              : dfsdm_mic.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : DFSDM1 PDM microphone front-end with DMA buffering
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 25, 2026
+ ******************************************************************************/
+
+#ifndef _DFSDM_MIC_H_
+#define _DFSDM_MIC_H_
+
+#include "stm32h7xx.h"
+#include "kernel_clock.h"
+
+/*************************** Macros ************************************/
+
+#define DFSDM_MIC_MAX               ( 4U )
+
+/* Ping and pong buffer of every microphone in D3 SRAM4, reachable by DMA1.
+ * AXI SRAM holds the framebuffers, D2 SRAM1..3 the JPEG and SAI buffers.
+ */
+#define DFSDM_MIC_BUFFER_BASE       ( 0x38000000UL )
+#define DFSDM_MIC_BUFFER_SIZE       ( 0x00004000UL )
+
+// PDM microphone clock range, typical digital MEMS microphone data sheet
+#define DFSDM_CKOUT_MIN_HZ          ( 1000000UL )
+#define DFSDM_CKOUT_MAX_HZ          ( 3250000UL )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	DFSDM_MIC_OK = 0 ,
+	DFSDM_MIC_ERROR     // No CKOUT for this PCM rate, buffers too large
+} DFSDM_Mic_Status_t;
+
+/* Beamforming stage, called from the DMA interrupt once per buffer with one
+ * array of frames signed 24-bit samples per microphone. All microphones are
+ * sampled on the same CKOUT edges and their filters start together, so
+ * mic[m][i] are simultaneous samples.
+ */
+typedef void (*DFSDM_Mic_Process_t)(const int32_t *const *mic, uint8_t mics, uint32_t frames) ;
+
+typedef struct
+{
+	uint32_t            pcm_rate ;  // 8000..48000 Hz
+	uint8_t             mics     ;  // 1..4, pairs on DATIN1 and DATIN3
+	uint16_t            frames   ;  // Samples per microphone per buffer, multiple of 8
+	DFSDM_Mic_Process_t process  ;
+} DFSDM_Mic_Config_t;
+
+typedef struct
+{
+	Kernel_Clock_Plan_t ckout             ;  // CKOUT source, divider, rate and error
+	uint32_t            pcm_rate          ;  // Achieved, CKOUT / (fosr x iosr)
+	uint16_t            fosr              ;  // Sinc filter oversampling
+	uint8_t             order             ;  // Sinc order 3..5
+	uint8_t             iosr              ;  // Integrator oversampling
+	uint8_t             shift             ;  // Right shift to 24 bits
+	uint32_t            buffers           ;
+	uint32_t            overruns          ;  // Regular data overrun, any filter
+	uint32_t            dma_errors        ;
+	uint32_t            skew              ;  // Buffers where the filters were not aligned
+	uint32_t            cycles_per_sample ;  // Conversion and process, per microphone sample
+	uint32_t            cpu_load_permille ;
+} DFSDM_Mic_Stats_t;
+
+/************************ Function prototypes ***************************/
+DFSDM_Mic_Status_t DFSDM_Mic_Init(const DFSDM_Mic_Config_t *config) ;
+void               DFSDM_Mic_Stop(void) ;
+void               DFSDM_Mic_Get_Stats(DFSDM_Mic_Stats_t *stats) ;
+
+void               DFSDM_Mic_IRQHandler(void) ;
+void               DFSDM_Mic_DMA_IRQHandler(uint8_t mic) ;
+
+#endif /* _DFSDM_MIC_H_ */
@@ -0,0 +1,188 @@
+/*
+ ******************************************************************************
+ * File              : dma_alloc.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : DMA1/DMA2/BDMA stream allocator with DMAMUX routing
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 29, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Register side of the allocation table (dma_alloc_table.c). A driver either
+ * reserves the stream it was written for (DMA_Alloc_Reserve) or asks for any
+ * stream of a priority class (DMA_Alloc_Request). Both route the request
+ * through the DMAMUX channel of the stream and clock the controller:
+ *
+ *   DMA1 stream s   DMAMUX1 channel s        Reference Manual, Page 690
+ *   DMA2 stream s   DMAMUX1 channel 8 + s
+ *   BDMA channel s  DMAMUX2 channel s        (D3 memories only)
+ *
+ * Two drivers on the same stream are reported at init instead of
+ * overwriting each other's registers. Streams given at boot:
+ *
+ *   DMA1 S0/S1  SAI1 A/B     DMA1 S2..S5  DFSDM1 filters 0..3
+ *   DMA2 S0     GPIO wave    DMA2 S1      HRTIM burst DMA
+ *   DMA2 S2..S5 TIM5 input capture
+ *
+ * The owners call DMA_Alloc_Account() from their transfer complete
+ * interrupt, DMA_Alloc_Get_Contention() then gives the bytes per stream and
+ * controller and how many streams win the arbitration against each one.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "dma_alloc.h"
+#include "fpu_policy.h"
+
+/************************** Local Variables ****************************/
+
+static DMA_Alloc_Table_t Table ;
+
+static const IRQn_Type Stream_IRQ[DMA_ALLOC_CONTROLLERS][DMA_ALLOC_STREAMS] =
+{
+	{ DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+	  DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn },
+	{ DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+	  DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn },
+	{ BDMA_Channel0_IRQn, BDMA_Channel1_IRQn, BDMA_Channel2_IRQn, BDMA_Channel3_IRQn,
+	  BDMA_Channel4_IRQn, BDMA_Channel5_IRQn, BDMA_Channel6_IRQn, BDMA_Channel7_IRQn }
+};
+
+/* DMAMUX channel and controller clock of a reserved stream */
+static void Route(uint8_t handle, const DMA_Alloc_Request_t *req)
+{
+	switch (DMA_ALLOC_CONTROLLER(handle))
+	{
+		case DMA_ALLOC_DMA1: RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN ; break;
+		case DMA_ALLOC_DMA2: RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN ; break;
+		default:             RCC->AHB4ENR |= RCC_AHB4ENR_BDMAEN ; break;
+	}
+	DMA_Alloc_Mux(handle)->CCR = req->request ;
+}
+
+DMA_Alloc_Status_t DMA_Alloc_Reserve(uint8_t handle, const DMA_Alloc_Request_t *req)
+{
+	uint32_t primask = __get_PRIMASK();
+	DMA_Alloc_Status_t status;
+
+	__disable_irq();
+	status = DMA_Alloc_Table_Reserve(&Table, handle, req);
+	__set_PRIMASK(primask);
+
+	if (status == DMA_ALLOC_OK)
+	{
+		Route(handle, req);
+	}
+	return status;
+}
+
+DMA_Alloc_Status_t DMA_Alloc_Request(const DMA_Alloc_Request_t *req, uint8_t *handle)
+{
+	uint32_t primask = __get_PRIMASK();
+	DMA_Alloc_Status_t status;
+
+	__disable_irq();
+	status = DMA_Alloc_Table_Allocate(&Table, req, handle);
+	__set_PRIMASK(primask);
+
+	if (status == DMA_ALLOC_OK)
+	{
+		Route(*handle, req);
+	}
+	return status;
+}
+
+/* Stops the stream and disconnects its request */
+void DMA_Alloc_Release(uint8_t handle)
+{
+	uint32_t primask;
+
+	if (handle >= DMA_ALLOC_CONTROLLERS * DMA_ALLOC_STREAMS)
+	{
+		return;
+	}
+	if (DMA_ALLOC_CONTROLLER(handle) == DMA_ALLOC_BDMA)
+	{
+		DMA_Alloc_BDMA_Channel(handle)->CCR &= ~ BDMA_CCR_EN ;
+	}
+	else
+	{
+		DMA_Stream_TypeDef *s = DMA_Alloc_Stream(handle);
+
+		s->CR &= ~ DMA_SxCR_EN ;
+		while( s->CR & DMA_SxCR_EN ) {}
+	}
+	DMA_Alloc_Mux(handle)->CCR = 0U ;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	DMA_Alloc_Table_Release(&Table, handle);
+	__set_PRIMASK(primask);
+}
+
+/* Called by the owner only, usually from its transfer complete interrupt */
+FPU_FREE_ISR void DMA_Alloc_Account(uint8_t handle, uint32_t bytes)
+{
+	DMA_Alloc_Table_Account(&Table, handle, bytes);
+}
+
+/* Streams are 0x18 apart from DMAx_Stream0, Reference Manual, Page 669 */
+DMA_Stream_TypeDef *DMA_Alloc_Stream(uint8_t handle)
+{
+	switch (DMA_ALLOC_CONTROLLER(handle))
+	{
+		case DMA_ALLOC_DMA1: return (DMA_Stream_TypeDef *)(DMA1_Stream0_BASE + 0x18UL * DMA_ALLOC_STREAM(handle));
+		case DMA_ALLOC_DMA2: return (DMA_Stream_TypeDef *)(DMA2_Stream0_BASE + 0x18UL * DMA_ALLOC_STREAM(handle));
+		default:             return 0;
+	}
+}
+
+/* Channels are 0x14 apart from BDMA_Channel0, Reference Manual, Page 721 */
+BDMA_Channel_TypeDef *DMA_Alloc_BDMA_Channel(uint8_t handle)
+{
+	if (DMA_ALLOC_CONTROLLER(handle) != DMA_ALLOC_BDMA)
+	{
+		return 0;
+	}
+	return (BDMA_Channel_TypeDef *)(BDMA_Channel0_BASE + 0x14UL * DMA_ALLOC_STREAM(handle));
+}
+
+DMAMUX_Channel_TypeDef *DMA_Alloc_Mux(uint8_t handle)
+{
+	if (DMA_ALLOC_CONTROLLER(handle) == DMA_ALLOC_BDMA)
+	{
+		return DMAMUX2_Channel0 + DMA_ALLOC_STREAM(handle);
+	}
+	return DMAMUX1_Channel0 + handle;
+}
+
+IRQn_Type DMA_Alloc_IRQn(uint8_t handle)
+{
+	return Stream_IRQ[DMA_ALLOC_CONTROLLER(handle) % DMA_ALLOC_CONTROLLERS][DMA_ALLOC_STREAM(handle)];
+}
+
+void DMA_Alloc_Get_Contention(DMA_Alloc_Contention_t *out)
+{
+	DMA_Alloc_Table_Contention(&Table, out);
+}
+
+const DMA_Alloc_Table_t *DMA_Alloc_Get_Table(void)
+{
+	return &Table;
+}
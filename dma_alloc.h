@@ -0,0 +1,45 @@
+/*
+ ******************************************************************************
+ * File              : dma_alloc.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : DMA1/DMA2/BDMA stream allocator with DMAMUX routing
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 29, 2026
+ ******************************************************************************/
+
+#ifndef _DMA_ALLOC_H_
+#define _DMA_ALLOC_H_
+
+#include "stm32h7xx.h"
+#include "dma_alloc_table.h"
+
+/************************ Function prototypes ***************************/
+DMA_Alloc_Status_t       DMA_Alloc_Reserve(uint8_t handle, const DMA_Alloc_Request_t *req) ;
+DMA_Alloc_Status_t       DMA_Alloc_Request(const DMA_Alloc_Request_t *req, uint8_t *handle) ;
+void                     DMA_Alloc_Release(uint8_t handle) ;
+void                     DMA_Alloc_Account(uint8_t handle, uint32_t bytes) ;
+
+DMA_Stream_TypeDef      *DMA_Alloc_Stream(uint8_t handle) ;
+BDMA_Channel_TypeDef    *DMA_Alloc_BDMA_Channel(uint8_t handle) ;
+DMAMUX_Channel_TypeDef  *DMA_Alloc_Mux(uint8_t handle) ;
+IRQn_Type                DMA_Alloc_IRQn(uint8_t handle) ;
+
+void                     DMA_Alloc_Get_Contention(DMA_Alloc_Contention_t *out) ;
+const DMA_Alloc_Table_t *DMA_Alloc_Get_Table(void) ;
+
+#endif /* _DMA_ALLOC_H_ */
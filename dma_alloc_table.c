@@ -0,0 +1,248 @@
+/*
+ ******************************************************************************
+ * File              : dma_alloc_table.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : DMA stream allocation table, portable part
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 29, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * No register access in this file. It is compiled into the firmware and into
+ * tools/dma_alloc_tool.c, which checks the allocation rules on the host.
+ *
+ * DMA_Alloc_Table_Allocate() scores every free stream of the controllers
+ * behind the DMAMUX of the request, the lowest score wins:
+ *
+ *   1. streams that would win the arbitration against the new one
+ *   2. streams of the same class that the new one would overtake
+ *   3. position: HIGH and VERY_HIGH take the lowest free stream number,
+ *      LOW and MEDIUM the highest, so a later urgent request still finds a
+ *      stream that wins its ties
+ *   4. streams already active on the controller, DMA1 and DMA2 are filled
+ *      evenly
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "dma_alloc_table.h"
+
+static uint8_t Valid(const DMA_Alloc_Request_t *req)
+{
+	uint8_t max = (req->mux == 2U) ? DMA_ALLOC_DMAMUX2_MAX : DMA_ALLOC_DMAMUX1_MAX;
+
+	return ((req->mux == 1U) || (req->mux == 2U)) && (req->request != 0U) && (req->request <= max) &&
+	       (req->prio <= DMA_ALLOC_VERY_HIGH);
+}
+
+static uint8_t Active(const DMA_Alloc_Table_t *table, uint8_t c)
+{
+	uint8_t n = 0U;
+
+	for (uint8_t s = 0U; s < DMA_ALLOC_STREAMS; s++)
+	{
+		n += table->entry[c][s].used;
+	}
+	return n;
+}
+
+void DMA_Alloc_Table_Init(DMA_Alloc_Table_t *table)
+{
+	memset(table, 0, sizeof(*table));
+}
+
+/* Fixed stream chosen by the driver. Reserving again with the same request
+ * (the driver initialized twice) is not a conflict.
+ */
+DMA_Alloc_Status_t DMA_Alloc_Table_Reserve(DMA_Alloc_Table_t *table, uint8_t handle, const DMA_Alloc_Request_t *req)
+{
+	DMA_Alloc_Entry_t *e;
+	uint8_t            c = DMA_ALLOC_CONTROLLER(handle);
+
+	if ((handle >= DMA_ALLOC_CONTROLLERS * DMA_ALLOC_STREAMS) || !Valid(req) ||
+	    ((c == DMA_ALLOC_BDMA) != (req->mux == 2U)))
+	{
+		return DMA_ALLOC_ERR_PARAM;
+	}
+	e = &table->entry[c][DMA_ALLOC_STREAM(handle)];
+
+	if (e->used)
+	{
+		if ((e->req.mux == req->mux) && (e->req.request == req->request))
+		{
+			e->req = *req;
+			return DMA_ALLOC_OK;
+		}
+		table->failures++;
+		return DMA_ALLOC_ERR_BUSY;
+	}
+	memset(e, 0, sizeof(*e));
+	e->req  = *req;
+	e->used = 1U;
+	return DMA_ALLOC_OK;
+}
+
+/* Free stream with the lowest score, see the comments on top */
+DMA_Alloc_Status_t DMA_Alloc_Table_Allocate(DMA_Alloc_Table_t *table, const DMA_Alloc_Request_t *req, uint8_t *handle)
+{
+	uint8_t  first = (req->mux == 2U) ? DMA_ALLOC_BDMA : DMA_ALLOC_DMA1;
+	uint8_t  last  = (req->mux == 2U) ? DMA_ALLOC_BDMA : DMA_ALLOC_DMA2;
+	uint32_t best_score = UINT32_MAX;
+	uint8_t  best = DMA_ALLOC_NONE;
+
+	*handle = DMA_ALLOC_NONE;
+	if (!Valid(req))
+	{
+		return DMA_ALLOC_ERR_PARAM;
+	}
+
+	for (uint8_t c = first; c <= last; c++)
+	{
+		uint8_t active = Active(table, c);
+
+		for (uint8_t s = 0U; s < DMA_ALLOC_STREAMS; s++)
+		{
+			uint32_t behind = 0U, score;
+
+			if (table->entry[c][s].used)
+			{
+				continue;
+			}
+			for (uint8_t t = s + 1U; t < DMA_ALLOC_STREAMS; t++)
+			{
+				behind += (table->entry[c][t].used && (table->entry[c][t].req.prio == req->prio)) ? 1U : 0U;
+			}
+			score = DMA_Alloc_Table_Contenders(table, DMA_ALLOC_HANDLE(c, s), req->prio);
+			score = score * 8U + behind;
+			score = score * 8U + ((req->prio >= DMA_ALLOC_HIGH) ? s : (DMA_ALLOC_STREAMS - 1U - s));
+			score = score * 8U + active;
+
+			if (score < best_score)
+			{
+				best_score = score;
+				best       = DMA_ALLOC_HANDLE(c, s);
+			}
+		}
+	}
+
+	if (best == DMA_ALLOC_NONE)
+	{
+		table->failures++;
+		return DMA_ALLOC_ERR_FULL;
+	}
+	DMA_Alloc_Table_Reserve(table, best, req);
+	*handle = best;
+	return DMA_ALLOC_OK;
+}
+
+void DMA_Alloc_Table_Release(DMA_Alloc_Table_t *table, uint8_t handle)
+{
+	if (handle < DMA_ALLOC_CONTROLLERS * DMA_ALLOC_STREAMS)
+	{
+		memset(&table->entry[DMA_ALLOC_CONTROLLER(handle)][DMA_ALLOC_STREAM(handle)], 0, sizeof(DMA_Alloc_Entry_t));
+	}
+}
+
+void DMA_Alloc_Table_Account(DMA_Alloc_Table_t *table, uint8_t handle, uint32_t bytes)
+{
+	DMA_Alloc_Entry_t *e;
+
+	if (handle >= DMA_ALLOC_CONTROLLERS * DMA_ALLOC_STREAMS)
+	{
+		return;
+	}
+	e = &table->entry[DMA_ALLOC_CONTROLLER(handle)][DMA_ALLOC_STREAM(handle)];
+	if (e->used)
+	{
+		e->bytes += bytes;
+		e->transfers++;
+	}
+}
+
+/* Active streams that win the arbitration against a stream of class prio at
+ * handle: higher class, or same class and lower number
+ */
+uint8_t DMA_Alloc_Table_Contenders(const DMA_Alloc_Table_t *table, uint8_t handle, uint8_t prio)
+{
+	uint8_t c = DMA_ALLOC_CONTROLLER(handle);
+	uint8_t s = DMA_ALLOC_STREAM(handle);
+	uint8_t n = 0U;
+
+	for (uint8_t t = 0U; t < DMA_ALLOC_STREAMS; t++)
+	{
+		const DMA_Alloc_Entry_t *e = &table->entry[c][t];
+
+		if (e->used && (t != s) && ((e->req.prio > prio) || ((e->req.prio == prio) && (t < s))))
+		{
+			n++;
+		}
+	}
+	return n;
+}
+
+void DMA_Alloc_Table_Contention(const DMA_Alloc_Table_t *table, DMA_Alloc_Contention_t *out)
+{
+	uint32_t most_bytes = 0U;
+	uint8_t  most_contenders = 0U;
+
+	memset(out, 0, sizeof(*out));
+	out->worst    = DMA_ALLOC_NONE;
+	out->busiest  = DMA_ALLOC_NONE;
+	out->failures = table->failures;
+
+	for (uint8_t c = 0U; c < DMA_ALLOC_CONTROLLERS; c++)
+	{
+		for (uint8_t s = 0U; s < DMA_ALLOC_STREAMS; s++)
+		{
+			const DMA_Alloc_Entry_t *e = &table->entry[c][s];
+			uint8_t h = DMA_ALLOC_HANDLE(c, s);
+
+			if (!e->used)
+			{
+				continue;
+			}
+			out->active[c]++;
+			out->bytes[c]        += e->bytes;
+			out->contenders[c][s] = DMA_Alloc_Table_Contenders(table, h, e->req.prio);
+
+			if ((out->worst == DMA_ALLOC_NONE) || (out->contenders[c][s] > most_contenders))
+			{
+				out->worst      = h;
+				most_contenders = out->contenders[c][s];
+			}
+			if ((out->busiest == DMA_ALLOC_NONE) || (e->bytes > most_bytes))
+			{
+				out->busiest = h;
+				most_bytes   = e->bytes;
+			}
+		}
+	}
+}
+
+const char *DMA_Alloc_Status_Name(DMA_Alloc_Status_t status)
+{
+	switch (status)
+	{
+		case DMA_ALLOC_OK:        return "ok";
+		case DMA_ALLOC_ERR_PARAM: return "bad parameter";
+		case DMA_ALLOC_ERR_BUSY:  return "stream busy";
+		case DMA_ALLOC_ERR_FULL:  return "no free stream";
+		default:                  return "unknown";
+	}
+}
@@ -0,0 +1,128 @@
+/*
+ ******************************************************************************
+ * File              : dma_alloc_table.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : DMA stream allocation table, portable part
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 29, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * The table holds the owner, DMAMUX request, priority class and traffic of
+ * every stream of DMA1, DMA2 (requests routed by DMAMUX1) and every channel
+ * of the BDMA (DMAMUX2). It does not touch a register, so the allocation
+ * rules can be checked on the host with tools/dma_alloc_tool.c. The
+ * register side is in dma_alloc.c.
+ *
+ * A stream is named by a handle: controller x 8 + stream number.
+ *
+ ******************************************************************************/
+
+#ifndef _DMA_ALLOC_TABLE_H_
+#define _DMA_ALLOC_TABLE_H_
+
+#include <stdint.h>
+
+/*************************** Macros ************************************/
+
+#define DMA_ALLOC_CONTROLLERS       ( 3U )
+#define DMA_ALLOC_STREAMS           ( 8U )      // Streams (DMA1, DMA2) or channels (BDMA) per controller
+
+#define DMA_ALLOC_HANDLE(c, s)      ( (uint8_t)((c) * DMA_ALLOC_STREAMS + (s)) )
+#define DMA_ALLOC_CONTROLLER(h)     ( (uint8_t)((h) / DMA_ALLOC_STREAMS) )
+#define DMA_ALLOC_STREAM(h)         ( (uint8_t)((h) % DMA_ALLOC_STREAMS) )
+#define DMA_ALLOC_NONE              ( 0xFFU )
+
+// Highest request line, Reference Manual, Tables 121 and 122
+#define DMA_ALLOC_DMAMUX1_MAX       ( 115U )
+#define DMA_ALLOC_DMAMUX2_MAX       ( 17U )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	DMA_ALLOC_DMA1 = 0 ,
+	DMA_ALLOC_DMA2     ,
+	DMA_ALLOC_BDMA
+} DMA_Alloc_Controller_t;
+
+/* Same encoding as PL[1:0] in DMA_SxCR and BDMA_CCRx */
+typedef enum
+{
+	DMA_ALLOC_LOW = 0    ,
+	DMA_ALLOC_MEDIUM     ,
+	DMA_ALLOC_HIGH       ,
+	DMA_ALLOC_VERY_HIGH
+} DMA_Alloc_Class_t;
+
+typedef enum
+{
+	DMA_ALLOC_OK = 0    ,
+	DMA_ALLOC_ERR_PARAM ,   // Bad controller, stream, request or class
+	DMA_ALLOC_ERR_BUSY  ,   // Stream owned by another request
+	DMA_ALLOC_ERR_FULL      // No free stream on the controllers of the DMAMUX
+} DMA_Alloc_Status_t;
+
+typedef struct
+{
+	const char *owner   ;  // Driver name, for the reports
+	uint8_t     mux     ;  // 1: DMAMUX1 (DMA1, DMA2), 2: DMAMUX2 (BDMA)
+	uint8_t     request ;  // dmamux_reqx line, 1..DMA_ALLOC_DMAMUXx_MAX
+	uint8_t     prio    ;  // DMA_Alloc_Class_t
+} DMA_Alloc_Request_t;
+
+typedef struct
+{
+	DMA_Alloc_Request_t req ;
+	uint8_t  used      ;
+	uint32_t bytes     ;  // Accounted by the owner, usually per transfer complete
+	uint32_t transfers ;
+} DMA_Alloc_Entry_t;
+
+typedef struct
+{
+	DMA_Alloc_Entry_t entry[DMA_ALLOC_CONTROLLERS][DMA_ALLOC_STREAMS] ;
+	uint32_t          failures ;  // DMA_ALLOC_ERR_BUSY and DMA_ALLOC_ERR_FULL results
+} DMA_Alloc_Table_t;
+
+/* A stream loses the arbitration of its controller against the active
+ * streams of a higher class, and of the same class with a lower number
+ * (Reference Manual, Page 637).
+ */
+typedef struct
+{
+	uint8_t  active[DMA_ALLOC_CONTROLLERS] ;
+	uint8_t  contenders[DMA_ALLOC_CONTROLLERS][DMA_ALLOC_STREAMS] ;  // Streams that win against it
+	uint32_t bytes[DMA_ALLOC_CONTROLLERS] ;
+	uint8_t  worst ;         // Handle with the most contenders, DMA_ALLOC_NONE if empty
+	uint8_t  busiest ;       // Handle with the most bytes, DMA_ALLOC_NONE if empty
+	uint32_t failures ;
+} DMA_Alloc_Contention_t;
+
+/************************ Function prototypes ***************************/
+void               DMA_Alloc_Table_Init(DMA_Alloc_Table_t *table) ;
+DMA_Alloc_Status_t DMA_Alloc_Table_Reserve(DMA_Alloc_Table_t *table, uint8_t handle, const DMA_Alloc_Request_t *req) ;
+DMA_Alloc_Status_t DMA_Alloc_Table_Allocate(DMA_Alloc_Table_t *table, const DMA_Alloc_Request_t *req, uint8_t *handle) ;
+void               DMA_Alloc_Table_Release(DMA_Alloc_Table_t *table, uint8_t handle) ;
+void               DMA_Alloc_Table_Account(DMA_Alloc_Table_t *table, uint8_t handle, uint32_t bytes) ;
+uint8_t            DMA_Alloc_Table_Contenders(const DMA_Alloc_Table_t *table, uint8_t handle, uint8_t prio) ;
+void               DMA_Alloc_Table_Contention(const DMA_Alloc_Table_t *table, DMA_Alloc_Contention_t *out) ;
+const char        *DMA_Alloc_Status_Name(DMA_Alloc_Status_t status) ;
+
+#endif /* _DMA_ALLOC_TABLE_H_ */
@@ -0,0 +1,282 @@
+/*
+ ******************************************************************************
+ * File              : dwt_events.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : DWT event counters over scoped measurement regions
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 11, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Next to CYCCNT (cycle_counter.c) the DWT of the Cortex-M7 has five 8-bit
+ * counters, each adds one per cycle or instruction of its kind:
+ *
+ *   CPICNT    extra cycles of multi-cycle instructions and instruction
+ *             fetch stalls, LSU cycles excluded
+ *   EXCCNT    cycles of exception entry and return
+ *   SLEEPCNT  cycles asleep
+ *   LSUCNT    extra cycles of loads and stores, memory wait
+ *   FOLDCNT   instructions folded, executed in no cycle
+ *
+ * so that (ARMv7-M Architecture Reference Manual, DWT profiling counters)
+ *
+ *   instructions = cycles - CPICNT - EXCCNT - SLEEPCNT - LSUCNT + FOLDCNT
+ *
+ * A region is a piece of code between DWT_Events_Begin() and
+ * DWT_Events_End(). Each end and each DWT_Events_Poll() adds the counter
+ * differences since the previous reading to the region sums. CYCCNT is
+ * 32 bits, the difference is right across one wrap. The 8-bit counters
+ * wrap after 256 events, and at most one event a cycle: the difference is
+ * exact for an interval of less than 256 cycles, and counted in inexact
+ * otherwise. For a longer region, DWT_Events_Poll() in its inner loop
+ * keeps the intervals short.
+ *
+ * The cost of a reading (call, loads of the DWT) is measured at init with
+ * empty regions and taken off each interval. Interrupt handlers that run
+ * inside a region are counted with it, their entry and return in exc.
+ * Regions can nest, the outer one then counts the readings of the inner.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "dwt_events.h"
+
+/*************************** Macros ************************************/
+
+#define DWT_EVENTS_ENABLE           ( DWT_CTRL_CPIEVTENA_Msk   | DWT_CTRL_EXCEVTENA_Msk | \
+                                      DWT_CTRL_SLEEPEVTENA_Msk | DWT_CTRL_LSUEVTENA_Msk | \
+                                      DWT_CTRL_FOLDEVTENA_Msk )
+#define DWT_EVENTS_CALIBRATION      ( 16U )
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	DWT_Events_Stats_t stats ;
+	DWT_Events_Snap_t  last  ;  // Reading at Begin or at the last Poll
+	uint32_t           call_cycles ;
+} Region_t;
+
+/************************** Local Variables ****************************/
+
+static Region_t          Regions[DWT_EVENTS_REGIONS] ;
+static uint8_t           Region_Count ;
+static DWT_Events_Snap_t Cost ;  // Of an empty interval
+static uint8_t           Calibration = DWT_EVENTS_NONE ;
+
+/****************************** Functions ******************************/
+
+static uint8_t Less(uint8_t a, uint8_t b)
+{
+	return (a > b) ? (uint8_t)(a - b) : 0U;
+}
+
+/* Counters from the last reading to now, less the cost of the reading */
+static void Interval(Region_t *r, const DWT_Events_Snap_t *now)
+{
+	DWT_Events_Stats_t *s = &r->stats;
+	uint32_t cycles = now->cycles - r->last.cycles;
+
+	s->intervals++;
+	s->inexact += (cycles >= DWT_EVENTS_EXACT_CYCLES) ? 1U : 0U;
+
+	cycles          = (cycles > Cost.cycles) ? cycles - Cost.cycles : 0U;
+	r->call_cycles += cycles;
+	s->cycles      += cycles;
+	s->cpi         += Less((uint8_t)(now->cpi   - r->last.cpi),   Cost.cpi);
+	s->exc         += Less((uint8_t)(now->exc   - r->last.exc),   Cost.exc);
+	s->sleep       += Less((uint8_t)(now->sleep - r->last.sleep), Cost.sleep);
+	s->lsu         += Less((uint8_t)(now->lsu   - r->last.lsu),   Cost.lsu);
+	s->fold        += Less((uint8_t)(now->fold  - r->last.fold),  Cost.fold);
+}
+
+/* Cycle_Counter_Init() first: it sets TRCENA and starts CYCCNT.
+ * Returns 0 when the DWT has no event counters or no region is free.
+ * A second call calibrates again in the same region.
+ */
+uint8_t DWT_Events_Init(void)
+{
+	DWT_Events_Snap_t min = { UINT32_MAX, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU };
+	uint8_t id;
+
+	/* Step 1: Event counters implemented */
+	if (DWT->CTRL & DWT_CTRL_NOPRFCNT_Msk)
+	{
+		return 0U;
+	}
+
+	/* Step 2: Clear and start them */
+	DWT->CPICNT   = 0U ;
+	DWT->EXCCNT   = 0U ;
+	DWT->SLEEPCNT = 0U ;
+	DWT->LSUCNT   = 0U ;
+	DWT->FOLDCNT  = 0U ;
+	DWT->CTRL    |= DWT_EVENTS_ENABLE ;
+
+	/* Step 3: Cost of a reading, smallest of empty regions, none taken off */
+	if (Calibration == DWT_EVENTS_NONE)
+	{
+		Calibration = DWT_Events_Region("Calibration");
+		if (Calibration == DWT_EVENTS_NONE)
+		{
+			return 0U;
+		}
+	}
+	id   = Calibration;
+	Cost = (DWT_Events_Snap_t){ 0U, 0U, 0U, 0U, 0U, 0U };
+	for (uint32_t i = 0U; i < DWT_EVENTS_CALIBRATION; i++)
+	{
+		DWT_Events_Stats_t *s = &Regions[id].stats;
+
+		DWT_Events_Reset(id);
+		DWT_Events_Begin(id);
+		DWT_Events_End(id);
+
+		min.cycles = (s->cycles < min.cycles) ? (uint32_t)s->cycles : min.cycles;
+		min.cpi    = (s->cpi    < min.cpi)    ? (uint8_t)s->cpi     : min.cpi;
+		min.exc    = (s->exc    < min.exc)    ? (uint8_t)s->exc     : min.exc;
+		min.sleep  = (s->sleep  < min.sleep)  ? (uint8_t)s->sleep   : min.sleep;
+		min.lsu    = (s->lsu    < min.lsu)    ? (uint8_t)s->lsu     : min.lsu;
+		min.fold   = (s->fold   < min.fold)   ? (uint8_t)s->fold    : min.fold;
+	}
+	Cost = min;
+
+	/* Step 4: The slot is kept, its sums now show the residual cost */
+	DWT_Events_Reset(id);
+	return 1U;
+}
+
+uint8_t DWT_Events_Region(const char *name)
+{
+	uint8_t id;
+
+	if (Region_Count == DWT_EVENTS_REGIONS)
+	{
+		return DWT_EVENTS_NONE;
+	}
+	id = Region_Count++;
+	Regions[id].stats.name = name;
+	DWT_Events_Reset(id);
+	return id;
+}
+
+void DWT_Events_Begin(uint8_t id)
+{
+	if (id >= Region_Count)
+	{
+		return;
+	}
+	Regions[id].call_cycles = 0U;
+	DWT_Events_Snap(&Regions[id].last);
+}
+
+/* Within a region, closes the interval and starts the next one */
+void DWT_Events_Poll(uint8_t id)
+{
+	DWT_Events_Snap_t now;
+
+	if (id >= Region_Count)
+	{
+		return;
+	}
+	DWT_Events_Snap(&now);
+	Interval(&Regions[id], &now);
+	DWT_Events_Snap(&Regions[id].last);
+}
+
+void DWT_Events_End(uint8_t id)
+{
+	DWT_Events_Snap_t   now;
+	Region_t           *r;
+
+	if (id >= Region_Count)
+	{
+		return;
+	}
+	r = &Regions[id];
+	DWT_Events_Snap(&now);
+	Interval(r, &now);
+
+	r->stats.calls++;
+	r->stats.min_cycles = (r->call_cycles < r->stats.min_cycles) ? r->call_cycles : r->stats.min_cycles;
+	r->stats.max_cycles = (r->call_cycles > r->stats.max_cycles) ? r->call_cycles : r->stats.max_cycles;
+}
+
+void DWT_Events_Reset(uint8_t id)
+{
+	DWT_Events_Stats_t *s;
+
+	if (id >= Region_Count)
+	{
+		return;
+	}
+	s = &Regions[id].stats;
+	s->calls      = 0U;
+	s->intervals  = 0U;
+	s->inexact    = 0U;
+	s->min_cycles = UINT32_MAX;
+	s->max_cycles = 0U;
+	s->cycles     = 0U;
+	s->cpi        = 0U;
+	s->exc        = 0U;
+	s->sleep      = 0U;
+	s->lsu        = 0U;
+	s->fold       = 0U;
+}
+
+void DWT_Events_Get_Stats(uint8_t id, DWT_Events_Stats_t *stats)
+{
+	if (id >= Region_Count)
+	{
+		return;
+	}
+	*stats = Regions[id].stats;
+}
+
+static uint16_t Permille(uint64_t part, uint64_t whole)
+{
+	return (whole != 0U) ? (uint16_t)((part * 1000U) / whole) : 0U;
+}
+
+/* Memory wait (LSU) against instruction stalls (CPI), exceptions and sleep */
+void DWT_Events_Report(uint8_t id, DWT_Events_Report_t *report)
+{
+	const DWT_Events_Stats_t *s;
+	uint64_t stalls;
+	uint32_t spent;
+
+	if (id >= Region_Count)
+	{
+		return;
+	}
+	s      = &Regions[id].stats;
+	stalls = s->cpi + s->exc + s->sleep + s->lsu;
+	report->instructions    = (s->cycles + s->fold > stalls) ? s->cycles + s->fold - stalls : 0U;
+	report->cycles_per_call = s->calls ? (uint32_t)(s->cycles / s->calls) : 0U;
+	report->cpi_x1000       = report->instructions ? (uint32_t)((s->cycles * 1000U) / report->instructions) : 0U;
+
+	report->memory_permille = Permille(s->lsu,   s->cycles);
+	report->core_permille   = Permille(s->cpi,   s->cycles);
+	report->exc_permille    = Permille(s->exc,   s->cycles);
+	report->sleep_permille  = Permille(s->sleep, s->cycles);
+
+	spent = (uint32_t)report->memory_permille + report->core_permille + report->exc_permille + report->sleep_permille;
+	report->issue_permille  = (spent < 1000U) ? (uint16_t)(1000U - spent) : 0U;
+	report->exact           = (s->inexact == 0U) ? 1U : 0U;
+}
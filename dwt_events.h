@@ -0,0 +1,107 @@
+/*
+ ******************************************************************************
+ * File              : dwt_events.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : DWT event counters over scoped measurement regions
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 11, 2026
+ ******************************************************************************/
+
+#ifndef _DWT_EVENTS_H_
+#define _DWT_EVENTS_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+#define DWT_EVENTS_REGIONS          ( 16U )
+#define DWT_EVENTS_NONE             ( 0xFFU )
+
+/* The 8-bit counters add at most one per cycle: the difference of two
+ * readings is exact when fewer cycles than this separate them
+ */
+#define DWT_EVENTS_EXACT_CYCLES     ( 256U )
+
+/*************************** Types *************************************/
+
+/* One reading of CYCCNT and the five 8-bit event counters */
+typedef struct
+{
+	uint32_t cycles ;
+	uint8_t  cpi    ;
+	uint8_t  exc    ;
+	uint8_t  sleep  ;
+	uint8_t  lsu    ;
+	uint8_t  fold   ;
+} DWT_Events_Snap_t;
+
+/* Sums over the intervals of a region, the calibrated cost of the
+ * measurement taken off
+ */
+typedef struct
+{
+	const char *name      ;
+	uint32_t    calls     ;  // DWT_Events_End()
+	uint32_t    intervals ;  // Begin to Poll, Poll to Poll, Poll to End
+	uint32_t    inexact   ;  // Intervals of DWT_EVENTS_EXACT_CYCLES cycles or more
+	uint32_t    min_cycles;  // Per call
+	uint32_t    max_cycles;
+	uint64_t    cycles    ;
+	uint64_t    cpi       ;  // Extra cycles of multi-cycle instructions and instruction fetch
+	uint64_t    exc       ;  // Exception entry and return
+	uint64_t    sleep     ;  // Cycles asleep
+	uint64_t    lsu       ;  // Extra cycles of loads and stores
+	uint64_t    fold      ;  // Instructions that took no cycle
+} DWT_Events_Stats_t;
+
+/* Where the cycles of a region went, in permille of its cycles */
+typedef struct
+{
+	uint64_t instructions    ;  // cycles - cpi - exc - sleep - lsu + fold
+	uint32_t cycles_per_call ;
+	uint32_t cpi_x1000       ;  // Cycles per instruction x 1000
+	uint16_t memory_permille ;  // lsu
+	uint16_t core_permille   ;  // cpi
+	uint16_t exc_permille    ;
+	uint16_t sleep_permille  ;
+	uint16_t issue_permille  ;  // The rest, one cycle per instruction
+	uint8_t  exact           ;  // No inexact interval
+} DWT_Events_Report_t;
+
+/************************ Function prototypes ***************************/
+uint8_t DWT_Events_Init(void) ;
+uint8_t DWT_Events_Region(const char *name) ;
+void    DWT_Events_Begin(uint8_t id) ;
+void    DWT_Events_Poll(uint8_t id) ;
+void    DWT_Events_End(uint8_t id) ;
+void    DWT_Events_Reset(uint8_t id) ;
+void    DWT_Events_Get_Stats(uint8_t id, DWT_Events_Stats_t *stats) ;
+void    DWT_Events_Report(uint8_t id, DWT_Events_Report_t *report) ;
+
+/* Reading of all counters, CYCCNT last */
+__STATIC_INLINE void DWT_Events_Snap(DWT_Events_Snap_t *snap)
+{
+	snap->cpi    = (uint8_t)DWT->CPICNT;
+	snap->exc    = (uint8_t)DWT->EXCCNT;
+	snap->sleep  = (uint8_t)DWT->SLEEPCNT;
+	snap->lsu    = (uint8_t)DWT->LSUCNT;
+	snap->fold   = (uint8_t)DWT->FOLDCNT;
+	snap->cycles = DWT->CYCCNT;
+}
+
+#endif /* _DWT_EVENTS_H_ */
@@ -0,0 +1,614 @@
+/*
+ ******************************************************************************
+ * File              : fdcan.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : FDCAN1 driver, bit timing, message RAM and timestamps
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 23, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Chapter 56, Controller area network with
+ * flexible data rate (FDCAN)
+ *
+ * Kernel clock: FDCANSEL[1:0] in RCC_D2CCIP1R picks hse_ck, pll1_q_ck or
+ * pll2_q_ck. A bit rate is only exact when the kernel clock is a multiple of
+ * it, so every running input is tried and the one that gives exact nominal
+ * and data bit rates with the most time quanta in the data phase is kept.
+ * With the default profile pll1_q_ck is 480 MHz, above the 125 MHz limit;
+ * a profile with divq1 = 12 gives 80 MHz, which divides 500 kbit/s, 1, 2, 4,
+ * 5 and 8 Mbit/s exactly. PLL2 is not started here, it is left to audio.
+ *
+ * Message RAM: the sections are laid out back to back from the start of
+ * SRAMCAN in the order standard filters, extended filters, RX FIFO 0, TX
+ * event FIFO, TX FIFO, all with 64-byte data fields (18 words per element).
+ * FDCAN2 would have to start after FDCAN_Info.ram_words.
+ *
+ * Zero copy RX: FDCAN_RX_Peek() returns the element in the message RAM at
+ * the FIFO get index, FDCAN_RX_Release() acknowledges it. With a callback set
+ * the interrupt calls it for every element and releases it.
+ *
+ * Timestamps: the 16-bit timestamp counter counts nominal bit times (TSS = 01,
+ * TCP = 0). The interrupt counts the wrap arounds (TSW) and extends the
+ * TX event timestamps to 32 bits. An event older than the last wrap has a
+ * timestamp above the current counter value and takes the previous count.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "fdcan.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+#define FDCAN_ELEMENT_WORDS         ( 18U )    // 2 header words + 64 data bytes
+#define FDCAN_EVENT_RING            ( 32U )    // Power of 2
+#define FDCAN_EVENT_MASK            ( FDCAN_EVENT_RING - 1U )
+#define FDCAN_DATA_FIELD_64         ( 7U )     // F0DS, TBDS: 64 bytes, Reference Manual, Page 2505
+
+// Element bits, Reference Manual, Page 2455 to 2460
+#define FDCAN_ELEMENT_XTD           ( 1UL << 30 )
+#define FDCAN_ELEMENT_EFC           ( 1UL << 23 )
+#define FDCAN_ELEMENT_FDF           ( 1UL << 21 )
+#define FDCAN_ELEMENT_BRS           ( 1UL << 20 )
+
+/* FDCAN1 pins, AF9. Check the schematic of the CAN transceiver header */
+#define FDCAN_RX_PIN                ( 8U )     // PB8
+#define FDCAN_TX_PIN                ( 9U )     // PB9
+#define FDCAN_AF                    ( 9U )
+
+/************************** Local Variables ****************************/
+
+static const uint8_t Dlc_Length[16] = { 0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U };
+
+/* Kernel clock inputs, FDCANSEL[1:0], Reference Manual, Page 409 */
+static const Kernel_Clock_Option_t Kernel_Options[3] =
+{
+	{ KERNEL_CLOCK_PLL1_Q, 1U },
+	{ KERNEL_CLOCK_HSE   , 0U },
+	{ KERNEL_CLOCK_PLL2_Q, 2U },
+};
+
+static FDCAN_Info_t                 Info ;
+static FDCAN_Ram_Layout_t           Layout ;
+static uint32_t                     Std_Filter_Base ;   // Word addresses in SRAMCAN
+static uint32_t                     Rx_Fifo0_Base ;
+static uint32_t                     Tx_Event_Base ;
+static uint32_t                     Tx_Fifo_Base ;
+static uint32_t                     Nominal_Bps ;
+
+static volatile uint32_t            Ts_Wraps ;
+static volatile FDCAN_RX_Callback_t Rx_Callback ;
+
+static FDCAN_TX_Event_t             Events[FDCAN_EVENT_RING] ;
+static volatile uint32_t            Event_Head ;         // Written by the interrupt only
+static volatile uint32_t            Event_Tail ;
+
+static FDCAN_Stats_t                Stats ;
+
+static __IO uint32_t *Ram_Word(uint32_t word)
+{
+	return (__IO uint32_t *)(SRAMCAN_BASE + 4U * word);
+}
+
+/* Exact bit timing: kernel_hz / bps = prescaler * (1 + seg1 + seg2).
+ * The smallest prescaler, that is the most time quanta, is taken.
+ * Nominal: NBRP 1..512, NTSEG1 2..256, NTSEG2 2..128, Reference Manual, Page 2484
+ * Data:    DBRP 1..32,  DTSEG1 1..32,  DTSEG2 1..16,  Reference Manual, Page 2478
+ * Returns 1 when found
+ */
+uint8_t FDCAN_Bit_Timing(uint32_t kernel_hz, uint32_t bps, uint16_t sp_permille, uint8_t data_phase, FDCAN_Bit_Timing_t *timing)
+{
+	uint32_t pre_max  = data_phase ? 32U : 512U;
+	uint32_t seg1_min = data_phase ? 1U  : 2U;
+	uint32_t seg1_max = data_phase ? 32U : 256U;
+	uint32_t seg2_min = data_phase ? 1U  : 2U;
+	uint32_t seg2_max = data_phase ? 16U : 128U;
+	uint32_t ratio;
+
+	if ((bps == 0U) || (kernel_hz % bps) != 0U)
+	{
+		return 0U;
+	}
+	ratio = kernel_hz / bps;
+
+	for (uint32_t pre = 1U; pre <= pre_max; pre++)
+	{
+		uint32_t tq, seg1, seg2;
+
+		if ((ratio % pre) != 0U)
+		{
+			continue;
+		}
+		tq = ratio / pre;
+		if (tq < (1U + seg1_min + seg2_min))
+		{
+			break;
+		}
+
+		seg2 = (tq * (1000U - sp_permille) + 500U) / 1000U;
+		seg2 = (seg2 < seg2_min) ? seg2_min : (seg2 > seg2_max) ? seg2_max : seg2;
+		seg1 = tq - 1U - seg2;
+		if ((seg1 < seg1_min) || (seg1 > seg1_max))
+		{
+			continue;
+		}
+
+		timing->prescaler = (uint16_t)pre;
+		timing->tq        = (uint16_t)tq;
+		timing->seg1      = (uint16_t)seg1;
+		timing->seg2      = (uint16_t)seg2;
+		return 1U;
+	}
+	return 0U;
+}
+
+static void FDCAN_Pins_Config(void)
+{
+	RCC->AHB4ENR |= RCC_AHB4ENR_GPIOBEN ;
+
+	GPIOB->MODER   = (GPIOB->MODER & ~ ((3UL << (2U * FDCAN_RX_PIN)) | (3UL << (2U * FDCAN_TX_PIN)))) |
+	                 (2UL << (2U * FDCAN_RX_PIN)) | (2UL << (2U * FDCAN_TX_PIN)) ;
+	GPIOB->OSPEEDR |= (2UL << (2U * FDCAN_RX_PIN)) | (2UL << (2U * FDCAN_TX_PIN)) ;
+	GPIOB->AFR[1]  = (GPIOB->AFR[1] & ~ ((0xFUL << (4U * (FDCAN_RX_PIN - 8U))) | (0xFUL << (4U * (FDCAN_TX_PIN - 8U))))) |
+	                 (FDCAN_AF << (4U * (FDCAN_RX_PIN - 8U))) | (FDCAN_AF << (4U * (FDCAN_TX_PIN - 8U))) ;
+}
+
+FDCAN_Status_t FDCAN_Init(const FDCAN_Config_t *config)
+{
+	FDCAN_Bit_Timing_t nominal, data;
+	uint32_t           best_score = 0U;
+	uint32_t           word;
+
+	/* Step 1: Kernel clock with exact nominal and data bit rates */
+	for (uint32_t i = 0U; i < 3U; i++)
+	{
+		uint32_t hz = Kernel_Clock_Hz(Kernel_Options[i].clock);
+		uint32_t score;
+
+		if ((hz == 0U) || (hz > FDCAN_KERNEL_CLOCK_MAX_HZ) ||
+		    !FDCAN_Bit_Timing(hz, config->nominal_bps, config->nominal_sp_permille, 0U, &nominal) ||
+		    !FDCAN_Bit_Timing(hz, config->data_bps, config->data_sp_permille, 1U, &data))
+		{
+			continue;
+		}
+
+		/* Prescaler 1 in the data phase keeps transceiver delay compensation
+		 * exact, then more time quanta give a finer sample point
+		 */
+		score = ((data.prescaler == 1U) ? 1000U : 0U) + data.tq;
+		if (score > best_score)
+		{
+			best_score        = score;
+			Info.kernel_clock = Kernel_Options[i].clock;
+			Info.kernel_hz    = hz;
+			Info.nominal      = nominal;
+			Info.data         = data;
+			RCC->D2CCIP1R     = (RCC->D2CCIP1R & ~ RCC_D2CCIP1R_FDCANSEL) |
+			                    ((uint32_t)Kernel_Options[i].sel << RCC_D2CCIP1R_FDCANSEL_Pos) ;
+		}
+	}
+	if (best_score == 0U)
+	{
+		return FDCAN_ERROR;
+	}
+
+	/* Step 2: Message RAM layout, Reference Manual, Page 2449 */
+	Layout          = config->ram;
+	Std_Filter_Base = 0U;
+	word            = Layout.std_filters;
+	word           += 2U * Layout.ext_filters;
+	Rx_Fifo0_Base   = word;
+	word           += FDCAN_ELEMENT_WORDS * Layout.rx_fifo0;
+	Tx_Event_Base   = word;
+	word           += 2U * Layout.tx_events;
+	Tx_Fifo_Base    = word;
+	word           += FDCAN_ELEMENT_WORDS * Layout.tx_fifo;
+	Info.ram_words  = word;
+	if ((word > FDCAN_RAM_WORDS) || (Layout.std_filters > 128U) || (Layout.ext_filters > 64U) ||
+	    (Layout.rx_fifo0 == 0U) || (Layout.rx_fifo0 > 64U) || (Layout.tx_events > 32U) ||
+	    (Layout.tx_fifo == 0U) || (Layout.tx_fifo > 32U))
+	{
+		return FDCAN_ERROR;
+	}
+
+	/* Step 3: Bus clock and pins, FDCAN is on APB1, Reference Manual, Page 461 */
+	RCC->APB1HENR |= RCC_APB1HENR_FDCANEN ;
+	FDCAN_Pins_Config();
+
+	/* Step 4: Initialization mode with configuration change enabled */
+	FDCAN1->CCCR |= FDCAN_CCCR_INIT ;
+	while(! (FDCAN1->CCCR & FDCAN_CCCR_INIT) ) {}
+	FDCAN1->CCCR |= FDCAN_CCCR_CCE ;
+
+	for (uint32_t i = 0U; i < Info.ram_words; i++)
+	{
+		*Ram_Word(i) = 0U;
+	}
+
+	/* Step 5: CAN FD with bit rate switching, optional internal loopback */
+	FDCAN1->CCCR |= FDCAN_CCCR_FDOE | FDCAN_CCCR_BRSE ;
+	if (config->loopback)
+	{
+		FDCAN1->CCCR |= FDCAN_CCCR_TEST | FDCAN_CCCR_MON ;
+		FDCAN1->TEST |= FDCAN_TEST_LBCK ;
+	}
+
+	/* Step 6: Bit timing, SJW = seg2, Reference Manual, Page 2478 and 2484 */
+	FDCAN1->NBTP = ((uint32_t)(Info.nominal.seg2 - 1U)      << FDCAN_NBTP_NSJW_Pos)   |
+	               ((uint32_t)(Info.nominal.prescaler - 1U) << FDCAN_NBTP_NBRP_Pos)   |
+	               ((uint32_t)(Info.nominal.seg1 - 1U)      << FDCAN_NBTP_NTSEG1_Pos) |
+	               ((uint32_t)(Info.nominal.seg2 - 1U)      << FDCAN_NBTP_NTSEG2_Pos) ;
+	FDCAN1->DBTP = ((uint32_t)(Info.data.prescaler - 1U)    << FDCAN_DBTP_DBRP_Pos)   |
+	               ((uint32_t)(Info.data.seg1 - 1U)         << FDCAN_DBTP_DTSEG1_Pos) |
+	               ((uint32_t)(Info.data.seg2 - 1U)         << FDCAN_DBTP_DTSEG2_Pos) |
+	               ((uint32_t)(Info.data.seg2 - 1U)         << FDCAN_DBTP_DSJW_Pos)   ;
+
+	/* Transceiver delay compensation, secondary sample point at the data
+	 * sample point measured from the transmitted edge, Reference Manual, Page 2434
+	 */
+	if (Info.data.prescaler <= 2U)
+	{
+		FDCAN1->TDCR  = ((uint32_t)Info.data.prescaler * (Info.data.seg1 + 1U)) << FDCAN_TDCR_TDCO_Pos ;
+		FDCAN1->DBTP |= FDCAN_DBTP_TDC ;
+	}
+
+	/* Step 7: Timestamp counter in nominal bit times, TSS = 01 */
+	FDCAN1->TSCC = 1UL << FDCAN_TSCC_TSS_Pos ;
+	Nominal_Bps  = config->nominal_bps;
+
+	/* Step 8: Message RAM sections, start addresses in words, Reference Manual, Page 2497 to 2511 */
+	FDCAN1->SIDFC = (Std_Filter_Base << FDCAN_SIDFC_FLSSA_Pos) | ((uint32_t)Layout.std_filters << FDCAN_SIDFC_LSS_Pos) ;
+	FDCAN1->XIDFC = (Layout.std_filters << FDCAN_XIDFC_FLESA_Pos) | ((uint32_t)Layout.ext_filters << FDCAN_XIDFC_LSE_Pos) ;
+	FDCAN1->RXF0C = (Rx_Fifo0_Base << FDCAN_RXF0C_F0SA_Pos) | ((uint32_t)Layout.rx_fifo0 << FDCAN_RXF0C_F0S_Pos) ;
+	FDCAN1->RXESC = (FDCAN_DATA_FIELD_64 << FDCAN_RXESC_F0DS_Pos) ;
+	FDCAN1->TXEFC = (Tx_Event_Base << FDCAN_TXEFC_EFSA_Pos) | ((uint32_t)Layout.tx_events << FDCAN_TXEFC_EFS_Pos) ;
+	FDCAN1->TXBC  = (Tx_Fifo_Base << FDCAN_TXBC_TBSA_Pos) | ((uint32_t)Layout.tx_fifo << FDCAN_TXBC_TFQS_Pos) ;
+	FDCAN1->TXESC = (FDCAN_DATA_FIELD_64 << FDCAN_TXESC_TBDS_Pos) ;
+
+	/* Step 9: Frames that match no filter: FIFO 0 without filters, rejected
+	 * once standard filters are configured. Remote frames rejected.
+	 */
+	FDCAN1->GFC = ((Layout.std_filters ? 2UL : 0UL) << FDCAN_GFC_ANFS_Pos) |
+	              ((Layout.ext_filters ? 2UL : 0UL) << FDCAN_GFC_ANFE_Pos) |
+	              FDCAN_GFC_RRFS | FDCAN_GFC_RRFE ;
+
+	/* Step 10: Interrupts on line 0 */
+	Ts_Wraps   = 0U;
+	Event_Head = 0U;
+	Event_Tail = 0U;
+	FDCAN1->IR  = 0xFFFFFFFFUL ;
+	FDCAN1->ILS = 0U ;
+	FDCAN1->IE  = FDCAN_IE_RF0NE | FDCAN_IE_RF0LE | FDCAN_IE_TEFNE | FDCAN_IE_TEFLE |
+	              FDCAN_IE_TSWE  | FDCAN_IE_BOE   | FDCAN_IE_PEAE  | FDCAN_IE_PEDE  ;
+	FDCAN1->ILE = FDCAN_ILE_EINT0 ;
+
+	NVIC_SetPriority(FDCAN1_IT0_IRQn, 6U);
+	NVIC_EnableIRQ(FDCAN1_IT0_IRQn);
+
+	/* Step 11: Leave initialization, the node joins after 11 recessive bits */
+	FDCAN1->CCCR &= ~ FDCAN_CCCR_INIT ;
+	while( FDCAN1->CCCR & FDCAN_CCCR_INIT ) {}
+
+	return FDCAN_OK;
+}
+
+const FDCAN_Info_t *FDCAN_Get_Info(void)
+{
+	return &Info;
+}
+
+/* Classic filter id/mask to RX FIFO 0, SFT = 10, SFEC = 001,
+ * Reference Manual, Page 2458
+ */
+FDCAN_Status_t FDCAN_Filter_Standard(uint8_t index, uint16_t id, uint16_t mask)
+{
+	if (index >= Layout.std_filters)
+	{
+		return FDCAN_ERROR;
+	}
+	*Ram_Word(Std_Filter_Base + index) = (2UL << 30) | (1UL << 27) |
+	                                     ((uint32_t)(id & 0x7FFU) << 16) | (mask & 0x7FFU) ;
+	return FDCAN_OK;
+}
+
+/* Smallest DLC that holds length bytes, 8 at most for classic frames */
+static uint32_t Length_To_Dlc(uint8_t length, uint8_t fd)
+{
+	uint32_t dlc = 0U;
+
+	while ((dlc < 15U) && (Dlc_Length[dlc] < length))
+	{
+		dlc++;
+	}
+	return (!fd && (dlc > 8U)) ? 8U : dlc;
+}
+
+FDCAN_Status_t FDCAN_Send(uint32_t id, uint8_t flags, const void *data, uint8_t length, uint8_t marker)
+{
+	const uint8_t *src = (const uint8_t *)data;
+	__IO uint32_t *element;
+	uint32_t       put, dlc, bytes;
+
+	if (FDCAN1->CCCR & FDCAN_CCCR_INIT)
+	{
+		return FDCAN_ERROR;
+	}
+	if (FDCAN1->TXFQS & FDCAN_TXFQS_TFQF)
+	{
+		return FDCAN_BUSY;
+	}
+
+	/* TX buffer element, Reference Manual, Page 2456 */
+	put     = (FDCAN1->TXFQS & FDCAN_TXFQS_TFQPI) >> FDCAN_TXFQS_TFQPI_Pos;
+	element = Ram_Word(Tx_Fifo_Base + FDCAN_ELEMENT_WORDS * put);
+	dlc     = Length_To_Dlc(length, flags & FDCAN_FLAG_FD);
+	bytes   = Dlc_Length[dlc];
+
+	element[0] = (flags & FDCAN_FLAG_EXT) ? (FDCAN_ELEMENT_XTD | (id & 0x1FFFFFFFUL)) : ((id & 0x7FFUL) << 18) ;
+	element[1] = ((uint32_t)marker << 24) | (Layout.tx_events ? FDCAN_ELEMENT_EFC : 0U) |
+	             ((flags & FDCAN_FLAG_FD)  ? FDCAN_ELEMENT_FDF : 0U) |
+	             ((flags & FDCAN_FLAG_BRS) ? FDCAN_ELEMENT_BRS : 0U) | (dlc << 16) ;
+
+	/* Message RAM takes 32-bit accesses only, pad up to the DLC length with 0 */
+	for (uint32_t i = 0U; i < bytes; i += 4U)
+	{
+		uint32_t w = 0U;
+
+		for (uint32_t b = 0U; b < 4U; b++)
+		{
+			if ((i + b) < length)
+			{
+				w |= (uint32_t)src[i + b] << (8U * b);
+			}
+		}
+		element[2U + i / 4U] = w;
+	}
+
+	FDCAN1->TXBAR = 1UL << put ;
+	Stats.tx_frames++;
+
+	return FDCAN_OK;
+}
+
+/* Oldest element of RX FIFO 0 in the message RAM, NULL when empty.
+ * Valid until FDCAN_RX_Release()
+ */
+const FDCAN_Element_t *FDCAN_RX_Peek(void)
+{
+	uint32_t status = FDCAN1->RXF0S;
+
+	if ((status & FDCAN_RXF0S_F0FL) == 0U)
+	{
+		return 0;
+	}
+	return (const FDCAN_Element_t *)Ram_Word(Rx_Fifo0_Base +
+	       FDCAN_ELEMENT_WORDS * ((status & FDCAN_RXF0S_F0GI) >> FDCAN_RXF0S_F0GI_Pos));
+}
+
+void FDCAN_RX_Release(void)
+{
+	uint32_t status = FDCAN1->RXF0S;
+
+	if (status & FDCAN_RXF0S_F0FL)
+	{
+		FDCAN1->RXF0A = (status & FDCAN_RXF0S_F0GI) >> FDCAN_RXF0S_F0GI_Pos ;
+		Stats.rx_frames++;
+	}
+}
+
+void FDCAN_Set_RX_Callback(FDCAN_RX_Callback_t callback)
+{
+	Rx_Callback = callback;
+}
+
+uint8_t FDCAN_TX_Event_Get(FDCAN_TX_Event_t *event)
+{
+	if (Event_Tail == Event_Head)
+	{
+		return 0U;
+	}
+	*event = Events[Event_Tail & FDCAN_EVENT_MASK];
+	__DMB();
+	Event_Tail = Event_Tail + 1U;
+	return 1U;
+}
+
+uint8_t FDCAN_Length(const FDCAN_Element_t *element)
+{
+	return Dlc_Length[(element->r1 >> 16) & 0xFU];
+}
+
+uint32_t FDCAN_Id(const FDCAN_Element_t *element)
+{
+	return (element->r0 & FDCAN_ELEMENT_XTD) ? (element->r0 & 0x1FFFFFFFUL) : ((element->r0 >> 18) & 0x7FFUL);
+}
+
+uint32_t FDCAN_Timestamp_Ns(uint32_t bit_times)
+{
+	return (Nominal_Bps == 0U) ? 0U : (uint32_t)(((uint64_t)bit_times * 1000000000ULL) / Nominal_Bps);
+}
+
+void FDCAN_Get_Stats(FDCAN_Stats_t *stats)
+{
+	*stats = Stats;
+}
+
+/* 16-bit timestamp to 32 bits, see the comments on top */
+static uint32_t Extend_Timestamp(uint32_t ts)
+{
+	uint32_t wraps = Ts_Wraps;
+
+	if ((ts > (FDCAN1->TSCV & 0xFFFFUL)) && (wraps != 0U))
+	{
+		wraps--;
+	}
+	return (wraps << 16) | ts;
+}
+
+/* Move the TX event FIFO to the event ring, TX event element,
+ * Reference Manual, Page 2457
+ */
+static void Drain_TX_Events(void)
+{
+	uint32_t status;
+
+	while ((status = FDCAN1->TXEFS) & FDCAN_TXEFS_EFFL)
+	{
+		uint32_t       get = (status & FDCAN_TXEFS_EFGI) >> FDCAN_TXEFS_EFGI_Pos;
+		__IO uint32_t *e   = Ram_Word(Tx_Event_Base + 2U * get);
+		uint32_t       e0  = e[0];
+		uint32_t       e1  = e[1];
+
+		if ((Event_Head - Event_Tail) < FDCAN_EVENT_RING)
+		{
+			FDCAN_TX_Event_t *ev = &Events[Event_Head & FDCAN_EVENT_MASK];
+
+			ev->id        = (e0 & FDCAN_ELEMENT_XTD) ? (e0 & 0x1FFFFFFFUL) : ((e0 >> 18) & 0x7FFUL);
+			ev->marker    = (uint8_t)(e1 >> 24);
+			ev->timestamp = Extend_Timestamp(e1 & 0xFFFFUL);
+			__DMB();
+			Event_Head = Event_Head + 1U;
+			Stats.tx_events++;
+		}
+		else
+		{
+			Stats.tx_events_lost++;
+		}
+		FDCAN1->TXEFA = get ;
+	}
+}
+
+/* Loopback throughput: frames of length bytes with bit rate switching,
+ * as fast as the TX FIFO takes them. Needs FDCAN_Init() with loopback = 1
+ * and no standard filters.
+ */
+FDCAN_Status_t FDCAN_Benchmark(uint32_t frames, uint8_t length, FDCAN_Bench_t *bench)
+{
+	FDCAN_RX_Callback_t saved = Rx_Callback;
+	FDCAN_TX_Event_t    event;
+	uint8_t             payload[64];
+	uint32_t            sent = 0U, received = 0U, events = 0U;
+	uint32_t            first_ts = 0U, last_ts = 0U;
+	uint32_t            start, timeout;
+
+	if (!(FDCAN1->TEST & FDCAN_TEST_LBCK) || (frames == 0U) || (length > 64U))
+	{
+		return FDCAN_ERROR;
+	}
+
+	for (uint32_t i = 0U; i < sizeof(payload); i++)
+	{
+		payload[i] = (uint8_t)i;
+	}
+	while (FDCAN_TX_Event_Get(&event)) {}
+
+	/* Elements stay in the FIFO for this loop, no callback */
+	Rx_Callback = 0;
+	timeout     = SystemCoreClock;   // 1 s
+	start       = Cycle_Counter_Get();
+
+	while ((received < frames) && ((Cycle_Counter_Get() - start) < timeout))
+	{
+		if ((sent < frames) &&
+		    (FDCAN_Send(0x123U, FDCAN_FLAG_FD | FDCAN_FLAG_BRS, payload, length, (uint8_t)sent) == FDCAN_OK))
+		{
+			sent++;
+		}
+		if (FDCAN_RX_Peek() != 0)
+		{
+			FDCAN_RX_Release();
+			received++;
+		}
+		while (FDCAN_TX_Event_Get(&event))
+		{
+			if (events++ == 0U)
+			{
+				first_ts = event.timestamp;
+			}
+			last_ts = event.timestamp;
+		}
+	}
+
+	bench->cycles       = Cycle_Counter_Get() - start;
+	Rx_Callback         = saved;
+	bench->frames       = received;
+	bench->length       = Dlc_Length[Length_To_Dlc(length, 1U)];
+	bench->frames_per_s = (bench->cycles == 0U) ? 0U :
+	                      (uint32_t)(((uint64_t)received * SystemCoreClock) / bench->cycles);
+	bench->payload_kbps = (bench->frames_per_s * bench->length * 8U) / 1000U;
+	bench->latency_bits = (events > 1U) ? ((last_ts - first_ts) / (events - 1U)) : 0U;
+
+	return (received == frames) ? FDCAN_OK : FDCAN_ERROR;
+}
+
+void FDCAN_IRQHandler(void)
+{
+	uint32_t ir = FDCAN1->IR & FDCAN1->IE;
+
+	FDCAN1->IR = ir ;
+
+	/* Wrap around first, so events read below see the new count */
+	if (ir & FDCAN_IR_TSW)
+	{
+		Ts_Wraps = Ts_Wraps + 1U;
+	}
+
+	if (ir & (FDCAN_IR_TEFN | FDCAN_IR_TEFL))
+	{
+		if (ir & FDCAN_IR_TEFL)
+		{
+			Stats.tx_events_lost++;
+		}
+		Drain_TX_Events();
+	}
+
+	if (ir & FDCAN_IR_RF0L)
+	{
+		Stats.rx_lost++;
+	}
+
+	if ((ir & FDCAN_IR_RF0N) && (Rx_Callback != 0))
+	{
+		const FDCAN_Element_t *element;
+
+		while ((element = FDCAN_RX_Peek()) != 0)
+		{
+			Rx_Callback(element);
+			FDCAN_RX_Release();
+		}
+	}
+
+	if (ir & (FDCAN_IR_PEA | FDCAN_IR_PED))
+	{
+		Stats.protocol_errors++;
+	}
+
+	/* Bus off sets INIT, clearing it starts the recovery sequence of
+	 * 128 x 11 recessive bits, Reference Manual, Page 2432
+	 */
+	if (ir & FDCAN_IR_BO)
+	{
+		Stats.bus_off++;
+		if (FDCAN1->PSR & FDCAN_PSR_BO)
+		{
+			FDCAN1->CCCR &= ~ FDCAN_CCCR_INIT ;
+		}
+	}
+}
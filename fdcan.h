@@ -0,0 +1,151 @@
+/*
+ ******************************************************************************
+ * File              : fdcan.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : FDCAN1 driver, bit timing, message RAM and timestamps
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 23, 2026
+ ******************************************************************************/
+
+#ifndef _FDCAN_H_
+#define _FDCAN_H_
+
+#include "stm32h7xx.h"
+#include "kernel_clock.h"
+
+/*************************** Macros ************************************/
+
+// fdcan_ker_ck maximum, Datasheet DS12110, FDCAN characteristics
+#define FDCAN_KERNEL_CLOCK_MAX_HZ   ( 125000000UL )
+
+// Message RAM shared by FDCAN1 and FDCAN2, 2560 words, Reference Manual, Page 2449
+#define FDCAN_RAM_WORDS             ( 2560U )
+
+// Flags of FDCAN_Send()
+#define FDCAN_FLAG_EXT              ( 1U << 0 )  // 29-bit identifier
+#define FDCAN_FLAG_FD               ( 1U << 1 )  // CAN FD frame, up to 64 bytes
+#define FDCAN_FLAG_BRS              ( 1U << 2 )  // Data phase at the data bit rate
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	FDCAN_OK = 0     ,
+	FDCAN_BUSY       ,  // TX FIFO full
+	FDCAN_ERROR         // No exact bit timing, message RAM too small, bus off
+} FDCAN_Status_t;
+
+/* Element counts of the message RAM sections, data fields are 64 bytes */
+typedef struct
+{
+	uint8_t std_filters ;  // 0..128
+	uint8_t ext_filters ;  // 0..64
+	uint8_t rx_fifo0    ;  // 1..64
+	uint8_t tx_events   ;  // 0..32
+	uint8_t tx_fifo     ;  // 1..32
+} FDCAN_Ram_Layout_t;
+
+typedef struct
+{
+	uint32_t           nominal_bps         ;  // Arbitration phase, e.g. 500000
+	uint32_t           data_bps            ;  // Data phase, e.g. 5000000
+	uint16_t           nominal_sp_permille ;  // Sample point, e.g. 800
+	uint16_t           data_sp_permille    ;  // e.g. 750
+	uint8_t            loopback            ;  // 1: internal loopback, no transceiver needed
+	FDCAN_Ram_Layout_t ram                 ;
+} FDCAN_Config_t;
+
+typedef struct
+{
+	uint16_t prescaler ;
+	uint16_t tq        ;  // Time quanta per bit, 1 + seg1 + seg2
+	uint16_t seg1      ;
+	uint16_t seg2      ;
+} FDCAN_Bit_Timing_t;
+
+typedef struct
+{
+	Kernel_Clock_t     kernel_clock ;
+	uint32_t           kernel_hz    ;
+	FDCAN_Bit_Timing_t nominal      ;
+	FDCAN_Bit_Timing_t data         ;
+	uint32_t           ram_words    ;  // Message RAM used
+} FDCAN_Info_t;
+
+/* RX FIFO and TX buffer element with a 64-byte data field, as in the
+ * message RAM. RX elements are read in place (zero copy).
+ */
+typedef struct
+{
+	uint32_t r0       ;  // ESI[31] XTD[30] RTR[29] ID[28:0]
+	uint32_t r1       ;  // ANMF[31] FIDX[30:24] FDF[21] BRS[20] DLC[19:16] RXTS[15:0]
+	uint32_t data[16] ;
+} FDCAN_Element_t;
+
+typedef struct
+{
+	uint32_t id        ;
+	uint8_t  marker    ;  // Message marker given to FDCAN_Send()
+	uint32_t timestamp ;  // Start of frame, nominal bit times, 32-bit extended
+} FDCAN_TX_Event_t;
+
+typedef struct
+{
+	uint32_t rx_frames       ;
+	uint32_t rx_lost         ;  // RX FIFO 0 full, message lost
+	uint32_t tx_frames       ;
+	uint32_t tx_events       ;
+	uint32_t tx_events_lost  ;
+	uint32_t bus_off         ;
+	uint32_t protocol_errors ;
+} FDCAN_Stats_t;
+
+typedef struct
+{
+	uint32_t frames          ;
+	uint32_t length          ;  // Payload bytes per frame
+	uint32_t cycles          ;
+	uint32_t frames_per_s    ;
+	uint32_t payload_kbps    ;
+	uint32_t latency_bits    ;  // Mean TX event to TX event distance, nominal bit times
+} FDCAN_Bench_t;
+
+typedef void (*FDCAN_RX_Callback_t)(const FDCAN_Element_t *element) ;
+
+/************************ Function prototypes ***************************/
+FDCAN_Status_t         FDCAN_Init(const FDCAN_Config_t *config) ;
+const FDCAN_Info_t    *FDCAN_Get_Info(void) ;
+uint8_t                FDCAN_Bit_Timing(uint32_t kernel_hz, uint32_t bps, uint16_t sp_permille, uint8_t data_phase, FDCAN_Bit_Timing_t *timing) ;
+FDCAN_Status_t         FDCAN_Filter_Standard(uint8_t index, uint16_t id, uint16_t mask) ;
+
+FDCAN_Status_t         FDCAN_Send(uint32_t id, uint8_t flags, const void *data, uint8_t length, uint8_t marker) ;
+const FDCAN_Element_t *FDCAN_RX_Peek(void) ;
+void                   FDCAN_RX_Release(void) ;
+void                   FDCAN_Set_RX_Callback(FDCAN_RX_Callback_t callback) ;
+uint8_t                FDCAN_TX_Event_Get(FDCAN_TX_Event_t *event) ;
+
+uint8_t                FDCAN_Length(const FDCAN_Element_t *element) ;
+uint32_t               FDCAN_Id(const FDCAN_Element_t *element) ;
+uint32_t               FDCAN_Timestamp_Ns(uint32_t bit_times) ;
+
+void                   FDCAN_Get_Stats(FDCAN_Stats_t *stats) ;
+FDCAN_Status_t         FDCAN_Benchmark(uint32_t frames, uint8_t length, FDCAN_Bench_t *bench) ;
+
+void                   FDCAN_IRQHandler(void) ;
+
+#endif /* _FDCAN_H_ */
@@ -0,0 +1,218 @@
+/*
+ ******************************************************************************
+ * File              : fpu_policy.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : FPU context save policy and FPU-free interrupt handlers
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 31, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * An exception taken while CONTROL.FPCA is set (the interrupted code has
+ * executed an FP instruction) uses the extended frame: 8 words plus S0..S15,
+ * FPSCR and one reserved word, 26 words. ASPEN and LSPEN in FPCCR decide if
+ * and when the FP part is written (ARMv7-M Architecture Reference Manual,
+ * B1.5.7). The policy of the build is applied by FPU_Policy_Init(), before
+ * any code uses the FPU.
+ *
+ * FPU_Policy_Benchmark() measures the cost of the three policies with a
+ * software triggered interrupt on the SWPMI1 vector, not used by the
+ * project, in three cases:
+ *
+ *   no_fp       the thread has no FP context (FPCA cleared)
+ *   fp_thread   the thread has an FP context, the handler is integer only
+ *   fp_handler  both use the FPU. The handler executes its FP instruction
+ *               before taking the entry time, so a lazy save is counted in
+ *               the entry like the stacking of the always policy
+ *
+ * Entry is NVIC_STIR write to first handler instruction, exit is last
+ * handler instruction to the first thread instruction after the return, in
+ * CPU cycles (2.08 ns each at 480 MHz). fp_handler is not measured under
+ * FPU_POLICY_OFF: the handler would overwrite the FP registers of the thread.
+ * The build policy is restored at the end.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "fpu_policy.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+#define FPU_BENCH_IRQ               ( SWPMI1_IRQn )
+#define FPU_BENCH_IRQ_PRIORITY      ( 0U )
+
+/************************** Local Variables ****************************/
+
+static uint8_t           Policy = FPU_POLICY ;
+static volatile uint32_t Violations ;
+
+static volatile uint32_t Bench_Entry ;
+static volatile uint32_t Bench_Leave ;
+static volatile uint8_t  Bench_Use_FP ;
+static volatile float    Bench_Value  = 1.0f ;
+static volatile float    Thread_Value = 1.0f ;
+
+/****************************** Functions ******************************/
+
+void FPU_Policy_Init(void)
+{
+	FPU_Policy_Set(FPU_POLICY);
+}
+
+/* FPCCR, ARMv7-M Architecture Reference Manual, B3.2.21 */
+void FPU_Policy_Set(uint8_t policy)
+{
+	uint32_t fpccr = FPU->FPCCR & ~(FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk);
+
+	switch (policy)
+	{
+		case FPU_POLICY_LAZY:   fpccr |= FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk ; break;
+		case FPU_POLICY_ALWAYS: fpccr |= FPU_FPCCR_ASPEN_Msk ;                       break;
+		case FPU_POLICY_OFF:                                                         break;
+		default:                return;
+	}
+	FPU->FPCCR = fpccr ;
+	__DSB();
+	__ISB();
+	Policy = policy;
+}
+
+uint8_t FPU_Policy_Get(void)
+{
+	return Policy;
+}
+
+const char *FPU_Policy_Name(uint8_t policy)
+{
+	switch (policy)
+	{
+		case FPU_POLICY_LAZY:   return "lazy";
+		case FPU_POLICY_ALWAYS: return "always";
+		case FPU_POLICY_OFF:    return "off";
+		default:                return "unknown";
+	}
+}
+
+/* Called by FPU_ISR_EXIT(): the lazy save was pending at entry and has been
+ * done since, an FP instruction ran in the handler or in a nested one
+ */
+FPU_FREE_ISR void FPU_Policy_Check(uint32_t lspact_at_entry)
+{
+	if (lspact_at_entry && !(FPU->FPCCR & FPU_FPCCR_LSPACT_Msk))
+	{
+		Violations++;
+	}
+}
+
+uint32_t FPU_Policy_Violations(void)
+{
+	return Violations;
+}
+
+/* Benchmark handler, on the SWPMI1 vector */
+void FPU_Policy_Bench_IRQHandler(void)
+{
+	if (Bench_Use_FP)
+	{
+		Bench_Value = Bench_Value * 1.0001f;
+	}
+	Bench_Entry = DWT->CYCCNT;
+	Bench_Leave = DWT->CYCCNT;
+}
+
+static void Accumulate(FPU_Latency_t *lat, uint32_t entry, uint32_t exit, uint32_t run, uint64_t sum[2])
+{
+	if ((run == 0U) || (entry < lat->entry_min)) { lat->entry_min = entry; }
+	if ((run == 0U) || (exit  < lat->exit_min))  { lat->exit_min  = exit;  }
+	sum[0] += entry;
+	sum[1] += exit;
+}
+
+static void Measure_Case(uint8_t fp_thread, uint8_t fp_handler, uint32_t runs, FPU_Latency_t *lat)
+{
+	uint64_t sum[2] = { 0U, 0U };
+
+	Bench_Use_FP = fp_handler;
+
+	for (uint32_t run = 0U; run < runs; run++)
+	{
+		uint32_t t0, t1;
+
+		if (fp_thread)
+		{
+			Thread_Value = Thread_Value + 1.0f;  // Sets CONTROL.FPCA
+		}
+		else
+		{
+			__set_CONTROL(__get_CONTROL() & ~CONTROL_FPCA_Msk);
+			__ISB();
+		}
+
+		t0 = DWT->CYCCNT;
+		NVIC->STIR = FPU_BENCH_IRQ ;
+		__DSB();
+		__ISB();
+		t1 = DWT->CYCCNT;
+
+		Accumulate(lat, Bench_Entry - t0, t1 - Bench_Leave, run, sum);
+	}
+
+	lat->entry_avg = runs ? (uint32_t)(sum[0] / runs) : 0U;
+	lat->exit_avg  = runs ? (uint32_t)(sum[1] / runs) : 0U;
+}
+
+/* Entry and exit cost of every policy, runs interrupts per case.
+ * Cycle_Counter_Init() must have been called.
+ */
+void FPU_Policy_Benchmark(uint32_t runs, FPU_Policy_Bench_t results[FPU_POLICY_COUNT])
+{
+	uint8_t saved = Policy;
+
+	/* Step 1: Highest priority, so the other interrupts do not delay it */
+	NVIC_SetPriority(FPU_BENCH_IRQ, FPU_BENCH_IRQ_PRIORITY);
+	NVIC_ClearPendingIRQ(FPU_BENCH_IRQ);
+	NVIC_EnableIRQ(FPU_BENCH_IRQ);
+
+	/* Step 2: Every policy, every case */
+	for (uint8_t policy = 0U; policy < FPU_POLICY_COUNT; policy++)
+	{
+		FPU_Policy_Bench_t *r = &results[policy];
+
+		FPU_Policy_Set(policy);
+		r->policy = policy;
+
+		Measure_Case(0U, 0U, runs, &r->no_fp);
+		Measure_Case(1U, 0U, runs, &r->fp_thread);
+
+		r->fp_handler_valid = (policy != FPU_POLICY_OFF);
+		if (r->fp_handler_valid)
+		{
+			Measure_Case(1U, 1U, runs, &r->fp_handler);
+		}
+		else
+		{
+			r->fp_handler = (FPU_Latency_t){ 0U, 0U, 0U, 0U };
+		}
+	}
+
+	/* Step 3: Back to the build policy */
+	NVIC_DisableIRQ(FPU_BENCH_IRQ);
+	FPU_Policy_Set(saved);
+}
@@ -0,0 +1,101 @@
+/*
+ ******************************************************************************
+ * File              : fpu_policy.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : FPU context save policy and FPU-free interrupt handlers
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 31, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * FPU_POLICY selects the FPCCR set-up of the build, for example with
+ * -DFPU_POLICY=FPU_POLICY_ALWAYS in the compiler flags:
+ *
+ *   FPU_POLICY_LAZY    ASPEN = 1, LSPEN = 1 (reset value). Space for S0..S15
+ *                      and FPSCR is reserved, they are saved only when the
+ *                      handler executes an FP instruction.
+ *   FPU_POLICY_ALWAYS  ASPEN = 1, LSPEN = 0. S0..S15 and FPSCR are stacked on
+ *                      every exception taken with an active FP context.
+ *   FPU_POLICY_OFF     ASPEN = 0, LSPEN = 0. Never stacked, the FP registers
+ *                      of the interrupted code are only safe if no handler
+ *                      uses the FPU.
+ *
+ * FPU_FREE_ISR on a handler makes the compiler keep it off the FP registers.
+ * It only covers the body of the function, functions called from it in
+ * other files need the attribute too. FPU_ISR_ENTER()/FPU_ISR_EXIT() check
+ * at run time under the lazy policy that nothing in the handler (or a
+ * nested one) triggered the lazy save.
+ *
+ ******************************************************************************/
+
+#ifndef _FPU_POLICY_H_
+#define _FPU_POLICY_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+#define FPU_POLICY_LAZY             ( 0U )
+#define FPU_POLICY_ALWAYS           ( 1U )
+#define FPU_POLICY_OFF              ( 2U )
+
+#ifndef FPU_POLICY
+#define FPU_POLICY                  FPU_POLICY_LAZY
+#endif
+
+#define FPU_POLICY_COUNT            ( 3U )
+
+#define FPU_FREE_ISR                __attribute__((target("general-regs-only")))
+
+// LSPACT is still set at exit if the lazy save was not needed
+#define FPU_ISR_ENTER()             uint32_t fpu_lspact_ = FPU->FPCCR & FPU_FPCCR_LSPACT_Msk
+#define FPU_ISR_EXIT()              FPU_Policy_Check(fpu_lspact_)
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	uint32_t entry_min ;  // CPU cycles, software trigger to first handler instruction
+	uint32_t entry_avg ;
+	uint32_t exit_min  ;  // CPU cycles, last handler instruction to back in thread mode
+	uint32_t exit_avg  ;
+} FPU_Latency_t;
+
+/* One row per policy */
+typedef struct
+{
+	uint8_t       policy       ;
+	FPU_Latency_t no_fp        ;  // Thread without FP context, integer handler
+	FPU_Latency_t fp_thread    ;  // Thread with FP context, integer handler
+	FPU_Latency_t fp_handler   ;  // Thread with FP context, handler uses the FPU
+	uint8_t       fp_handler_valid ;  // 0 under FPU_POLICY_OFF, not measured
+} FPU_Policy_Bench_t;
+
+/************************ Function prototypes ***************************/
+void        FPU_Policy_Init(void) ;
+void        FPU_Policy_Set(uint8_t policy) ;
+uint8_t     FPU_Policy_Get(void) ;
+const char *FPU_Policy_Name(uint8_t policy) ;
+void        FPU_Policy_Check(uint32_t lspact_at_entry) ;
+uint32_t    FPU_Policy_Violations(void) ;
+void        FPU_Policy_Benchmark(uint32_t runs, FPU_Policy_Bench_t results[FPU_POLICY_COUNT]) ;
+
+void        FPU_Policy_Bench_IRQHandler(void) ;
+
+#endif /* _FPU_POLICY_H_ */
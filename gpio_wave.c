@@ -0,0 +1,331 @@
+/*
+ ******************************************************************************
+ * File              : gpio_wave.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Timer triggered DMA to GPIO BSRR parallel waveforms
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 26, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Every update event of TIM8 requests one DMA2 stream 0 transfer of a
+ * 32-bit word from the pattern buffer to GPIOx_BSRR. A BSRR word sets the
+ * pins of its low half and resets the pins of its high half in a single
+ * write, so all pins of the bus change on the same AHB4 cycle and the other
+ * pins of the port are not touched (Reference Manual, Page 542).
+ *
+ *   rate = rcc_timy_ker_ck / (ARR + 1)       TIM8 is on APB2
+ *
+ * The stream runs in double buffer mode: while it reads one buffer the CPU
+ * fills the other (GPIO_Wave_Back_Buffer) and commits it. A buffer that is
+ * not committed when the stream comes back to it is played again and
+ * counted as a late commit. ARR is preloaded, GPIO_Wave_Set_Rate() takes
+ * effect on the next update without a short or long word.
+ *
+ * The DMA FIFO reads the pattern ahead, the timer request then only waits
+ * for the AHB4 write. Above some rate the stream cannot serve a request
+ * before the next update and words stretch. GPIO_Wave_Benchmark() finds that
+ * rate for the active clock profile: it times bursts with the cycle counter
+ * and lowers the rate until a burst lasts words x period. The spread of the
+ * burst durations is reported as jitter.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "gpio_wave.h"
+#include "kernel_clock.h"
+#include "clock_profile.h"
+#include "cycle_counter.h"
+#include "dma_alloc.h"
+#include "fpu_policy.h"
+
+/*************************** Macros ************************************/
+
+#define WAVE_TIM                    TIM8
+#define WAVE_DMA                    DMA2_Stream0
+#define WAVE_DMA_HANDLE             DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 0U)
+#define WAVE_DMAREQ_TIM8_UP         ( 51U )             // Reference Manual, Page 695
+#define WAVE_DMA_FLAGS              ( 0x3DUL )          // Stream 0 in LISR / LIFCR
+#define WAVE_BENCH_RUNS             ( 8U )
+#define WAVE_BENCH_TOLERANCE        ( 200U )            // Permille x 10, 2 %
+
+/************************** Local Variables ****************************/
+
+static GPIO_Wave_Config_t Config ;
+static GPIO_Wave_Stats_t  Stats ;
+static uint32_t          *Buf[2] ;
+static volatile uint8_t   Committed[2] ;
+
+static const DMA_Alloc_Request_t Request = { "gpio_wave", 1U, WAVE_DMAREQ_TIM8_UP, DMA_ALLOC_VERY_HIGH };
+
+/* Port clock enable bit, GPIOA..GPIOK are 0x400 apart on AHB4 */
+static void Port_Config(GPIO_TypeDef *port, uint16_t pins)
+{
+	uint32_t index = ((uint32_t)port - GPIOA_BASE) / 0x400UL;
+
+	RCC->AHB4ENR |= 1UL << index ;
+
+	for (uint32_t pin = 0U; pin < 16U; pin++)
+	{
+		if (pins & (1U << pin))
+		{
+			/* Output push-pull, very high speed as in MCO_Pins_Config() */
+			port->MODER    = (port->MODER & ~ (3UL << (2U * pin))) | (1UL << (2U * pin)) ;
+			port->OTYPER  &= ~ (1UL << pin) ;
+			port->OSPEEDR |= (3UL << (2U * pin)) ;
+		}
+	}
+}
+
+static uint32_t Period_For(uint32_t rate_hz)
+{
+	uint32_t period = (Stats.timer_hz + rate_hz / 2U) / rate_hz;
+
+	return (period < 2U) ? 2U : (period > 65536U) ? 65536U : period;
+}
+
+static void Stream_Stop(void)
+{
+	WAVE_TIM->CR1 &= ~ TIM_CR1_CEN ;
+	WAVE_DMA->CR  &= ~ DMA_SxCR_EN ;
+	while( WAVE_DMA->CR & DMA_SxCR_EN ) {}
+	DMA2->LIFCR = WAVE_DMA_FLAGS ;
+}
+
+GPIO_Wave_Status_t GPIO_Wave_Init(const GPIO_Wave_Config_t *config)
+{
+	if ((config->words == 0U) || (config->words > GPIO_WAVE_MAX_WORDS) || (config->rate_hz == 0U) ||
+	    (config->pins == 0U) || (DMA_Alloc_Reserve(WAVE_DMA_HANDLE, &Request) != DMA_ALLOC_OK))
+	{
+		return GPIO_WAVE_ERROR;
+	}
+	Config = *config;
+	Buf[0] = (uint32_t *)GPIO_WAVE_BUFFER_BASE;
+	Buf[1] = Buf[0] + Config.words;
+
+	/* Step 1: Clocks, TIM8 on APB2, DMA2 on AHB1, Reference Manual, Page 464 */
+	RCC->APB2ENR |= RCC_APB2ENR_TIM8EN ;
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN ;
+	Port_Config(Config.port, Config.pins);
+
+	/* Step 2: Both buffers hold the current pin state */
+	for (uint32_t i = 0U; i < 2U * Config.words; i++)
+	{
+		Buf[0][i] = Config.port->ODR & Config.pins;
+	}
+	SCB_CleanDCache_by_Addr(Buf[0], (int32_t)(8U * Config.words));
+	Committed[0] = 1U;
+	Committed[1] = 1U;
+
+	/* Step 3: TIM8 update requests only, preloaded ARR, Reference Manual, Page 1713 */
+	Stats.timer_hz = Kernel_Clock_Hz(KERNEL_CLOCK_TIMY);
+	WAVE_TIM->CR1  = TIM_CR1_ARPE | TIM_CR1_URS ;
+	WAVE_TIM->PSC  = 0U ;
+	WAVE_TIM->ARR  = Period_For(Config.rate_hz) - 1U ;
+	WAVE_TIM->EGR  = TIM_EGR_UG ;
+	WAVE_TIM->SR   = 0U ;
+	WAVE_TIM->DIER = TIM_DIER_UDE ;
+	Stats.rate_hz  = Stats.timer_hz / (WAVE_TIM->ARR + 1U);
+
+	NVIC_SetPriority(DMA2_Stream0_IRQn, 5U);
+	NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+
+	return GPIO_WAVE_OK;
+}
+
+/* values[i] & pins are driven high, the other pins of the mask low */
+void GPIO_Wave_Encode(const uint16_t *values, uint32_t count, uint32_t *bsrr)
+{
+	for (uint32_t i = 0U; i < count; i++)
+	{
+		bsrr[i] = (uint32_t)(values[i] & Config.pins) | ((uint32_t)(~ values[i] & Config.pins) << 16);
+	}
+}
+
+/* Buffer the stream does not read now, fill it then GPIO_Wave_Commit() */
+uint32_t *GPIO_Wave_Back_Buffer(void)
+{
+	uint32_t back = (WAVE_DMA->CR & DMA_SxCR_CT) ? 0U : 1U;
+
+	Committed[back] = 0U;
+	return Buf[back];
+}
+
+void GPIO_Wave_Commit(void)
+{
+	uint32_t back = (WAVE_DMA->CR & DMA_SxCR_CT) ? 0U : 1U;
+
+	SCB_CleanDCache_by_Addr(Buf[back], (int32_t)(4U * Config.words));
+	Committed[back] = 1U;
+}
+
+GPIO_Wave_Status_t GPIO_Wave_Start(void)
+{
+	if (WAVE_DMA->CR & DMA_SxCR_EN)
+	{
+		return GPIO_WAVE_ERROR;
+	}
+
+	/* Step 1: Memory to peripheral, double buffer, FIFO full threshold,
+	 * Reference Manual, Page 653
+	 */
+	WAVE_DMA->PAR  = (uint32_t)&Config.port->BSRR ;
+	WAVE_DMA->M0AR = (uint32_t)Buf[0] ;
+	WAVE_DMA->M1AR = (uint32_t)Buf[1] ;
+	WAVE_DMA->NDTR = Config.words ;
+	WAVE_DMA->FCR  = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH ;
+	WAVE_DMA->CR   = DMA_SxCR_DBM | DMA_SxCR_PL | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC |
+	                 DMA_SxCR_DIR_0 | DMA_SxCR_TCIE | DMA_SxCR_TEIE | DMA_SxCR_FEIE ;
+	WAVE_DMA->CR  |= DMA_SxCR_EN ;
+
+	/* Step 2: Start the timer, the first word goes out after one period */
+	WAVE_TIM->CNT  = 0U ;
+	WAVE_TIM->CR1 |= TIM_CR1_CEN ;
+
+	return GPIO_WAVE_OK;
+}
+
+void GPIO_Wave_Stop(void)
+{
+	Stream_Stop();
+}
+
+/* New rate from the next update, returns the achieved rate */
+uint32_t GPIO_Wave_Set_Rate(uint32_t rate_hz)
+{
+	if (rate_hz == 0U)
+	{
+		return Stats.rate_hz;
+	}
+	WAVE_TIM->ARR = Period_For(rate_hz) - 1U ;
+	Stats.rate_hz = Stats.timer_hz / (WAVE_TIM->ARR + 1U);
+	return Stats.rate_hz;
+}
+
+void GPIO_Wave_Get_Stats(GPIO_Wave_Stats_t *stats)
+{
+	*stats = Stats;
+}
+
+/* One burst of words at period timer clocks, returns CPU cycles, 0 on timeout */
+static uint32_t Burst(uint16_t words, uint32_t period)
+{
+	uint32_t start, timeout;
+
+	WAVE_TIM->ARR  = period - 1U ;
+	WAVE_TIM->EGR  = TIM_EGR_UG ;
+	WAVE_TIM->CNT  = 0U ;
+
+	WAVE_DMA->M0AR = (uint32_t)Buf[0] ;
+	WAVE_DMA->NDTR = words ;
+	WAVE_DMA->FCR  = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH ;
+	WAVE_DMA->CR   = DMA_SxCR_PL | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC | DMA_SxCR_DIR_0 ;
+	WAVE_DMA->CR  |= DMA_SxCR_EN ;
+
+	/* Let the FIFO fill, as in streaming */
+	while( (WAVE_DMA->FCR & DMA_SxFCR_FS) != (DMA_SxFCR_FS_2 | DMA_SxFCR_FS_0) ) {}
+
+	timeout = SystemCoreClock / 100U;
+	start   = Cycle_Counter_Get();
+	WAVE_TIM->CR1 |= TIM_CR1_CEN ;
+	while (!(DMA2->LISR & DMA_LISR_TCIF0))
+	{
+		if ((Cycle_Counter_Get() - start) > timeout)
+		{
+			Stream_Stop();
+			return 0U;
+		}
+	}
+	start = Cycle_Counter_Get() - start;
+
+	Stream_Stop();
+	return start;
+}
+
+/* Highest rate without missed requests for the active clock profile, see
+ * the comments on top. The streaming engine is stopped, the pins toggle
+ * with buffer 0.
+ */
+GPIO_Wave_Status_t GPIO_Wave_Benchmark(uint16_t words, GPIO_Wave_Bench_t *bench)
+{
+	if ((words < 16U) || (words > Config.words) || (Stats.timer_hz == 0U))
+	{
+		return GPIO_WAVE_ERROR;
+	}
+	Stream_Stop();
+
+	bench->profile_id  = Clock_Profile_Active()->profile_id;
+	bench->cpu_hz      = SystemCoreClock;
+	bench->timer_hz    = Stats.timer_hz;
+	bench->max_rate_hz = 0U;
+
+	for (uint32_t period = 2U; period <= 256U; period++)
+	{
+		uint64_t expected = ((uint64_t)words * period * SystemCoreClock) / Stats.timer_hz;
+		uint32_t min = UINT32_MAX, max = 0U;
+
+		for (uint32_t run = 0U; run < WAVE_BENCH_RUNS; run++)
+		{
+			uint32_t cycles = Burst(words, period);
+
+			min = (cycles < min) ? cycles : min;
+			max = (cycles > max) ? cycles : max;
+		}
+
+		/* The slowest burst within tolerance of words x period: no request missed */
+		if ((min != 0U) && ((uint64_t)max * 10000U <= expected * (10000U + WAVE_BENCH_TOLERANCE)))
+		{
+			bench->min_period  = period;
+			bench->max_rate_hz = Stats.timer_hz / period;
+			bench->jitter_ns   = Cycle_Counter_To_Ns(max - min);
+			break;
+		}
+	}
+
+	WAVE_TIM->ARR = Period_For(Stats.rate_hz) - 1U ;
+	WAVE_TIM->EGR = TIM_EGR_UG ;
+
+	return (bench->max_rate_hz != 0U) ? GPIO_WAVE_OK : GPIO_WAVE_ERROR;
+}
+
+FPU_FREE_ISR void GPIO_Wave_DMA_IRQHandler(void)
+{
+	uint32_t isr = DMA2->LISR;
+
+	if (isr & (DMA_LISR_TEIF0 | DMA_LISR_FEIF0))
+	{
+		DMA2->LIFCR = DMA_LIFCR_CTEIF0 | DMA_LIFCR_CFEIF0 ;
+		Stats.dma_errors++;
+	}
+
+	if (isr & DMA_LISR_TCIF0)
+	{
+		uint32_t next = (WAVE_DMA->CR & DMA_SxCR_CT) ? 1U : 0U;
+
+		DMA2->LIFCR = DMA_LIFCR_CTCIF0 ;
+		DMA_Alloc_Account(WAVE_DMA_HANDLE, 4U * Config.words);
+		Stats.swaps++;
+
+		/* The stream has started on a buffer that was still being written */
+		if (!Committed[next])
+		{
+			Stats.late_commits++;
+		}
+	}
+}
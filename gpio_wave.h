@@ -0,0 +1,85 @@
+/*
+ ******************************************************************************
+ * File              : gpio_wave.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Timer triggered DMA to GPIO BSRR parallel waveforms
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 26, 2026
+ ******************************************************************************/
+
+#ifndef _GPIO_WAVE_H_
+#define _GPIO_WAVE_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+/* Two pattern buffers of BSRR words in D3 SRAM4, after the DFSDM buffers */
+#define GPIO_WAVE_BUFFER_BASE       ( 0x38004000UL )
+#define GPIO_WAVE_BUFFER_SIZE       ( 0x00004000UL )
+#define GPIO_WAVE_MAX_WORDS         ( GPIO_WAVE_BUFFER_SIZE / 8U )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	GPIO_WAVE_OK = 0 ,
+	GPIO_WAVE_ERROR     // Bad buffer length or rate, engine running
+} GPIO_Wave_Status_t;
+
+typedef struct
+{
+	GPIO_TypeDef *port    ;  // GPIOA..GPIOK
+	uint16_t      pins    ;  // Mask of the pins driven by the patterns
+	uint32_t      rate_hz ;  // Words per second
+	uint16_t      words   ;  // BSRR words per buffer, 1..GPIO_WAVE_MAX_WORDS
+} GPIO_Wave_Config_t;
+
+typedef struct
+{
+	uint32_t timer_hz     ;  // rcc_timy_ker_ck
+	uint32_t rate_hz      ;  // Achieved, timer_hz / (ARR + 1)
+	uint32_t swaps        ;  // Buffers completed
+	uint32_t late_commits ;  // Buffer replayed because it was not committed in time
+	uint32_t dma_errors   ;
+} GPIO_Wave_Stats_t;
+
+typedef struct
+{
+	uint32_t profile_id     ;  // Active clock profile
+	uint32_t cpu_hz         ;
+	uint32_t timer_hz       ;
+	uint32_t max_rate_hz    ;  // Highest rate where no timer request was missed
+	uint32_t min_period     ;  // Timer clocks per word at max_rate_hz
+	uint32_t jitter_ns      ;  // Spread of the burst duration at max_rate_hz
+} GPIO_Wave_Bench_t;
+
+/************************ Function prototypes ***************************/
+GPIO_Wave_Status_t GPIO_Wave_Init(const GPIO_Wave_Config_t *config) ;
+void               GPIO_Wave_Encode(const uint16_t *values, uint32_t count, uint32_t *bsrr) ;
+uint32_t          *GPIO_Wave_Back_Buffer(void) ;
+void               GPIO_Wave_Commit(void) ;
+GPIO_Wave_Status_t GPIO_Wave_Start(void) ;
+void               GPIO_Wave_Stop(void) ;
+uint32_t           GPIO_Wave_Set_Rate(uint32_t rate_hz) ;
+void               GPIO_Wave_Get_Stats(GPIO_Wave_Stats_t *stats) ;
+GPIO_Wave_Status_t GPIO_Wave_Benchmark(uint16_t words, GPIO_Wave_Bench_t *bench) ;
+
+void               GPIO_Wave_DMA_IRQHandler(void) ;
+
+#endif /* _GPIO_WAVE_H_ */
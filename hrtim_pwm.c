@@ -0,0 +1,412 @@
+/*
+ ******************************************************************************
+ * File              : hrtim_pwm.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : HRTIM PWM engine clocked from the CPU clock
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 27, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Chapter 37, High-Resolution Timer (HRTIM)
+ *
+ * HRTIMSEL in RCC_CFGR selects the HRTIM clock: 0 rcc_timy_ker_ck (APB2
+ * timer clock, 240 MHz at most), 1 c_ck, the CPU clock (480 MHz in VOS0).
+ * The STM32H7 HRTIM has no DLL, so there is no calibration to run and
+ * no x32 interpolation: the resolution is one fHRCK period, 2.08 ns at
+ * 480 MHz. CKPSC = 5, 6, 7 give fHRCK = fHRTIM, /2, /4 (0 to 4 are not
+ * available on this device), the smallest that fits the period is used.
+ *
+ * The master timer sets the PWM period, timers A..E are reset by the master
+ * period event and all counters are started by one write to MCR, so every
+ * output is synchronous. Output 1 of timer x is set on CMP1 (phase) and
+ * reset on CMP2 (phase + duty, modulo the period). With a dead time,
+ * output 2 is the complement of output 1 with rising and falling edges
+ * delayed by the dead time generator.
+ *
+ * All period and compare registers are preloaded (PREEN). Master and timers
+ * transfer them on the master repetition / timer reset, so a new period or
+ * duty never gives a short pulse. HRTIM_PWM_Stream() feeds the preload
+ * registers from memory with the burst DMA: on every master repetition the
+ * HRTIM requests the DMA until HRTIM_BDMADR has received every register
+ * selected in HRTIM_BDMUPR and HRTIM_BDTxUPR, Reference Manual, Page 1451.
+ *
+ * Burst mode idles the outputs for idle_periods out of burst_periods PWM
+ * periods, for light load. FLT1 (active high) forces every output to its
+ * inactive state within a few ns, without the CPU.
+ *
+ * Pins: A1 PC6, A2 PC7, B1 PC8 (AF1), B2 PA8, C1 PA9, C2 PA10, D1 PA11,
+ * D2 PA12, E1 PG6, E2 PG7, FLT1 PA15 (AF2). B2 is also MCO1, C1 to D2 are
+ * the USB OTG FS pins. Check the schematic.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "hrtim_pwm.h"
+#include "kernel_clock.h"
+#include "dma_alloc.h"
+#include "fpu_policy.h"
+
+/*************************** Macros ************************************/
+
+#define HRTIM_DMA                   DMA2_Stream1
+#define HRTIM_DMA_HANDLE            DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 1U)
+#define HRTIM_DMAREQ_MASTER         ( 95U )             // hrtim_dma1, Reference Manual, Page 695
+#define HRTIM_CKPSC_DIV1            ( 5U )
+#define HRTIM_COMPARE_MIN           ( 3U )              // Reference Manual, Page 1405
+
+/* Burst DMA update sequences in D3 SRAM4, after the GPIO waveform buffers */
+#define HRTIM_BUFFER_BASE           ( 0x38008000UL )
+#define HRTIM_BUFFER_SIZE           ( 0x00002000UL )
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	GPIO_TypeDef *port ;
+	uint8_t       pin  ;
+	uint8_t       af   ;
+} Pin_t;
+
+/************************** Local Variables ****************************/
+
+static HRTIM_Timerx_TypeDef * const Timers[HRTIM_PWM_TIMERS] =
+{
+	HRTIM1_TIMA, HRTIM1_TIMB, HRTIM1_TIMC, HRTIM1_TIMD, HRTIM1_TIME
+};
+
+// Outputs 1 and 2 of timers A..E
+static const Pin_t Pins[HRTIM_PWM_TIMERS][2] =
+{
+	{ { GPIOC,  6U, 1U }, { GPIOC,  7U, 1U } },
+	{ { GPIOC,  8U, 1U }, { GPIOA,  8U, 2U } },
+	{ { GPIOA,  9U, 2U }, { GPIOA, 10U, 2U } },
+	{ { GPIOA, 11U, 2U }, { GPIOA, 12U, 2U } },
+	{ { GPIOG,  6U, 2U }, { GPIOG,  7U, 2U } },
+};
+
+static const Pin_t Fault_Pin = { GPIOA, 15U, 2U };
+
+static HRTIM_PWM_Config_t Config ;
+static HRTIM_PWM_Info_t   Info ;
+static uint32_t           Outputs ;   // OENR bits of the enabled outputs
+static uint32_t           Stream_Bytes ;
+
+static const DMA_Alloc_Request_t Request = { "hrtim_master", 1U, HRTIM_DMAREQ_MASTER, DMA_ALLOC_HIGH };
+
+static void Pin_Config(const Pin_t *p)
+{
+	uint32_t index = ((uint32_t)p->port - GPIOA_BASE) / 0x400UL;
+
+	RCC->AHB4ENR |= 1UL << index ;
+
+	p->port->MODER    = (p->port->MODER & ~ (3UL << (2U * p->pin))) | (2UL << (2U * p->pin)) ;
+	p->port->OSPEEDR |= (3UL << (2U * p->pin)) ;
+	p->port->AFR[p->pin >> 3] = (p->port->AFR[p->pin >> 3] & ~ (0xFUL << (4U * (p->pin & 7U)))) |
+	                            ((uint32_t)p->af << (4U * (p->pin & 7U))) ;
+}
+
+uint32_t HRTIM_PWM_Ns_To_Ticks(uint32_t ns)
+{
+	return (uint32_t)(((uint64_t)ns * (Info.hrtim_hz / Info.prescaler) + 500000000ULL) / 1000000000ULL);
+}
+
+/* Dead time generator, tDTG = tHRTIM x 2^(DTPRSC - 3), 9-bit rising and
+ * falling values, Reference Manual, Page 1417
+ */
+static uint32_t Dead_Time(uint32_t ns)
+{
+	uint64_t ticks = ((uint64_t)ns * Info.hrtim_hz + 999999999ULL) / 1000000000ULL;
+	uint32_t prsc  = 3U;
+
+	while ((ticks > 511U) && (prsc < 7U))
+	{
+		ticks = (ticks + 1U) / 2U;
+		prsc++;
+	}
+	ticks = (ticks > 511U) ? 511U : ticks;
+
+	return (prsc << HRTIM_DTR_DTPRSC_Pos) | ((uint32_t)ticks << HRTIM_DTR_DTR_Pos) | ((uint32_t)ticks << HRTIM_DTR_DTF_Pos);
+}
+
+HRTIM_PWM_Status_t HRTIM_PWM_Init(const HRTIM_PWM_Config_t *config)
+{
+	uint32_t period = 0U;
+	uint32_t psc;
+	uint32_t mcr;
+
+	if ((config->timers == 0U) || (config->timers >= (1U << HRTIM_PWM_TIMERS)) || (config->frequency_hz == 0U) ||
+	    (DMA_Alloc_Reserve(HRTIM_DMA_HANDLE, &Request) != DMA_ALLOC_OK))
+	{
+		return HRTIM_PWM_ERROR;
+	}
+	Config = *config;
+
+	/* Step 1: HRTIMSEL = 1, CPU clock, then the bus clock, Reference Manual, Page 390 */
+	RCC->CFGR    |= RCC_CFGR_HRTIMSEL ;
+	RCC->APB2ENR |= RCC_APB2ENR_HRTIMEN ;
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN ;
+	Info.cpu_clock = 1U;
+	Info.hrtim_hz  = Kernel_Clock_Hz(KERNEL_CLOCK_CPU);
+
+	/* Step 2: Smallest prescaler where the period fits */
+	for (psc = HRTIM_CKPSC_DIV1; psc <= 7U; psc++)
+	{
+		Info.prescaler = (uint8_t)(1U << (psc - HRTIM_CKPSC_DIV1));
+		period = (Info.hrtim_hz / Info.prescaler + config->frequency_hz / 2U) / config->frequency_hz;
+		if (period <= HRTIM_PWM_PERIOD_MAX)
+		{
+			break;
+		}
+	}
+	if ((psc > 7U) || (period < (2U * HRTIM_COMPARE_MIN)))
+	{
+		DMA_Alloc_Release(HRTIM_DMA_HANDLE);
+		return HRTIM_PWM_ERROR;
+	}
+	Info.period        = period;
+	Info.frequency_hz  = Info.hrtim_hz / Info.prescaler / period;
+	Info.resolution_ps = (uint32_t)((1000000000000ULL * Info.prescaler) / Info.hrtim_hz);
+	Info.duty_bits     = 0U;
+	while ((2UL << Info.duty_bits) <= period)
+	{
+		Info.duty_bits++;
+	}
+
+	/* Step 3: Master timer, continuous, preload transferred on repetition */
+	HRTIM1->sMasterRegs.MCR   = (psc << HRTIM_MCR_CK_PSC_Pos) | HRTIM_MCR_CONT | HRTIM_MCR_PREEN | HRTIM_MCR_MREPU ;
+	HRTIM1->sMasterRegs.MPER  = period ;
+	HRTIM1->sMasterRegs.MREP  = 0U ;
+
+	/* Step 4: Timers A..E reset by the master period, 50 % duty, no phase */
+	Outputs = 0U;
+	for (uint32_t i = 0U; i < HRTIM_PWM_TIMERS; i++)
+	{
+		HRTIM_Timerx_TypeDef *t = Timers[i];
+
+		if (!(config->timers & (1U << i)))
+		{
+			continue;
+		}
+
+		t->TIMxCR  = (psc << HRTIM_TIMCR_CK_PSC_Pos) | HRTIM_TIMCR_CONT | HRTIM_TIMCR_PREEN | HRTIM_TIMCR_TRSTU ;
+		t->PERxR   = period ;
+		t->CMP1xR  = HRTIM_COMPARE_MIN ;
+		t->CMP2xR  = HRTIM_COMPARE_MIN + period / 2U ;
+		t->RSTxR   = HRTIM_RSTR_MSTPER ;
+		t->SETx1R  = HRTIM_SET1R_CMP1 ;
+		t->RSTx1R  = HRTIM_RST1R_CMP2 ;
+
+		/* Outputs inactive in burst idle and on fault */
+		t->OUTxR   = HRTIM_OUTR_IDLM1 | HRTIM_OUTR_IDLM2 | HRTIM_OUTR_FAULT1_0 | HRTIM_OUTR_FAULT2_0 ;
+		Outputs   |= 1UL << (2U * i);
+		Pin_Config(&Pins[i][0]);
+
+		if (config->deadtime_ns != 0U)
+		{
+			t->DTxR   = Dead_Time(config->deadtime_ns) ;
+			t->OUTxR |= HRTIM_OUTR_DTEN ;
+			Outputs  |= 2UL << (2U * i);
+			Pin_Config(&Pins[i][1]);
+		}
+
+		if (config->fault)
+		{
+			t->FLTxR = HRTIM_FLTR_FLT1EN ;
+		}
+	}
+
+	/* Step 5: Fault 1 from its pin, active high, no filter, Reference Manual, Page 1436 */
+	if (config->fault)
+	{
+		Pin_Config(&Fault_Pin);
+		HRTIM1_COMMON->FLTINR1 = HRTIM_FLTINR1_FLT1E | HRTIM_FLTINR1_FLT1P ;
+		HRTIM1_COMMON->ICR     = HRTIM_ICR_FLT1C ;
+		HRTIM1_COMMON->IER    |= HRTIM_IER_FLT1 ;
+		NVIC_SetPriority(HRTIM1_FLT_IRQn, 0U);
+		NVIC_EnableIRQ(HRTIM1_FLT_IRQn);
+	}
+
+	/* Step 6: Enable the outputs, then start master and timers in one write */
+	HRTIM1_COMMON->OENR = Outputs ;
+	mcr = HRTIM_MCR_MCEN;
+	for (uint32_t i = 0U; i < HRTIM_PWM_TIMERS; i++)
+	{
+		if (config->timers & (1U << i))
+		{
+			mcr |= HRTIM_MCR_TACEN << i;
+		}
+	}
+	HRTIM1->sMasterRegs.MCR |= mcr ;
+
+	return HRTIM_PWM_OK;
+}
+
+/* Phase and duty in fHRCK periods, taken at the next period */
+HRTIM_PWM_Status_t HRTIM_PWM_Set(uint8_t timer, uint32_t phase, uint32_t duty)
+{
+	HRTIM_Timerx_TypeDef *t;
+	uint32_t              set, reset;
+
+	if ((timer >= HRTIM_PWM_TIMERS) || !(Config.timers & (1U << timer)))
+	{
+		return HRTIM_PWM_ERROR;
+	}
+	t = Timers[timer];
+
+	set   = (phase % Info.period < HRTIM_COMPARE_MIN) ? HRTIM_COMPARE_MIN : (phase % Info.period);
+	reset = (set + duty) % Info.period;
+	reset = (reset < HRTIM_COMPARE_MIN) ? HRTIM_COMPARE_MIN : reset;
+
+	t->CMP1xR = set ;
+	t->CMP2xR = reset ;
+
+	/* 0 %: never set, 100 %: never reset */
+	t->SETx1R = (duty == 0U)           ? 0U : HRTIM_SET1R_CMP1 ;
+	t->RSTx1R = (duty >= Info.period)  ? 0U : HRTIM_RST1R_CMP2 ;
+
+	return HRTIM_PWM_OK;
+}
+
+/* Play count update sequences, one per PWM period, in a loop */
+HRTIM_PWM_Status_t HRTIM_PWM_Stream(const HRTIM_PWM_Update_t *updates, uint16_t count)
+{
+	__IO uint32_t *bdtupr[HRTIM_PWM_TIMERS] =
+	{
+		&HRTIM1_COMMON->BDTAUPR, &HRTIM1_COMMON->BDTBUPR, &HRTIM1_COMMON->BDTCUPR,
+		&HRTIM1_COMMON->BDTDUPR, &HRTIM1_COMMON->BDTEUPR
+	};
+	uint32_t *buf   = (uint32_t *)HRTIM_BUFFER_BASE;
+	uint32_t  words = 1U;
+	uint32_t  n     = 0U;
+
+	for (uint32_t i = 0U; i < HRTIM_PWM_TIMERS; i++)
+	{
+		words += (Config.timers & (1U << i)) ? 3U : 0U;
+	}
+
+	/* Step 1: Stop a running sequence */
+	HRTIM1->sMasterRegs.MDIER &= ~ HRTIM_MDIER_MREPDE ;
+	HRTIM_DMA->CR &= ~ DMA_SxCR_EN ;
+	while( HRTIM_DMA->CR & DMA_SxCR_EN ) {}
+	DMA2->LIFCR = 0x00000F40UL ;   // All flags of stream 1
+
+	if ((count == 0U) || ((4UL * words * count) > HRTIM_BUFFER_SIZE))
+	{
+		return (count == 0U) ? HRTIM_PWM_OK : HRTIM_PWM_ERROR;
+	}
+
+	/* Step 2: Pack the updates, burst order is master then timers A..E */
+	for (uint32_t u = 0U; u < count; u++)
+	{
+		buf[n++] = updates[u].master_period;
+		for (uint32_t i = 0U; i < HRTIM_PWM_TIMERS; i++)
+		{
+			if (Config.timers & (1U << i))
+			{
+				buf[n++] = updates[u].timer[i][0];
+				buf[n++] = updates[u].timer[i][1];
+				buf[n++] = updates[u].timer[i][2];
+			}
+		}
+	}
+	SCB_CleanDCache_by_Addr(buf, (int32_t)(4U * n));
+
+	/* Step 3: Registers written by the burst DMA, Reference Manual, Page 1485 */
+	HRTIM1_COMMON->BDMUPR = HRTIM_BDMUPR_MPER ;
+	for (uint32_t i = 0U; i < HRTIM_PWM_TIMERS; i++)
+	{
+		*bdtupr[i] = (Config.timers & (1U << i)) ?
+		             (HRTIM_BDTUPR_TIMPER | HRTIM_BDTUPR_TIMCMP1 | HRTIM_BDTUPR_TIMCMP2) : 0U ;
+	}
+
+	/* Step 4: Circular DMA to HRTIM_BDMADR on the master repetition request */
+	Stream_Bytes      = 4U * n ;
+	HRTIM_DMA->PAR    = (uint32_t)&HRTIM1_COMMON->BDMADR ;
+	HRTIM_DMA->M0AR   = (uint32_t)buf ;
+	HRTIM_DMA->NDTR   = n ;
+	HRTIM_DMA->FCR    = 0U ;
+	HRTIM_DMA->CR     = DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC | DMA_SxCR_CIRC |
+	                    DMA_SxCR_DIR_0 | DMA_SxCR_TCIE | DMA_SxCR_TEIE ;
+	HRTIM_DMA->CR    |= DMA_SxCR_EN ;
+
+	NVIC_SetPriority(DMA2_Stream1_IRQn, 5U);
+	NVIC_EnableIRQ(DMA2_Stream1_IRQn);
+
+	HRTIM1->sMasterRegs.MDIER |= HRTIM_MDIER_MREPDE ;
+
+	return HRTIM_PWM_OK;
+}
+
+/* Outputs idle for idle_periods of every burst_periods PWM periods,
+ * burst mode clock is the master period. idle_periods = 0 stops it.
+ * Reference Manual, Page 1440
+ */
+void HRTIM_PWM_Burst(uint16_t idle_periods, uint16_t burst_periods)
+{
+	HRTIM1_COMMON->BMCR &= ~ HRTIM_BMCR_BME ;
+	if ((idle_periods == 0U) || (idle_periods >= burst_periods))
+	{
+		return;
+	}
+
+	HRTIM1_COMMON->BMCMPR = idle_periods ;
+	HRTIM1_COMMON->BMPER  = burst_periods - 1U ;
+	HRTIM1_COMMON->BMCR   = HRTIM_BMCR_BMOM ;        // Continuous, BMCLK = 0: master period
+	HRTIM1_COMMON->BMCR  |= HRTIM_BMCR_BME ;
+	HRTIM1_COMMON->BMTRGR = HRTIM_BMTRGR_SW ;
+}
+
+/* The fault disables the outputs (OENR), enable them again */
+void HRTIM_PWM_Fault_Clear(void)
+{
+	HRTIM1_COMMON->ICR  = HRTIM_ICR_FLT1C ;
+	HRTIM1_COMMON->OENR = Outputs ;
+}
+
+void HRTIM_PWM_Get_Info(HRTIM_PWM_Info_t *info)
+{
+	*info = Info;
+}
+
+void HRTIM_PWM_Fault_IRQHandler(void)
+{
+	if (HRTIM1_COMMON->ISR & HRTIM_ISR_FLT1)
+	{
+		HRTIM1_COMMON->ICR = HRTIM_ICR_FLT1C ;
+		Info.faults++;
+	}
+}
+
+FPU_FREE_ISR void HRTIM_PWM_DMA_IRQHandler(void)
+{
+	uint32_t isr = DMA2->LISR;
+
+	if (isr & DMA_LISR_TEIF1)
+	{
+		DMA2->LIFCR = DMA_LIFCR_CTEIF1 ;
+		Info.dma_errors++;
+	}
+	if (isr & DMA_LISR_TCIF1)
+	{
+		DMA2->LIFCR = DMA_LIFCR_CTCIF1 ;
+		DMA_Alloc_Account(HRTIM_DMA_HANDLE, Stream_Bytes);
+		Info.updates++;
+	}
+}
@@ -0,0 +1,94 @@
+/*
+ ******************************************************************************
+ * File              : hrtim_pwm.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : HRTIM PWM engine clocked from the CPU clock
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 27, 2026
+ ******************************************************************************/
+
+#ifndef _HRTIM_PWM_H_
+#define _HRTIM_PWM_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+#define HRTIM_PWM_TIMERS            ( 5U )      // Timers A..E
+
+#define HRTIM_PWM_TIMER_A           ( 1U << 0 )
+#define HRTIM_PWM_TIMER_B           ( 1U << 1 )
+#define HRTIM_PWM_TIMER_C           ( 1U << 2 )
+#define HRTIM_PWM_TIMER_D           ( 1U << 3 )
+#define HRTIM_PWM_TIMER_E           ( 1U << 4 )
+
+// Largest period, Reference Manual, Page 1405
+#define HRTIM_PWM_PERIOD_MAX        ( 0xFFDFU )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	HRTIM_PWM_OK = 0 ,
+	HRTIM_PWM_ERROR     // Frequency out of range, timer not enabled
+} HRTIM_PWM_Status_t;
+
+typedef struct
+{
+	uint8_t  timers        ;  // HRTIM_PWM_TIMER_x mask
+	uint32_t frequency_hz  ;  // Common PWM frequency, master timer period
+	uint16_t deadtime_ns   ;  // Complementary output 2 with dead time, 0: output 1 only
+	uint8_t  fault         ;  // 1: FLT1 input (active high) forces the outputs inactive
+} HRTIM_PWM_Config_t;
+
+/* One DMA update: master period then, for each enabled timer in A..E
+ * order, period, compare 1 (output set) and compare 2 (output reset)
+ */
+typedef struct
+{
+	uint32_t master_period ;
+	uint32_t timer[HRTIM_PWM_TIMERS][3] ;
+} HRTIM_PWM_Update_t;
+
+typedef struct
+{
+	uint32_t hrtim_hz       ;  // fHRTIM, CPU clock when HRTIMSEL = 1
+	uint8_t  cpu_clock      ;  // 1: HRTIMSEL selects the CPU clock
+	uint8_t  prescaler      ;  // fHRCK = fHRTIM / prescaler
+	uint32_t resolution_ps  ;  // One fHRCK period
+	uint32_t period         ;  // fHRCK periods per PWM period
+	uint8_t  duty_bits      ;  // Effective duty resolution, log2(period)
+	uint32_t frequency_hz   ;  // Achieved
+	uint32_t updates        ;  // DMA update sequences completed
+	uint32_t faults         ;
+	uint32_t dma_errors     ;
+} HRTIM_PWM_Info_t;
+
+/************************ Function prototypes ***************************/
+HRTIM_PWM_Status_t HRTIM_PWM_Init(const HRTIM_PWM_Config_t *config) ;
+HRTIM_PWM_Status_t HRTIM_PWM_Set(uint8_t timer, uint32_t phase, uint32_t duty) ;
+uint32_t           HRTIM_PWM_Ns_To_Ticks(uint32_t ns) ;
+HRTIM_PWM_Status_t HRTIM_PWM_Stream(const HRTIM_PWM_Update_t *updates, uint16_t count) ;
+void               HRTIM_PWM_Burst(uint16_t idle_periods, uint16_t burst_periods) ;
+void               HRTIM_PWM_Fault_Clear(void) ;
+void               HRTIM_PWM_Get_Info(HRTIM_PWM_Info_t *info) ;
+
+void               HRTIM_PWM_Fault_IRQHandler(void) ;
+void               HRTIM_PWM_DMA_IRQHandler(void) ;
+
+#endif /* _HRTIM_PWM_H_ */
@@ -0,0 +1,583 @@
+/*
+ ******************************************************************************
+ * File              : i2c_engine.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : I2C1 master, queued DMA transactions, TIMINGR from the kernel clock
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 7, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Chapter 50, Inter-integrated circuit
+ * interface (I2C)
+ *
+ * TIMINGR: the I2C kernel clock is the one selected by I2C123SEL, rcc_pclk1
+ * after reset, so it follows Clock_Profile_Apply(), SystemClock_Config() and
+ * the throttle levels. Before every transaction the kernel clock is read
+ * from the RCC registers (Kernel_Clock_Hz); when it differs from the one of
+ * the TIMINGR in force, I2C_Timing_Compute() runs again and TIMINGR and the
+ * SCL low timeout are written with PE clear, between two transactions. No
+ * notifier to register, and a clock change from any path is caught. A
+ * change in the middle of a transaction only stretches it: every time
+ * scales with the kernel clock, the minimum times still hold.
+ *
+ * Transactions are queued by pointer (I2C_ENGINE_QUEUE) and run one after
+ * the other from the interrupt, without the CPU between the bytes:
+ *
+ *   write        CR2 = NBYTES, AUTOEND, START          TX DMA feeds TXDR
+ *   write+read   CR2 = NBYTES, START (no AUTOEND)       TX DMA feeds TXDR
+ *                TC: CR2 = RD_WRN, NBYTES, AUTOEND, START (repeated START)
+ *   read         CR2 = RD_WRN, NBYTES, AUTOEND, START  RX DMA empties RXDR
+ *   STOPF        transaction done, the next one starts from the interrupt
+ *
+ * A NACK makes the peripheral send STOP itself, the transaction ends on
+ * STOPF with I2C_ENGINE_ERR_NACK. Bus error, arbitration loss and the SCL
+ * low timeout (I2C_ENGINE_TIMEOUT_US, TIMEOUTA) reset the peripheral with PE
+ * and end the transaction with I2C_ENGINE_ERR_BUS. The timeout also ends a
+ * transaction that stalls on a DMA error.
+ *
+ * The DMA streams come from DMA_Alloc_Request(), no DMA interrupt is used:
+ * TC and STOPF of the I2C tell when the bytes are through. The data goes
+ * through bounce buffers in D3 SRAM4, so the callers' buffers can be in
+ * DTCM and need no cache maintenance.
+ *
+ * Fast-mode Plus sets the 20 mA drive (I2C1_FMP in SYSCFG_PMCR), the
+ * pull-ups must be sized for 1 MHz (tr at most 120 ns).
+ *
+ * I2C_Engine_Benchmark() keeps the queue full of register reads at Fast-mode
+ * Plus and measures the bus utilisation: payload bits over the elapsed time
+ * at 1 Mbit/s, and the share of the time with a transaction on the bus.
+ * tools/i2c_timing_tool.c gives the protocol limit for the same shapes.
+ *
+ * Pins, AF4, open drain: PB6 SCL, PB7 SDA. Check the schematic.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "stm32h7xx.h"
+#include "i2c_engine.h"
+#include "dma_alloc.h"
+#include "timebase.h"
+
+/*************************** Macros ************************************/
+
+#define I2C_DMAREQ_RX               ( 33U )    // i2c1_rx_dma, Reference Manual, DMAMUX1 request table
+#define I2C_DMAREQ_TX               ( 34U )    // i2c1_tx_dma
+#define I2C_AF                      ( 4U )
+#define I2C_SCL_PIN                 ( 6U )     // PB6
+#define I2C_SDA_PIN                 ( 7U )     // PB7
+#define I2C_QUEUE_MASK              ( I2C_ENGINE_QUEUE - 1U )
+
+// TIMEOUTA counts 2048 kernel clocks, 12 bits, Reference Manual, I2C_TIMEOUTR
+#define I2C_TIMEOUTA(hz)            ( (uint32_t)(((uint64_t)(hz) * I2C_ENGINE_TIMEOUT_US) / (2048ULL * 1000000ULL)) )
+
+#define I2C_CR1_ENGINE              ( I2C_CR1_ERRIE | I2C_CR1_TCIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE | \
+                                      I2C_CR1_TXDMAEN | I2C_CR1_RXDMAEN )
+
+/************************** Local Variables ****************************/
+
+static const DMA_Alloc_Request_t Tx_Request = { "i2c1_tx", 1U, I2C_DMAREQ_TX, DMA_ALLOC_MEDIUM };
+static const DMA_Alloc_Request_t Rx_Request = { "i2c1_rx", 1U, I2C_DMAREQ_RX, DMA_ALLOC_MEDIUM };
+
+static I2C_Engine_Config_t Config ;
+static I2C_Engine_Info_t   Info ;
+static I2C_Engine_Stats_t  Stats ;
+static uint8_t             Tx_Handle = DMA_ALLOC_NONE ;
+static uint8_t             Rx_Handle = DMA_ALLOC_NONE ;
+static uint8_t             Ready ;
+static uint8_t             Timing_Valid ;
+
+static I2C_Engine_Xfer_t  *Queue[I2C_ENGINE_QUEUE] ;
+static volatile uint32_t   Head ;
+static volatile uint32_t   Tail ;
+static volatile uint8_t    Busy ;
+static uint8_t             Result ;
+static uint64_t            Start_Ns ;
+
+static uint8_t * const     Tx_Buf = (uint8_t *)I2C_ENGINE_BUFFER_BASE ;
+static uint8_t * const     Rx_Buf = (uint8_t *)(I2C_ENGINE_BUFFER_BASE + I2C_ENGINE_BUFFER_SIZE / 2U) ;
+
+/****************************** Functions ******************************/
+
+static void I2C_Pins_Config(void)
+{
+	RCC->AHB4ENR |= RCC_AHB4ENR_GPIOBEN ;
+
+	for (uint32_t pin = I2C_SCL_PIN; pin <= I2C_SDA_PIN; pin++)
+	{
+		GPIOB->OTYPER  |= (1UL << pin) ;
+		GPIOB->OSPEEDR |= (2UL << (2U * pin)) ;
+		GPIOB->AFR[0]   = (GPIOB->AFR[0] & ~ (0xFUL << (4U * pin))) | (I2C_AF << (4U * pin)) ;
+		GPIOB->MODER    = (GPIOB->MODER & ~ (3UL << (2U * pin))) | (2UL << (2U * pin)) ;
+	}
+}
+
+/* I2C123SEL[1:0]: 00 rcc_pclk1, 01 pll3_r_ck, 10 hsi_ker_ck, 11 csi_ker_ck */
+static Kernel_Clock_t Kernel_Source(void)
+{
+	static const Kernel_Clock_t Source[4] =
+	{
+		KERNEL_CLOCK_PCLK1, KERNEL_CLOCK_PLL3_R, KERNEL_CLOCK_HSI, KERNEL_CLOCK_CSI
+	};
+
+	return Source[(RCC->D2CCIP2R & RCC_D2CCIP2R_I2C123SEL_Msk) >> RCC_D2CCIP2R_I2C123SEL_Pos];
+}
+
+/* PE low resets the state machine and releases the lines,
+ * it must stay low for 3 APB clock cycles
+ */
+static void Peripheral_Reset(void)
+{
+	I2C1->CR1 &= ~ I2C_CR1_PE ;
+	(void)I2C1->CR1;
+	(void)I2C1->CR1;
+	(void)I2C1->CR1;
+	I2C1->CR1 |= I2C_CR1_PE ;
+}
+
+/* TIMINGR for the kernel clock in force, only between transactions.
+ * Returns 0 when the speed cannot be reached at this clock.
+ */
+static uint8_t Timing_Update(void)
+{
+	Kernel_Clock_t clock = Kernel_Source();
+	uint32_t       hz    = Kernel_Clock_Hz(clock);
+
+	if (Timing_Valid && (hz == Info.kernel_hz) && (clock == Info.kernel_clock))
+	{
+		return 1U;
+	}
+
+	Info.kernel_clock = clock;
+	Info.kernel_hz    = hz;
+	Timing_Valid      = I2C_Timing_Compute(hz, Config.speed, Config.rise_ns, Config.fall_ns, &Info.timing);
+	if (!Timing_Valid)
+	{
+		return 0U;
+	}
+
+	/* TIMINGR and TIMEOUTR are written with PE clear */
+	I2C1->CR1     &= ~ I2C_CR1_PE ;
+	I2C1->TIMINGR  = Info.timing.timingr ;
+	I2C1->TIMEOUTR = ((I2C_TIMEOUTA(hz) & 0xFFFU) << I2C_TIMEOUTR_TIMEOUTA_Pos) | I2C_TIMEOUTR_TIMOUTEN ;
+	I2C1->CR1     |= I2C_CR1_PE ;
+
+	Stats.timing_updates++;
+	return 1U;
+}
+
+/* Every flag of a stream: FEIF, DMEIF, TEIF, HTIF, TCIF, Reference Manual, DMA_LIFCR */
+static void DMA_Clear(uint8_t handle)
+{
+	static const uint8_t Shift[4] = { 0U, 6U, 16U, 22U };
+	DMA_TypeDef *dma = (DMA_ALLOC_CONTROLLER(handle) == DMA_ALLOC_DMA1) ? DMA1 : DMA2;
+	uint8_t      s   = DMA_ALLOC_STREAM(handle);
+
+	if (s < 4U)
+	{
+		dma->LIFCR = 0x3DUL << Shift[s] ;
+	}
+	else
+	{
+		dma->HIFCR = 0x3DUL << Shift[s - 4U] ;
+	}
+}
+
+static uint8_t DMA_Error(uint8_t handle)
+{
+	static const uint8_t Shift[4] = { 0U, 6U, 16U, 22U };
+	DMA_TypeDef *dma = (DMA_ALLOC_CONTROLLER(handle) == DMA_ALLOC_DMA1) ? DMA1 : DMA2;
+	uint8_t      s   = DMA_ALLOC_STREAM(handle);
+	uint32_t     isr = (s < 4U) ? dma->LISR : dma->HISR;
+
+	return ((isr >> Shift[s & 3U]) & (DMA_LISR_TEIF0 | DMA_LISR_DMEIF0)) ? 1U : 0U;
+}
+
+static void DMA_Stop(uint8_t handle)
+{
+	DMA_Stream_TypeDef *s = DMA_Alloc_Stream(handle);
+
+	s->CR &= ~ DMA_SxCR_EN ;
+	while( s->CR & DMA_SxCR_EN ) {}
+}
+
+/* Byte transfers, direct mode, Reference Manual, DMA_SxCR */
+static void DMA_Start(uint8_t handle, volatile uint32_t *periph, uint8_t *mem, uint16_t length, uint32_t dir)
+{
+	DMA_Stream_TypeDef *s = DMA_Alloc_Stream(handle);
+
+	DMA_Stop(handle);
+	DMA_Clear(handle);
+
+	s->PAR  = (uint32_t)periph ;
+	s->M0AR = (uint32_t)mem ;
+	s->NDTR = length ;
+	s->FCR  = 0U ;
+	s->CR   = dir | DMA_SxCR_MINC | ((uint32_t)DMA_ALLOC_MEDIUM << DMA_SxCR_PL_Pos) ;
+	s->CR  |= DMA_SxCR_EN ;
+}
+
+static void Read_Phase(const I2C_Engine_Xfer_t *x)
+{
+	uint32_t cr2 = ((uint32_t)x->addr << 1) | I2C_CR2_AUTOEND | I2C_CR2_START ;
+
+	if (x->rx_len != 0U)
+	{
+		DMA_Start(Rx_Handle, &I2C1->RXDR, Rx_Buf, x->rx_len, 0U);
+		cr2 |= I2C_CR2_RD_WRN | ((uint32_t)x->rx_len << I2C_CR2_NBYTES_Pos) ;
+	}
+	I2C1->CR2 = cr2 ;
+}
+
+/* First phase of x: the write, or the read when there is nothing to write */
+static void Start(I2C_Engine_Xfer_t *x)
+{
+	Result   = I2C_ENGINE_OK;
+	Start_Ns = Timebase_Now_Ns();
+
+	if (x->tx_len == 0U)
+	{
+		Read_Phase(x);
+		return;
+	}
+
+	memcpy(Tx_Buf, x->tx, x->tx_len);
+	SCB_CleanDCache_by_Addr((uint32_t *)Tx_Buf, (int32_t)x->tx_len);
+	DMA_Start(Tx_Handle, &I2C1->TXDR, Tx_Buf, x->tx_len, DMA_SxCR_DIR_0);
+
+	I2C1->CR2 = ((uint32_t)x->addr << 1) | ((uint32_t)x->tx_len << I2C_CR2_NBYTES_Pos) |
+	            ((x->rx_len == 0U) ? I2C_CR2_AUTOEND : 0U) | I2C_CR2_START ;
+}
+
+/* Interrupts masked or from the I2C interrupt. Starts the oldest queued
+ * transaction, those refused by the timing end at once.
+ */
+static void Next(void)
+{
+	while (Head != Tail)
+	{
+		I2C_Engine_Xfer_t *x = Queue[Tail & I2C_QUEUE_MASK];
+
+		if (Timing_Update())
+		{
+			Busy = 1U;
+			Start(x);
+			return;
+		}
+		Tail++;
+		x->status = I2C_ENGINE_ERR_TIMING;
+		if (x->done)
+		{
+			x->done(x);
+		}
+	}
+	Busy = 0U;
+}
+
+static void Finish(uint8_t status)
+{
+	I2C_Engine_Xfer_t *x = Queue[Tail & I2C_QUEUE_MASK];
+
+	DMA_Stop(Tx_Handle);
+	DMA_Stop(Rx_Handle);
+
+	if (status == I2C_ENGINE_OK)
+	{
+		if (x->rx_len != 0U)
+		{
+			SCB_InvalidateDCache_by_Addr((uint32_t *)Rx_Buf, (int32_t)x->rx_len);
+			memcpy(x->rx, Rx_Buf, x->rx_len);
+		}
+		Stats.bytes += (uint32_t)x->tx_len + x->rx_len;
+		DMA_Alloc_Account(Tx_Handle, x->tx_len);
+		DMA_Alloc_Account(Rx_Handle, x->rx_len);
+	}
+	else
+	{
+		I2C1->ISR |= I2C_ISR_TXE ;   // Flush a byte left in TXDR
+	}
+
+	Stats.bus_ns += Timebase_Now_Ns() - Start_Ns;
+	Stats.transactions++;
+
+	Tail++;
+	x->status = status;
+	if (x->done)
+	{
+		x->done(x);
+	}
+	Next();
+}
+
+I2C_Engine_Status_t I2C_Engine_Init(const I2C_Engine_Config_t *config)
+{
+	/* Step 1: Check the speed, two DMA streams from the allocator */
+	if (config->speed >= I2C_TIMING_SPEEDS)
+	{
+		return I2C_ENGINE_ERR_PARAM;
+	}
+	if (Tx_Handle == DMA_ALLOC_NONE)
+	{
+		if (DMA_Alloc_Request(&Tx_Request, &Tx_Handle) != DMA_ALLOC_OK)
+		{
+			return I2C_ENGINE_ERR_DMA;
+		}
+		if (DMA_Alloc_Request(&Rx_Request, &Rx_Handle) != DMA_ALLOC_OK)
+		{
+			DMA_Alloc_Release(Tx_Handle);
+			Tx_Handle = DMA_ALLOC_NONE;
+			return I2C_ENGINE_ERR_DMA;
+		}
+	}
+	Config = *config;
+
+	/* Step 2: Bus clocks, I2C1 on APB1, SYSCFG for the FM+ drive, pins */
+	RCC->APB1LENR |= RCC_APB1LENR_I2C1EN ;
+	RCC->APB4ENR  |= RCC_APB4ENR_SYSCFGEN ;
+	I2C_Pins_Config();
+
+	/* Step 3: Analog filter on, no digital filter, interrupts and DMA requests */
+	I2C1->CR1 = 0U ;
+	I2C1->CR1 = I2C_CR1_ENGINE ;
+	I2C_Engine_Set_Speed(config->speed);
+
+	/* Step 4: TIMINGR for the kernel clock in force, enable */
+	Timing_Valid = 0U;
+	if (!Timing_Update())
+	{
+		return I2C_ENGINE_ERR_TIMING;
+	}
+
+	/* Step 5: Event and error interrupts */
+	NVIC_SetPriority(I2C1_EV_IRQn, 5U);
+	NVIC_SetPriority(I2C1_ER_IRQn, 5U);
+	NVIC_EnableIRQ(I2C1_EV_IRQn);
+	NVIC_EnableIRQ(I2C1_ER_IRQn);
+
+	Ready = 1U;
+	return I2C_ENGINE_OK;
+}
+
+/* Applied before the next transaction, the one on the bus keeps its speed */
+I2C_Engine_Status_t I2C_Engine_Set_Speed(I2C_Timing_Speed_t speed)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	if (speed >= I2C_TIMING_SPEEDS)
+	{
+		return I2C_ENGINE_ERR_PARAM;
+	}
+
+	__disable_irq();
+	Config.speed = speed;
+	Timing_Valid = 0U;
+	if (speed == I2C_TIMING_FAST_PLUS)
+	{
+		SYSCFG->PMCR |= SYSCFG_PMCR_I2C1_FMP ;
+	}
+	else
+	{
+		SYSCFG->PMCR &= ~ SYSCFG_PMCR_I2C1_FMP ;
+	}
+	if (!Busy && Ready && !Timing_Update())
+	{
+		__set_PRIMASK(primask);
+		return I2C_ENGINE_ERR_TIMING;
+	}
+	__set_PRIMASK(primask);
+
+	return I2C_ENGINE_OK;
+}
+
+/* Queue a transaction, callable from interrupts */
+I2C_Engine_Status_t I2C_Engine_Submit(I2C_Engine_Xfer_t *xfer)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	if (!Ready || (xfer->addr > 0x7FU) || (xfer->tx_len > I2C_ENGINE_MAX_LEN) || (xfer->rx_len > I2C_ENGINE_MAX_LEN) ||
+	    ((xfer->tx_len != 0U) && (xfer->tx == 0)) || ((xfer->rx_len != 0U) && (xfer->rx == 0)))
+	{
+		return I2C_ENGINE_ERR_PARAM;
+	}
+
+	__disable_irq();
+	if ((Head - Tail) >= I2C_ENGINE_QUEUE)
+	{
+		__set_PRIMASK(primask);
+		return I2C_ENGINE_ERR_FULL;
+	}
+	xfer->status = I2C_ENGINE_PENDING;
+	Queue[Head & I2C_QUEUE_MASK] = xfer;
+	Head++;
+	if (!Busy)
+	{
+		Next();
+	}
+	__set_PRIMASK(primask);
+
+	return I2C_ENGINE_OK;
+}
+
+uint8_t I2C_Engine_Busy(void)
+{
+	return Busy;
+}
+
+const I2C_Engine_Info_t *I2C_Engine_Get_Info(void)
+{
+	return &Info;
+}
+
+void I2C_Engine_Get_Stats(I2C_Engine_Stats_t *stats)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	*stats = Stats;
+	__set_PRIMASK(primask);
+}
+
+/* count register reads of length bytes from reg of the device at addr,
+ * at Fast-mode Plus with the queue kept full, see the comments on top.
+ * The engine must be idle, the speed is restored after.
+ */
+I2C_Engine_Status_t I2C_Engine_Benchmark(uint8_t addr, uint8_t reg, uint16_t length, uint32_t count,
+                                         I2C_Engine_Bench_t *bench)
+{
+	static I2C_Engine_Xfer_t Xfer[I2C_ENGINE_QUEUE];
+	static uint8_t           Data[I2C_ENGINE_QUEUE][I2C_ENGINE_MAX_LEN];
+	uint8_t            Queued[I2C_ENGINE_QUEUE] = { 0U };
+	I2C_Timing_Speed_t speed = Config.speed;
+	I2C_Engine_Stats_t before, after;
+	uint32_t           submitted = 0U, done = 0U;
+	uint64_t           t0;
+	I2C_Engine_Status_t status;
+
+	memset(bench, 0, sizeof(*bench));
+	if (!Ready || Busy || (length == 0U) || (length > I2C_ENGINE_MAX_LEN) || (count == 0U))
+	{
+		return I2C_ENGINE_ERR_PARAM;
+	}
+
+	/* Step 1: Fast-mode Plus for the run */
+	status = I2C_Engine_Set_Speed(I2C_TIMING_FAST_PLUS);
+	if (status != I2C_ENGINE_OK)
+	{
+		I2C_Engine_Set_Speed(speed);
+		return status;
+	}
+	for (uint32_t i = 0U; i < I2C_ENGINE_QUEUE; i++)
+	{
+		Xfer[i] = (I2C_Engine_Xfer_t){ addr, &reg, 1U, Data[i], length, 0, 0, I2C_ENGINE_OK };
+	}
+	I2C_Engine_Get_Stats(&before);
+	t0 = Timebase_Now_Ns();
+
+	/* Step 2: Resubmit every finished transfer until count are done */
+	while (done < count)
+	{
+		for (uint32_t i = 0U; i < I2C_ENGINE_QUEUE; i++)
+		{
+			if (Xfer[i].status == I2C_ENGINE_PENDING)
+			{
+				continue;
+			}
+			if (Queued[i])
+			{
+				Queued[i] = 0U;
+				done++;
+				bench->errors += (Xfer[i].status != I2C_ENGINE_OK) ? 1U : 0U;
+			}
+			if ((submitted < count) && (I2C_Engine_Submit(&Xfer[i]) == I2C_ENGINE_OK))
+			{
+				Queued[i] = 1U;
+				submitted++;
+			}
+		}
+	}
+	bench->elapsed_ns = Timebase_Now_Ns() - t0;
+	I2C_Engine_Get_Stats(&after);
+
+	/* Step 3: Results, then back to the speed in use */
+	bench->transactions  = after.transactions - before.transactions;
+	bench->bytes         = (count - bench->errors) * length;
+	bench->bus_ns        = after.bus_ns - before.bus_ns;
+	bench->scl_hz        = Info.timing.scl_hz;
+	bench->payload_kbps  = (uint32_t)(((uint64_t)bench->bytes * 8000000ULL) / bench->elapsed_ns);
+	bench->util_permille = (uint16_t)(((uint64_t)bench->payload_kbps * 1000000ULL) /
+	                                  I2C_Timing_Spec(I2C_TIMING_FAST_PLUS)->scl_hz);
+	bench->bus_permille  = (uint16_t)((bench->bus_ns * 1000ULL) / bench->elapsed_ns);
+
+	I2C_Engine_Set_Speed(speed);
+	return (bench->errors == 0U) ? I2C_ENGINE_OK : I2C_ENGINE_ERR_NACK;
+}
+
+void I2C_Engine_EV_IRQHandler(void)
+{
+	uint32_t isr = I2C1->ISR;
+
+	/* STOP follows a NACK without software */
+	if (isr & I2C_ISR_NACKF)
+	{
+		I2C1->ICR = I2C_ICR_NACKCF ;
+		Result    = I2C_ENGINE_ERR_NACK;
+		Stats.nacks++;
+	}
+
+	/* Write phase done without AUTOEND: repeated START for the read */
+	if ((isr & I2C_ISR_TC) && Busy)
+	{
+		Read_Phase(Queue[Tail & I2C_QUEUE_MASK]);
+	}
+
+	if (isr & I2C_ISR_STOPF)
+	{
+		I2C1->ICR = I2C_ICR_STOPCF ;
+		if (Busy)
+		{
+			Finish(Result);
+		}
+	}
+}
+
+void I2C_Engine_ER_IRQHandler(void)
+{
+	uint32_t isr = I2C1->ISR;
+
+	I2C1->ICR = I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF | I2C_ICR_TIMOUTCF ;
+
+	if (isr & I2C_ISR_TIMEOUT)
+	{
+		Stats.timeouts++;
+	}
+	else
+	{
+		Stats.bus_errors++;
+	}
+	if (DMA_Error(Tx_Handle) || DMA_Error(Rx_Handle))
+	{
+		Stats.dma_errors++;
+	}
+
+	Peripheral_Reset();
+	if (Busy)
+	{
+		Finish(I2C_ENGINE_ERR_BUS);
+	}
+}
@@ -0,0 +1,131 @@
+/*
+ ******************************************************************************
+ * File              : i2c_engine.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : I2C1 master, queued DMA transactions, TIMINGR from the kernel clock
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 7, 2026
+ ******************************************************************************/
+
+#ifndef _I2C_ENGINE_H_
+#define _I2C_ENGINE_H_
+
+#include "stm32h7xx.h"
+#include "kernel_clock.h"
+#include "i2c_timing.h"
+
+/*************************** Macros ************************************/
+
+/* DMA bounce buffers in D3 SRAM4, after the input capture rings.
+ * DMA1 and DMA2 cannot reach DTCM where the linker script puts the data.
+ */
+#define I2C_ENGINE_BUFFER_BASE      ( 0x3800E000UL )
+#define I2C_ENGINE_BUFFER_SIZE      ( 0x00000200UL )    // TX then RX, 256 bytes each
+
+#define I2C_ENGINE_QUEUE            ( 8U )      // Transactions waiting, power of 2
+#define I2C_ENGINE_MAX_LEN          ( 255U )    // NBYTES per phase, no RELOAD
+#define I2C_ENGINE_TIMEOUT_US       ( 25000U )  // SCL held low, SMBus tTIMEOUT
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	I2C_ENGINE_OK = 0        ,
+	I2C_ENGINE_PENDING       ,  // Queued or on the bus
+	I2C_ENGINE_ERR_PARAM     ,  // Length, address or buffer, or not initialized
+	I2C_ENGINE_ERR_FULL      ,  // Queue full
+	I2C_ENGINE_ERR_TIMING    ,  // No TIMINGR for the speed at the kernel clock in force
+	I2C_ENGINE_ERR_NACK      ,  // Address or data not acknowledged
+	I2C_ENGINE_ERR_BUS       ,  // Bus error, arbitration lost, SCL low timeout
+	I2C_ENGINE_ERR_DMA          // No DMA stream left
+} I2C_Engine_Status_t;
+
+typedef struct
+{
+	I2C_Timing_Speed_t speed   ;
+	uint16_t           rise_ns ;  // Of the board: pull-ups and bus capacitance
+	uint16_t           fall_ns ;
+} I2C_Engine_Config_t;
+
+typedef struct I2C_Engine_Xfer_s I2C_Engine_Xfer_t;
+
+/* Called from the I2C interrupt when the transaction is done */
+typedef void (*I2C_Engine_Done_t)(I2C_Engine_Xfer_t *xfer) ;
+
+/* tx_len bytes written, then rx_len bytes read after a repeated START.
+ * Either length can be 0, both 0 is an address probe. The caller keeps
+ * the structure until status leaves I2C_ENGINE_PENDING.
+ */
+struct I2C_Engine_Xfer_s
+{
+	uint8_t           addr   ;  // 7-bit address
+	const uint8_t    *tx     ;
+	uint16_t          tx_len ;
+	uint8_t          *rx     ;
+	uint16_t          rx_len ;
+	I2C_Engine_Done_t done   ;  // 0: poll status
+	void             *ctx    ;
+	volatile uint8_t  status ;  // I2C_Engine_Status_t
+};
+
+typedef struct
+{
+	Kernel_Clock_t kernel_clock ;  // I2C123SEL in RCC_D2CCIP2R
+	uint32_t       kernel_hz    ;  // TIMINGR computed for this clock
+	I2C_Timing_t   timing       ;
+} I2C_Engine_Info_t;
+
+typedef struct
+{
+	uint32_t transactions   ;
+	uint32_t bytes          ;  // Written and read, successful transactions
+	uint32_t nacks          ;
+	uint32_t bus_errors     ;
+	uint32_t timeouts       ;
+	uint32_t dma_errors     ;
+	uint32_t timing_updates ;  // TIMINGR written, after a kernel clock or speed change
+	uint64_t bus_ns         ;  // START to STOP, summed
+} I2C_Engine_Stats_t;
+
+typedef struct
+{
+	uint32_t transactions  ;
+	uint32_t errors        ;
+	uint32_t bytes         ;  // Payload read
+	uint32_t scl_hz        ;
+	uint64_t elapsed_ns    ;  // First START to last STOP
+	uint64_t bus_ns        ;  // START to STOP, summed
+	uint32_t payload_kbps  ;
+	uint16_t util_permille ;  // Payload bits over the elapsed time at the bit rate of the speed
+	uint16_t bus_permille  ;  // bus_ns over elapsed_ns, the rest is the gap between transactions
+} I2C_Engine_Bench_t;
+
+/************************ Function prototypes ***************************/
+I2C_Engine_Status_t      I2C_Engine_Init(const I2C_Engine_Config_t *config) ;
+I2C_Engine_Status_t      I2C_Engine_Set_Speed(I2C_Timing_Speed_t speed) ;
+I2C_Engine_Status_t      I2C_Engine_Submit(I2C_Engine_Xfer_t *xfer) ;
+uint8_t                  I2C_Engine_Busy(void) ;
+const I2C_Engine_Info_t *I2C_Engine_Get_Info(void) ;
+void                     I2C_Engine_Get_Stats(I2C_Engine_Stats_t *stats) ;
+I2C_Engine_Status_t      I2C_Engine_Benchmark(uint8_t addr, uint8_t reg, uint16_t length, uint32_t count,
+                                              I2C_Engine_Bench_t *bench) ;
+
+void                     I2C_Engine_EV_IRQHandler(void) ;
+void                     I2C_Engine_ER_IRQHandler(void) ;
+
+#endif /* _I2C_ENGINE_H_ */
@@ -0,0 +1,162 @@
+/*
+ ******************************************************************************
+ * File              : i2c_timing.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : I2C_TIMINGR from the kernel clock, portable part
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 7, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * No register access in this file. Reference Manual, I2C timings, with the
+ * analog filter on and the digital filter off (DNF = 0):
+ *
+ *   tPRESC  = (PRESC + 1) x tI2CCLK
+ *   tSCLDEL = (SCLDEL + 1) x tPRESC     >= tr + tSU;DAT(min)
+ *   tSDADEL = SDADEL x tPRESC           >= tf + tHD;DAT(min) - tAF(min) - 3 tI2CCLK
+ *                                       <= tVD;DAT(max) - tr - tAF(max) - 4 tI2CCLK
+ *   tLOW    = tSYNC + (SCLL + 1) x tPRESC
+ *   tHIGH   = tSYNC + (SCLH + 1) x tPRESC
+ *   tSCL    = tLOW + tHIGH + tr + tf,   tSYNC = tAF(min) + 2 tI2CCLK
+ *
+ * For each PRESC the smallest SCLDEL and SDADEL are taken, then the fewest
+ * SCLL + SCLH counts that keep tSCL at or above the period of the speed,
+ * shared in the ratio of tLOW(min) to tHIGH(min). The PRESC with the
+ * period closest to the speed wins, the lowest PRESC on a tie. 16 steps,
+ * cheap enough to run again at every clock change. A speed is refused when
+ * SCL would stay below I2C_TIMING_MIN_PERCENT of it (kernel clock too low).
+ *
+ * The smallest SDADEL for the hold time is kept even when it is above the
+ * tVD;DAT bound: at 1 MHz with the worst tf (120 ns) the two bounds leave
+ * no room, the 260 ns of tAF(max) take most of tVD;DAT. The hold time is
+ * the one that corrupts data, tools/i2c_timing_tool.c lists the clocks
+ * where tVD;DAT is not met.
+ *
+ * Times are computed in picoseconds, tI2CCLK is 8.33 ns at 120 MHz.
+ *
+ ******************************************************************************/
+
+#include "i2c_timing.h"
+
+/*************************** Macros ************************************/
+
+#define PS_PER_S                    ( 1000000000000ULL )
+#define PS(ns)                      ( (int64_t)(ns) * 1000 )
+
+/************************** Local Variables ****************************/
+
+/* UM10204, Table 10 */
+static const I2C_Timing_Spec_t Spec[I2C_TIMING_SPEEDS] =
+{
+	{  100000UL, 4700U, 4000U, 250U, 0U, 3450U, 1000U, 300U },
+	{  400000UL, 1300U,  600U, 100U, 0U,  900U,  300U, 300U },
+	{ 1000000UL,  500U,  260U,  50U, 0U,  450U,  120U, 120U },
+};
+
+/****************************** Functions ******************************/
+
+static int64_t Div_Up(int64_t a, int64_t b)
+{
+	return (a <= 0) ? 0 : (a + b - 1) / b;
+}
+
+const I2C_Timing_Spec_t *I2C_Timing_Spec(I2C_Timing_Speed_t speed)
+{
+	return (speed < I2C_TIMING_SPEEDS) ? &Spec[speed] : 0;
+}
+
+/* rise_ns and fall_ns are those of the board (bus capacitance, pull-ups),
+ * at most the maximum of the speed. Returns 0 when no setting fits.
+ */
+uint8_t I2C_Timing_Compute(uint32_t kernel_hz, I2C_Timing_Speed_t speed,
+                           uint16_t rise_ns, uint16_t fall_ns, I2C_Timing_t *timing)
+{
+	const I2C_Timing_Spec_t *spec = I2C_Timing_Spec(speed);
+	int64_t  tclk, tsync, period, edges, best = INT64_MAX;
+
+	if ((spec == 0) || (kernel_hz == 0U) || (rise_ns > spec->rise_max) || (fall_ns > spec->fall_max))
+	{
+		return 0U;
+	}
+
+	tclk   = (int64_t)(PS_PER_S / kernel_hz);
+	tsync  = PS(I2C_TIMING_AF_MIN_NS) + 2 * tclk;
+	period = (int64_t)(PS_PER_S / spec->scl_hz);
+	edges  = 2 * tsync + PS(rise_ns) + PS(fall_ns);
+
+	for (uint8_t presc = 0U; presc < 16U; presc++)
+	{
+		int64_t tpresc = (presc + 1) * tclk;
+		int64_t scldel, sdadel, lmin, hmin, n, low, high, err;
+
+		/* Step 1: Data setup time */
+		scldel = Div_Up(PS(rise_ns) + PS(spec->su_dat_min), tpresc) - 1;
+		scldel = (scldel < 0) ? 0 : scldel;
+
+		/* Step 2: Data hold time, the smallest SDADEL is also the best for tVD;DAT */
+		sdadel = Div_Up(PS(fall_ns) + PS(spec->hd_dat_min) - PS(I2C_TIMING_AF_MIN_NS) - 3 * tclk, tpresc);
+		if ((scldel > 15) || (sdadel > 15))
+		{
+			continue;
+		}
+
+		/* Step 3: Fewest counts for tLOW(min), tHIGH(min) and the period.
+		 * The low phase is longer than 4 tI2CCLK, the high phase than tI2CCLK.
+		 */
+		lmin = Div_Up(PS(spec->low_min) - tsync, tpresc);
+		lmin = (lmin * tpresc > 4 * tclk) ? lmin : (4 * tclk) / tpresc + 1;
+		hmin = Div_Up(PS(spec->high_min) - tsync, tpresc);
+		hmin = (hmin * tpresc > tclk) ? hmin : tclk / tpresc + 1;
+
+		n = Div_Up(period - edges, tpresc);
+		n = (n < lmin + hmin) ? lmin + hmin : n;
+
+		low  = lmin + ((n - lmin - hmin) * lmin) / (lmin + hmin);
+		high = n - low;
+		if ((low > 256) || (high > 256))
+		{
+			continue;
+		}
+
+		/* Step 4: Closest period, never shorter than the one of the speed */
+		err = edges + n * tpresc - period;
+		if ((err < best) && ((edges + n * tpresc) * I2C_TIMING_MIN_PERCENT <= period * 100))
+		{
+			best             = err;
+			timing->presc    = presc;
+			timing->scldel   = (uint8_t)scldel;
+			timing->sdadel   = (uint8_t)sdadel;
+			timing->scll     = (uint8_t)(low - 1);
+			timing->sclh     = (uint8_t)(high - 1);
+			timing->low_ns   = (uint32_t)((tsync + low  * tpresc) / 1000);
+			timing->high_ns  = (uint32_t)((tsync + high * tpresc) / 1000);
+			timing->scl_hz   = (uint32_t)(PS_PER_S / (uint64_t)(edges + n * tpresc));
+			timing->timingr  = I2C_TIMING_TIMINGR(presc, scldel, sdadel, high - 1, low - 1);
+		}
+	}
+
+	return (best != INT64_MAX) ? 1U : 0U;
+}
+
+const char *I2C_Timing_Name(I2C_Timing_Speed_t speed)
+{
+	static const char *Names[I2C_TIMING_SPEEDS] = { "100 kHz", "400 kHz", "1 MHz" };
+
+	return (speed < I2C_TIMING_SPEEDS) ? Names[speed] : "?";
+}
@@ -0,0 +1,94 @@
+/*
+ ******************************************************************************
+ * File              : i2c_timing.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : I2C_TIMINGR from the kernel clock, portable part
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 7, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Portable like dma_alloc_table.c: I2C_Timing_Compute() is compiled into the
+ * firmware (i2c_engine.c) and into tools/i2c_timing_tool.c, which checks the
+ * result against the I2C-bus specification over the range of kernel clocks.
+ *
+ ******************************************************************************/
+
+#ifndef _I2C_TIMING_H_
+#define _I2C_TIMING_H_
+
+#include <stdint.h>
+
+/*************************** Macros ************************************/
+
+// Analog noise filter delay, Datasheet DS12110, I2C analog filter characteristics
+#define I2C_TIMING_AF_MIN_NS        ( 50U )
+#define I2C_TIMING_AF_MAX_NS        ( 260U )
+
+// Lowest SCL frequency accepted, in percent of the speed
+#define I2C_TIMING_MIN_PERCENT      ( 80 )
+
+// I2C_TIMINGR fields, Reference Manual, I2C timing register (I2C_TIMINGR)
+#define I2C_TIMING_TIMINGR(presc, scldel, sdadel, sclh, scll)                          \
+	( ((uint32_t)(presc) << 28) | ((uint32_t)(scldel) << 20) | ((uint32_t)(sdadel) << 16) | \
+	  ((uint32_t)(sclh) << 8) | (uint32_t)(scll) )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	I2C_TIMING_STANDARD = 0 ,  // 100 kHz
+	I2C_TIMING_FAST         ,  // 400 kHz
+	I2C_TIMING_FAST_PLUS    ,  // 1 MHz, needs the FMP drive of the pins
+	I2C_TIMING_SPEEDS
+} I2C_Timing_Speed_t;
+
+/* Limits of one speed, UM10204 I2C-bus specification, Table 10, in ns */
+typedef struct
+{
+	uint32_t scl_hz     ;
+	uint16_t low_min    ;  // tLOW
+	uint16_t high_min   ;  // tHIGH
+	uint16_t su_dat_min ;  // tSU;DAT
+	uint16_t hd_dat_min ;  // tHD;DAT
+	uint16_t vd_dat_max ;  // tVD;DAT
+	uint16_t rise_max   ;  // tr
+	uint16_t fall_max   ;  // tf
+} I2C_Timing_Spec_t;
+
+typedef struct
+{
+	uint32_t timingr ;
+	uint32_t scl_hz  ;  // With the rise and fall times given, never above the speed, at least I2C_TIMING_MIN_PERCENT of it
+	uint32_t low_ns  ;  // SCL low, synchronization included
+	uint32_t high_ns ;
+	uint8_t  presc   ;
+	uint8_t  scldel  ;
+	uint8_t  sdadel  ;
+	uint8_t  sclh    ;
+	uint8_t  scll    ;
+} I2C_Timing_t;
+
+/************************ Function prototypes ***************************/
+const I2C_Timing_Spec_t *I2C_Timing_Spec(I2C_Timing_Speed_t speed) ;
+uint8_t                  I2C_Timing_Compute(uint32_t kernel_hz, I2C_Timing_Speed_t speed,
+                                            uint16_t rise_ns, uint16_t fall_ns, I2C_Timing_t *timing) ;
+const char              *I2C_Timing_Name(I2C_Timing_Speed_t speed) ;
+
+#endif /* _I2C_TIMING_H_ */
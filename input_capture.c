@@ -0,0 +1,442 @@
+/*
+ ******************************************************************************
+ * File              : input_capture.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : TIM5 input capture timestamps streamed by DMA
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 28, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * The four TIM5 channels capture the counter of the monotonic timebase
+ * (timebase.c), so an edge is timed at the resolution of rcc_timx_ker_ck
+ * and needs no conversion between two clocks.
+ *
+ *   Channel   Pin (AF2)   DMA2 stream   DMAMUX1 channel   Request
+ *   CH1       PA0         2             10                55 TIM5_CH1
+ *   CH2       PA1         3             11                56 TIM5_CH2
+ *   CH3       PA2         4             12                57 TIM5_CH3
+ *   CH4       PA3         5             13                58 TIM5_CH4
+ *
+ * Each capture requests one DMA transfer of CCRx into a circular ring of
+ * INPUT_CAPTURE_RING_WORDS words. The half and full transfer interrupts
+ * count the halves written, which with NDTR gives the number of words
+ * written since the start. Input_Capture_Read() compares it with the number
+ * read: words overwritten before they were read are counted as lost, the
+ * others are extended to 64 bits against the tick count read just after
+ * NDTR (as Timebase_Extend does) and converted to ns with the clock rate
+ * that was active when they were captured. The ring must be read at least
+ * once per counter wrap, 17.9 s at 240 MHz.
+ *
+ * An edge that comes while CCRx still holds a capture not read by the DMA
+ * sets CCxOF: the edge rate is higher than the DMA can sustain. The flag
+ * is polled by Input_Capture_Read() and counted as an overcapture.
+ *
+ * Input_Capture_Benchmark() needs MCO1 (PA8) wired to PA0. It outputs HSE
+ * (or HSI) divided by 15 down to 1 on MCO1 and captures rising edges until
+ * an edge is missed or two captures are not one period apart.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "input_capture.h"
+#include "timebase.h"
+#include "kernel_clock.h"
+#include "clock_profile.h"
+#include "dma_alloc.h"
+#include "fpu_policy.h"
+
+/*************************** Macros ************************************/
+
+#define CAPTURE_DMAREQ_TIM5_CH1     ( 55U )             // Reference Manual, Page 695
+#define CAPTURE_HALF_WORDS          ( INPUT_CAPTURE_RING_WORDS / 2U )
+#define CAPTURE_PIN_AF              ( 2U )
+#define CAPTURE_MCO1_HSI            ( 0U )              // MCO1[2:0], Reference Manual, Page 391
+#define CAPTURE_MCO1_HSE            ( 2U )
+
+/************************** Local Variables ****************************/
+
+static DMA_Stream_TypeDef * const Streams[INPUT_CAPTURE_CHANNELS] =
+{
+	DMA2_Stream2, DMA2_Stream3, DMA2_Stream4, DMA2_Stream5
+};
+
+static const DMA_Alloc_Request_t Requests[INPUT_CAPTURE_CHANNELS] =
+{
+	{ "tim5_ch1", 1U, CAPTURE_DMAREQ_TIM5_CH1 + 0U, DMA_ALLOC_HIGH },
+	{ "tim5_ch2", 1U, CAPTURE_DMAREQ_TIM5_CH1 + 1U, DMA_ALLOC_HIGH },
+	{ "tim5_ch3", 1U, CAPTURE_DMAREQ_TIM5_CH1 + 2U, DMA_ALLOC_HIGH },
+	{ "tim5_ch4", 1U, CAPTURE_DMAREQ_TIM5_CH1 + 3U, DMA_ALLOC_HIGH }
+};
+
+static const IRQn_Type Stream_IRQ[INPUT_CAPTURE_CHANNELS] =
+{
+	DMA2_Stream2_IRQn, DMA2_Stream3_IRQn, DMA2_Stream4_IRQn, DMA2_Stream5_IRQn
+};
+
+// Position of the stream flags in LISR/HISR, Reference Manual, Page 666
+static const uint8_t Flag_Offset[INPUT_CAPTURE_CHANNELS] = { 16U, 22U, 0U, 6U };
+
+static Input_Capture_Config_t Config ;
+static Input_Capture_Stats_t  Stats ;
+static volatile uint32_t      Halves[INPUT_CAPTURE_CHANNELS] ;
+static uint32_t               Read_Count[INPUT_CAPTURE_CHANNELS] ;
+
+static uint32_t *Ring(uint8_t ch)
+{
+	return (uint32_t *)INPUT_CAPTURE_RING_BASE + ch * INPUT_CAPTURE_RING_WORDS;
+}
+
+static uint32_t Dma_Flags(uint8_t ch)
+{
+	return ((ch < 2U) ? DMA2->LISR : DMA2->HISR) >> Flag_Offset[ch];
+}
+
+static void Dma_Clear(uint8_t ch, uint32_t flags)
+{
+	if (ch < 2U)
+	{
+		DMA2->LIFCR = flags << Flag_Offset[ch] ;
+	}
+	else
+	{
+		DMA2->HIFCR = flags << Flag_Offset[ch] ;
+	}
+}
+
+/* TIM5_CHx in alternate function 2 on PA0..PA3 */
+static void Pin_Config(uint8_t ch)
+{
+	RCC->AHB4ENR |= RCC_AHB4ENR_GPIOAEN ;
+
+	GPIOA->MODER  = (GPIOA->MODER & ~ (3UL << (2U * ch))) | (2UL << (2U * ch)) ;
+	GPIOA->AFR[0] = (GPIOA->AFR[0] & ~ (0xFUL << (4U * ch))) | ((uint32_t)CAPTURE_PIN_AF << (4U * ch)) ;
+}
+
+/* Input capture on TIx, Reference Manual, Page 1760
+ * CCxS = 01, ICxPSC and ICxF in CCMR1/CCMR2, polarity CCxP/CCxNP in CCER:
+ * 00 rising, 01 falling, 11 both edges
+ */
+static void Channel_Config(uint8_t ch, uint8_t edge, uint8_t filter, uint8_t prescaler)
+{
+	volatile uint32_t *ccmr = (ch < 2U) ? &TIMEBASE_TIM->CCMR1 : &TIMEBASE_TIM->CCMR2;
+	uint32_t shift = 8U * (ch & 1U);
+	uint32_t pol   = (edge == INPUT_CAPTURE_RISING)  ? 0U :
+	                 (edge == INPUT_CAPTURE_FALLING) ? TIM_CCER_CC1P : (TIM_CCER_CC1P | TIM_CCER_CC1NP);
+
+	Pin_Config(ch);
+
+	TIMEBASE_TIM->CCER &= ~ (0xFUL << (4U * ch)) ;
+	*ccmr = (*ccmr & ~ (0xFFUL << shift)) |
+	        ((1UL | ((uint32_t)(prescaler & 3U) << 2) | ((uint32_t)(filter & 0xFU) << 4)) << shift) ;
+	TIMEBASE_TIM->CCER |= (pol | TIM_CCER_CC1E) << (4U * ch) ;
+}
+
+/* Stream from CCRx to the ring, circular or one pass */
+static void Stream_Start(uint8_t ch, uint32_t circular)
+{
+	DMA_Stream_TypeDef *s = Streams[ch];
+
+	Dma_Clear(ch, 0x3DU);
+	Halves[ch]     = 0U;
+	Read_Count[ch] = 0U;
+
+	/* Drop a capture latched before the start, its edge is not in the ring */
+	TIMEBASE_TIM->SR = ~ ((TIM_SR_CC1IF | TIM_SR_CC1OF) << ch) ;
+
+	/* Peripheral to memory, 32-bit, direct mode, Reference Manual, Page 653 */
+	s->PAR  = (uint32_t)(&TIMEBASE_TIM->CCR1 + ch) ;
+	s->M0AR = (uint32_t)Ring(ch) ;
+	s->NDTR = INPUT_CAPTURE_RING_WORDS ;
+	s->FCR  = 0U ;
+	s->CR   = DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC | DMA_SxCR_TEIE |
+	          DMA_SxCR_DMEIE | (circular ? (DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE) : 0U) ;
+	s->CR  |= DMA_SxCR_EN ;
+
+	TIMEBASE_TIM->DIER |= TIM_DIER_CC1DE << ch ;
+}
+
+static void Stream_Stop(uint8_t ch)
+{
+	TIMEBASE_TIM->DIER &= ~ (TIM_DIER_CC1DE << ch) ;
+	Streams[ch]->CR    &= ~ DMA_SxCR_EN ;
+	while( Streams[ch]->CR & DMA_SxCR_EN ) {}
+	Dma_Clear(ch, 0x3DU);
+}
+
+/* Words written since Stream_Start(). A half not yet counted by the
+ * interrupt shows as NDTR in the other half of the ring.
+ */
+static uint32_t Written(uint8_t ch)
+{
+	uint32_t h, pos;
+
+	do
+	{
+		h   = Halves[ch];
+		pos = (INPUT_CAPTURE_RING_WORDS - Streams[ch]->NDTR) % INPUT_CAPTURE_RING_WORDS;
+	} while (h != Halves[ch]);
+
+	return h * CAPTURE_HALF_WORDS +
+	       (pos + INPUT_CAPTURE_RING_WORDS - (h & 1U) * CAPTURE_HALF_WORDS) % INPUT_CAPTURE_RING_WORDS;
+}
+
+Input_Capture_Status_t Input_Capture_Init(const Input_Capture_Config_t *config)
+{
+	if ((config->channels == 0U) || (config->channels >= (1U << INPUT_CAPTURE_CHANNELS)))
+	{
+		return INPUT_CAPTURE_ERROR;
+	}
+	for (uint8_t ch = 0U; ch < INPUT_CAPTURE_CHANNELS; ch++)
+	{
+		if ((config->channels & (1U << ch)) &&
+		    (DMA_Alloc_Reserve(DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 2U + ch), &Requests[ch]) != DMA_ALLOC_OK))
+		{
+			while (ch-- > 0U)
+			{
+				if (config->channels & (1U << ch))
+				{
+					DMA_Alloc_Release(DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 2U + ch));
+				}
+			}
+			return INPUT_CAPTURE_ERROR;
+		}
+	}
+	Config = *config;
+
+	/* Step 1: The captures are taken on the running timebase counter */
+	if (!(TIMEBASE_TIM->CR1 & TIM_CR1_CEN))
+	{
+		Timebase_Init();
+	}
+	Stats.timer_hz = Timebase_Hz();
+
+	/* Step 2: Channels, pins and DMA interrupts */
+	for (uint8_t ch = 0U; ch < INPUT_CAPTURE_CHANNELS; ch++)
+	{
+		if (Config.channels & (1U << ch))
+		{
+			Channel_Config(ch, Config.edge[ch], Config.filter, Config.prescaler);
+			NVIC_SetPriority(Stream_IRQ[ch], 2U);
+			NVIC_EnableIRQ(Stream_IRQ[ch]);
+		}
+	}
+	return INPUT_CAPTURE_OK;
+}
+
+void Input_Capture_Start(void)
+{
+	for (uint8_t ch = 0U; ch < INPUT_CAPTURE_CHANNELS; ch++)
+	{
+		if (Config.channels & (1U << ch))
+		{
+			Stream_Start(ch, 1U);
+		}
+	}
+}
+
+void Input_Capture_Stop(void)
+{
+	for (uint8_t ch = 0U; ch < INPUT_CAPTURE_CHANNELS; ch++)
+	{
+		if (Config.channels & (1U << ch))
+		{
+			Stream_Stop(ch);
+		}
+	}
+}
+
+/* Oldest edges of channel 0..3 not read yet, returns how many were stored */
+uint32_t Input_Capture_Read(uint8_t channel, Input_Capture_Event_t *events, uint32_t max)
+{
+	const uint32_t *ring = Ring(channel);
+	uint32_t written, first, count, late;
+	uint64_t now;
+
+	if ((channel >= INPUT_CAPTURE_CHANNELS) || !(Config.channels & (1U << channel)))
+	{
+		return 0U;
+	}
+
+	if (TIMEBASE_TIM->SR & (TIM_SR_CC1OF << channel))
+	{
+		TIMEBASE_TIM->SR = ~ (TIM_SR_CC1OF << channel) ;
+		Stats.overcaptures[channel]++;
+	}
+
+	/* Step 1: Every word counted in written is older than now */
+	written = Written(channel);
+	now     = Timebase_Ticks();
+
+	if ((written - Read_Count[channel]) > INPUT_CAPTURE_RING_WORDS)
+	{
+		Stats.lost[channel] += written - Read_Count[channel] - INPUT_CAPTURE_RING_WORDS;
+		Read_Count[channel]  = written - INPUT_CAPTURE_RING_WORDS;
+	}
+	first = Read_Count[channel];
+	count = written - first;
+	count = (count > max) ? max : count;
+
+	/* Step 2: The DMA wrote the ring behind the D-cache */
+	SCB_InvalidateDCache_by_Addr((uint32_t *)ring, (int32_t)(4U * INPUT_CAPTURE_RING_WORDS));
+
+	for (uint32_t i = 0U; i < count; i++)
+	{
+		uint32_t capture = ring[(first + i) % INPUT_CAPTURE_RING_WORDS];
+
+		events[i].ticks = now - (uint32_t)((uint32_t)now - capture);
+	}
+
+	/* Step 3: Words the DMA overwrote while they were copied are dropped */
+	written = Written(channel);
+	late    = ((written - first) > INPUT_CAPTURE_RING_WORDS) ? (written - first - INPUT_CAPTURE_RING_WORDS) : 0U;
+	late    = (late > count) ? count : late;
+
+	for (uint32_t i = late; i < count; i++)
+	{
+		events[i - late].ticks = events[i].ticks;
+		events[i - late].ns    = Timebase_Ticks_To_Ns(events[i].ticks);
+	}
+
+	Read_Count[channel]     = first + count;
+	Stats.lost[channel]    += late;
+	Stats.edges[channel]   += count - late;
+
+	return count - late;
+}
+
+void Input_Capture_Get_Stats(Input_Capture_Stats_t *stats)
+{
+	Stats.timer_hz = Timebase_Hz();
+	*stats = Stats;
+}
+
+/* One pass of the ring on channel 1 at rate_hz: no overcapture, and every
+ * capture one period after the previous one (1/8 period tolerance, the HSI
+ * is only accurate to 1 %)
+ */
+static uint8_t Bench_Pass(uint32_t timer_hz, uint32_t rate_hz)
+{
+	const uint32_t *ring  = Ring(0U);
+	uint32_t        period = timer_hz / rate_hz;
+	uint64_t        deadline;
+	uint8_t         pass = 1U;
+
+	Stream_Start(0U, 0U);
+
+	deadline = Timebase_Ticks() + 2U * (uint64_t)INPUT_CAPTURE_RING_WORDS * period + timer_hz / 100U;
+	while (!(Dma_Flags(0U) & DMA_LISR_TCIF0))
+	{
+		if (Timebase_Ticks() > deadline)
+		{
+			pass = 0U;
+			break;
+		}
+	}
+	if (TIMEBASE_TIM->SR & TIM_SR_CC1OF)
+	{
+		pass = 0U;
+	}
+	Stream_Stop(0U);
+
+	SCB_InvalidateDCache_by_Addr((uint32_t *)ring, (int32_t)(4U * INPUT_CAPTURE_RING_WORDS));
+
+	for (uint32_t i = 1U; pass && (i < INPUT_CAPTURE_RING_WORDS); i++)
+	{
+		uint32_t delta = ring[i] - ring[i - 1U];
+		uint32_t error = (delta > period) ? (delta - period) : (period - delta);
+
+		pass = (error <= (period / 8U + 1U)) ? 1U : 0U;
+	}
+	return pass;
+}
+
+/* Highest sustained edge rate for the active clock profile, see the comments
+ * on top. The service is stopped, call Input_Capture_Start() again after.
+ */
+Input_Capture_Status_t Input_Capture_Benchmark(Input_Capture_Bench_t *bench)
+{
+	uint32_t cfgr = RCC->CFGR;
+	uint32_t mco1 = (RCC->CR & RCC_CR_HSERDY) ? CAPTURE_MCO1_HSE : CAPTURE_MCO1_HSI;
+
+	if (!(TIMEBASE_TIM->CR1 & TIM_CR1_CEN) ||
+	    (DMA_Alloc_Reserve(DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 2U), &Requests[0]) != DMA_ALLOC_OK))
+	{
+		return INPUT_CAPTURE_ERROR;
+	}
+	Input_Capture_Stop();
+
+	bench->profile_id     = Clock_Profile_Active()->profile_id;
+	bench->cpu_hz         = SystemCoreClock;
+	bench->timer_hz       = Timebase_Hz();
+	bench->source_hz      = Kernel_Clock_Hz((mco1 == CAPTURE_MCO1_HSE) ? KERNEL_CLOCK_HSE : KERNEL_CLOCK_HSI);
+	bench->max_edge_hz    = 0U;
+	bench->ticks_per_edge = 0U;
+
+	Channel_Config(0U, INPUT_CAPTURE_RISING, 0U, 0U);
+
+	/* Step 1: Faster and faster MCO1 until a pass fails, at least 4 ticks per edge */
+	for (uint32_t div = 15U; div >= 1U; div--)
+	{
+		uint32_t rate = bench->source_hz / div;
+
+		if (rate > bench->timer_hz / 4U)
+		{
+			break;
+		}
+		RCC->CFGR = (cfgr & ~ (RCC_CFGR_MCO1 | RCC_CFGR_MCO1PRE)) |
+		            (mco1 << RCC_CFGR_MCO1_Pos) | (div << RCC_CFGR_MCO1PRE_Pos) ;
+
+		if (!Bench_Pass(bench->timer_hz, rate))
+		{
+			break;
+		}
+		bench->max_edge_hz    = rate;
+		bench->ticks_per_edge = bench->timer_hz / rate;
+	}
+
+	/* Step 2: MCO1 and channel 1 as they were */
+	RCC->CFGR = cfgr ;
+	if (Config.channels & INPUT_CAPTURE_CH1)
+	{
+		Channel_Config(0U, Config.edge[0], Config.filter, Config.prescaler);
+	}
+
+	return (bench->max_edge_hz != 0U) ? INPUT_CAPTURE_OK : INPUT_CAPTURE_ERROR;
+}
+
+FPU_FREE_ISR void Input_Capture_DMA_IRQHandler(uint8_t channel)
+{
+	uint32_t flags = Dma_Flags(channel);
+
+	if (flags & (DMA_LISR_TEIF0 | DMA_LISR_DMEIF0))
+	{
+		Dma_Clear(channel, DMA_LIFCR_CTEIF0 | DMA_LIFCR_CDMEIF0);
+		Stats.dma_errors++;
+	}
+
+	if (flags & (DMA_LISR_HTIF0 | DMA_LISR_TCIF0))
+	{
+		uint32_t halves = ((flags & DMA_LISR_HTIF0) && (flags & DMA_LISR_TCIF0)) ? 2U : 1U;
+
+		Dma_Clear(channel, flags & (DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTCIF0));
+		Halves[channel] += halves;
+		DMA_Alloc_Account(DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 2U + channel), 4U * CAPTURE_HALF_WORDS * halves);
+	}
+}
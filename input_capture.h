@@ -0,0 +1,102 @@
+/*
+ ******************************************************************************
+ * File              : input_capture.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : TIM5 input capture timestamps streamed by DMA
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 28, 2026
+ ******************************************************************************/
+
+#ifndef _INPUT_CAPTURE_H_
+#define _INPUT_CAPTURE_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+#define INPUT_CAPTURE_CHANNELS      ( 4U )
+
+#define INPUT_CAPTURE_CH1           ( 1U << 0 )     // PA0
+#define INPUT_CAPTURE_CH2           ( 1U << 1 )     // PA1
+#define INPUT_CAPTURE_CH3           ( 1U << 2 )     // PA2
+#define INPUT_CAPTURE_CH4           ( 1U << 3 )     // PA3
+
+/* One ring of 32-bit captures per channel in D3 SRAM4, after the HRTIM buffer */
+#define INPUT_CAPTURE_RING_BASE     ( 0x3800A000UL )
+#define INPUT_CAPTURE_RING_WORDS    ( 1024U )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	INPUT_CAPTURE_OK = 0 ,
+	INPUT_CAPTURE_ERROR     // No channel, bad parameter, no edges in the benchmark
+} Input_Capture_Status_t;
+
+typedef enum
+{
+	INPUT_CAPTURE_RISING = 0 ,
+	INPUT_CAPTURE_FALLING    ,
+	INPUT_CAPTURE_BOTH
+} Input_Capture_Edge_t;
+
+typedef struct
+{
+	uint8_t channels   ;  // INPUT_CAPTURE_CHx mask
+	uint8_t edge[INPUT_CAPTURE_CHANNELS] ;  // Input_Capture_Edge_t
+	uint8_t filter     ;  // ICxF[3:0], 0: no digital filter
+	uint8_t prescaler  ;  // ICxPSC[1:0], capture every 1, 2, 4 or 8 edges
+} Input_Capture_Config_t;
+
+/* An edge on the monotonic timebase */
+typedef struct
+{
+	uint64_t ticks ;  // TIM5 ticks since Timebase_Init()
+	uint64_t ns    ;
+} Input_Capture_Event_t;
+
+typedef struct
+{
+	uint32_t timer_hz      ;  // rcc_timx_ker_ck
+	uint32_t edges[INPUT_CAPTURE_CHANNELS] ;         // Returned by Input_Capture_Read()
+	uint32_t lost[INPUT_CAPTURE_CHANNELS] ;          // Overwritten in the ring before being read
+	uint32_t overcaptures[INPUT_CAPTURE_CHANNELS] ;  // Edge before the DMA read the previous one
+	uint32_t dma_errors    ;
+} Input_Capture_Stats_t;
+
+typedef struct
+{
+	uint32_t profile_id     ;  // Active clock profile
+	uint32_t cpu_hz         ;
+	uint32_t timer_hz       ;
+	uint32_t source_hz      ;  // MCO1 source, HSE or HSI
+	uint32_t max_edge_hz    ;  // Highest edge rate captured without loss
+	uint32_t ticks_per_edge ;  // At max_edge_hz
+} Input_Capture_Bench_t;
+
+/************************ Function prototypes ***************************/
+Input_Capture_Status_t Input_Capture_Init(const Input_Capture_Config_t *config) ;
+void                   Input_Capture_Start(void) ;
+void                   Input_Capture_Stop(void) ;
+uint32_t               Input_Capture_Read(uint8_t channel, Input_Capture_Event_t *events, uint32_t max) ;
+void                   Input_Capture_Get_Stats(Input_Capture_Stats_t *stats) ;
+Input_Capture_Status_t Input_Capture_Benchmark(Input_Capture_Bench_t *bench) ;
+
+void                   Input_Capture_DMA_IRQHandler(uint8_t channel) ;
+
+#endif /* _INPUT_CAPTURE_H_ */
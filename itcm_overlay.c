@@ -0,0 +1,519 @@
+/*
+ ******************************************************************************
+ * File              : itcm_overlay.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Code overlays paged from flash into ITCM slots by MDMA
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 9, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Thunk table: Thunk[id] is the address to call for overlay id, the ITCM
+ * copy with the Thumb bit, or 0 when the routine is not loaded.
+ * ITCM_Overlay_Get() is one load and a test on a hit. On a miss:
+ *
+ *   1. slots needed = size rounded up to ITCM_OVERLAY_SLOT_SIZE
+ *   2. the run of free or least recently used slots is chosen (the age of
+ *      a run is the most recent use of the overlays in it, pinned overlays
+ *      are never in a run), the overlays in it are evicted, Thunk[] = 0
+ *   3. MDMA channel 4 copies the routine from flash (AXI) to ITCM (AHBS),
+ *      the CPU polls the channel transfer complete: the caller needs the
+ *      code before it can go on
+ *   4. DSB and ISB, then Thunk[id] is set. ITCM is not cached, there is
+ *      no I-cache maintenance.
+ *
+ * The loaded code runs with zero wait states and stays out of the 16 KB
+ * I-cache, which keeps the rest of the flash code. A routine in quad-SPI
+ * flash works the same way once the QUADSPI is memory mapped (0x90000000),
+ * the MDMA reads it over the AXI like the internal flash.
+ *
+ * Loads and evictions happen in thread mode. An interrupt handler may only
+ * call overlays made resident with ITCM_Overlay_Pin().
+ *
+ * ITCM_Overlay_Benchmark() compares three routines of this file (CRC-32,
+ * Fletcher-32, FNV-1a over 64 bytes) called in flash, execute in place
+ * through the I-cache, and called through the overlays:
+ *
+ *   hot loop   one routine, over and over: both stay warm after the first
+ *              call, the overlay pays its load once
+ *   rotation   the three in turn
+ *   polluted   the three in turn, I-cache invalidated before each call (not
+ *              timed): the rest of the application evicting the lines, the
+ *              flash calls miss every time, the overlays do not
+ *
+ * The I-cache is enabled for the run when it is off, and disabled again
+ * after. The overlays are evicted before each pattern, the first loads are
+ * in the average. The results of both calls are compared, a difference is a bad
+ * copy (errors). Cycle_Counter_Init() must have been called.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "itcm_overlay.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+#define SLOT_FREE                   ( 0xFFU )
+#define SLOT_ADDRESS(s)             ( ITCM_OVERLAY_BASE + (uint32_t)(s) * ITCM_OVERLAY_SLOT_SIZE )
+#define WORD_MASK                   ( ~ 3UL )      // MDMA word transfers, the routine may start on a halfword
+
+// MDMA_CxTCR fields, Reference Manual, MDMA channel x transfer configuration register
+#define MDMA_SIZE_WORD              ( 2UL )
+#define MDMA_TLEN_128               ( 127UL << MDMA_CTCR_TLEN_Pos )
+
+#define BENCH_LENGTH                ( 64U )
+#define BENCH_ROUTINES              ( 3U )
+
+/*************************** Types *************************************/
+
+typedef uint32_t (*Bench_Fn_t)(const uint8_t *data, uint32_t length) ;
+
+/************************** Local Variables ****************************/
+
+static const ITCM_Overlay_t *Table[ITCM_OVERLAY_ROUTINES] ;
+static void * volatile       Thunk[ITCM_OVERLAY_ROUTINES] ;
+static uint32_t              Size[ITCM_OVERLAY_ROUTINES] ;   // 0: called in flash
+static uint32_t              Stamp[ITCM_OVERLAY_ROUTINES] ;  // Last use, LRU
+static uint8_t               Pinned[ITCM_OVERLAY_ROUTINES] ;
+static ITCM_Overlay_Stats_t  Stats[ITCM_OVERLAY_ROUTINES] ;
+static uint8_t               Owner[ITCM_OVERLAY_SLOTS] ;
+static uint32_t              Count ;
+static uint32_t              Clock ;
+
+static uint8_t               Bench_Ids[BENCH_ROUTINES] = { ITCM_OVERLAY_NONE, ITCM_OVERLAY_NONE, ITCM_OVERLAY_NONE };
+static uint8_t               Bench_Data[BENCH_LENGTH] ;
+
+/****************************** Functions ******************************/
+
+/* Benchmark routines: leaf, constants in the literal pool, no switch */
+ITCM_OVERLAY_ROUTINE(Bench_Crc32)
+uint32_t Bench_Crc32(const uint8_t *data, uint32_t length)
+{
+	uint32_t crc = 0xFFFFFFFFUL;
+
+	while (length--)
+	{
+		crc ^= *data++;
+		for (uint32_t bit = 0U; bit < 8U; bit++)
+		{
+			crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+		}
+	}
+	return ~ crc;
+}
+
+ITCM_OVERLAY_ROUTINE(Bench_Fletcher32)
+uint32_t Bench_Fletcher32(const uint8_t *data, uint32_t length)
+{
+	uint32_t s1 = 0xFFFFU, s2 = 0xFFFFU;
+
+	while (length--)
+	{
+		s1 += *data++;
+		s2 += s1;
+		s1  = (s1 & 0xFFFFU) + (s1 >> 16);
+		s2  = (s2 & 0xFFFFU) + (s2 >> 16);
+	}
+	return (s2 << 16) | s1;
+}
+
+ITCM_OVERLAY_ROUTINE(Bench_Fnv1a)
+uint32_t Bench_Fnv1a(const uint8_t *data, uint32_t length)
+{
+	uint32_t hash = 0x811C9DC5UL;
+
+	while (length--)
+	{
+		hash = (hash ^ *data++) * 0x01000193UL;
+	}
+	return hash;
+}
+
+static const ITCM_Overlay_t Bench_Overlays[BENCH_ROUTINES] =
+{
+	ITCM_OVERLAY_ENTRY(Bench_Crc32),
+	ITCM_OVERLAY_ENTRY(Bench_Fletcher32),
+	ITCM_OVERLAY_ENTRY(Bench_Fnv1a),
+};
+
+static const Bench_Fn_t Bench_Flash[BENCH_ROUTINES] = { Bench_Crc32, Bench_Fletcher32, Bench_Fnv1a };
+
+/* Flash to ITCM, word transfers, polled. Returns 0 on a transfer error. */
+static uint8_t MDMA_Copy(uint32_t dst, uint32_t src, uint32_t length)
+{
+	MDMA_Channel_TypeDef *ch = ITCM_OVERLAY_MDMA_CHANNEL;
+
+	/* Step 1: Channel disabled, all flags cleared */
+	ch->CCR  &= ~ MDMA_CCR_EN ;
+	ch->CIFCR = MDMA_CIFCR_CTEIF | MDMA_CIFCR_CCTCIF | MDMA_CIFCR_CBRTIF |
+	            MDMA_CIFCR_CBTIF | MDMA_CIFCR_CLTCIF ;
+
+	/* Step 2: Word reads and writes with increment, one block per software
+	 * request, the destination on the AHBS bus (TCM)
+	 */
+	ch->CTCR   = MDMA_CTCR_SINC_1 | MDMA_CTCR_DINC_1 |
+	             (MDMA_SIZE_WORD << MDMA_CTCR_SSIZE_Pos ) |
+	             (MDMA_SIZE_WORD << MDMA_CTCR_DSIZE_Pos ) |
+	             (MDMA_SIZE_WORD << MDMA_CTCR_SINCOS_Pos) |
+	             (MDMA_SIZE_WORD << MDMA_CTCR_DINCOS_Pos) |
+	             MDMA_TLEN_128 | MDMA_CTCR_TRGM_0 | MDMA_CTCR_SWRM ;
+	ch->CBNDTR = length ;
+	ch->CSAR   = src ;
+	ch->CDAR   = dst ;
+	ch->CBRUR  = 0U ;
+	ch->CLAR   = 0U ;
+	ch->CTBR   = MDMA_CTBR_DBUS ;
+	ch->CMAR   = 0U ;
+	ch->CMDR   = 0U ;
+
+	/* Step 3: Enable, request, wait for the channel transfer complete */
+	ch->CCR  = MDMA_CCR_PL_1 ;
+	ch->CCR |= MDMA_CCR_EN ;
+	ch->CCR |= MDMA_CCR_SWRQ ;
+	while(! (ch->CISR & (MDMA_CISR_CTCIF | MDMA_CISR_TEIF)) ) {}
+
+	if (ch->CISR & MDMA_CISR_TEIF)
+	{
+		ch->CCR  &= ~ MDMA_CCR_EN ;
+		ch->CIFCR = MDMA_CIFCR_CTEIF ;
+		return 0U;
+	}
+	ch->CIFCR = MDMA_CIFCR_CCTCIF | MDMA_CIFCR_CBTIF | MDMA_CIFCR_CBRTIF | MDMA_CIFCR_CLTCIF ;
+	return 1U;
+}
+
+static uint32_t Slots_Of(uint8_t id)
+{
+	return (Size[id] + ITCM_OVERLAY_SLOT_SIZE - 1U) / ITCM_OVERLAY_SLOT_SIZE;
+}
+
+static void Evict(uint8_t id)
+{
+	if (Thunk[id] == 0)
+	{
+		return;
+	}
+	Thunk[id] = 0;
+	for (uint32_t s = 0U; s < ITCM_OVERLAY_SLOTS; s++)
+	{
+		Owner[s] = (Owner[s] == id) ? SLOT_FREE : Owner[s];
+	}
+	Stats[id].evictions++;
+}
+
+/* First slot of the least recently used run of n slots, SLOT_FREE if every
+ * run holds a pinned overlay
+ */
+static uint8_t Choose_Run(uint32_t n)
+{
+	uint8_t  best     = SLOT_FREE;
+	uint32_t best_age = 0xFFFFFFFFUL;
+
+	for (uint32_t first = 0U; first + n <= ITCM_OVERLAY_SLOTS; first++)
+	{
+		uint32_t age = 0U;
+		uint8_t  ok  = 1U;
+
+		for (uint32_t s = first; s < first + n; s++)
+		{
+			uint8_t o = Owner[s];
+
+			if (o == SLOT_FREE)
+			{
+				continue;
+			}
+			if (Pinned[o])
+			{
+				ok = 0U;
+				break;
+			}
+			age = (Stamp[o] + 1U > age) ? Stamp[o] + 1U : age;
+		}
+		if (ok && (age < best_age))
+		{
+			best     = (uint8_t)first;
+			best_age = age;
+		}
+	}
+	return best;
+}
+
+/* Miss: slots, copy, thunk. Returns the flash entry when it cannot load. */
+static void *Load(uint8_t id)
+{
+	uint32_t t0    = Cycle_Counter_Get();
+	uint32_t n     = Slots_Of(id);
+	uint32_t entry = (uint32_t)Table[id]->entry;
+	uint32_t src   = entry & WORD_MASK;
+	uint8_t  first = Choose_Run(n);
+
+	if (first == SLOT_FREE)
+	{
+		Stats[id].xip_calls++;
+		return (void *)Table[id]->entry;
+	}
+
+	/* Step 1: Evict the overlays of the run */
+	for (uint32_t s = first; s < first + n; s++)
+	{
+		if (Owner[s] != SLOT_FREE)
+		{
+			Evict(Owner[s]);
+		}
+	}
+
+	/* Step 2: Copy from the word below the routine, size rounded up to words */
+	if (!MDMA_Copy(SLOT_ADDRESS(first), src, (Size[id] + 3U) & ~ 3UL))
+	{
+		Stats[id].load_errors++;
+		return (void *)Table[id]->entry;
+	}
+	for (uint32_t s = first; s < first + n; s++)
+	{
+		Owner[s] = id;
+	}
+
+	/* Step 3: Copy visible to the instruction fetch, then the thunk */
+	__DSB();
+	__ISB();
+	Thunk[id] = (void *)(SLOT_ADDRESS(first) + (entry - src));
+
+	Stats[id].misses++;
+	Stats[id].bytes       += Size[id];
+	Stats[id].load_cycles += Cycle_Counter_Get() - t0;
+	return Thunk[id];
+}
+
+void ITCM_Overlay_Init(void)
+{
+	RCC->AHB3ENR |= RCC_AHB3ENR_MDMAEN ;
+	ITCM_OVERLAY_MDMA_CHANNEL->CCR &= ~ MDMA_CCR_EN ;
+
+	for (uint32_t s = 0U; s < ITCM_OVERLAY_SLOTS; s++)
+	{
+		Owner[s] = SLOT_FREE;
+	}
+}
+
+/* Returns the id, ITCM_OVERLAY_NONE when the table is full */
+uint8_t ITCM_Overlay_Register(const ITCM_Overlay_t *overlay)
+{
+	uint32_t start = (uint32_t)overlay->entry & WORD_MASK;
+	uint32_t end   = (uint32_t)overlay->end;
+	uint8_t  id;
+
+	if (Count >= ITCM_OVERLAY_ROUTINES)
+	{
+		return ITCM_OVERLAY_NONE;
+	}
+	id = (uint8_t)Count++;
+
+	/* An end label not right after the routine: sections not sorted by the linker */
+	Table[id]  = overlay;
+	Size[id]   = ((end > start) && (end - start <= ITCM_OVERLAY_SLOTS * ITCM_OVERLAY_SLOT_SIZE)) ? (end - start) : 0U;
+	Thunk[id]  = 0;
+	Pinned[id] = 0U;
+
+	return id;
+}
+
+/* Address to call for overlay id, loaded on a miss. Thread mode, or a
+ * pinned overlay.
+ */
+void *ITCM_Overlay_Get(uint8_t id)
+{
+	void *fn;
+
+	if (id >= Count)
+	{
+		return 0;
+	}
+
+	Stats[id].calls++;
+	Stamp[id] = ++Clock;
+
+	fn = Thunk[id];
+	if (fn != 0)
+	{
+		Stats[id].hits++;
+		return fn;
+	}
+	if (Size[id] == 0U)
+	{
+		Stats[id].xip_calls++;
+		return (void *)Table[id]->entry;
+	}
+	return Load(id);
+}
+
+/* Loaded now and never evicted. Returns 0 when it cannot be loaded. */
+uint8_t ITCM_Overlay_Pin(uint8_t id)
+{
+	if ((id >= Count) || (Size[id] == 0U))
+	{
+		return 0U;
+	}
+	if (Thunk[id] == 0)
+	{
+		Stamp[id] = ++Clock;
+		Load(id);
+	}
+	Pinned[id] = (Thunk[id] != 0) ? 1U : 0U;
+	return Pinned[id];
+}
+
+/* Thread mode, not while the routine runs */
+void ITCM_Overlay_Evict(uint8_t id)
+{
+	if (id < Count)
+	{
+		Pinned[id] = 0U;
+		Evict(id);
+	}
+}
+
+/* One overlay, or all of them summed with ITCM_OVERLAY_NONE */
+void ITCM_Overlay_Get_Stats(uint8_t id, ITCM_Overlay_Stats_t *stats)
+{
+	if (id < Count)
+	{
+		*stats = Stats[id];
+		return;
+	}
+
+	*stats = (ITCM_Overlay_Stats_t){ 0 };
+	for (uint32_t i = 0U; i < Count; i++)
+	{
+		stats->calls       += Stats[i].calls;
+		stats->hits        += Stats[i].hits;
+		stats->misses      += Stats[i].misses;
+		stats->evictions   += Stats[i].evictions;
+		stats->xip_calls   += Stats[i].xip_calls;
+		stats->load_errors += Stats[i].load_errors;
+		stats->bytes       += Stats[i].bytes;
+		stats->load_cycles += Stats[i].load_cycles;
+	}
+}
+
+/* calls per pattern, see the comments on top */
+void ITCM_Overlay_Benchmark(uint32_t calls, ITCM_Overlay_Bench_t *bench)
+{
+	static const char * const Patterns[3] = { "hot loop", "rotation", "polluted" };
+	uint32_t misses = 0U, bytes = 0U;
+	uint64_t load_cycles = 0U;
+	uint32_t icache;
+
+	*bench = (ITCM_Overlay_Bench_t){ 0 };
+	if (calls == 0U)
+	{
+		return;
+	}
+
+	/* Step 1: Routines registered once, input data */
+	for (uint32_t r = 0U; r < BENCH_ROUTINES; r++)
+	{
+		if (Bench_Ids[r] == ITCM_OVERLAY_NONE)
+		{
+			Bench_Ids[r] = ITCM_Overlay_Register(&Bench_Overlays[r]);
+		}
+		if (Bench_Ids[r] == ITCM_OVERLAY_NONE)
+		{
+			return;
+		}
+	}
+	for (uint32_t i = 0U; i < BENCH_LENGTH; i++)
+	{
+		Bench_Data[i] = (uint8_t)(i * 37U + 11U);
+	}
+
+	/* Step 2: The flash baseline runs through the I-cache, on for the run
+	 * when the application keeps it off
+	 */
+	icache = SCB->CCR & SCB_CCR_IC_Msk;
+	if (!icache)
+	{
+		SCB_EnableICache();
+	}
+
+	for (uint32_t p = 0U; p < 3U; p++)
+	{
+		ITCM_Overlay_Bench_Row_t *row = &bench->row[p];
+		uint64_t xip = 0U, ovl = 0U;
+		uint32_t before = 0U;
+
+		row->pattern = Patterns[p];
+		for (uint32_t r = 0U; r < BENCH_ROUTINES; r++)
+		{
+			ITCM_Overlay_Evict(Bench_Ids[r]);
+			before += Stats[Bench_Ids[r]].misses;
+		}
+
+		/* Step 3: Same sequence in flash, then through the overlays */
+		for (uint32_t i = 0U; i < calls; i++)
+		{
+			uint32_t   r = (p == 0U) ? 0U : (i % BENCH_ROUTINES);
+			uint32_t   t0, a, b;
+			Bench_Fn_t fn;
+
+			if (p == 2U)
+			{
+				SCB_InvalidateICache();
+			}
+			t0  = Cycle_Counter_Get();
+			a   = Bench_Flash[r](Bench_Data, BENCH_LENGTH);
+			xip += Cycle_Counter_Get() - t0;
+
+			if (p == 2U)
+			{
+				SCB_InvalidateICache();
+			}
+			t0  = Cycle_Counter_Get();
+			fn  = (Bench_Fn_t)ITCM_Overlay_Get(Bench_Ids[r]);
+			b   = fn(Bench_Data, BENCH_LENGTH);
+			ovl += Cycle_Counter_Get() - t0;
+
+			bench->errors += (a != b) ? 1U : 0U;
+		}
+
+		row->xip_cycles     = (uint32_t)(xip / calls);
+		row->overlay_cycles = (uint32_t)(ovl / calls);
+		for (uint32_t r = 0U; r < BENCH_ROUTINES; r++)
+		{
+			row->misses += Stats[Bench_Ids[r]].misses;
+		}
+		row->misses -= before;
+	}
+
+	if (!icache)
+	{
+		SCB_DisableICache();
+	}
+
+	/* Step 4: Cost of one load */
+	for (uint32_t r = 0U; r < BENCH_ROUTINES; r++)
+	{
+		misses      += Stats[Bench_Ids[r]].misses;
+		bytes       += Stats[Bench_Ids[r]].bytes;
+		load_cycles += Stats[Bench_Ids[r]].load_cycles;
+		ITCM_Overlay_Evict(Bench_Ids[r]);
+	}
+	bench->load_cycles = misses ? (uint32_t)(load_cycles / misses) : 0U;
+	bench->load_bytes  = misses ? (bytes / misses) : 0U;
+}
@@ -0,0 +1,127 @@
+/*
+ ******************************************************************************
+ * File              : itcm_overlay.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Code overlays paged from flash into ITCM slots by MDMA
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 9, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * An overlay routine is written with ITCM_OVERLAY_ROUTINE(name) in front of
+ * its definition. It lands in the input section .itcm_overlay.<name>.a,
+ * followed by an empty section .itcm_overlay.<name>.z holding the label
+ * <name>_overlay_end, so the size is known without a map file. The linker
+ * script keeps them in order in the flash .text output section:
+ *
+ *     KEEP(*(SORT_BY_NAME(.itcm_overlay.*)))
+ *
+ * The code is copied to any slot, it must run from any address:
+ *
+ *   - literal pools inside the routine (the GCC default), no jump tables
+ *     in other sections (-fno-jump-tables on the file if it has a switch)
+ *   - calls out of the routine through absolute addresses: long_call
+ *     attribute on the callees, or -mlong-calls on the file. A BL to a
+ *     flash function is PC relative and breaks once copied.
+ *   - no call to another overlay through ITCM_Overlay_Get(), it could
+ *     evict the caller
+ *
+ * An entry whose size cannot be taken (sections not sorted, larger than
+ * the slot area) is called in place in flash, execute in place through the
+ * I-cache, and counted in xip_calls.
+ *
+ ******************************************************************************/
+
+#ifndef _ITCM_OVERLAY_H_
+#define _ITCM_OVERLAY_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+/* ITCM is 64 KB at 0x00000000. The first 4 KB are left out, a null
+ * function pointer then faults instead of running a loaded overlay.
+ */
+#define ITCM_OVERLAY_BASE           ( 0x00001000UL )
+#define ITCM_OVERLAY_SLOT_SIZE      ( 0x00001000UL )
+#define ITCM_OVERLAY_SLOTS          ( 14U )         // Up to 0x0000F000
+#define ITCM_OVERLAY_ROUTINES       ( 16U )
+#define ITCM_OVERLAY_NONE           ( 0xFFU )
+
+#define ITCM_OVERLAY_MDMA_CHANNEL   MDMA_Channel4
+
+#define ITCM_OVERLAY_ROUTINE(name)                                                              \
+	__asm__(".section .itcm_overlay." #name ".z,\"ax\",%progbits\n"                               \
+	        ".global " #name "_overlay_end\n" #name "_overlay_end:\n.previous");                 \
+	extern const uint8_t name##_overlay_end[];                                                \
+	__attribute__((section(".itcm_overlay." #name ".a"), noinline, noclone, used))
+
+#define ITCM_OVERLAY_ENTRY(name)    { #name, (const void *)(name), name##_overlay_end }
+
+// Cast of the entry to the type of the routine: ITCM_OVERLAY_CALL(id, uint32_t (*)(uint32_t))(x)
+#define ITCM_OVERLAY_CALL(id, type) ( (type)ITCM_Overlay_Get(id) )
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	const char *name  ;
+	const void *entry ;  // Routine in flash, Thumb bit set
+	const void *end   ;  // <name>_overlay_end
+} ITCM_Overlay_t;
+
+typedef struct
+{
+	uint32_t calls       ;
+	uint32_t hits        ;  // Already in ITCM
+	uint32_t misses      ;  // Loaded on the call
+	uint32_t evictions   ;
+	uint32_t xip_calls   ;  // Called in flash, no size or no slot
+	uint32_t load_errors ;  // MDMA transfer error, called in flash
+	uint32_t bytes       ;  // Copied into ITCM
+	uint64_t load_cycles ;  // CPU cycles in the loads, slot choice and MDMA copy
+} ITCM_Overlay_Stats_t;
+
+/* Cycles per call, averaged, for one call pattern */
+typedef struct
+{
+	const char *pattern      ;
+	uint32_t    xip_cycles     ;  // Direct call of the routine in flash
+	uint32_t    overlay_cycles ;  // ITCM_Overlay_Get() and the call in ITCM, loads included
+	uint32_t    misses         ;
+} ITCM_Overlay_Bench_Row_t;
+
+typedef struct
+{
+	ITCM_Overlay_Bench_Row_t row[3] ;
+	uint32_t load_cycles  ;  // Per load, average
+	uint32_t load_bytes   ;
+	uint32_t errors       ;  // Overlay and flash results differ
+} ITCM_Overlay_Bench_t;
+
+/************************ Function prototypes ***************************/
+void                        ITCM_Overlay_Init(void) ;
+uint8_t                     ITCM_Overlay_Register(const ITCM_Overlay_t *overlay) ;
+void                       *ITCM_Overlay_Get(uint8_t id) ;
+uint8_t                     ITCM_Overlay_Pin(uint8_t id) ;
+void                        ITCM_Overlay_Evict(uint8_t id) ;
+void                        ITCM_Overlay_Get_Stats(uint8_t id, ITCM_Overlay_Stats_t *stats) ;
+void                        ITCM_Overlay_Benchmark(uint32_t calls, ITCM_Overlay_Bench_t *bench) ;
+
+#endif /* _ITCM_OVERLAY_H_ */
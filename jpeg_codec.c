@@ -0,0 +1,750 @@
+/*
+ ******************************************************************************
+ * File              : jpeg_codec.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Hardware JPEG codec, streaming decode and encode by MDMA
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 22, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Chapter 31, JPEG codec (JPEG)
+ *
+ * Both FIFOs are served by MDMA in buffer transfer mode: the FIFO threshold
+ * flags (MDMA requests 17 and 19) move 32 bytes per request. Blocks longer
+ * than 64 Kbytes are chained from the MDMA interrupt, the codec simply waits
+ * on a full output FIFO or an empty input FIFO meanwhile.
+ *
+ * Decode: JPEG_Codec_Feed() takes chunks of any size and alignment. The
+ * MDMA packs bytes into words (PKE), so a chunk is sent as whole words and
+ * the 0..3 bytes left over are joined with the start of the next chunk and
+ * written by the CPU. The header is parsed by the codec (HDR = 1); at the
+ * end the YCbCr MCUs are in the MCU buffer and JPEG_Codec_Show() converts
+ * them to RGB565 with DMA2D.
+ *
+ * Encode: the RGB565 image is converted to YCbCr MCUs by the CPU, the
+ * quantization tables are the Annex K tables scaled to the quality, the
+ * Huffman tables are the Annex K tables. The codec writes the header.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "stm32h7xx.h"
+#include "jpeg_codec.h"
+#include "ltdc_display.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+// MDMA hardware requests, TSEL[5:0], Reference Manual, Table 95
+#define MDMA_REQUEST_JPEG_INFIFO_TH     ( 17UL )
+#define MDMA_REQUEST_JPEG_OUTFIFO_TH    ( 19UL )
+
+// MDMA_CxTCR fields, Reference Manual, Page 681
+#define MDMA_SIZE_BYTE              ( 0UL )
+#define MDMA_SIZE_WORD              ( 2UL )
+#define MDMA_TLEN_32                ( 31UL << MDMA_CTCR_TLEN_Pos )
+
+// Largest MDMA block kept a multiple of the 32-byte FIFO buffer
+#define JPEG_MDMA_BLOCK             ( 0xFFE0UL )
+
+// CONFR1 COLORSPACE[1:0]: 00 grey, 01 YUV (YCbCr), Reference Manual, Page 1258
+#define JPEG_COLORSPACE_YCBCR       ( 1UL )
+
+#define JPEG_MODE_IDLE              ( 0U )
+#define JPEG_MODE_DECODE            ( 1U )
+#define JPEG_MODE_ENCODE            ( 2U )
+
+/*************************** Types *************************************/
+
+/* One direction of MDMA, blocks chained from the interrupt */
+typedef struct
+{
+	MDMA_Channel_TypeDef *ch        ;
+	uint32_t              next      ;  // Memory address of the next block
+	uint32_t              remaining ;  // Bytes not yet started
+	uint32_t              block     ;  // Bytes of the block in flight
+	uint32_t              done      ;  // Bytes of finished blocks
+	volatile uint8_t      active    ;
+} JPEG_Stream_t;
+
+/************************** Local Variables ****************************/
+
+static JPEG_Stream_t        In  ;
+static JPEG_Stream_t        Out ;
+static volatile uint8_t     Mode ;
+static volatile uint8_t     Error ;
+static uint8_t              Carry[4] ;
+static uint32_t             Carry_Length ;
+static volatile uint8_t     Pad_Pending ;
+static uint32_t             Out_Size ;
+static uint32_t             Out_Length ;
+
+static JPEG_Codec_Info_t    Info ;
+static JPEG_Codec_Stats_t   Stats ;
+static uint32_t             Frame_Start ;
+static uint32_t             Cpu_Cycles ;
+
+static uint8_t *MCU_Buffer(void)
+{
+	return (uint8_t *)JPEG_CODEC_MCU_BUFFER_BASE;
+}
+
+void JPEG_Codec_Init(void)
+{
+	/* Step 1: Clock the codec and the MDMA (AHB3), D2 SRAM1 and SRAM2 (AHB2)
+	 * Reference Manual, Page 448 and 449
+	 */
+	RCC->AHB3ENR |= RCC_AHB3ENR_JPGDECEN | RCC_AHB3ENR_MDMAEN ;
+	RCC->AHB2ENR |= RCC_AHB2ENR_D2SRAM1EN | RCC_AHB2ENR_D2SRAM2EN ;
+
+	/* Step 2: Codec enabled and idle, MDMA channels stopped */
+	JPEG->CONFR0 = 0U ;
+	JPEG->CR     = JPEG_CR_JCEN ;
+	In.ch        = JPEG_CODEC_MDMA_IN;
+	Out.ch       = JPEG_CODEC_MDMA_OUT;
+	In.ch->CCR  &= ~ MDMA_CCR_EN ;
+	Out.ch->CCR &= ~ MDMA_CCR_EN ;
+	Mode         = JPEG_MODE_IDLE;
+
+	NVIC_SetPriority(JPEG_IRQn, 6U);
+	NVIC_EnableIRQ(JPEG_IRQn);
+	NVIC_SetPriority(MDMA_IRQn, 6U);
+	NVIC_EnableIRQ(MDMA_IRQn);
+}
+
+static void Stream_Start_Block(JPEG_Stream_t *s)
+{
+	MDMA_Channel_TypeDef *ch = s->ch;
+
+	s->block = (s->remaining > JPEG_MDMA_BLOCK) ? JPEG_MDMA_BLOCK : s->remaining;
+
+	/* Step 1: Channel disabled, all flags cleared */
+	ch->CCR  &= ~ MDMA_CCR_EN ;
+	ch->CIFCR = MDMA_CIFCR_CTEIF | MDMA_CIFCR_CCTCIF | MDMA_CIFCR_CBRTIF |
+	            MDMA_CIFCR_CBTIF | MDMA_CIFCR_CLTCIF ;
+
+	/* Step 2: 32 bytes per FIFO threshold request (TRGM = 00, buffer mode)
+	 * Input:  bytes from memory packed into words for JPEG_DIR
+	 * Output: words from JPEG_DOR to memory
+	 */
+	if (s == &In)
+	{
+		ch->CTCR = MDMA_CTCR_SINC_1 | MDMA_CTCR_PKE |
+		           (MDMA_SIZE_BYTE << MDMA_CTCR_SSIZE_Pos ) |
+		           (MDMA_SIZE_WORD << MDMA_CTCR_DSIZE_Pos ) |
+		           (MDMA_SIZE_BYTE << MDMA_CTCR_SINCOS_Pos) |
+		           MDMA_TLEN_32 ;
+		ch->CSAR = s->next ;
+		ch->CDAR = (uint32_t)&JPEG->DIR ;
+		ch->CTBR = MDMA_REQUEST_JPEG_INFIFO_TH << MDMA_CTBR_TSEL_Pos ;
+	}
+	else
+	{
+		ch->CTCR = MDMA_CTCR_DINC_1 |
+		           (MDMA_SIZE_WORD << MDMA_CTCR_SSIZE_Pos ) |
+		           (MDMA_SIZE_WORD << MDMA_CTCR_DSIZE_Pos ) |
+		           (MDMA_SIZE_WORD << MDMA_CTCR_DINCOS_Pos) |
+		           MDMA_TLEN_32 ;
+		ch->CSAR = (uint32_t)&JPEG->DOR ;
+		ch->CDAR = s->next ;
+		ch->CTBR = MDMA_REQUEST_JPEG_OUTFIFO_TH << MDMA_CTBR_TSEL_Pos ;
+	}
+	ch->CBNDTR = s->block ;
+	ch->CBRUR  = 0U ;
+	ch->CLAR   = 0U ;
+	ch->CMAR   = 0U ;
+	ch->CMDR   = 0U ;
+
+	/* Step 3: Interrupts on completion and error, enable, requests come from the codec */
+	s->active = 1U;
+	ch->CCR   = MDMA_CCR_PL_1 | MDMA_CCR_CTCIE | MDMA_CCR_TEIE ;
+	ch->CCR  |= MDMA_CCR_EN ;
+}
+
+static void Stream_Start(JPEG_Stream_t *s, uint32_t address, uint32_t length)
+{
+	s->next      = address;
+	s->remaining = length;
+	s->done      = 0U;
+	Stream_Start_Block(s);
+}
+
+/* Stop a stream, returns the bytes moved so far */
+static uint32_t Stream_Stop(JPEG_Stream_t *s)
+{
+	uint32_t moved = s->done;
+
+	if (s->active)
+	{
+		s->ch->CCR &= ~ MDMA_CCR_EN ;
+		while (s->ch->CCR & MDMA_CCR_EN) {}
+		moved    += s->block - (s->ch->CBNDTR & MDMA_CBNDTR_BNDT);
+		s->active = 0U;
+	}
+	return moved;
+}
+
+/* CPU write of one word to the input FIFO */
+static void Write_Word(const uint8_t *bytes)
+{
+	uint32_t word;
+
+	memcpy(&word, bytes, 4U);
+	while (! (JPEG->SR & JPEG_SR_IFNFF) ) {}
+	JPEG->DIR = word ;
+}
+
+/* Step common to decode and encode: stop, flush FIFOs, clear flags */
+static void Codec_Reset(void)
+{
+	(void)Stream_Stop(&In);
+	(void)Stream_Stop(&Out);
+	JPEG->CONFR0 = 0U ;
+	JPEG->CR     = JPEG_CR_JCEN ;
+	JPEG->CR    |= JPEG_CR_IFF | JPEG_CR_OFF ;
+	JPEG->CFR    = JPEG_CFR_CEOCF | JPEG_CFR_CHPDF ;
+
+	Error        = 0U;
+	Carry_Length = 0U;
+	Pad_Pending  = 0U;
+	Out_Length   = 0U;
+	Cpu_Cycles   = 0U;
+	memset(&Info, 0, sizeof(Info));
+	Stats.bytes_in  = 0U;
+	Stats.bytes_out = 0U;
+}
+
+JPEG_Codec_Status_t JPEG_Codec_Decode_Start(void)
+{
+	uint32_t t0 = Cycle_Counter_Get();
+
+	if (Mode != JPEG_MODE_IDLE)
+	{
+		return JPEG_CODEC_BUSY;
+	}
+	Codec_Reset();
+	Mode        = JPEG_MODE_DECODE;
+	Frame_Start = t0;
+
+	/* Step 1: Decode with header processing, Reference Manual, Page 1252 */
+	JPEG->CONFR1 = JPEG_CONFR1_DE | JPEG_CONFR1_HDR ;
+
+	/* Step 2: MCUs go to the MCU buffer, no dirty line may be written over them */
+	SCB_CleanInvalidateDCache_by_Addr((uint32_t *)MCU_Buffer(), (int32_t)JPEG_CODEC_MCU_BUFFER_SIZE);
+	Out_Size = JPEG_CODEC_MCU_BUFFER_SIZE;
+	Stream_Start(&Out, (uint32_t)MCU_Buffer(), Out_Size);
+
+	/* Step 3: FIFO requests to the MDMA, header and end interrupts, start */
+	JPEG->CR     |= JPEG_CR_IDMAEN | JPEG_CR_ODMAEN | JPEG_CR_HPDIE | JPEG_CR_EOCIE ;
+	JPEG->CONFR0  = JPEG_CONFR0_START ;
+
+	Cpu_Cycles += Cycle_Counter_Get() - t0;
+	return JPEG_CODEC_OK;
+}
+
+/* Give the next piece of the JPEG file. The chunk must stay in memory until
+ * JPEG_Codec_Feed_Busy() returns 0. last = 1 on the final chunk.
+ */
+JPEG_Codec_Status_t JPEG_Codec_Feed(const void *chunk, uint32_t length, uint8_t last)
+{
+	const uint8_t *p  = (const uint8_t *)chunk;
+	uint32_t       t0 = Cycle_Counter_Get();
+	uint32_t       words;
+
+	if (Mode != JPEG_MODE_DECODE)
+	{
+		return Error ? JPEG_CODEC_ERROR : JPEG_CODEC_OK;  // Already at the end of the image
+	}
+	if (In.active || Pad_Pending)
+	{
+		return JPEG_CODEC_BUSY;
+	}
+	Stats.bytes_in += length;
+
+	/* Step 1: Complete the word left over by the previous chunk */
+	while ((Carry_Length != 0U) && (Carry_Length < 4U) && (length != 0U))
+	{
+		Carry[Carry_Length++] = *p++;
+		length--;
+	}
+	if (Carry_Length == 4U)
+	{
+		Write_Word(Carry);
+		Carry_Length = 0U;
+	}
+
+	/* Step 2: Whole words by MDMA, the MDMA reads memory, not the D-cache */
+	words = length & ~ 3U;
+	if (words != 0U)
+	{
+		SCB_CleanDCache_by_Addr((uint32_t *)((uint32_t)p & ~ 31U), (int32_t)(words + 32U));
+		Stream_Start(&In, (uint32_t)p, words);
+	}
+
+	/* Step 3: Keep the tail, on the last chunk pad it with zeros after EOI */
+	memcpy(&Carry[Carry_Length], p + words, length - words);
+	Carry_Length += length - words;
+	if (last && (Carry_Length != 0U))
+	{
+		memset(&Carry[Carry_Length], 0, 4U - Carry_Length);
+		Carry_Length = 4U;
+		if (words != 0U)
+		{
+			Pad_Pending = 1U;       // Written when the MDMA is done
+		}
+		else
+		{
+			Write_Word(Carry);
+			Carry_Length = 0U;
+		}
+	}
+
+	Cpu_Cycles += Cycle_Counter_Get() - t0;
+	return JPEG_CODEC_OK;
+}
+
+uint8_t JPEG_Codec_Feed_Busy(void)
+{
+	return In.active || Pad_Pending;
+}
+
+const JPEG_Codec_Info_t *JPEG_Codec_Info(void)
+{
+	return &Info;
+}
+
+const uint8_t *JPEG_Codec_MCU_Buffer(void)
+{
+	return MCU_Buffer();
+}
+
+/* Convert the decoded image to RGB565 at x, y of the display back buffer */
+JPEG_Codec_Status_t JPEG_Codec_Show(uint16_t x, uint16_t y)
+{
+	if (Mode != JPEG_MODE_IDLE)
+	{
+		return JPEG_CODEC_BUSY;
+	}
+	if ((Info.components != 3U) || (Error != 0U))
+	{
+		return JPEG_CODEC_ERROR;  // DMA2D reads YCbCr MCUs only
+	}
+	Display_Convert_YCbCr(MCU_Buffer(), Info.css, x, y, Info.width, Info.height);
+	return JPEG_CODEC_OK;
+}
+
+/* Header parsed: image size and sampling, Reference Manual, Page 1259 */
+static void Read_Header(void)
+{
+	uint32_t hsf = (JPEG->CONFR4 & JPEG_CONFR4_HSF) >> JPEG_CONFR4_HSF_Pos;
+	uint32_t vsf = (JPEG->CONFR4 & JPEG_CONFR4_VSF) >> JPEG_CONFR4_VSF_Pos;
+
+	Info.width      = (uint16_t)(JPEG->CONFR3 >> JPEG_CONFR3_XSIZE_Pos);
+	Info.height     = (uint16_t)(JPEG->CONFR1 >> JPEG_CONFR1_YSIZE_Pos);
+	Info.components = (uint8_t)((JPEG->CONFR1 & JPEG_CONFR1_NF) + 1U);
+	Info.mcus       = (JPEG->CONFR2 & JPEG_CONFR2_NMCU) + 1U;
+
+	if (Info.components == 1U)
+	{
+		Info.css       = JPEG_CSS_444;
+		Info.mcu_bytes = 64U;
+	}
+	else if ((hsf == 2U) && (vsf == 2U))
+	{
+		Info.css       = JPEG_CSS_420;
+		Info.mcu_bytes = 6U * 64U;
+	}
+	else if (hsf == 2U)
+	{
+		Info.css       = JPEG_CSS_422;
+		Info.mcu_bytes = 4U * 64U;
+	}
+	else
+	{
+		Info.css       = JPEG_CSS_444;
+		Info.mcu_bytes = (uint32_t)Info.components * 64U;
+	}
+
+	/* The MCUs must fit, the codec stops with a full output FIFO otherwise */
+	if ((Info.mcus * Info.mcu_bytes) > JPEG_CODEC_MCU_BUFFER_SIZE)
+	{
+		Error = 1U;
+	}
+}
+
+/* RGB565 to YCbCr, JFIF equations in 8.8 fixed point */
+static void To_YCbCr(uint16_t pixel, int32_t *y, int32_t *cb, int32_t *cr)
+{
+	int32_t r = (int32_t)((pixel >> 11) & 0x1FU), g = (int32_t)((pixel >> 5) & 0x3FU), b = (int32_t)(pixel & 0x1FU);
+
+	r = (r << 3) | (r >> 2);
+	g = (g << 2) | (g >> 4);
+	b = (b << 3) | (b >> 2);
+
+	*y  = (  77 * r + 150 * g +  29 * b + 128) >> 8;
+	*cb = (( -43 * r -  85 * g + 128 * b + 128) >> 8) + 128;
+	*cr = (( 128 * r - 107 * g -  21 * b + 128) >> 8) + 128;
+}
+
+/* Build the MCUs: Y blocks left to right, top to bottom, then Cb and Cr.
+ * Pixels outside the image repeat the last column and row.
+ */
+static void Image_To_MCU(const uint16_t *rgb565, uint16_t width, uint16_t height, uint8_t hs, uint8_t vs)
+{
+	uint8_t *o     = MCU_Buffer();
+	uint32_t mcu_w = 8U * hs, mcu_h = 8U * vs;
+
+	for (uint32_t my = 0U; my < height; my += mcu_h)
+	{
+		for (uint32_t mx = 0U; mx < width; mx += mcu_w)
+		{
+			int32_t sum_cb[64] = { 0 }, sum_cr[64] = { 0 };
+
+			for (uint32_t by = 0U; by < vs; by++)
+			{
+				for (uint32_t bx = 0U; bx < hs; bx++)
+				{
+					for (uint32_t i = 0U; i < 64U; i++)
+					{
+						uint32_t px = mx + bx * 8U + (i & 7U), py = my + by * 8U + (i >> 3);
+						int32_t  y, cb, cr;
+						uint32_t c;
+
+						px = (px < width)  ? px : (width  - 1U);
+						py = (py < height) ? py : (height - 1U);
+						To_YCbCr(rgb565[py * width + px], &y, &cb, &cr);
+						*o++ = (uint8_t)((y < 0) ? 0 : (y > 255) ? 255 : y);
+
+						/* Chroma sample of this pixel, averaged over hs x vs pixels */
+						c = ((by * 8U + (i >> 3)) / vs) * 8U + (bx * 8U + (i & 7U)) / hs;
+						sum_cb[c] += cb;
+						sum_cr[c] += cr;
+					}
+				}
+			}
+			for (uint32_t i = 0U; i < 64U; i++)
+			{
+				int32_t cb = sum_cb[i] / (hs * vs);
+				o[i] = (uint8_t)((cb < 0) ? 0 : (cb > 255) ? 255 : cb);
+			}
+			o += 64U;
+			for (uint32_t i = 0U; i < 64U; i++)
+			{
+				int32_t cr = sum_cr[i] / (hs * vs);
+				o[i] = (uint8_t)((cr < 0) ? 0 : (cr > 255) ? 255 : cr);
+			}
+			o += 64U;
+		}
+	}
+}
+
+/* Quantization table in zigzag order, 4 coefficients per word */
+static void Quant_Load(__IO uint32_t *qmem, const uint8_t *base, uint8_t quality)
+{
+	uint8_t q[64];
+
+	JPEG_Quant_Scale(base, quality, q);
+	for (uint32_t i = 0U; i < 16U; i++)
+	{
+		qmem[i] = (uint32_t)q[4U * i] | ((uint32_t)q[4U * i + 1U] << 8) |
+		          ((uint32_t)q[4U * i + 2U] << 16) | ((uint32_t)q[4U * i + 3U] << 24) ;
+	}
+}
+
+/* Huffman encoder memory, one half-word per symbol: (length - 1) << 8 |
+ * code[7:0]. AC symbols are indexed run x 10 + size - 1, EOB is 160
+ * and ZRL 161. Entries 168..175 of an AC table hold 0xFD0..0xFD7.
+ */
+static void Huff_Enc_Load(__IO uint32_t *mem, const JPEG_Huff_Table_t *table, uint8_t ac)
+{
+	uint16_t entry[JPEG_HUFFENC_AC_ENTRIES];
+	uint32_t entries = JPEG_Huff_Enc_Entries(table, ac, entry);
+
+	for (uint32_t i = 0U; i < entries; i += 2U)
+	{
+		mem[i / 2U] = (uint32_t)entry[i] | ((uint32_t)entry[i + 1U] << 16) ;
+	}
+}
+
+/* DHTMEM: BITS and HUFFVAL of DC0, AC0, DC1, AC1 one after the other as
+ * bytes, used by the codec to write the DHT segment of the header
+ */
+static void Huff_DHT_Load(void)
+{
+	static const JPEG_Huff_Table_t *const Tables[4] =
+	{
+		&JPEG_Huff_DC_Luma, &JPEG_Huff_AC_Luma, &JPEG_Huff_DC_Chroma, &JPEG_Huff_AC_Chroma
+	};
+	uint8_t  bytes[sizeof(JPEG->DHTMEM)];
+	uint32_t n = 0U;
+
+	memset(bytes, 0, sizeof(bytes));
+	for (uint32_t t = 0U; t < 4U; t++)
+	{
+		memcpy(&bytes[n], Tables[t]->bits, 16U);
+		memcpy(&bytes[n + 16U], Tables[t]->vals, Tables[t]->count);
+		n += 16U + Tables[t]->count;
+	}
+	for (uint32_t i = 0U; i < (sizeof(bytes) / 4U); i++)
+	{
+		uint32_t word;
+
+		memcpy(&word, &bytes[4U * i], 4U);
+		JPEG->DHTMEM[i] = word ;
+	}
+}
+
+/* Encode an RGB565 image to out (word aligned). Returns when the codec runs,
+ * JPEG_Codec_Wait() then JPEG_Codec_Output_Length() give the file.
+ */
+JPEG_Codec_Status_t JPEG_Codec_Encode(const uint16_t *rgb565, uint16_t width, uint16_t height,
+                                      uint8_t css, uint8_t quality, void *out, uint32_t out_size)
+{
+	uint32_t t0     = Cycle_Counter_Get();
+	uint8_t  hs     = (css == JPEG_CSS_444) ? 1U : 2U;
+	uint8_t  vs     = (css == JPEG_CSS_420) ? 2U : 1U;
+	uint32_t mcus   = ((width + 8U * hs - 1U) / (8U * hs)) * ((height + 8U * vs - 1U) / (8U * vs));
+	uint32_t blocks = (uint32_t)hs * vs + 2U;
+
+	if (Mode != JPEG_MODE_IDLE)
+	{
+		return JPEG_CODEC_BUSY;
+	}
+	if ((width == 0U) || (height == 0U) || (css > JPEG_CSS_420) ||
+	    ((mcus * blocks * 64U) > JPEG_CODEC_MCU_BUFFER_SIZE) || (((uint32_t)out & 3U) != 0U))
+	{
+		return JPEG_CODEC_ERROR;
+	}
+	Codec_Reset();
+	Mode        = JPEG_MODE_ENCODE;
+	Frame_Start = t0;
+
+	/* Step 1: YCbCr MCUs in the MCU buffer, written back for the MDMA */
+	Image_To_MCU(rgb565, width, height, hs, vs);
+	SCB_CleanDCache_by_Addr((uint32_t *)MCU_Buffer(), (int32_t)(mcus * blocks * 64U));
+
+	/* Step 2: Image and components, Reference Manual, Page 1258
+	 * Y uses table 0, Cb and Cr table 1 (quantization and Huffman)
+	 */
+	JPEG->CONFR1 = ((uint32_t)height << JPEG_CONFR1_YSIZE_Pos) | JPEG_CONFR1_HDR |
+	               (2UL << JPEG_CONFR1_NS_Pos) | (JPEG_COLORSPACE_YCBCR << JPEG_CONFR1_COLORSPACE_Pos) |
+	               (2UL << JPEG_CONFR1_NF_Pos) ;
+	JPEG->CONFR2 = mcus - 1U ;
+	JPEG->CONFR3 = (uint32_t)width << JPEG_CONFR3_XSIZE_Pos ;
+	JPEG->CONFR4 = ((uint32_t)hs << JPEG_CONFR4_HSF_Pos) | ((uint32_t)vs << JPEG_CONFR4_VSF_Pos) |
+	               (((uint32_t)hs * vs - 1U) << JPEG_CONFR4_NB_Pos) ;
+	JPEG->CONFR5 = (1UL << JPEG_CONFR5_HSF_Pos) | (1UL << JPEG_CONFR5_VSF_Pos) |
+	               (1UL << JPEG_CONFR5_QT_Pos)  | JPEG_CONFR5_HA | JPEG_CONFR5_HD ;
+	JPEG->CONFR6 = (1UL << JPEG_CONFR6_HSF_Pos) | (1UL << JPEG_CONFR6_VSF_Pos) |
+	               (1UL << JPEG_CONFR6_QT_Pos)  | JPEG_CONFR6_HA | JPEG_CONFR6_HD ;
+	JPEG->CONFR7 = 0U ;
+
+	/* Step 3: Tables */
+	Quant_Load(JPEG->QMEM0, JPEG_Quant_Luma,   quality);
+	Quant_Load(JPEG->QMEM1, JPEG_Quant_Chroma, quality);
+	Huff_Enc_Load(JPEG->HUFFENC_DC0, &JPEG_Huff_DC_Luma,   0U);
+	Huff_Enc_Load(JPEG->HUFFENC_AC0, &JPEG_Huff_AC_Luma,   1U);
+	Huff_Enc_Load(JPEG->HUFFENC_DC1, &JPEG_Huff_DC_Chroma, 0U);
+	Huff_Enc_Load(JPEG->HUFFENC_AC1, &JPEG_Huff_AC_Chroma, 1U);
+	Huff_DHT_Load();
+
+	/* Step 4: MDMA both ways, end interrupt, start */
+	SCB_CleanInvalidateDCache_by_Addr((uint32_t *)out, (int32_t)out_size);
+	Out_Size = out_size & ~ 3U;
+	Stream_Start(&Out, (uint32_t)out, Out_Size);
+	Stream_Start(&In, (uint32_t)MCU_Buffer(), mcus * blocks * 64U);
+	Stats.bytes_in = mcus * blocks * 64U;
+
+	JPEG->CR     |= JPEG_CR_IDMAEN | JPEG_CR_ODMAEN | JPEG_CR_EOCIE ;
+	JPEG->CONFR0  = JPEG_CONFR0_START ;
+
+	Cpu_Cycles += Cycle_Counter_Get() - t0;
+	return JPEG_CODEC_OK;
+}
+
+uint32_t JPEG_Codec_Output_Length(void)
+{
+	return Out_Length;
+}
+
+uint8_t JPEG_Codec_Busy(void)
+{
+	return Mode != JPEG_MODE_IDLE;
+}
+
+JPEG_Codec_Status_t JPEG_Codec_Wait(void)
+{
+	while (Mode != JPEG_MODE_IDLE) {}
+	return Error ? JPEG_CODEC_ERROR : JPEG_CODEC_OK;
+}
+
+void JPEG_Codec_Stats(JPEG_Codec_Stats_t *stats)
+{
+	*stats = Stats;
+}
+
+static void Codec_Finish(void)
+{
+	uint32_t now = Cycle_Counter_Get();
+	uint8_t *out;
+
+	/* Step 1: Stop the MDMA, the output FIFO may hold less than a buffer */
+	(void)Stream_Stop(&In);
+	Out_Length = Stream_Stop(&Out);
+	out        = (uint8_t *)(Out.next - Out.done) ;   // Start of the output buffer
+	while (JPEG->SR & JPEG_SR_OFNEF)
+	{
+		uint32_t word = JPEG->DOR;
+
+		if ((Out_Length + 4U) <= Out_Size)
+		{
+			memcpy(&out[Out_Length], &word, 4U);
+			Out_Length += 4U;
+		}
+		else
+		{
+			Error = 1U;
+		}
+	}
+	JPEG->CONFR0  = 0U ;
+	JPEG->CR     &= ~ (JPEG_CR_IDMAEN | JPEG_CR_ODMAEN | JPEG_CR_HPDIE | JPEG_CR_EOCIE) ;
+	SCB_InvalidateDCache_by_Addr((uint32_t *)out, (int32_t)Out_Size);
+
+	/* Step 2: The codec writes whole words, drop the padding after EOI */
+	if (Mode == JPEG_MODE_ENCODE)
+	{
+		while ((Out_Length >= 2U) && !((out[Out_Length - 2U] == 0xFFU) && (out[Out_Length - 1U] == 0xD9U)) &&
+		       (out[Out_Length - 1U] == 0x00U))
+		{
+			Out_Length--;
+		}
+		Stats.frames_encoded++;
+	}
+	else if (!Error)
+	{
+		Stats.frames_decoded++;
+	}
+	if (Error)
+	{
+		Stats.errors++;
+	}
+
+	/* Step 3: Frame figures */
+	Stats.bytes_out    = Out_Length;
+	Stats.frame_cycles = now - Frame_Start;
+	Stats.cpu_cycles   = Cpu_Cycles + (Cycle_Counter_Get() - now);
+	if (Stats.frame_cycles != 0U)
+	{
+		Stats.fps_x10           = (uint32_t)(((uint64_t)SystemCoreClock * 10U) / Stats.frame_cycles);
+		Stats.cpu_load_permille = (uint32_t)(((uint64_t)Stats.cpu_cycles * 1000U) / Stats.frame_cycles);
+	}
+	Mode = JPEG_MODE_IDLE;
+}
+
+void JPEG_Codec_IRQHandler(void)
+{
+	uint32_t t0 = Cycle_Counter_Get();
+	uint32_t sr = JPEG->SR;
+
+	if (Mode == JPEG_MODE_IDLE)
+	{
+		/* Already finished from the MDMA interrupt */
+		JPEG->CFR = JPEG_CFR_CEOCF | JPEG_CFR_CHPDF ;
+		return;
+	}
+	if (sr & JPEG_SR_HPDF)
+	{
+		JPEG->CFR = JPEG_CFR_CHPDF ;
+		Read_Header();
+		if (Error)
+		{
+			Codec_Finish();
+			return;
+		}
+	}
+	if (sr & JPEG_SR_EOCF)
+	{
+		JPEG->CFR = JPEG_CFR_CEOCF ;
+		Codec_Finish();
+		return;
+	}
+	Cpu_Cycles += Cycle_Counter_Get() - t0;
+}
+
+static void Stream_IRQHandler(JPEG_Stream_t *s)
+{
+	MDMA_Channel_TypeDef *ch = s->ch;
+
+	if (ch->CISR & MDMA_CISR_TEIF)
+	{
+		ch->CIFCR = MDMA_CIFCR_CTEIF ;
+		ch->CCR  &= ~ MDMA_CCR_EN ;
+		s->active = 0U;
+		Error     = 1U;
+		if (Mode != JPEG_MODE_IDLE)
+		{
+			Codec_Finish();
+		}
+		return;
+	}
+
+	if (ch->CISR & MDMA_CISR_CTCIF)
+	{
+		ch->CIFCR = MDMA_CIFCR_CCTCIF | MDMA_CIFCR_CBTIF | MDMA_CIFCR_CBRTIF | MDMA_CIFCR_CLTCIF ;
+
+		s->next      += s->block;
+		s->remaining -= s->block;
+		s->done      += s->block;
+		s->active     = 0U;
+
+		if (s->remaining != 0U)
+		{
+			Stream_Start_Block(s);
+		}
+		else if ((s == &In) && Pad_Pending)
+		{
+			Write_Word(Carry);
+			Carry_Length = 0U;
+			Pad_Pending  = 0U;
+		}
+		else if ((s == &Out) && !((Mode == JPEG_MODE_DECODE) && (s->done == (Info.mcus * Info.mcu_bytes))))
+		{
+			/* Output buffer full before the end of the conversion */
+			Error = 1U;
+			Codec_Finish();
+		}
+	}
+}
+
+/* Called from MDMA_IRQHandler for channels 1 and 2 */
+void JPEG_Codec_MDMA_IRQHandler(void)
+{
+	uint32_t t0 = Cycle_Counter_Get();
+
+	if (MDMA->GISR0 & (1UL << 1))
+	{
+		Stream_IRQHandler(&In);
+	}
+	if (MDMA->GISR0 & (1UL << 2))
+	{
+		Stream_IRQHandler(&Out);
+	}
+	Cpu_Cycles += Cycle_Counter_Get() - t0;
+}
@@ -0,0 +1,103 @@
+/*
+ ******************************************************************************
+ * File              : jpeg_codec.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Hardware JPEG codec, streaming decode and encode by MDMA
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 22, 2026
+ ******************************************************************************/
+
+#ifndef _JPEG_CODEC_H_
+#define _JPEG_CODEC_H_
+
+#include "stm32h7xx.h"
+#include "jpeg_tables.h"
+
+/*************************** Macros ************************************/
+
+/* Decoded MCUs (YCbCr blocks) and encoder input, in D2 SRAM1 and SRAM2.
+ * AXI SRAM is taken by the display framebuffers, the top 32 Kbytes of SRAM2
+ * by the data moved out of DTCM (tcm_profile.h). 224 Kbytes hold a 480x272
+ * 4:2:0 frame (196 Kbytes) or a 4:4:4 frame up to 76000 pixels.
+ */
+#define JPEG_CODEC_MCU_BUFFER_BASE  ( 0x30000000UL )
+#define JPEG_CODEC_MCU_BUFFER_SIZE  ( 0x00038000UL )
+
+// MDMA channels reserved for the codec FIFOs
+#define JPEG_CODEC_MDMA_IN          MDMA_Channel1
+#define JPEG_CODEC_MDMA_OUT         MDMA_Channel2
+
+// Chroma subsampling, same coding as DMA2D_FGPFCCR CSS[1:0]
+#define JPEG_CSS_444                ( 0U )
+#define JPEG_CSS_422                ( 1U )
+#define JPEG_CSS_420                ( 2U )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	JPEG_CODEC_OK = 0  ,
+	JPEG_CODEC_BUSY    ,  // A conversion or a chunk transfer is in progress
+	JPEG_CODEC_ERROR      // Bad stream, buffer too small or MDMA error
+} JPEG_Codec_Status_t;
+
+typedef struct
+{
+	uint16_t width      ;
+	uint16_t height     ;
+	uint8_t  components ;  // 1: grey, 3: YCbCr
+	uint8_t  css        ;  // JPEG_CSS_x
+	uint32_t mcus       ;
+	uint32_t mcu_bytes  ;  // Bytes of one MCU in the MCU buffer
+} JPEG_Codec_Info_t;
+
+typedef struct
+{
+	uint32_t frames_decoded    ;
+	uint32_t frames_encoded    ;
+	uint32_t errors            ;
+	uint32_t bytes_in          ;  // Last frame, bytes given to the codec
+	uint32_t bytes_out         ;  // Last frame, bytes taken from the codec
+	uint32_t frame_cycles      ;  // Last frame, start to end of conversion
+	uint32_t cpu_cycles        ;  // Last frame, CPU time in the driver and its interrupts
+	uint32_t fps_x10           ;  // 10 x frames per second of the last frame
+	uint32_t cpu_load_permille ;  // cpu_cycles / frame_cycles
+} JPEG_Codec_Stats_t;
+
+/************************ Function prototypes ***************************/
+void                JPEG_Codec_Init(void) ;
+
+JPEG_Codec_Status_t JPEG_Codec_Decode_Start(void) ;
+JPEG_Codec_Status_t JPEG_Codec_Feed(const void *chunk, uint32_t length, uint8_t last) ;
+uint8_t             JPEG_Codec_Feed_Busy(void) ;
+const JPEG_Codec_Info_t *JPEG_Codec_Info(void) ;
+const uint8_t      *JPEG_Codec_MCU_Buffer(void) ;
+JPEG_Codec_Status_t JPEG_Codec_Show(uint16_t x, uint16_t y) ;
+
+JPEG_Codec_Status_t JPEG_Codec_Encode(const uint16_t *rgb565, uint16_t width, uint16_t height,
+                                      uint8_t css, uint8_t quality, void *out, uint32_t out_size) ;
+uint32_t            JPEG_Codec_Output_Length(void) ;
+
+uint8_t             JPEG_Codec_Busy(void) ;
+JPEG_Codec_Status_t JPEG_Codec_Wait(void) ;
+void                JPEG_Codec_Stats(JPEG_Codec_Stats_t *stats) ;
+
+void                JPEG_Codec_IRQHandler(void) ;
+void                JPEG_Codec_MDMA_IRQHandler(void) ;
+
+#endif /* _JPEG_CODEC_H_ */
@@ -0,0 +1,189 @@
+/*
+ ******************************************************************************
+ * File              : jpeg_tables.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Baseline JPEG tables, quality scaling and Huffman codes
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 22, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Quality 1..100 scales the Annex K tables the same way as the IJG library:
+ * scale = 5000 / quality below 50, 200 - 2 x quality from 50, so files
+ * from the board and from a PC at the same quality have the same tables.
+ *
+ ******************************************************************************/
+
+#include "jpeg_tables.h"
+
+/************************** Tables *************************************/
+
+const uint8_t JPEG_Zigzag[64] =
+{
+	 0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+	12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+	35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+	58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+};
+
+const uint8_t JPEG_Quant_Luma[64] =
+{
+	16,  11,  10,  16,  24,  40,  51,  61,
+	12,  12,  14,  19,  26,  58,  60,  55,
+	14,  13,  16,  24,  40,  57,  69,  56,
+	14,  17,  22,  29,  51,  87,  80,  62,
+	18,  22,  37,  56,  68, 109, 103,  77,
+	24,  35,  55,  64,  81, 104, 113,  92,
+	49,  64,  78,  87, 103, 121, 120, 101,
+	72,  92,  95,  98, 112, 100, 103,  99
+};
+
+const uint8_t JPEG_Quant_Chroma[64] =
+{
+	17,  18,  24,  47,  99,  99,  99,  99,
+	18,  21,  26,  66,  99,  99,  99,  99,
+	24,  26,  56,  99,  99,  99,  99,  99,
+	47,  66,  99,  99,  99,  99,  99,  99,
+	99,  99,  99,  99,  99,  99,  99,  99,
+	99,  99,  99,  99,  99,  99,  99,  99,
+	99,  99,  99,  99,  99,  99,  99,  99,
+	99,  99,  99,  99,  99,  99,  99,  99
+};
+
+static const uint8_t Vals_DC[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+static const uint8_t Vals_AC_Luma[162] =
+{
+	0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+	0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0,
+	0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+	0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+	0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+	0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+	0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5,
+	0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+	0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+	0xF9, 0xFA
+};
+
+static const uint8_t Vals_AC_Chroma[162] =
+{
+	0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+	0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0,
+	0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26,
+	0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+	0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+	0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+	0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5,
+	0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3,
+	0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA,
+	0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+	0xF9, 0xFA
+};
+
+const JPEG_Huff_Table_t JPEG_Huff_DC_Luma   = { { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,    0 }, Vals_DC,        12U  };
+const JPEG_Huff_Table_t JPEG_Huff_DC_Chroma = { { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,    0 }, Vals_DC,        12U  };
+const JPEG_Huff_Table_t JPEG_Huff_AC_Luma   = { { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7D }, Vals_AC_Luma,   162U };
+const JPEG_Huff_Table_t JPEG_Huff_AC_Chroma = { { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 }, Vals_AC_Chroma, 162U };
+
+/* Scale a natural order table to quality 1..100, result in zigzag order
+ * as stored in a DQT segment and in the JPEG_QMEMx registers.
+ */
+void JPEG_Quant_Scale(const uint8_t *base, uint8_t quality, uint8_t *zigzag_out)
+{
+	uint32_t scale;
+
+	if (quality == 0U)
+	{
+		quality = 1U;
+	}
+	if (quality > 100U)
+	{
+		quality = 100U;
+	}
+	scale = (quality < 50U) ? (5000U / quality) : (200U - 2U * quality);
+
+	for (uint32_t i = 0U; i < 64U; i++)
+	{
+		uint32_t q = ((uint32_t)base[JPEG_Zigzag[i]] * scale + 50U) / 100U;
+
+		zigzag_out[i] = (uint8_t)((q == 0U) ? 1U : (q > 255U) ? 255U : q);
+	}
+}
+
+/* Figures C.1 and C.2: code length and code of every symbol, in the order
+ * of HUFFVAL. Returns the number of codes, 0 if BITS is not valid.
+ */
+uint16_t JPEG_Huff_Codes(const uint8_t *bits, uint8_t *sizes, uint16_t *codes)
+{
+	uint32_t count = 0U;
+	uint32_t code  = 0U;
+
+	for (uint32_t length = 1U; length <= 16U; length++)
+	{
+		for (uint32_t i = 0U; i < bits[length - 1U]; i++)
+		{
+			if ((count >= 256U) || (code >= (1UL << length)))
+			{
+				return 0U;
+			}
+			sizes[count] = (uint8_t)length;
+			codes[count] = (uint16_t)code;
+			count++;
+			code++;
+		}
+		code <<= 1;
+	}
+	return (uint16_t)count;
+}
+
+/* Entries of the HUFFENC memory of the codec for a DC or an AC table, in
+ * the order of the core: DC by category, AC by run x 10 + size - 1 with
+ * EOB at 160 and ZRL at 161. Returns the number of entries, entry holds
+ * JPEG_HUFFENC_AC_ENTRIES.
+ */
+uint32_t JPEG_Huff_Enc_Entries(const JPEG_Huff_Table_t *table, uint8_t ac, uint16_t *entry)
+{
+	uint8_t  sizes[256];
+	uint16_t codes[256];
+	uint32_t entries = ac ? JPEG_HUFFENC_AC_ENTRIES : JPEG_HUFFENC_DC_ENTRIES;
+	uint16_t n       = JPEG_Huff_Codes(table->bits, sizes, codes);
+
+	for (uint32_t i = 0U; i < entries; i++)
+	{
+		entry[i] = (ac && (i >= 168U)) ? (uint16_t)(0x0FD0U + i - 168U) : JPEG_HUFFENC_UNUSED;
+	}
+	for (uint32_t k = 0U; k < n; k++)
+	{
+		uint32_t symbol = table->vals[k];
+		uint32_t index  = symbol;
+
+		if (ac)
+		{
+			index = (symbol == 0x00U) ? 160U : (symbol == 0xF0U) ? 161U :
+			        ((symbol >> 4) * 10U + (symbol & 0x0FU) - 1U);
+		}
+		if (index < entries)
+		{
+			entry[index] = (uint16_t)((((sizes[k] - 1U) & 0x0FU) << 8) | (codes[k] & 0xFFU));
+		}
+	}
+	return entries;
+}
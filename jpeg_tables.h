@@ -0,0 +1,68 @@
+/*
+ ******************************************************************************
+ * File              : jpeg_tables.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Baseline JPEG tables, quality scaling and Huffman codes
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 22, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * ITU-T T.81 (ISO/IEC 10918-1), Annex K: example quantization and Huffman
+ * tables, Annex C: generation of the Huffman codes from BITS and HUFFVAL.
+ * No register access: this file is also built into tools/jpeg_soft_bench.c.
+ *
+ ******************************************************************************/
+
+#ifndef _JPEG_TABLES_H_
+#define _JPEG_TABLES_H_
+
+#include <stdint.h>
+
+/*************************** Macros ************************************/
+
+// JPEG_HUFFENC_ACx and DCx entries: (length - 1) << 8 | low byte of the code
+#define JPEG_HUFFENC_AC_ENTRIES     ( 176U )  // 162..175 used by the core
+#define JPEG_HUFFENC_DC_ENTRIES     ( 16U  )  // 12..15 used by the core
+#define JPEG_HUFFENC_UNUSED         ( 0x0FFFU )
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	uint8_t        bits[16] ;  // Number of codes of length 1..16
+	const uint8_t *vals     ;  // Symbols in order of increasing code length
+	uint16_t       count    ;  // Number of symbols, sum of bits[]
+} JPEG_Huff_Table_t;
+
+/************************** Tables *************************************/
+extern const uint8_t           JPEG_Zigzag[64] ;      // Zigzag index -> natural (row major) index
+extern const uint8_t           JPEG_Quant_Luma[64] ;  // Annex K.1, natural order, quality 50
+extern const uint8_t           JPEG_Quant_Chroma[64] ;
+extern const JPEG_Huff_Table_t JPEG_Huff_DC_Luma ;    // Annex K.3
+extern const JPEG_Huff_Table_t JPEG_Huff_DC_Chroma ;
+extern const JPEG_Huff_Table_t JPEG_Huff_AC_Luma ;
+extern const JPEG_Huff_Table_t JPEG_Huff_AC_Chroma ;
+
+/************************ Function prototypes ***************************/
+void     JPEG_Quant_Scale(const uint8_t *base, uint8_t quality, uint8_t *zigzag_out) ;
+uint16_t JPEG_Huff_Codes(const uint8_t *bits, uint8_t *sizes, uint16_t *codes) ;
+uint32_t JPEG_Huff_Enc_Entries(const JPEG_Huff_Table_t *table, uint8_t ac, uint16_t *entry) ;
+
+#endif /* _JPEG_TABLES_H_ */
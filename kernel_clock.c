@@ -0,0 +1,231 @@
+/*
+ ******************************************************************************
+ * File              : kernel_clock.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Kernel clock frequencies and kernel clock planner
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 23, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Figure 49, Kernel clock distribution
+ *
+ * Frequencies are read from the RCC registers as they are now, not from
+ * the clock profile, so a PLL started by a driver (PLL2, PLL3) is seen by
+ * the others. A clock that is off or an output that is not enabled
+ * (DIVxyEN = 0) reads 0 Hz.
+ *
+ * Kernel_Clock_Plan() goes through the inputs of a peripheral clock
+ * multiplexer in order of preference and keeps the clock and integer
+ * divider closest to the target. Only running clocks are considered.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "kernel_clock.h"
+#include "pll_config.h"
+#include "clock_profile.h"
+
+/************************** Local Variables ****************************/
+
+static const char *const Names[KERNEL_CLOCK_COUNT] =
+{
+	"none", "hsi_ck", "csi_ck", "hse_ck", "hsi48_ck", "lse_ck", "lsi_ck",
+	"pll1_p_ck", "pll1_q_ck", "pll1_r_ck", "pll2_p_ck", "pll2_q_ck", "pll2_r_ck",
+	"pll3_p_ck", "pll3_q_ck", "pll3_r_ck", "per_ck", "sys_ck", "sys_d1cpre_ck",
+	"rcc_hclk", "rcc_pclk1", "rcc_pclk2", "rcc_pclk3", "rcc_pclk4",
+	"rcc_timx_ker_ck", "rcc_timy_ker_ck"
+};
+
+// D1CPRE[3:0] and HPRE[3:0]: 0xxx: 1, 1000: 2 ... 1111: 512, Reference Manual, Page 391
+static const uint16_t Ahb_Div[8] = { 2U, 4U, 8U, 16U, 64U, 128U, 256U, 512U };
+
+/* PLLx output 0: P, 1: Q, 2: R, Reference Manual, Page 397 to 408 */
+static uint32_t PLL_Hz(uint32_t pll, uint32_t output)
+{
+	static const uint32_t Ready[3]   = { RCC_CR_PLL1RDY, RCC_CR_PLL2RDY, RCC_CR_PLL3RDY };
+	static const uint8_t  Div_Pos[3] = { 9U, 16U, 24U };
+	__IO uint32_t *divr  = (pll == 0U) ? &RCC->PLL1DIVR  : (pll == 1U) ? &RCC->PLL2DIVR  : &RCC->PLL3DIVR ;
+	__IO uint32_t *fracr = (pll == 0U) ? &RCC->PLL1FRACR : (pll == 1U) ? &RCC->PLL2FRACR : &RCC->PLL3FRACR ;
+	uint32_t divm, n, fracn = 0U, div;
+
+	if (!(RCC->CR & Ready[pll]) || !(RCC->PLLCFGR & (1UL << (16U + 3U * pll + output))))
+	{
+		return 0U;
+	}
+
+	divm = (RCC->PLLCKSELR >> (4U + 8U * pll)) & 0x3FUL;
+	n    = (*divr & 0x1FFUL) + 1U;
+	div  = ((*divr >> Div_Pos[output]) & 0x7FUL) + 1U;
+	if (RCC->PLLCFGR & (1UL << (4U * pll)))
+	{
+		fracn = (*fracr >> 3) & 0x1FFFUL;
+	}
+	if (divm == 0U)
+	{
+		return 0U;
+	}
+
+	return (uint32_t)(((uint64_t)PLL_Source_Hz() * (((uint64_t)n << 13) + fracn)) /
+	                  (((uint64_t)divm << 13) * div));
+}
+
+static uint32_t Ahb_Prescale(uint32_t hz, uint32_t field)
+{
+	return (field & 8U) ? (hz / Ahb_Div[field & 7U]) : hz;
+}
+
+// D1PPRE, D2PPRE1, D2PPRE2, D3PPRE[2:0]: 0xx: 1, 100: 2 ... 111: 16
+static uint32_t Apb_Div(uint32_t field)
+{
+	return (field & 4U) ? (2UL << (field & 3U)) : 1U;
+}
+
+/* Timer kernel clock, TIMPRE in RCC_CFGR, Reference Manual, Page 376 */
+static uint32_t Timer_Hz(uint32_t hclk, uint32_t apb_div)
+{
+	if (RCC->CFGR & RCC_CFGR_TIMPRE)
+	{
+		return (apb_div <= 4U) ? hclk : (4U * (hclk / apb_div));
+	}
+	return (apb_div == 1U) ? hclk : (2U * (hclk / apb_div));
+}
+
+uint32_t Kernel_Clock_Hz(Kernel_Clock_t clock)
+{
+	uint32_t hz;
+
+	switch (clock)
+	{
+		case KERNEL_CLOCK_HSI:
+			return (RCC->CR & RCC_CR_HSIRDY) ? (64000000UL >> ((RCC->CR & RCC_CR_HSIDIV) >> RCC_CR_HSIDIV_Pos)) : 0U;
+		case KERNEL_CLOCK_CSI:
+			return (RCC->CR & RCC_CR_CSIRDY) ? 4000000UL : 0U;
+		case KERNEL_CLOCK_HSE:
+			return (RCC->CR & RCC_CR_HSERDY) ? Clock_Profile_Active()->hse_hz : 0U;
+		case KERNEL_CLOCK_HSI48:
+			return (RCC->CR & RCC_CR_HSI48RDY) ? 48000000UL : 0U;
+		case KERNEL_CLOCK_LSE:
+			return (RCC->BDCR & RCC_BDCR_LSERDY) ? 32768UL : 0U;
+		case KERNEL_CLOCK_LSI:
+			return (RCC->CSR & RCC_CSR_LSIRDY) ? 32000UL : 0U;
+
+		case KERNEL_CLOCK_PLL1_P: case KERNEL_CLOCK_PLL1_Q: case KERNEL_CLOCK_PLL1_R:
+		case KERNEL_CLOCK_PLL2_P: case KERNEL_CLOCK_PLL2_Q: case KERNEL_CLOCK_PLL2_R:
+		case KERNEL_CLOCK_PLL3_P: case KERNEL_CLOCK_PLL3_Q: case KERNEL_CLOCK_PLL3_R:
+			hz = (uint32_t)clock - (uint32_t)KERNEL_CLOCK_PLL1_P;
+			return PLL_Hz(hz / 3U, hz % 3U);
+
+		case KERNEL_CLOCK_PER:
+			/* CKPERSEL[1:0]: 00 HSI, 01 CSI, 10 HSE, Reference Manual, Page 409 */
+			switch ((RCC->D1CCIPR & RCC_D1CCIPR_CKPERSEL) >> RCC_D1CCIPR_CKPERSEL_Pos)
+			{
+				case 0U: return Kernel_Clock_Hz(KERNEL_CLOCK_HSI);
+				case 1U: return Kernel_Clock_Hz(KERNEL_CLOCK_CSI);
+				case 2U: return Kernel_Clock_Hz(KERNEL_CLOCK_HSE);
+				default: return 0U;
+			}
+
+		case KERNEL_CLOCK_SYS:
+			/* SWS[2:0]: 000 HSI, 001 CSI, 010 HSE, 011 PLL1, Reference Manual, Page 389 */
+			switch ((RCC->CFGR & RCC_CFGR_SWS) >> RCC_CFGR_SWS_Pos)
+			{
+				case 0U: return Kernel_Clock_Hz(KERNEL_CLOCK_HSI);
+				case 1U: return Kernel_Clock_Hz(KERNEL_CLOCK_CSI);
+				case 2U: return Kernel_Clock_Hz(KERNEL_CLOCK_HSE);
+				default: return Kernel_Clock_Hz(KERNEL_CLOCK_PLL1_P);
+			}
+
+		case KERNEL_CLOCK_CPU:
+			return Ahb_Prescale(Kernel_Clock_Hz(KERNEL_CLOCK_SYS), (RCC->D1CFGR & RCC_D1CFGR_D1CPRE) >> RCC_D1CFGR_D1CPRE_Pos);
+		case KERNEL_CLOCK_HCLK:
+			return Ahb_Prescale(Kernel_Clock_Hz(KERNEL_CLOCK_CPU), (RCC->D1CFGR & RCC_D1CFGR_HPRE) >> RCC_D1CFGR_HPRE_Pos);
+
+		case KERNEL_CLOCK_PCLK1:
+			return Kernel_Clock_Hz(KERNEL_CLOCK_HCLK) / Apb_Div((RCC->D2CFGR & RCC_D2CFGR_D2PPRE1) >> RCC_D2CFGR_D2PPRE1_Pos);
+		case KERNEL_CLOCK_PCLK2:
+			return Kernel_Clock_Hz(KERNEL_CLOCK_HCLK) / Apb_Div((RCC->D2CFGR & RCC_D2CFGR_D2PPRE2) >> RCC_D2CFGR_D2PPRE2_Pos);
+		case KERNEL_CLOCK_PCLK3:
+			return Kernel_Clock_Hz(KERNEL_CLOCK_HCLK) / Apb_Div((RCC->D1CFGR & RCC_D1CFGR_D1PPRE) >> RCC_D1CFGR_D1PPRE_Pos);
+		case KERNEL_CLOCK_PCLK4:
+			return Kernel_Clock_Hz(KERNEL_CLOCK_HCLK) / Apb_Div((RCC->D3CFGR & RCC_D3CFGR_D3PPRE) >> RCC_D3CFGR_D3PPRE_Pos);
+
+		case KERNEL_CLOCK_TIMX:
+			return Timer_Hz(Kernel_Clock_Hz(KERNEL_CLOCK_HCLK), Apb_Div((RCC->D2CFGR & RCC_D2CFGR_D2PPRE1) >> RCC_D2CFGR_D2PPRE1_Pos));
+		case KERNEL_CLOCK_TIMY:
+			return Timer_Hz(Kernel_Clock_Hz(KERNEL_CLOCK_HCLK), Apb_Div((RCC->D2CFGR & RCC_D2CFGR_D2PPRE2) >> RCC_D2CFGR_D2PPRE2_Pos));
+
+		default:
+			return 0U;
+	}
+}
+
+const char *Kernel_Clock_Name(Kernel_Clock_t clock)
+{
+	return (clock < KERNEL_CLOCK_COUNT) ? Names[clock] : "?";
+}
+
+/* Choose the input and the divider (div_min..div_max) giving the frequency
+ * closest to target_hz. An input above max_hz is not used. Returns 1 when
+ * a running input was found, plan->error_ppm tells how close it is.
+ */
+uint8_t Kernel_Clock_Plan(const Kernel_Clock_Option_t *options, uint32_t count, uint32_t max_hz,
+                          uint32_t target_hz, uint32_t div_min, uint32_t div_max, Kernel_Clock_Plan_t *plan)
+{
+	uint64_t best  = UINT64_MAX;
+	uint8_t  found = 0U;
+
+	if ((target_hz == 0U) || (div_min == 0U))
+	{
+		return 0U;
+	}
+
+	for (uint32_t i = 0U; i < count; i++)
+	{
+		uint32_t hz = Kernel_Clock_Hz(options[i].clock);
+		uint32_t div;
+
+		if ((hz == 0U) || (hz > max_hz))
+		{
+			continue;
+		}
+
+		/* Nearest divider and the one below, both clamped */
+		div = (hz + target_hz / 2U) / target_hz;
+		for (uint32_t d = (div > div_min) ? (div - 1U) : div_min; d <= (div + 1U); d++)
+		{
+			uint32_t k   = (d < div_min) ? div_min : (d > div_max) ? div_max : d;
+			uint32_t out = hz / k;
+			uint64_t err = (out > target_hz) ? (uint64_t)(out - target_hz) : (uint64_t)(target_hz - out);
+
+			if (err < best)
+			{
+				best            = err;
+				found           = 1U;
+				plan->clock     = options[i].clock;
+				plan->sel       = options[i].sel;
+				plan->source_hz = hz;
+				plan->divider   = k;
+				plan->out_hz    = out;
+				plan->error_ppm = (int32_t)((((int64_t)out - (int64_t)target_hz) * 1000000LL) / (int64_t)target_hz);
+			}
+		}
+	}
+	return found;
+}
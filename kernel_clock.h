@@ -0,0 +1,88 @@
+/*
+ ******************************************************************************
+ * File              : kernel_clock.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Kernel clock frequencies and kernel clock planner
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 23, 2026
+ ******************************************************************************/
+
+#ifndef _KERNEL_CLOCK_H_
+#define _KERNEL_CLOCK_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	KERNEL_CLOCK_NONE = 0 ,
+	KERNEL_CLOCK_HSI      ,
+	KERNEL_CLOCK_CSI      ,
+	KERNEL_CLOCK_HSE      ,
+	KERNEL_CLOCK_HSI48    ,
+	KERNEL_CLOCK_LSE      ,
+	KERNEL_CLOCK_LSI      ,
+	KERNEL_CLOCK_PLL1_P   ,
+	KERNEL_CLOCK_PLL1_Q   ,
+	KERNEL_CLOCK_PLL1_R   ,
+	KERNEL_CLOCK_PLL2_P   ,
+	KERNEL_CLOCK_PLL2_Q   ,
+	KERNEL_CLOCK_PLL2_R   ,
+	KERNEL_CLOCK_PLL3_P   ,
+	KERNEL_CLOCK_PLL3_Q   ,
+	KERNEL_CLOCK_PLL3_R   ,
+	KERNEL_CLOCK_PER      ,  // per_ck, CKPERSEL in RCC_D1CCIPR
+	KERNEL_CLOCK_SYS      ,  // sys_ck, before D1CPRE
+	KERNEL_CLOCK_CPU      ,  // sys_d1cpre_ck
+	KERNEL_CLOCK_HCLK     ,  // rcc_hclk1..4
+	KERNEL_CLOCK_PCLK1    ,
+	KERNEL_CLOCK_PCLK2    ,
+	KERNEL_CLOCK_PCLK3    ,
+	KERNEL_CLOCK_PCLK4    ,
+	KERNEL_CLOCK_TIMX     ,  // rcc_timx_ker_ck, APB1 timers
+	KERNEL_CLOCK_TIMY     ,  // rcc_timy_ker_ck, APB2 timers
+	KERNEL_CLOCK_COUNT
+} Kernel_Clock_t;
+
+/* One input of a kernel clock multiplexer: the clock and the value of the
+ * xxxSEL field that selects it
+ */
+typedef struct
+{
+	Kernel_Clock_t clock ;
+	uint8_t        sel   ;
+} Kernel_Clock_Option_t;
+
+typedef struct
+{
+	Kernel_Clock_t clock     ;
+	uint8_t        sel       ;
+	uint32_t       source_hz ;
+	uint32_t       divider   ;
+	uint32_t       out_hz    ;  // source_hz / divider
+	int32_t        error_ppm ;  // (out_hz - target) / target
+} Kernel_Clock_Plan_t;
+
+/************************ Function prototypes ***************************/
+uint32_t    Kernel_Clock_Hz(Kernel_Clock_t clock) ;
+const char *Kernel_Clock_Name(Kernel_Clock_t clock) ;
+uint8_t     Kernel_Clock_Plan(const Kernel_Clock_Option_t *options, uint32_t count, uint32_t max_hz,
+                              uint32_t target_hz, uint32_t div_min, uint32_t div_max, Kernel_Clock_Plan_t *plan) ;
+
+#endif /* _KERNEL_CLOCK_H_ */
@@ -0,0 +1,213 @@
+/*
+ ******************************************************************************
+ * File              : lse_clock.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : LSE start-up in the background, drive ramp and CSS
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 5, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * The 32.768 kHz crystal takes up to seconds to start. LSE_Clock_Start()
+ * sets LSEON at the highest drive and returns, the boot goes on. The
+ * LSERDY interrupt (RCC global interrupt) then:
+ *
+ *   - steps the drive down to LSE_CLOCK_DRIVE_RUN, the start-up needs the
+ *     margin, a running crystal does not (AN2867, oscillator design guide)
+ *   - selects the LSE as RTC clock if no RTC clock is selected yet, the CSS
+ *     on LSE is armed after RTCSEL (Reference Manual, LSE clock security
+ *     system)
+ *   - sets LSECSSON with its interrupt
+ *   - calls the listeners with LSE_CLOCK_READY
+ *
+ * A consumer (RTC, LPTIM, HSI trimming) calls LSE_Clock_Attach() at boot and
+ * starts using the LSE in its listener. A listener attached after the LSE
+ * is ready is called at once. On a CSS failure the LSE is off for the rest
+ * of the backup domain life, the listeners get LSE_CLOCK_CSS_FAIL.
+ *
+ * A crystal that never starts has no interrupt: LSE_Clock_State() reports
+ * LSE_CLOCK_TIMEOUT (and calls the listeners once) when it is read more than
+ * LSE_CLOCK_TIMEOUT_NS after the start. The main loop can poll it.
+ *
+ * The LSE is in the backup domain: after a reset with VBAT kept, it is
+ * already running and is reported ready at once.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "lse_clock.h"
+#include "timebase.h"
+
+/*************************** Macros ************************************/
+
+#define BDCR_LSEDRV(drive)          ( ((uint32_t)(drive) << RCC_BDCR_LSEDRV_Pos) & RCC_BDCR_LSEDRV_Msk )
+#define BDCR_RTCSEL_LSE             ( 1UL << RCC_BDCR_RTCSEL_Pos )
+
+/************************** Local Variables ****************************/
+
+static volatile uint8_t   State ;
+static LSE_Clock_Listener_t Listeners[LSE_CLOCK_LISTENERS] ;
+static uint32_t           Listener_Count ;
+static uint64_t           Start_Ns ;
+static uint64_t           Ready_Ns ;
+
+/****************************** Functions ******************************/
+
+static void Publish(LSE_Clock_State_t state)
+{
+	State = (uint8_t)state;
+	for (uint32_t i = 0U; i < Listener_Count; i++)
+	{
+		Listeners[i](state);
+	}
+}
+
+/* Backup domain write access, Reference Manual, PWR_CR1 DBP */
+static void Backup_Unlock(void)
+{
+	PWR->CR1 |= PWR_CR1_DBP ;
+	while(! (PWR->CR1 & PWR_CR1_DBP) ) {}
+}
+
+/* LSE running: run drive, RTC clock, CSS */
+static void Running(void)
+{
+	uint32_t bdcr;
+
+	Backup_Unlock();
+
+	/* Step 1: Drive down once the oscillation is established */
+	RCC->BDCR = (RCC->BDCR & ~ RCC_BDCR_LSEDRV_Msk) | BDCR_LSEDRV(LSE_CLOCK_DRIVE_RUN) ;
+
+	/* Step 2: RTC clock, written once per backup domain life */
+	bdcr = RCC->BDCR;
+	if ((bdcr & RCC_BDCR_RTCSEL_Msk) == 0U)
+	{
+		RCC->BDCR = bdcr | BDCR_RTCSEL_LSE ;
+	}
+
+	/* Step 3: CSS on LSE with its interrupt */
+	RCC->CICR  = RCC_CICR_LSECSSC ;
+	RCC->CIER |= RCC_CIER_LSECSSIE ;
+	RCC->BDCR |= RCC_BDCR_LSECSSON ;
+
+	Ready_Ns = Timebase_Now_Ns();
+	Publish(LSE_CLOCK_READY);
+}
+
+/* Timebase_Init() must have been called */
+void LSE_Clock_Start(void)
+{
+	if (State != LSE_CLOCK_OFF)
+	{
+		return;
+	}
+
+	Backup_Unlock();
+	Start_Ns = Timebase_Now_Ns();
+
+	/* Step 1: Kept by VBAT over the reset */
+	if ((RCC->BDCR & (RCC_BDCR_LSEON | RCC_BDCR_LSERDY)) == (RCC_BDCR_LSEON | RCC_BDCR_LSERDY))
+	{
+		State = LSE_CLOCK_STARTING;
+		Running();
+		return;
+	}
+
+	/* Step 2: Highest drive, then LSEON. LSEDRV is written with the LSE off. */
+	RCC->BDCR &= ~ (RCC_BDCR_LSEON | RCC_BDCR_LSEBYP) ;
+	RCC->BDCR  = (RCC->BDCR & ~ RCC_BDCR_LSEDRV_Msk) | BDCR_LSEDRV(LSE_CLOCK_DRIVE_START) ;
+
+	/* Step 3: LSERDY interrupt on the RCC global interrupt, no waiting */
+	State      = LSE_CLOCK_STARTING;
+	RCC->CICR  = RCC_CICR_LSERDYC ;
+	RCC->CIER |= RCC_CIER_LSERDYIE ;
+	NVIC_SetPriority(RCC_IRQn, 15U);
+	NVIC_EnableIRQ(RCC_IRQn);
+
+	RCC->BDCR |= RCC_BDCR_LSEON ;
+}
+
+LSE_Clock_State_t LSE_Clock_State(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if ((State == LSE_CLOCK_STARTING) && ((Timebase_Now_Ns() - Start_Ns) > LSE_CLOCK_TIMEOUT_NS))
+	{
+		RCC->CIER &= ~ RCC_CIER_LSERDYIE ;
+		Publish(LSE_CLOCK_TIMEOUT);
+	}
+	__set_PRIMASK(primask);
+
+	return (LSE_Clock_State_t)State;
+}
+
+/* Listener called on every state change, at once if the LSE is ready.
+ * Returns 0 when the table is full.
+ */
+uint8_t LSE_Clock_Attach(LSE_Clock_Listener_t listener)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint8_t  ready;
+
+	__disable_irq();
+	if (Listener_Count >= LSE_CLOCK_LISTENERS)
+	{
+		__set_PRIMASK(primask);
+		return 0U;
+	}
+	Listeners[Listener_Count++] = listener;
+	ready = (State == LSE_CLOCK_READY);
+	__set_PRIMASK(primask);
+
+	if (ready)
+	{
+		listener(LSE_CLOCK_READY);
+	}
+	return 1U;
+}
+
+/* LSEON to LSERDY, 0 while not ready */
+uint64_t LSE_Clock_Startup_Ns(void)
+{
+	return (State == LSE_CLOCK_READY) ? (Ready_Ns - Start_Ns) : 0U;
+}
+
+void LSE_Clock_IRQHandler(void)
+{
+	uint32_t flags = RCC->CIFR;
+
+	if ((flags & RCC_CIFR_LSERDYF) && (RCC->CIER & RCC_CIER_LSERDYIE))
+	{
+		RCC->CICR  = RCC_CICR_LSERDYC ;
+		RCC->CIER &= ~ RCC_CIER_LSERDYIE ;
+		if (State == LSE_CLOCK_STARTING)
+		{
+			Running();
+		}
+	}
+
+	if (flags & RCC_CIFR_LSECSSF)
+	{
+		RCC->CICR  = RCC_CICR_LSECSSC ;
+		RCC->CIER &= ~ RCC_CIER_LSECSSIE ;
+		Publish(LSE_CLOCK_CSS_FAIL);
+	}
+}
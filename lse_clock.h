@@ -0,0 +1,69 @@
+/*
+ ******************************************************************************
+ * File              : lse_clock.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : LSE start-up in the background, drive ramp and CSS
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 5, 2026
+ ******************************************************************************/
+
+#ifndef _LSE_CLOCK_H_
+#define _LSE_CLOCK_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+// LSEDRV[1:0] in RCC_BDCR: 0 lowest ... 3 highest drive
+#ifndef LSE_CLOCK_DRIVE_START
+#define LSE_CLOCK_DRIVE_START       ( 3U )      // Fastest and most robust start
+#endif
+#ifndef LSE_CLOCK_DRIVE_RUN
+#define LSE_CLOCK_DRIVE_RUN         ( 0U )      // Lowest current once running, raise for a high ESR crystal
+#endif
+
+// Datasheet DS12110, tSU(LSE) is 2 s typical, margin for a cold crystal
+#define LSE_CLOCK_TIMEOUT_NS        ( 5000000000ULL )
+#define LSE_CLOCK_LISTENERS         ( 4U )
+#define LSE_CLOCK_HZ                ( 32768UL )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	LSE_CLOCK_OFF = 0   ,
+	LSE_CLOCK_STARTING  ,  // LSEON set, waiting for LSERDY
+	LSE_CLOCK_READY     ,  // Running at the run drive, CSS armed
+	LSE_CLOCK_TIMEOUT   ,  // No LSERDY within LSE_CLOCK_TIMEOUT_NS
+	LSE_CLOCK_CSS_FAIL     // Clock security system detected a failure
+} LSE_Clock_State_t;
+
+/* Called on READY, TIMEOUT and CSS_FAIL, from the RCC interrupt or from the
+ * caller of LSE_Clock_State()
+ */
+typedef void (*LSE_Clock_Listener_t)(LSE_Clock_State_t state);
+
+/************************ Function prototypes ***************************/
+void              LSE_Clock_Start(void) ;
+LSE_Clock_State_t LSE_Clock_State(void) ;
+uint8_t           LSE_Clock_Attach(LSE_Clock_Listener_t listener) ;
+uint64_t          LSE_Clock_Startup_Ns(void) ;
+
+void              LSE_Clock_IRQHandler(void) ;
+
+#endif /* _LSE_CLOCK_H_ */
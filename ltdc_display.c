@@ -0,0 +1,456 @@
+/*
+ ******************************************************************************
+ * File              : ltdc_display.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : LTDC display with PLL3_R pixel clock and DMA2D
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 21, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Chapter 32, LCD-TFT display controller
+ * (LTDC) and Chapter 19, Chrom-Art Accelerator controller (DMA2D)
+ *
+ * The pixel clock is ltdc_ker_ck = pll3_r_ck. PLL3 is computed from the
+ * panel timings: pixel clock = refresh x (HSYNC+HBP+width+HFP) x
+ * (VSYNC+VBP+height+VFP), with FRACN3 so the refresh rate is exact.
+ *
+ * Layer 1 shows the front buffer, the application draws in the back buffer
+ * and calls Display_Swap(). The new address is taken by the LTDC during the
+ * next vertical blanking (SRCR VBR), the register reload interrupt tells
+ * that the swap is done.
+ *
+ * DMA2D runs one operation at a time, a new operation waits for the one
+ * in flight. Bytes and busy cycles are counted for the bus-load figures.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "ltdc_display.h"
+#include "pll_config.h"
+#include "clock_profile.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+#define LTDC_PINS_AF                ( 14U )
+
+// DMA2D_CR MODE[2:0], Reference Manual, Page 727
+#define DMA2D_MODE_M2M              ( 0UL << DMA2D_CR_MODE_Pos )
+#define DMA2D_MODE_M2M_PFC          ( 1UL << DMA2D_CR_MODE_Pos )
+#define DMA2D_MODE_R2M              ( 3UL << DMA2D_CR_MODE_Pos )
+
+// LTDC_LxPFCR, Reference Manual, Page 1289
+#define LTDC_PIXEL_FORMAT_RGB565    ( 2UL )
+
+// Blending factors BF1 = constant alpha, BF2 = 1 - constant alpha
+#define LTDC_BLENDING_CONSTANT      ( (4UL << LTDC_LxBFCR_BF1_Pos) | (5UL << LTDC_LxBFCR_BF2_Pos) )
+
+// AXI bus matrix of D1 is 64 bits wide
+#define AXI_BYTES_PER_CLOCK         ( 8U )
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	GPIO_TypeDef *port ;
+	uint8_t       pin  ;
+} Display_Pin_t;
+
+/************************** Local Variables ****************************/
+
+/* RGB565 on the 40 pin FPC connector of the Waveshare board.
+ * Check against the schematic of the board revision in use.
+ */
+static const Display_Pin_t Pins[] =
+{
+	{ GPIOH,  9U }, { GPIOH, 10U }, { GPIOH, 11U }, { GPIOH, 12U }, { GPIOG,  6U },   // R3..R7
+	{ GPIOH, 13U }, { GPIOH, 14U }, { GPIOH, 15U }, { GPIOI,  0U }, { GPIOI,  1U },   // G2..G6
+	{ GPIOI,  2U },                                                                 // G7
+	{ GPIOG, 11U }, { GPIOI,  4U }, { GPIOI,  5U }, { GPIOI,  6U }, { GPIOI,  7U },   // B3..B7
+	{ GPIOG,  7U }, { GPIOI, 10U }, { GPIOI,  9U }, { GPIOF, 10U },                   // CLK, HSYNC, VSYNC, DE
+};
+
+/* Waveshare 4.3inch 480x272 RGB panel, timings of the panel data sheet */
+const Display_Panel_t Display_Panel_4inch3 =
+{
+	.width = 480U, .height = 272U,
+	.hsync = 41U,  .hbp = 2U, .hfp = 2U,
+	.vsync = 10U,  .vbp = 2U, .vfp = 2U,
+	.refresh_hz = 60U,
+	.hspol = 0U, .vspol = 0U, .depol = 0U, .pcpol = 0U,
+};
+
+static const uint8_t Format_Bytes[] = { 4U, 3U, 2U, 2U, 2U };
+
+static const Display_Panel_t *Panel ;
+static volatile uint8_t       Front ;          // Index of the buffer on screen
+static volatile uint8_t       Swap_Pending ;
+static volatile uint8_t       DMA2D_Busy ;
+static uint32_t               DMA2D_Start ;
+static uint32_t               DMA2D_Bytes_Pending ;
+
+static Display_Stats_t        Stats ;
+static uint32_t               Last_Cycles ;
+static uint32_t               Last_Swaps ;
+static uint32_t               Last_DMA2D_Bytes ;
+static uint32_t               Last_DMA2D_Busy ;
+
+static uint16_t *Buffer(uint8_t index)
+{
+	return (uint16_t *)(DISPLAY_FRAMEBUFFER_BASE + (uint32_t)index * DISPLAY_FRAMEBUFFER_SLOT);
+}
+
+static void Display_Pins_Config(void)
+{
+	/* Step 1: Enable clock access to GPIOF, GPIOG, GPIOH and GPIOI */
+	RCC->AHB4ENR |= RCC_AHB4ENR_GPIOFEN | RCC_AHB4ENR_GPIOGEN |
+	                RCC_AHB4ENR_GPIOHEN | RCC_AHB4ENR_GPIOIEN ;
+
+	for (uint32_t i = 0U; i < (sizeof(Pins) / sizeof(Pins[0])); i++)
+	{
+		GPIO_TypeDef *port = Pins[i].port;
+		uint32_t      pin  = Pins[i].pin;
+
+		/* Step 2: Alternate function mode, MODER[1:0] = 1 0 */
+		port->MODER = (port->MODER & ~ (3UL << (2U * pin))) | (2UL << (2U * pin)) ;
+
+		/* Step 3: AF14 = LTDC, Reference Manual, Page 545 */
+		port->AFR[pin >> 3] = (port->AFR[pin >> 3] & ~ (0xFUL << (4U * (pin & 7U)))) |
+		                      ((uint32_t)LTDC_PINS_AF << (4U * (pin & 7U))) ;
+
+		/* Step 4: Push-pull, very high speed */
+		port->OTYPER  &= ~ (1UL << pin) ;
+		port->OSPEEDR |=   (3UL << (2U * pin)) ;
+	}
+}
+
+/* Returns 1 when PLL3 has a legal setting for the panel */
+uint8_t Display_Init(const Display_Panel_t *panel)
+{
+	uint32_t htotal = (uint32_t)panel->hsync + panel->hbp + panel->width  + panel->hfp;
+	uint32_t vtotal = (uint32_t)panel->vsync + panel->vbp + panel->height + panel->vfp;
+	uint32_t ahbp   = (uint32_t)panel->hsync + panel->hbp - 1U;
+	uint32_t avbp   = (uint32_t)panel->vsync + panel->vbp - 1U;
+	uint32_t pitch  = (uint32_t)panel->width * DISPLAY_BYTES_PER_PIXEL;
+
+	if (((uint32_t)panel->height * pitch) > DISPLAY_FRAMEBUFFER_SLOT)
+	{
+		return 0U;
+	}
+
+	/* Step 1: PLL3_R = pixel clock, Reference Manual, Page 363 */
+	Stats.pixel_clock_target = (uint32_t)panel->refresh_hz * htotal * vtotal;
+	if (!PLL_Compute(PLL_Source_Hz(), Stats.pixel_clock_target, PLL_OUTPUT_R, &Stats.pll3))
+	{
+		return 0U;
+	}
+	PLL_Enable(PLL_3, &Stats.pll3, PLL_OUTPUT_R);
+
+	/* Step 2: Pins, LTDC clock (APB3) and DMA2D clock (AHB3)
+	 * Reference Manual, Page 454 and 448
+	 */
+	Display_Pins_Config();
+	RCC->APB3ENR |= RCC_APB3ENR_LTDCEN ;
+	RCC->AHB3ENR |= RCC_AHB3ENR_DMA2DEN ;
+
+	/* Step 3: Synchronization, back porch, active and total widths, all
+	 * accumulated and minus one, Reference Manual, Page 1280
+	 */
+	LTDC->SSCR = (((uint32_t)panel->hsync - 1U) << LTDC_SSCR_HSW_Pos) | ((uint32_t)panel->vsync - 1U) ;
+	LTDC->BPCR = (ahbp << LTDC_BPCR_AHBP_Pos) | avbp ;
+	LTDC->AWCR = ((ahbp + panel->width) << LTDC_AWCR_AAW_Pos) | (avbp + panel->height) ;
+	LTDC->TWCR = ((htotal - 1U) << LTDC_TWCR_TOTALW_Pos) | (vtotal - 1U) ;
+
+	/* Step 4: Polarities and black background */
+	LTDC->GCR  = (panel->hspol ? LTDC_GCR_HSPOL : 0U) | (panel->vspol ? LTDC_GCR_VSPOL : 0U) |
+	             (panel->depol ? LTDC_GCR_DEPOL : 0U) | (panel->pcpol ? LTDC_GCR_PCPOL : 0U) ;
+	LTDC->BCCR = 0U ;
+
+	/* Step 5: Layer 1 covers the active area, RGB565, front buffer
+	 * Reference Manual, Page 1286
+	 */
+	Front = 0U;
+	LTDC_Layer1->WHPCR  = ((ahbp + panel->width)  << LTDC_LxWHPCR_WHSPPOS_Pos) | (ahbp + 1U) ;
+	LTDC_Layer1->WVPCR  = ((avbp + panel->height) << LTDC_LxWVPCR_WVSPPOS_Pos) | (avbp + 1U) ;
+	LTDC_Layer1->PFCR   = LTDC_PIXEL_FORMAT_RGB565 ;
+	LTDC_Layer1->CACR   = 255U ;
+	LTDC_Layer1->DCCR   = 0U ;
+	LTDC_Layer1->BFCR   = LTDC_BLENDING_CONSTANT ;
+	LTDC_Layer1->CFBAR  = (uint32_t)Buffer(Front) ;
+	LTDC_Layer1->CFBLR  = (pitch << LTDC_LxCFBLR_CFBP_Pos) | (pitch + 7U) ;  // Line length + 7 on STM32H7
+	LTDC_Layer1->CFBLNR = panel->height ;
+	LTDC_Layer1->CR     = LTDC_LxCR_LEN ;
+	LTDC->SRCR          = LTDC_SRCR_IMR ;
+
+	/* Step 6: Line interrupt at the first line of vertical blanking, reload,
+	 * FIFO underrun and transfer error interrupts
+	 */
+	LTDC->LIPCR = avbp + panel->height + 1U ;
+	LTDC->ICR   = LTDC_ICR_CLIF | LTDC_ICR_CFUIF | LTDC_ICR_CTERRIF | LTDC_ICR_CRRIF ;
+	LTDC->IER   = LTDC_IER_LIE | LTDC_IER_FUIE | LTDC_IER_TERRIE | LTDC_IER_RRIE ;
+
+	NVIC_SetPriority(LTDC_IRQn, 7U);
+	NVIC_EnableIRQ(LTDC_IRQn);
+	NVIC_SetPriority(LTDC_ER_IRQn, 7U);
+	NVIC_EnableIRQ(LTDC_ER_IRQn);
+	NVIC_SetPriority(DMA2D_IRQn, 8U);
+	NVIC_EnableIRQ(DMA2D_IRQn);
+
+	Panel        = panel;
+	Swap_Pending = 0U;
+	DMA2D_Busy   = 0U;
+	Last_Cycles  = Cycle_Counter_Get();
+
+	/* Step 7: Start the controller */
+	LTDC->GCR |= LTDC_GCR_LTDCEN ;
+	return 1U;
+}
+
+/* The buffer to draw in. Wait for Display_Swap_Pending() to be 0 first,
+ * until then the LTDC may still read it.
+ */
+uint16_t *Display_Back_Buffer(void)
+{
+	return Buffer(Front ^ 1U);
+}
+
+uint8_t Display_Swap_Pending(void)
+{
+	return Swap_Pending;
+}
+
+/* Show the back buffer from the next vertical blanking */
+void Display_Swap(void)
+{
+	uint16_t *back = Display_Back_Buffer();
+
+	Display_DMA2D_Wait();
+
+	/* CPU drawing may still be in the D-cache, the LTDC reads memory */
+	SCB_CleanDCache_by_Addr((uint32_t *)back, (int32_t)((uint32_t)Panel->width * Panel->height * DISPLAY_BYTES_PER_PIXEL));
+
+	Swap_Pending       = 1U;
+	LTDC_Layer1->CFBAR = (uint32_t)back ;
+	LTDC->SRCR         = LTDC_SRCR_VBR ;
+}
+
+void Display_DMA2D_Wait(void)
+{
+	while (DMA2D_Busy) {}
+}
+
+static void DMA2D_Run(uint32_t mode, uint32_t bytes)
+{
+	DMA2D_Bytes_Pending = bytes;
+	DMA2D_Busy          = 1U;
+	DMA2D_Start         = Cycle_Counter_Get();
+	DMA2D->IFCR = DMA2D_IFCR_CTCIF | DMA2D_IFCR_CTEIF | DMA2D_IFCR_CCEIF ;
+	DMA2D->CR   = mode | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START ;
+}
+
+/* Output side of an operation: rectangle x, y, w, h of the back buffer */
+static void DMA2D_Output(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	uint16_t *out = Display_Back_Buffer() + (uint32_t)y * Panel->width + x;
+
+	/* Dirty lines of the CPU would later overwrite what DMA2D writes */
+	SCB_CleanInvalidateDCache_by_Addr((uint32_t *)out, (int32_t)((((uint32_t)h - 1U) * Panel->width + w) * DISPLAY_BYTES_PER_PIXEL));
+
+	DMA2D->OPFCCR = DISPLAY_FORMAT_RGB565 ;
+	DMA2D->OMAR   = (uint32_t)out ;
+	DMA2D->OOR    = (uint32_t)Panel->width - w ;
+	DMA2D->NLR    = ((uint32_t)w << DMA2D_NLR_PL_Pos) | h ;
+}
+
+/* Register to memory: fill a rectangle of the back buffer with one colour */
+void Display_Fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+	Display_DMA2D_Wait();
+
+	DMA2D_Output(x, y, w, h);
+	DMA2D->OCOLR = color ;
+	DMA2D_Run(DMA2D_MODE_R2M, (uint32_t)w * h * DISPLAY_BYTES_PER_PIXEL);
+}
+
+/* Memory to memory: copy an RGB565 image with a line pitch in pixels */
+void Display_Blit(const uint16_t *src, uint16_t src_pitch, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	Display_DMA2D_Wait();
+
+	SCB_CleanDCache_by_Addr((uint32_t *)src, (int32_t)((uint32_t)src_pitch * h * DISPLAY_BYTES_PER_PIXEL));
+
+	DMA2D_Output(x, y, w, h);
+	DMA2D->FGMAR   = (uint32_t)src ;
+	DMA2D->FGOR    = (uint32_t)src_pitch - w ;
+	DMA2D->FGPFCCR = DISPLAY_FORMAT_RGB565 ;
+	DMA2D_Run(DMA2D_MODE_M2M, 2U * (uint32_t)w * h * DISPLAY_BYTES_PER_PIXEL);
+}
+
+/* Memory to memory with pixel format conversion to RGB565,
+ * src_format is one of DISPLAY_FORMAT_x. YCbCr is taken as 4:4:4 MCUs,
+ * src_pitch unused, other formats are ignored.
+ */
+void Display_Convert(const void *src, uint8_t src_format, uint16_t src_pitch, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	uint32_t in_bytes;
+
+	if (src_format == DISPLAY_FORMAT_YCBCR)
+	{
+		Display_Convert_YCbCr(src, DISPLAY_CSS_444, x, y, w, h);
+		return;
+	}
+	if (src_format > DISPLAY_FORMAT_ARGB4444)
+	{
+		return;
+	}
+	in_bytes = Format_Bytes[src_format];
+
+	Display_DMA2D_Wait();
+
+	SCB_CleanDCache_by_Addr((uint32_t *)src, (int32_t)((uint32_t)src_pitch * h * in_bytes));
+
+	DMA2D_Output(x, y, w, h);
+	DMA2D->FGMAR   = (uint32_t)src ;
+	DMA2D->FGOR    = (uint32_t)src_pitch - w ;
+	DMA2D->FGPFCCR = src_format ;
+	DMA2D_Run(DMA2D_MODE_M2M_PFC, (uint32_t)w * h * (in_bytes + DISPLAY_BYTES_PER_PIXEL));
+}
+
+/* Memory to memory with conversion of YCbCr MCUs, as written by the JPEG
+ * codec, to RGB565. Lines of MCUs are padded to the MCU width (8 or 16).
+ */
+void Display_Convert_YCbCr(const void *mcu, uint8_t css, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	uint32_t mcu_w     = (css == DISPLAY_CSS_444) ? 8U : 16U;
+	uint32_t halves    = (css == DISPLAY_CSS_444) ? 6U : (css == DISPLAY_CSS_422) ? 4U : 3U;  // 2 x bytes per pixel
+	uint32_t in_bytes  = ((uint32_t)w * h * halves) / 2U;
+
+	Display_DMA2D_Wait();
+
+	SCB_CleanDCache_by_Addr((uint32_t *)mcu, (int32_t)in_bytes);
+
+	DMA2D_Output(x, y, w, h);
+	DMA2D->FGMAR   = (uint32_t)mcu ;
+	DMA2D->FGOR    = (mcu_w - (w % mcu_w)) % mcu_w ;
+	DMA2D->FGPFCCR = DISPLAY_FORMAT_YCBCR | ((uint32_t)css << DMA2D_FGPFCCR_CSS_Pos) ;
+	DMA2D_Run(DMA2D_MODE_M2M_PFC, in_bytes + (uint32_t)w * h * DISPLAY_BYTES_PER_PIXEL);
+}
+
+/* Frames per second and bus load since the previous call. Call it at least
+ * every 8 s, the window is measured with the 32-bit cycle counter.
+ */
+void Display_Measure(Display_Stats_t *stats)
+{
+	ClockProfile_Freq_t freq;
+	uint32_t now    = Cycle_Counter_Get();
+	uint32_t cycles = now - Last_Cycles;
+	uint32_t htotal, vtotal;
+	uint64_t axi_kbps;
+
+	/* Before Display_Init() there is no panel to measure */
+	if ((Panel == NULL) || (cycles == 0U))
+	{
+		*stats = Stats;
+		return;
+	}
+	htotal = (uint32_t)Panel->hsync + Panel->hbp + Panel->width  + Panel->hfp;
+	vtotal = (uint32_t)Panel->vsync + Panel->vbp + Panel->height + Panel->vfp;
+
+	Stats.fps_x10    = (uint32_t)(((uint64_t)(Stats.swaps - Last_Swaps) * 10U * SystemCoreClock) / cycles);
+	Stats.dma2d_kbps = (uint32_t)(((uint64_t)(Stats.dma2d_bytes - Last_DMA2D_Bytes) * SystemCoreClock) / cycles / 1000U);
+	Stats.dma2d_busy_permille = (uint32_t)(((uint64_t)(Stats.dma2d_busy_cycles - Last_DMA2D_Busy) * 1000U) / cycles);
+
+	/* The LTDC reads every active pixel once per refresh */
+	Stats.ltdc_kbps = (uint32_t)(((uint64_t)Stats.pll3.out_hz * Panel->width * Panel->height * DISPLAY_BYTES_PER_PIXEL) /
+	                             ((uint64_t)htotal * vtotal * 1000U));
+
+	axi_kbps = (Clock_Profile_Frequencies(Clock_Profile_Active(), &freq) == CLOCK_PROFILE_OK) ?
+	           ((uint64_t)freq.hclk_hz * AXI_BYTES_PER_CLOCK / 1000U) : ((uint64_t)SystemCoreClock * 4U / 1000U);
+	Stats.axi_load_permille = (uint32_t)(((uint64_t)Stats.ltdc_kbps + Stats.dma2d_kbps) * 1000U / axi_kbps);
+
+	Last_Cycles      = now;
+	Last_Swaps       = Stats.swaps;
+	Last_DMA2D_Bytes = Stats.dma2d_bytes;
+	Last_DMA2D_Busy  = Stats.dma2d_busy_cycles;
+
+	*stats = Stats;
+}
+
+void Display_LTDC_IRQHandler(void)
+{
+	uint32_t isr = LTDC->ISR;
+
+	/* Line interrupt: start of vertical blanking */
+	if (isr & LTDC_ISR_LIF)
+	{
+		LTDC->ICR = LTDC_ICR_CLIF ;
+		Stats.refreshes++;
+	}
+
+	/* Register reload: the back buffer is now on screen */
+	if (isr & LTDC_ISR_RRIF)
+	{
+		LTDC->ICR = LTDC_ICR_CRRIF ;
+		if (Swap_Pending)
+		{
+			Front        ^= 1U;
+			Swap_Pending  = 0U;
+			Stats.swaps++;
+		}
+	}
+}
+
+/* FIFO underrun: the bus did not deliver pixels in time. Transfer error:
+ * bus error on a framebuffer read. Reference Manual, Page 1276
+ */
+void Display_LTDC_ER_IRQHandler(void)
+{
+	uint32_t isr = LTDC->ISR;
+
+	if (isr & LTDC_ISR_FUIF)
+	{
+		LTDC->ICR = LTDC_ICR_CFUIF ;
+		Stats.fifo_underruns++;
+	}
+	if (isr & LTDC_ISR_TERRIF)
+	{
+		LTDC->ICR = LTDC_ICR_CTERRIF ;
+		Stats.transfer_errors++;
+	}
+}
+
+void Display_DMA2D_IRQHandler(void)
+{
+	uint32_t isr = DMA2D->ISR;
+
+	DMA2D->IFCR = DMA2D_IFCR_CTCIF | DMA2D_IFCR_CTEIF | DMA2D_IFCR_CCEIF ;
+
+	if (isr & DMA2D_ISR_TCIF)
+	{
+		Stats.dma2d_operations++;
+		Stats.dma2d_bytes += DMA2D_Bytes_Pending;
+	}
+	if (isr & (DMA2D_ISR_TEIF | DMA2D_ISR_CEIF))
+	{
+		Stats.transfer_errors++;
+	}
+	Stats.dma2d_busy_cycles += Cycle_Counter_Get() - DMA2D_Start;
+	DMA2D_Busy = 0U;
+}
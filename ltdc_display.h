@@ -0,0 +1,114 @@
+/*
+ ******************************************************************************
+ * File              : ltdc_display.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : LTDC display with PLL3_R pixel clock and DMA2D
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 21, 2026
+ ******************************************************************************/
+
+#ifndef _LTDC_DISPLAY_H_
+#define _LTDC_DISPLAY_H_
+
+#include "stm32h7xx.h"
+#include "pll_config.h"
+
+/*************************** Macros ************************************/
+
+/* Two framebuffers in RGB565, one per 256 Kbytes slot of AXI SRAM (D1).
+ * The ST linker script keeps data in DTCM, so AXI SRAM is free.
+ * For larger panels set the base to 0xC0000000 (FMC SDRAM bank 1) once the
+ * SDRAM controller has been initialised.
+ */
+#define DISPLAY_FRAMEBUFFER_BASE    ( 0x24000000UL )
+#define DISPLAY_FRAMEBUFFER_SLOT    ( 0x00040000UL )
+#define DISPLAY_BYTES_PER_PIXEL     ( 2U )
+
+// DMA2D colour modes, Reference Manual, Page 733
+#define DISPLAY_FORMAT_ARGB8888     ( 0U )
+#define DISPLAY_FORMAT_RGB888       ( 1U )
+#define DISPLAY_FORMAT_RGB565       ( 2U )
+#define DISPLAY_FORMAT_ARGB1555     ( 3U )
+#define DISPLAY_FORMAT_ARGB4444     ( 4U )
+#define DISPLAY_FORMAT_YCBCR        ( 11U )   // Input only, JPEG codec MCUs
+
+// Chroma subsampling of YCbCr input, DMA2D_FGPFCCR CSS[1:0]
+#define DISPLAY_CSS_444             ( 0U )
+#define DISPLAY_CSS_422             ( 1U )
+#define DISPLAY_CSS_420             ( 2U )
+
+#define DISPLAY_RGB565(r, g, b)     ( (uint16_t)((((r) & 0xF8U) << 8) | (((g) & 0xFCU) << 3) | ((b) >> 3)) )
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	uint16_t width      ;
+	uint16_t height     ;
+	uint16_t hsync      ;  // Horizontal sync width in pixel clocks
+	uint16_t hbp        ;  // Horizontal back porch
+	uint16_t hfp        ;  // Horizontal front porch
+	uint16_t vsync      ;  // Vertical sync height in lines
+	uint16_t vbp        ;
+	uint16_t vfp        ;
+	uint8_t  refresh_hz ;
+	uint8_t  hspol      ;  // 1: HSYNC active high
+	uint8_t  vspol      ;  // 1: VSYNC active high
+	uint8_t  depol      ;  // 1: DE active high
+	uint8_t  pcpol      ;  // 1: inverted pixel clock
+} Display_Panel_t;
+
+typedef struct
+{
+	uint32_t     pixel_clock_target ;  // Hz, from the panel timings
+	PLL_Config_t pll3               ;  // PLL3 set-up, pll3.out_hz is pll3_r_ck
+	uint32_t     refreshes          ;  // Vertical blanking periods
+	uint32_t     swaps              ;  // Buffer swaps taken by the LTDC
+	uint32_t     fifo_underruns     ;
+	uint32_t     transfer_errors    ;
+	uint32_t     dma2d_operations   ;
+	uint32_t     dma2d_bytes        ;  // Bytes read and written by DMA2D
+	uint32_t     dma2d_busy_cycles  ;
+	uint32_t     fps_x10            ;  // Frames per second x 10, last window
+	uint32_t     ltdc_kbps          ;  // LTDC framebuffer read bandwidth
+	uint32_t     dma2d_kbps         ;  // DMA2D bandwidth, last window
+	uint32_t     axi_load_permille  ;  // (LTDC + DMA2D) / AXI capacity at hclk
+	uint32_t     dma2d_busy_permille;
+} Display_Stats_t;
+
+/************************ Function prototypes ***************************/
+extern const Display_Panel_t Display_Panel_4inch3 ;
+
+uint8_t   Display_Init(const Display_Panel_t *panel) ;
+uint16_t *Display_Back_Buffer(void) ;
+void      Display_Swap(void) ;
+uint8_t   Display_Swap_Pending(void) ;
+
+void      Display_Fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) ;
+void      Display_Blit(const uint16_t *src, uint16_t src_pitch, uint16_t x, uint16_t y, uint16_t w, uint16_t h) ;
+void      Display_Convert(const void *src, uint8_t src_format, uint16_t src_pitch, uint16_t x, uint16_t y, uint16_t w, uint16_t h) ;
+void      Display_Convert_YCbCr(const void *mcu, uint8_t css, uint16_t x, uint16_t y, uint16_t w, uint16_t h) ;
+void      Display_DMA2D_Wait(void) ;
+
+void      Display_Measure(Display_Stats_t *stats) ;
+
+void      Display_LTDC_IRQHandler(void) ;
+void      Display_LTDC_ER_IRQHandler(void) ;
+void      Display_DMA2D_IRQHandler(void) ;
+
+#endif /* _LTDC_DISPLAY_H_ */
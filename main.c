@@ -52,21 +52,138 @@
 #include "stm32h7xx.h"
 #include "main.h"
 
+/* 500 kbit/s at 80 %, 5 Mbit/s at 75 %, no filters: every frame goes to RX FIFO 0 */
+static const FDCAN_Config_t Can_Config =
+{
+	.nominal_bps         = 500000UL,
+	.data_bps            = 5000000UL,
+	.nominal_sp_permille = 800U,
+	.data_sp_permille    = 750U,
+	.loopback            = 0U,
+	.ram                 = { .std_filters = 0U, .ext_filters = 0U, .rx_fifo0 = 16U, .tx_events = 16U, .tx_fifo = 16U },
+};
+
+/* 48 kHz I2S, 24-bit data in 32-bit slots, 64 frames (1.33 ms) per buffer, RX copied to TX */
+static const SAI_Audio_Config_t Audio_Config =
+{
+	.sample_rate = 48000UL,
+	.slots       = 2U,
+	.slot_bits   = 32U,
+	.data_bits   = 24U,
+	.pll         = PLL_2,
+	.frames      = 64U,
+	.process     = 0,
+};
+
+/* Two PDM microphones on DATIN1, 16 kHz, 8 ms per buffer */
+static const DFSDM_Mic_Config_t Mic_Config =
+{
+	.pcm_rate = 16000UL,
+	.mics     = 2U,
+	.frames   = 128U,
+	.process  = 0,
+};
+
+/* Sensors on I2C1 at 400 kHz, edges of the board pull-ups */
+static const I2C_Engine_Config_t I2C_Config =
+{
+	.speed   = I2C_TIMING_FAST,
+	.rise_ns = 100U,
+	.fall_ns = 20U,
+};
+
+/* Work items of the main loop on the throttle levels of the active profile */
+static Perf_Point_t Perf_Points[CLOCK_THROTTLE_LEVELS];
+Perf_Demand_t       Perf_Demand;
 
 int main(void)
 {
+	uint8_t perf_points;
+	uint8_t perf_ok;
+
 	/* Initialize MCU */
 	SystemInit();
 
+	/* Code and data placed by tools/tcm_placement_tool.c, before they are used */
+	TCM_Placement_Init()   ;
+
+	/* FPU context save policy of the build, before any FP instruction */
+	FPU_Policy_Init()      ;
+
+	/* Vector table copied to DTCM, VTOR moved onto it */
+	Vector_Table_Init()    ;
+
 	/* Configure MCO pins as system pins */
 	MCO_Pins_Config()      ;
 
-	/* Configure the system clock */
-	SystemClock_Config()   ;
+	/* Start the DWT cycle counter used by the benchmarks,
+	 * before the clock set-up so that its steps are timed
+	 */
+	Cycle_Counter_Init()   ;
+
+	/* CPI, exception, sleep, LSU and fold counters for the measurement regions */
+	DWT_Events_Init()      ;
+
+	/* Configure the system clock from the clock profile in flash,
+	 * SystemClock_Config() is used when no valid profile is found
+	 */
+	Clock_Profile_Boot()   ;
 
 	/* Update system clock and D2 clock */
 	SystemCoreClockUpdate();
 
+	/* Start the 64-bit monotonic timebase on TIM5 */
+	Timebase_Init()        ;
+
+	/* 32.768 kHz crystal started in the background, see lse_clock.c */
+	LSE_Clock_Start()      ;
+
+	/* Calendar on the LSE once it runs (LSI if it fails), continues after Standby */
+	RTC_Service_Init()     ;
+
+	/* D1CPRE/HPRE throttle levels of the active profile, TIM5 follows them */
+	Clock_Throttle_Init()  ;
+	Clock_Throttle_Register(Timebase_Clock_Changed);
+
+	/* Work items choose their throttle level, batched per level,
+	 * starting from the undivided clocks (last point)
+	 */
+	perf_points = Perf_Demand_Throttle_Points(Perf_Points);
+	perf_ok     = (perf_points != 0U) &&
+	              (Perf_Demand_Init(&Perf_Demand, Perf_Points, perf_points, perf_points - 1U,
+	                                PERF_POLICY_BATCH) == PERF_DEMAND_OK);
+
+	/* Clock the CRC unit and its MDMA channel */
+	CRC_Engine_Init()      ;
+
+	/* ITCM slots for the overlay routines, MDMA channel 4 loads them */
+	ITCM_Overlay_Init()    ;
+
+	/* Start the RNG and fill the entropy pool in the background */
+	RNG_Entropy_Init()     ;
+
+	/* Start PLL3 and the LTDC for the 4.3inch panel, clear the screen */
+	if (Display_Init(&Display_Panel_4inch3))
+	{
+		Display_Fill(0U, 0U, Display_Panel_4inch3.width, Display_Panel_4inch3.height, 0U);
+		Display_Swap();
+	}
+
+	/* Clock the JPEG codec, MDMA channels 1 and 2 feed its FIFOs */
+	JPEG_Codec_Init()      ;
+
+	/* FDCAN1 at 500 kbit/s nominal, 5 Mbit/s data phase */
+	FDCAN_Init(&Can_Config);
+
+	/* PLL2_P for an exact 12.288 MHz MCLK, SAI1 I2S in and out */
+	SAI_Audio_Init(&Audio_Config);
+
+	/* PDM microphones, CKOUT planned from the running clocks (SAI MCLK) */
+	DFSDM_Mic_Init(&Mic_Config);
+
+	/* I2C1 master, TIMINGR follows the kernel clock (pclk1) */
+	I2C_Engine_Init(&I2C_Config);
+
 	/*Select clocks to output on pins PA8 and PC9 with prescaler values
 	 * Maximum frequency to output on PA8 and PC9 is 100 MHz
 	 * */
@@ -74,6 +191,12 @@ int main(void)
 
 	while (1)
 	{
+		if (perf_ok)
+		{
+			Perf_Demand_Run(&Perf_Demand);
+		}
 
+		/* Reports a crystal that never starts */
+		LSE_Clock_State();
 	}
 }
@@ -35,6 +35,32 @@ extern "C" {
 #include "mco_pins_config.h"
 #include "mco_select_set.h"
 #include "system_clock_config.h"
+#include "clock_profile.h"
+#include "clock_plan.h"
+#include "clock_throttle.h"
+#include "perf_demand.h"
+#include "cycle_counter.h"
+#include "dma_alloc.h"
+#include "crc_engine.h"
+#include "rng_entropy.h"
+#include "ltdc_display.h"
+#include "jpeg_codec.h"
+#include "fdcan.h"
+#include "sai_audio.h"
+#include "dfsdm_mic.h"
+#include "gpio_wave.h"
+#include "hrtim_pwm.h"
+#include "timebase.h"
+#include "lse_clock.h"
+#include "input_capture.h"
+#include "axi_qos.h"
+#include "fpu_policy.h"
+#include "vector_table.h"
+#include "i2c_engine.h"
+#include "rtc_service.h"
+#include "itcm_overlay.h"
+#include "tcm_profile.h"
+#include "dwt_events.h"
 
 
 /************************ Function prototypes ***************************/
@@ -44,6 +70,7 @@ extern void SystemCoreClockUpdate(void);   // ST Microelectronics function
 /************************** Global Variables ***************************/
 extern uint32_t SystemD1Clock;
 extern uint32_t SystemD2Clock;
+extern Perf_Demand_t Perf_Demand;          // Work items of the main loop, Perf_Demand_Submit()
 
 
 
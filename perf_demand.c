@@ -0,0 +1,180 @@
+/*
+ ******************************************************************************
+ * File              : perf_demand.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Work items with performance demands, clock point selection
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 4, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Perf_Demand_Submit() can be called from interrupts, the queue is updated
+ * with interrupts masked. Perf_Demand_Run() is called from the main loop: it
+ * runs every queued item, each after moving to the point chosen by
+ * perf_demand_policy.c. The choice runs with interrupts enabled on a copy
+ * of the queue, the chosen item is checked again with them masked before
+ * it is taken. Submit only appends, so the copy stays valid.
+ *
+ *   same profile     Clock_Throttle_Set(), a few cycles
+ *   other profile    Clock_Throttle_Set(FULL), Clock_Profile_Transition(),
+ *                    Clock_Throttle_Init(), Timebase_Clock_Changed(),
+ *                    then the throttle level of the point
+ *
+ * Times come from Timebase_Now_Ns(), which follows the clock changes.
+ * Perf_Demand_Throttle_Points() gives the three throttle levels of the
+ * active profile as points, the run_mw and idle_mw fields are left 0.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "stm32h7xx.h"
+#include "perf_demand.h"
+#include "clock_plan.h"
+#include "clock_throttle.h"
+#include "timebase.h"
+
+/************************** Local Variables ****************************/
+
+static Perf_Demand_t View ;  // Copy of the queue for Perf_Demand_Choose()
+
+/****************************** Functions ******************************/
+
+Perf_Demand_Status_t Perf_Demand_Submit(Perf_Demand_t *d, const Perf_Work_t *work)
+{
+	uint32_t primask = __get_PRIMASK();
+	Perf_Demand_Status_t status;
+
+	__disable_irq();
+	status = Perf_Demand_Push(d, work);
+	__set_PRIMASK(primask);
+
+	return status;
+}
+
+static Perf_Demand_Status_t Select(Perf_Demand_t *d, uint8_t point)
+{
+	const Perf_Point_t *from = &d->points[d->point];
+	const Perf_Point_t *to   = &d->points[point];
+	uint64_t            t0   = Timebase_Now_Ns();
+	ClockPlan_t         plan;
+
+	/* Step 1: Other profile, from the undivided clocks */
+	if (from->profile != to->profile)
+	{
+		Clock_Throttle_Set(CLOCK_THROTTLE_FULL);
+		if (Clock_Profile_Transition(to->profile, &plan) != CLOCK_PLAN_OK)
+		{
+			Clock_Throttle_Set((ClockThrottle_Level_t)from->throttle);
+			return PERF_DEMAND_ERR_SWITCH;
+		}
+		Clock_Throttle_Init();
+
+		/* Clock_Throttle_Set() skips a level already set: SystemCoreClock
+		 * and SystemD2Clock of the new profile for the drivers
+		 */
+		SystemCoreClockUpdate();
+		Timebase_Clock_Changed();
+	}
+
+	/* Step 2: Throttle level of the point */
+	Clock_Throttle_Set((ClockThrottle_Level_t)to->throttle);
+
+	Perf_Demand_Switched(d, point, Timebase_Now_Ns() - t0);
+	return PERF_DEMAND_OK;
+}
+
+void Perf_Demand_Run(Perf_Demand_t *d)
+{
+	for (;;)
+	{
+		uint32_t    primask = __get_PRIMASK();
+		Perf_Work_t work;
+		uint64_t    start;
+		int32_t     index;
+		uint8_t     point;
+		uint8_t     taken = 0U;
+
+		/* Step 1: Copy of the queue, interrupts masked for the copy only */
+		View.points      = d->points;
+		View.point_count = d->point_count;
+		View.point       = d->point;
+		View.policy      = d->policy;
+		memcpy(View.switch_ns, d->switch_ns, sizeof(View.switch_ns));
+
+		__disable_irq();
+		View.count = d->count;
+		memcpy(View.queue, d->queue, (uint32_t)View.count * sizeof(Perf_Work_t));
+		__set_PRIMASK(primask);
+
+		/* Step 2: Choice on the copy, interrupts enabled */
+		index = Perf_Demand_Choose(&View, Timebase_Now_Ns(), &point);
+		if (index < 0)
+		{
+			return;
+		}
+
+		/* Step 3: Take the item if it is still where the copy had it */
+		__disable_irq();
+		if (((uint32_t)index < d->count) && (d->queue[index].seq == View.queue[index].seq))
+		{
+			Perf_Demand_Take(d, index, &work);
+			taken = 1U;
+		}
+		__set_PRIMASK(primask);
+
+		if (!taken)
+		{
+			continue;
+		}
+
+		/* A refused transition leaves the point in force, the item still runs */
+		if (point != d->point)
+		{
+			Select(d, point);
+		}
+
+		start = Timebase_Now_Ns();
+		work.fn(work.ctx);
+		Perf_Demand_Ran(d, &work, start, Timebase_Now_Ns());
+	}
+}
+
+/* Throttle levels of the active profile, slowest first. Returns the count. */
+uint8_t Perf_Demand_Throttle_Points(Perf_Point_t *points)
+{
+	static const char *Names[CLOCK_THROTTLE_LEVELS] = { "full", "half", "quarter" };
+	uint8_t count = 0U;
+
+	for (int32_t level = CLOCK_THROTTLE_LEVELS - 1; level >= 0; level--)
+	{
+		uint32_t hz = Clock_Throttle_Hz((ClockThrottle_Level_t)level);
+
+		if (hz != 0U)
+		{
+			points[count].name     = Names[level];
+			points[count].profile  = 0;
+			points[count].throttle = (uint8_t)level;
+			points[count].hz       = hz;
+			points[count].run_mw   = 0U;
+			points[count].idle_mw  = 0U;
+			count++;
+		}
+	}
+	return count;
+}
@@ -0,0 +1,133 @@
+/*
+ ******************************************************************************
+ * File              : perf_demand.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Work items with performance demands, clock point selection
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 4, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * A work item declares a minimum CPU clock, an estimate of its CPU cycles
+ * and an optional deadline. The dispatcher picks the next item and the
+ * lowest clock point that serves it. The policy is in
+ * perf_demand_policy.c, shared with the host replay
+ * tools/perf_demand_tool.c. perf_demand.c runs the items on the board.
+ *
+ ******************************************************************************/
+
+#ifndef _PERF_DEMAND_H_
+#define _PERF_DEMAND_H_
+
+#include <stdint.h>
+#include "clock_profile.h"
+
+/*************************** Macros ************************************/
+
+#define PERF_DEMAND_QUEUE           ( 32U )
+#define PERF_DEMAND_POINTS          ( 8U )
+#define PERF_DEADLINE_NONE          ( 0ULL )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	PERF_POLICY_MAX = 0 ,  // Always the fastest point, reference
+	PERF_POLICY_ITEM    ,  // Earliest deadline first, each item at its own lowest point
+	PERF_POLICY_BATCH   ,  // Same, items served by the point in force run first
+	PERF_POLICY_COUNT
+} Perf_Policy_t;
+
+typedef enum
+{
+	PERF_DEMAND_OK = 0     ,
+	PERF_DEMAND_ERR_FULL   ,  // Queue full
+	PERF_DEMAND_ERR_POINTS ,  // No point, too many, not sorted by clock or mixed profiles
+	PERF_DEMAND_ERR_SWITCH    // Clock transition refused, the point in force is kept
+} Perf_Demand_Status_t;
+
+/* A clock operating point, sorted by hz in the table. profile NULL means
+ * the profile in force, the point is then a throttle level only.
+ */
+typedef struct
+{
+	const char           *name     ;
+	const ClockProfile_t *profile  ;
+	uint8_t               throttle ;  // ClockThrottle_Level_t
+	uint32_t              hz       ;  // CPU clock
+	uint32_t              run_mw   ;  // Estimated power, running
+	uint32_t              idle_mw  ;  // Estimated power, waiting for work
+} Perf_Point_t;
+
+typedef void (*Perf_Work_Fn_t)(void *ctx);
+
+typedef struct
+{
+	Perf_Work_Fn_t fn          ;
+	void          *ctx         ;
+	uint32_t       min_hz      ;  // 0: any point
+	uint32_t       cycles      ;  // Estimated CPU cycles, for the deadline check
+	uint64_t       deadline_ns ;  // Absolute, timebase nanoseconds, PERF_DEADLINE_NONE: none
+	uint32_t       seq         ;  // Submission order, set by Perf_Demand_Push()
+} Perf_Work_t;
+
+typedef struct
+{
+	uint32_t runs        ;
+	uint32_t misses      ;  // Items finished after their deadline
+	uint32_t switches    ;
+	uint64_t late_ns_max ;
+	uint64_t switch_ns   ;  // Time spent in clock transitions
+	uint64_t busy_ns[PERF_DEMAND_POINTS] ;
+	uint64_t idle_ns[PERF_DEMAND_POINTS] ;
+} Perf_Stats_t;
+
+typedef struct
+{
+	const Perf_Point_t *points      ;
+	uint8_t             point_count ;
+	uint8_t             point       ;  // Point in force
+	Perf_Policy_t       policy      ;
+	uint32_t            switch_ns[PERF_DEMAND_POINTS][PERF_DEMAND_POINTS] ;  // Estimate, from clock_plan.c
+	Perf_Work_t         queue[PERF_DEMAND_QUEUE] ;
+	uint8_t             count       ;
+	uint32_t            seq         ;
+	Perf_Stats_t        stats       ;
+} Perf_Demand_t;
+
+/************************ Function prototypes ***************************/
+
+/* Portable part, perf_demand_policy.c (firmware and host tool) */
+Perf_Demand_Status_t Perf_Demand_Init(Perf_Demand_t *d, const Perf_Point_t *points, uint8_t count,
+                                      uint8_t start, Perf_Policy_t policy) ;
+Perf_Demand_Status_t Perf_Demand_Push(Perf_Demand_t *d, const Perf_Work_t *work) ;
+int32_t              Perf_Demand_Choose(const Perf_Demand_t *d, uint64_t now_ns, uint8_t *point) ;
+void                 Perf_Demand_Take(Perf_Demand_t *d, int32_t index, Perf_Work_t *work) ;
+void                 Perf_Demand_Switched(Perf_Demand_t *d, uint8_t point, uint64_t ns) ;
+void                 Perf_Demand_Ran(Perf_Demand_t *d, const Perf_Work_t *work, uint64_t start_ns, uint64_t end_ns) ;
+void                 Perf_Demand_Idled(Perf_Demand_t *d, uint64_t ns) ;
+uint64_t             Perf_Demand_Energy_uJ(const Perf_Demand_t *d) ;
+const char          *Perf_Policy_Name(Perf_Policy_t policy) ;
+
+/* Target part, perf_demand.c */
+Perf_Demand_Status_t Perf_Demand_Submit(Perf_Demand_t *d, const Perf_Work_t *work) ;
+void                 Perf_Demand_Run(Perf_Demand_t *d) ;
+uint8_t              Perf_Demand_Throttle_Points(Perf_Point_t *points) ;
+
+#endif /* _PERF_DEMAND_H_ */
@@ -0,0 +1,381 @@
+/*
+ ******************************************************************************
+ * File              : perf_demand_policy.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Work items with performance demands, portable part
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 4, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * No register access in this file, no time source: the caller gives now_ns.
+ *
+ * The class of an item is the lowest point at or above its min_hz at which
+ * it runs for at most PERF_DEMAND_BLOCK_NS. Items run to completion in earliest deadline order (no deadline last, then by
+ * submission), one at a time. The demands of the queue are aggregated: the
+ * next item runs at the lowest point, at or above its class, at which the
+ * whole queue in that order (each item at least at its class) still meets
+ * every deadline within PERF_DEMAND_SLACK_PCT of the time left, the
+ * transition from the point in force included. A short item never runs slow
+ * when a long one waits behind it, and the slack left covers work released
+ * meanwhile.
+ *
+ * PERF_POLICY_BATCH amortises the transitions: the items of the class in
+ * force run first, and lower class items join them while their run time is
+ * shorter than going down and back up. The batch is taken only if a replay
+ * of the whole queue (batch first, then earliest deadline at the needed
+ * points) makes no more items late than earliest deadline first alone.
+ *
+ * The transition times come from Clock_Plan_Compute() between the profiles
+ * of two points, plus one register write for the throttle level.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+#include "perf_demand.h"
+#include "clock_plan.h"
+
+/*************************** Macros ************************************/
+
+#define NS_PER_US                   ( 1000ULL )
+#define NO_DEADLINE_KEY             ( UINT64_MAX )
+
+// Share of the time left to a deadline a plan may use, the rest is kept for
+// work not queued yet
+#ifndef PERF_DEMAND_SLACK_PCT
+#define PERF_DEMAND_SLACK_PCT       ( 50U )
+#endif
+
+// Longest run of one item below the fastest point: items run to completion,
+// new work waits at most this long
+#ifndef PERF_DEMAND_BLOCK_NS
+#define PERF_DEMAND_BLOCK_NS        ( 2000000ULL )
+#endif
+
+/****************************** Functions ******************************/
+
+/* Transition estimate between two points of the table */
+static uint32_t Switch_Ns(const Perf_Point_t *from, const Perf_Point_t *to)
+{
+	uint32_t    us = 0U;
+	ClockPlan_t plan;
+
+	if ((from->profile != to->profile) &&
+	    (Clock_Plan_Compute(from->profile, to->profile, &plan) == CLOCK_PLAN_OK))
+	{
+		us += plan.cost_us;
+	}
+	if ((from->profile != to->profile) || (from->throttle != to->throttle))
+	{
+		us += CLOCK_PLAN_US_REGISTER;
+	}
+	return us * (uint32_t)NS_PER_US;
+}
+
+Perf_Demand_Status_t Perf_Demand_Init(Perf_Demand_t *d, const Perf_Point_t *points, uint8_t count,
+                                      uint8_t start, Perf_Policy_t policy)
+{
+	memset(d, 0, sizeof(*d));
+
+	if ((count == 0U) || (count > PERF_DEMAND_POINTS) || (start >= count))
+	{
+		return PERF_DEMAND_ERR_POINTS;
+	}
+	for (uint8_t i = 0U; i < count; i++)
+	{
+		if ((points[i].hz == 0U) || ((i > 0U) && (points[i].hz < points[i - 1U].hz)) ||
+		    ((points[i].profile == 0) != (points[0].profile == 0)))
+		{
+			return PERF_DEMAND_ERR_POINTS;
+		}
+	}
+
+	d->points      = points;
+	d->point_count = count;
+	d->point       = start;
+	d->policy      = policy;
+
+	for (uint8_t i = 0U; i < count; i++)
+	{
+		for (uint8_t j = 0U; j < count; j++)
+		{
+			d->switch_ns[i][j] = Switch_Ns(&points[i], &points[j]);
+		}
+	}
+	return PERF_DEMAND_OK;
+}
+
+Perf_Demand_Status_t Perf_Demand_Push(Perf_Demand_t *d, const Perf_Work_t *work)
+{
+	if (d->count >= PERF_DEMAND_QUEUE)
+	{
+		return PERF_DEMAND_ERR_FULL;
+	}
+	d->queue[d->count]     = *work;
+	d->queue[d->count].seq = d->seq++;
+	d->count++;
+	return PERF_DEMAND_OK;
+}
+
+static uint64_t Run_Ns(const Perf_Demand_t *d, const Perf_Work_t *w, uint8_t point)
+{
+	return ((uint64_t)w->cycles * 1000000000ULL + d->points[point].hz - 1U) / d->points[point].hz;
+}
+
+/* Lowest point at or above min_hz where the item blocks no longer than
+ * PERF_DEMAND_BLOCK_NS
+ */
+static uint8_t Class_Of(const Perf_Demand_t *d, const Perf_Work_t *w)
+{
+	for (uint8_t i = 0U; i < d->point_count; i++)
+	{
+		if ((d->points[i].hz >= w->min_hz) && (Run_Ns(d, w, i) <= PERF_DEMAND_BLOCK_NS))
+		{
+			return i;
+		}
+	}
+	return (uint8_t)(d->point_count - 1U);
+}
+
+/* Earliest deadline first, no deadline last, submission order on a tie */
+static uint8_t Before(const Perf_Work_t *a, const Perf_Work_t *b)
+{
+	uint64_t ka = (a->deadline_ns == PERF_DEADLINE_NONE) ? NO_DEADLINE_KEY : a->deadline_ns;
+	uint64_t kb = (b->deadline_ns == PERF_DEADLINE_NONE) ? NO_DEADLINE_KEY : b->deadline_ns;
+
+	return (ka < kb) || ((ka == kb) && ((int32_t)(a->seq - b->seq) < 0));
+}
+
+/* First item of the set (bit mask of queue indexes), -1 if empty */
+static int32_t Earliest(const Perf_Demand_t *d, uint32_t set)
+{
+	int32_t best = -1;
+
+	for (uint8_t i = 0U; i < d->count; i++)
+	{
+		if ((set & (1UL << i)) && ((best < 0) || Before(&d->queue[i], &d->queue[best])))
+		{
+			best = (int32_t)i;
+		}
+	}
+	return best;
+}
+
+/* Ends at t later than the share of the slack a plan may use */
+static uint8_t Late(const Perf_Work_t *w, uint64_t now_ns, uint64_t t)
+{
+	return (w->deadline_ns != PERF_DEADLINE_NONE) &&
+	       ((w->deadline_ns <= now_ns) || ((t - now_ns) * 100U > (w->deadline_ns - now_ns) * PERF_DEMAND_SLACK_PCT));
+}
+
+/* 1 if the items of left, in deadline order from now, each at its class or
+ * at q when higher, all end in time
+ */
+static uint8_t Meets(const Perf_Demand_t *d, uint64_t now_ns, uint8_t from, uint8_t q, uint32_t left)
+{
+	uint64_t t = now_ns + d->switch_ns[from][q];
+	uint8_t  p = q;
+
+	while (left)
+	{
+		int32_t            i = Earliest(d, left);
+		const Perf_Work_t *w = &d->queue[i];
+		uint8_t            c = Class_Of(d, w);
+		uint8_t            r = (c > q) ? c : q;
+
+		t   += d->switch_ns[p][r] + Run_Ns(d, w, r);
+		p    = r;
+		left &= ~(1UL << i);
+		if (Late(w, now_ns, t))
+		{
+			return 0U;
+		}
+	}
+	return 1U;
+}
+
+/* Aggregated demand: lowest point at or above the class of the first item
+ * of left that keeps every deadline of left, the fastest one if none does
+ */
+static uint8_t Need(const Perf_Demand_t *d, uint64_t now_ns, uint8_t from, uint32_t left)
+{
+	uint8_t top = (uint8_t)(d->point_count - 1U);
+
+	if (d->policy == PERF_POLICY_MAX)
+	{
+		return top;
+	}
+	for (uint8_t q = Class_Of(d, &d->queue[Earliest(d, left)]); q < top; q++)
+	{
+		if (Meets(d, now_ns, from, q, left))
+		{
+			return q;
+		}
+	}
+	return top;
+}
+
+static uint32_t All(const Perf_Demand_t *d)
+{
+	return (d->count >= 32U) ? 0xFFFFFFFFUL : ((1UL << d->count) - 1U);
+}
+
+/* Late items of the whole queue, the batch first at the point in force */
+static uint32_t Replay_Misses(const Perf_Demand_t *d, uint64_t now_ns, uint32_t batch)
+{
+	uint32_t left   = All(d);
+	uint64_t t      = now_ns;
+	uint8_t  p      = d->point;
+	uint32_t misses = 0U;
+
+	while (left)
+	{
+		uint8_t            in_batch = (left & batch) != 0U;
+		int32_t            i = Earliest(d, in_batch ? (left & batch) : left);
+		const Perf_Work_t *w = &d->queue[i];
+		uint8_t            q = in_batch ? p : Need(d, t, p, left);
+
+		t   += d->switch_ns[p][q] + Run_Ns(d, w, q);
+		p    = q;
+		left &= ~(1UL << i);
+		misses += Late(w, now_ns, t);
+	}
+	return misses;
+}
+
+/* Queue index of the item to run next and the point it runs at, -1 when the
+ * queue is empty
+ */
+int32_t Perf_Demand_Choose(const Perf_Demand_t *d, uint64_t now_ns, uint8_t *point)
+{
+	int32_t first;
+
+	if (d->count == 0U)
+	{
+		return -1;
+	}
+
+	if (d->policy == PERF_POLICY_BATCH)
+	{
+		uint32_t batch = 0U;
+		uint64_t lower_ns[PERF_DEMAND_POINTS] = { 0U };
+
+		/* Step 1: Items of the class in force, and lower ones cheaper to run
+		 * here than to go down for
+		 */
+		for (uint8_t i = 0U; i < d->count; i++)
+		{
+			uint8_t c = Class_Of(d, &d->queue[i]);
+
+			if (c == d->point)
+			{
+				batch |= 1UL << i;
+			}
+			else if (c < d->point)
+			{
+				lower_ns[c] += Run_Ns(d, &d->queue[i], d->point);
+			}
+		}
+		for (uint8_t i = 0U; i < d->count; i++)
+		{
+			uint8_t c = Class_Of(d, &d->queue[i]);
+
+			if ((c < d->point) && (lower_ns[c] < ((uint64_t)d->switch_ns[d->point][c] + d->switch_ns[c][d->point])))
+			{
+				batch |= 1UL << i;
+			}
+		}
+
+		/* Step 2: Batch only if it makes no item late */
+		if (batch && (Replay_Misses(d, now_ns, batch) <= Replay_Misses(d, now_ns, 0U)))
+		{
+			*point = d->point;
+			return Earliest(d, batch);
+		}
+	}
+
+	first  = Earliest(d, All(d));
+	*point = Need(d, now_ns, d->point, All(d));
+	return first;
+}
+
+void Perf_Demand_Take(Perf_Demand_t *d, int32_t index, Perf_Work_t *work)
+{
+	*work = d->queue[index];
+	d->count--;
+	for (uint8_t i = (uint8_t)index; i < d->count; i++)
+	{
+		d->queue[i] = d->queue[i + 1U];
+	}
+}
+
+void Perf_Demand_Switched(Perf_Demand_t *d, uint8_t point, uint64_t ns)
+{
+	if (point != d->point)
+	{
+		d->stats.switches++;
+		d->stats.switch_ns += ns;
+		d->point = point;
+	}
+}
+
+void Perf_Demand_Ran(Perf_Demand_t *d, const Perf_Work_t *work, uint64_t start_ns, uint64_t end_ns)
+{
+	d->stats.runs++;
+	d->stats.busy_ns[d->point] += end_ns - start_ns;
+
+	if ((work->deadline_ns != PERF_DEADLINE_NONE) && (end_ns > work->deadline_ns))
+	{
+		d->stats.misses++;
+		if ((end_ns - work->deadline_ns) > d->stats.late_ns_max)
+		{
+			d->stats.late_ns_max = end_ns - work->deadline_ns;
+		}
+	}
+}
+
+void Perf_Demand_Idled(Perf_Demand_t *d, uint64_t ns)
+{
+	d->stats.idle_ns[d->point] += ns;
+}
+
+/* Estimate from the point powers, transitions at the fastest point power */
+uint64_t Perf_Demand_Energy_uJ(const Perf_Demand_t *d)
+{
+	uint64_t nj = 0U;   // mW x ns = pJ, summed in nJ
+
+	for (uint8_t i = 0U; i < d->point_count; i++)
+	{
+		nj += (d->stats.busy_ns[i] * d->points[i].run_mw ) / 1000U;
+		nj += (d->stats.idle_ns[i] * d->points[i].idle_mw) / 1000U;
+	}
+	nj += (d->stats.switch_ns * d->points[d->point_count - 1U].run_mw) / 1000U;
+	return nj / 1000U;
+}
+
+const char *Perf_Policy_Name(Perf_Policy_t policy)
+{
+	switch (policy)
+	{
+		case PERF_POLICY_MAX:   return "max";
+		case PERF_POLICY_ITEM:  return "per-item";
+		case PERF_POLICY_BATCH: return "batch";
+		default:                return "?";
+	}
+}
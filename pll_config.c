@@ -0,0 +1,265 @@
+/*
+ ******************************************************************************
+ * File              : pll_config.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : PLL2 and PLL3 set-up for an exact output frequency
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 21, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Page 361, 8.5.5 PLL description
+ *
+ *   ref_ck  = src_ck / DIVMx                     1 to 16 MHz
+ *   vco_ck  = ref_ck x (DIVNx + FRACNx / 2^13)   wide: 192 to 836 MHz
+ *                                                medium: 150 to 420 MHz
+ *   out_ck  = vco_ck / DIVPx (DIVQx, DIVRx)
+ *
+ * PLL_Compute() tries every DIVM and every output divider and keeps the
+ * set with the smallest error, FRACN gives 13 more bits of resolution so
+ * most audio and pixel clocks come out exact or within a few ppb.
+ * All PLLs share the PLLSRC source, it is not changed here.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "pll_config.h"
+#include "clock_profile.h"
+
+/*************************** Macros ************************************/
+
+#define PLL_REF_MIN_HZ              (   1000000UL )
+#define PLL_REF_MAX_HZ              (  16000000UL )
+#define PLL_VCO_WIDE_MIN_HZ         ( 192000000ULL )
+#define PLL_VCO_WIDE_MAX_HZ         ( 836000000ULL )
+#define PLL_VCO_MEDIUM_MIN_HZ       ( 150000000ULL )
+#define PLL_VCO_MEDIUM_MAX_HZ       ( 420000000ULL )
+
+/*************************** Types *************************************/
+
+/* Register fields of PLL2 and PLL3 that are at different places */
+typedef struct
+{
+	__IO uint32_t *divr      ;
+	__IO uint32_t *fracr     ;
+	uint32_t       divm_pos  ;
+	uint32_t       cfg_pos   ;  // PLLxFRACEN, PLLxVCOSEL at +1, PLLxRGE at +2
+	uint32_t       diven_pos ;  // DIVPxEN, DIVQxEN at +1, DIVRxEN at +2
+	uint32_t       on        ;
+	uint32_t       rdy       ;
+} PLL_Regs_t;
+
+static PLL_Regs_t PLL_Regs(uint8_t pll)
+{
+	PLL_Regs_t regs;
+
+	if (pll == PLL_2)
+	{
+		regs.divr      = &RCC->PLL2DIVR;
+		regs.fracr     = &RCC->PLL2FRACR;
+		regs.divm_pos  = RCC_PLLCKSELR_DIVM2_Pos;
+		regs.cfg_pos   = RCC_PLLCFGR_PLL2FRACEN_Pos;
+		regs.diven_pos = RCC_PLLCFGR_DIVP2EN_Pos;
+		regs.on        = RCC_CR_PLL2ON;
+		regs.rdy       = RCC_CR_PLL2RDY;
+	}
+	else
+	{
+		regs.divr      = &RCC->PLL3DIVR;
+		regs.fracr     = &RCC->PLL3FRACR;
+		regs.divm_pos  = RCC_PLLCKSELR_DIVM3_Pos;
+		regs.cfg_pos   = RCC_PLLCFGR_PLL3FRACEN_Pos;
+		regs.diven_pos = RCC_PLLCFGR_DIVP3EN_Pos;
+		regs.on        = RCC_CR_PLL3ON;
+		regs.rdy       = RCC_CR_PLL3RDY;
+	}
+	return regs;
+}
+
+/* Frequency of the PLL source selected by PLLSRC[1:0], Reference Manual, Page 397 */
+uint32_t PLL_Source_Hz(void)
+{
+	switch (RCC->PLLCKSELR & RCC_PLLCKSELR_PLLSRC_Msk)
+	{
+		case RCC_PLLCKSELR_PLLSRC_HSI:
+			return 64000000UL >> ((RCC->CR & RCC_CR_HSIDIV_Msk) >> RCC_CR_HSIDIV_Pos);
+		case RCC_PLLCKSELR_PLLSRC_CSI:
+			return 4000000UL;
+		case RCC_PLLCKSELR_PLLSRC_HSE:
+			return Clock_Profile_Active()->hse_hz;
+		default:
+			return 0U;
+	}
+}
+
+/* Find DIVM, DIVN, FRACN and the divider of one output (P, Q or R) for
+ * target_hz. The two other dividers are set to the same value, change them
+ * before PLL_Enable() if they are used. Returns 1 when a legal set exists.
+ */
+uint8_t PLL_Compute(uint32_t src_hz, uint32_t target_hz, uint8_t output, PLL_Config_t *cfg)
+{
+	uint64_t best_err = UINT64_MAX;
+	uint8_t  found    = 0U;
+
+	if ((src_hz == 0U) || (target_hz == 0U))
+	{
+		return 0U;
+	}
+
+	for (uint32_t m = 1U; m <= 63U; m++)
+	{
+		uint32_t ref_hz = src_hz / m;
+		uint8_t  vcosel;
+		uint8_t  rge;
+
+		if ((ref_hz < PLL_REF_MIN_HZ) || (ref_hz > PLL_REF_MAX_HZ))
+		{
+			continue;
+		}
+
+		/* Input range, Reference Manual, Page 401, medium VCO only below 2 MHz */
+		rge    = (ref_hz < 2000000UL) ? 0U : (ref_hz < 4000000UL) ? 1U : (ref_hz < 8000000UL) ? 2U : 3U;
+		vcosel = (rge == 0U) ? 1U : 0U;
+
+		for (uint32_t div = 1U; div <= 128U; div++)
+		{
+			uint64_t vco_target = (uint64_t)target_hz * div;
+			uint64_t den        = (uint64_t)m * 8192U;
+			uint64_t total;
+			uint64_t err;
+			uint32_t n;
+
+			if (vcosel ? ((vco_target < PLL_VCO_MEDIUM_MIN_HZ) || (vco_target > PLL_VCO_MEDIUM_MAX_HZ))
+			           : ((vco_target < PLL_VCO_WIDE_MIN_HZ)   || (vco_target > PLL_VCO_WIDE_MAX_HZ)))
+			{
+				continue;
+			}
+
+			/* DIVN x 2^13 + FRACN, rounded to nearest */
+			total = (vco_target * den + (src_hz / 2U)) / src_hz;
+			n     = (uint32_t)(total >> 13);
+			if ((n < 4U) || (n > 512U))
+			{
+				continue;
+			}
+
+			/* Error in units of 1 / (m x 2^13 x div) Hz */
+			err = (uint64_t)src_hz * total;
+			err = (err > vco_target * den) ? (err - vco_target * den) : (vco_target * den - err);
+			err = err * 1000U / den;  // Hz x 1000 at the VCO
+
+			err = err / div;
+
+			if ((err < best_err) || ((err == best_err) && ((total & 8191U) == 0U) && (cfg->fracn != 0U)))
+			{
+				best_err     = err;
+				found        = 1U;
+				cfg->divm    = (uint8_t)m;
+				cfg->divn    = (uint16_t)n;
+				cfg->fracn   = (uint16_t)(total & 8191U);
+				cfg->divp    = (uint8_t)div;
+				cfg->divq    = (uint8_t)div;
+				cfg->divr    = (uint8_t)div;
+				cfg->rge     = rge;
+				cfg->vcosel  = vcosel;
+			}
+		}
+	}
+
+	if (found)
+	{
+		int64_t diff;
+
+		cfg->src_hz = src_hz;
+		cfg->vco_hz = (uint32_t)(((uint64_t)src_hz * (((uint64_t)cfg->divn << 13) + cfg->fracn)) /
+		                         ((uint64_t)cfg->divm << 13));
+		cfg->out_hz = PLL_Output_Hz(cfg, output);
+
+		/* Exact error from the integer ratio, in parts per billion */
+		diff = (int64_t)((uint64_t)src_hz * (((uint64_t)cfg->divn << 13) + cfg->fracn)) -
+		       (int64_t)((uint64_t)target_hz * cfg->divp * ((uint64_t)cfg->divm << 13));
+		cfg->error_ppb = (int32_t)((diff * 1000000000LL) /
+		                 (int64_t)((uint64_t)target_hz * cfg->divp * ((uint64_t)cfg->divm << 13)));
+	}
+	return found;
+}
+
+uint32_t PLL_Output_Hz(const PLL_Config_t *cfg, uint8_t output)
+{
+	uint8_t  div = (output == PLL_OUTPUT_P) ? cfg->divp : (output == PLL_OUTPUT_Q) ? cfg->divq : cfg->divr;
+	uint64_t num = (uint64_t)cfg->src_hz * (((uint64_t)cfg->divn << 13) + cfg->fracn);
+
+	return (uint32_t)(num / (((uint64_t)cfg->divm << 13) * div));
+}
+
+void PLL_Disable(uint8_t pll)
+{
+	PLL_Regs_t regs = PLL_Regs(pll);
+
+	RCC->CR &= ~ regs.on ;
+	while( (RCC->CR & regs.rdy) != 0 ) {}
+}
+
+/* Program and lock PLL2 or PLL3, outputs is a mask of PLL_OUTPUT_x */
+void PLL_Enable(uint8_t pll, const PLL_Config_t *cfg, uint8_t outputs)
+{
+	PLL_Regs_t regs = PLL_Regs(pll);
+	uint32_t   reg;
+
+	/* Step 1: The PLL must be off to change DIVM, DIVN and the ranges */
+	PLL_Disable(pll);
+
+	/* Step 2: DIVMx, Reference Manual, Page 397 */
+	RCC->PLLCKSELR = (RCC->PLLCKSELR & ~ (0x3FUL << regs.divm_pos)) |
+	                 ((uint32_t)cfg->divm << regs.divm_pos) ;
+
+	/* Step 3: DIVNx, DIVPx, DIVQx, DIVRx, Reference Manual, Page 404 and 406 */
+	*regs.divr = (((uint32_t)cfg->divn - 1U) << RCC_PLL2DIVR_N2_Pos) |
+	             (((uint32_t)cfg->divp - 1U) << RCC_PLL2DIVR_P2_Pos) |
+	             (((uint32_t)cfg->divq - 1U) << RCC_PLL2DIVR_Q2_Pos) |
+	             (((uint32_t)cfg->divr - 1U) << RCC_PLL2DIVR_R2_Pos) ;
+
+	/* Step 4: FRACNx, latched by the 0 to 1 transition of PLLxFRACEN */
+	RCC->PLLCFGR &= ~ (1UL << regs.cfg_pos) ;
+	*regs.fracr   = (uint32_t)cfg->fracn << RCC_PLL2FRACR_FRACN2_Pos ;
+
+	/* Step 5: Ranges and outputs, Reference Manual, Page 401 */
+	reg  = RCC->PLLCFGR & ~ ((0xFUL << regs.cfg_pos) | (7UL << regs.diven_pos)) ;
+	reg |= ((uint32_t)cfg->vcosel << (regs.cfg_pos + 1U)) |
+	       ((uint32_t)cfg->rge    << (regs.cfg_pos + 2U)) |
+	       ((uint32_t)outputs     <<  regs.diven_pos    ) |
+	       (1UL << regs.cfg_pos) ;
+	RCC->PLLCFGR = reg ;
+
+	/* Step 6: Enable and wait for lock */
+	RCC->CR |= regs.on ;
+	while(! (RCC->CR & regs.rdy) ) {}
+}
+
+/* Change FRACNx while the PLL runs, the output moves smoothly to the new
+ * frequency without unlocking, Reference Manual, Page 364
+ */
+void PLL_Set_Fracn(uint8_t pll, uint16_t fracn)
+{
+	PLL_Regs_t regs = PLL_Regs(pll);
+
+	RCC->PLLCFGR &= ~ (1UL << regs.cfg_pos) ;
+	*regs.fracr   = (uint32_t)fracn << RCC_PLL2FRACR_FRACN2_Pos ;
+	RCC->PLLCFGR |=   (1UL << regs.cfg_pos) ;
+}
@@ -0,0 +1,65 @@
+/*
+ ******************************************************************************
+ * File              : pll_config.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : PLL2 and PLL3 set-up for an exact output frequency
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 21, 2026
+ ******************************************************************************/
+
+#ifndef _PLL_CONFIG_H_
+#define _PLL_CONFIG_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+#define PLL_2                       ( 0U )
+#define PLL_3                       ( 1U )
+
+#define PLL_OUTPUT_P                ( 1U << 0 )
+#define PLL_OUTPUT_Q                ( 1U << 1 )
+#define PLL_OUTPUT_R                ( 1U << 2 )
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	uint8_t  divm      ;  // 1..63
+	uint16_t divn      ;  // 4..512
+	uint16_t fracn     ;  // 0..8191
+	uint8_t  divp      ;  // 1..128
+	uint8_t  divq      ;  // 1..128
+	uint8_t  divr      ;  // 1..128
+	uint8_t  rge       ;  // PLLxRGE[1:0]
+	uint8_t  vcosel    ;  // 0: wide, 1: medium VCO range
+	uint32_t src_hz    ;  // Common PLL source (PLLSRC) frequency
+	uint32_t vco_hz    ;
+	uint32_t out_hz    ;  // Achieved frequency of the requested output
+	int32_t  error_ppb ;  // (out_hz - target) / target in parts per billion
+} PLL_Config_t;
+
+/************************ Function prototypes ***************************/
+uint32_t PLL_Source_Hz(void) ;
+uint8_t  PLL_Compute(uint32_t src_hz, uint32_t target_hz, uint8_t output, PLL_Config_t *cfg) ;
+void     PLL_Enable(uint8_t pll, const PLL_Config_t *cfg, uint8_t outputs) ;
+void     PLL_Disable(uint8_t pll) ;
+void     PLL_Set_Fracn(uint8_t pll, uint16_t fracn) ;
+uint32_t PLL_Output_Hz(const PLL_Config_t *cfg, uint8_t output) ;
+
+#endif /* _PLL_CONFIG_H_ */
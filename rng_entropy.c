@@ -0,0 +1,363 @@
+/*
+ ******************************************************************************
+ * File              : rng_entropy.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : True RNG entropy pool with continuous health tests
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 20, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Chapter 34, Random number generator (RNG)
+ *
+ * The RNG needs a kernel clock of at most 48 MHz. SystemClock_Config() runs
+ * PLL1_Q at 480 MHz, so pll1_q_ck is only used when the active clock profile
+ * brings it down to 48 MHz or less. Otherwise HSI48 is started.
+ *
+ * The RNG interrupt fills a ring of 32-bit words. The interrupt is the only
+ * writer of Pool_Head, readers move Pool_Tail with LDREX/STREX, so a reader
+ * never takes a lock and never waits: it gets what is in the pool, maybe 0
+ * bytes. When the pool is full the RNG interrupt is masked in the NVIC and
+ * unmasked by the next reader.
+ *
+ * Continuous health tests, NIST SP 800-90B section 4.4, on every word:
+ *   - repetition count test: two equal 32-bit words in a row;
+ *   - adaptive proportion test: in a window of 512 bytes, the first byte
+ *     of the window appears 20 times or more (H = 7 bits/byte, alpha 2^-20).
+ * A failing word is never put in the pool. Three failures without
+ * RNG_RECOVER_WORDS good words in a row between them make the RNG
+ * unhealthy: readers get nothing, and each read empties the pool so the
+ * interrupt keeps testing words until the streak clears.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "rng_entropy.h"
+#include "clock_profile.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+#define RNG_POOL_MASK               ( RNG_POOL_WORDS - 1U )
+#define RNG_APT_WINDOW              ( 512U )
+#define RNG_APT_CUTOFF              ( 20U  )
+#define RNG_SEED_ERROR_DISCARD      ( 12U  )   // Reference Manual, Page 1346
+#define RNG_UNHEALTHY_STREAK        ( 3U   )
+#define RNG_RECOVER_WORDS           ( 128U )   // One APT window
+
+/************************** Local Variables ****************************/
+
+static volatile uint32_t    Pool[RNG_POOL_WORDS] ;
+static volatile uint32_t    Pool_Head ;          // Written by the interrupt only
+static volatile uint32_t    Pool_Tail ;          // Moved by readers with LDREX/STREX
+static volatile uint8_t     Producer_Stopped ;
+
+static uint32_t             Last_Word ;
+static uint32_t             Discard ;
+static uint8_t              Apt_Reference ;
+static uint32_t             Apt_Count ;
+static uint32_t             Apt_Seen ;
+static volatile uint32_t    Fail_Streak ;
+static uint32_t             Pass_Run ;           // Good words since the last failure
+
+static RNG_Entropy_Stats_t  Stats ;
+
+static uint32_t Select_Kernel_Clock(void)
+{
+	ClockProfile_Freq_t freq;
+
+	if ((Clock_Profile_Frequencies(Clock_Profile_Active(), &freq) == CLOCK_PROFILE_OK) &&
+	    (freq.pll1_q_hz <= RNG_KERNEL_CLOCK_MAX_HZ) && (RCC->CR & RCC_CR_PLL1RDY))
+	{
+		return RNG_CLOCK_PLL1_Q;
+	}
+
+	/* HSI48, Reference Manual, Page 382 */
+	RCC->CR |= RCC_CR_HSI48ON ;
+	while(! (RCC->CR & RCC_CR_HSI48RDY) ) {}
+
+	return RNG_CLOCK_HSI48;
+}
+
+void RNG_Entropy_Init(void)
+{
+	/* Step 1: Kernel clock, RNGSEL[1:0] in RCC_D2CCIP2R, Reference Manual, Page 411 */
+	Stats.kernel_clock = Select_Kernel_Clock();
+	RCC->D2CCIP2R = (RCC->D2CCIP2R & ~ RCC_D2CCIP2R_RNGSEL) |
+	                (Stats.kernel_clock << RCC_D2CCIP2R_RNGSEL_Pos) ;
+
+	/* Step 2: Bus clock, RNG is on AHB2, Reference Manual, Page 449 */
+	RCC->AHB2ENR |= RCC_AHB2ENR_RNGEN ;
+
+	/* Step 3: Empty pool, fresh health test state */
+	Pool_Head        = 0U;
+	Pool_Tail        = 0U;
+	Producer_Stopped = 0U;
+	Discard          = 0U;
+	Apt_Seen         = 0U;
+	Fail_Streak      = 0U;
+	Pass_Run         = 0U;
+
+	/* Step 4: Enable the RNG with interrupt, CED = 0 keeps clock error detection on */
+	RNG->CR = RNG_CR_IE | RNG_CR_RNGEN ;
+
+	NVIC_SetPriority(RNG_IRQn, 10U);
+	NVIC_EnableIRQ(RNG_IRQn);
+}
+
+/* Returns 1 when the word passes both continuous tests */
+static uint8_t Health_Test(uint32_t word)
+{
+	uint8_t pass = 1U;
+
+	/* Repetition count test, cutoff 2 for 32-bit samples */
+	if (word == Last_Word)
+	{
+		Stats.rct_failures++;
+		pass = 0U;
+	}
+	Last_Word = word;
+
+	/* Adaptive proportion test on the 4 bytes of the word */
+	for (uint32_t i = 0U; i < 4U; i++)
+	{
+		uint8_t b = (uint8_t)(word >> (8U * i));
+
+		if (Apt_Seen == 0U)
+		{
+			Apt_Reference = b;
+			Apt_Count     = 1U;
+		}
+		else if (b == Apt_Reference)
+		{
+			Apt_Count++;
+		}
+
+		if (++Apt_Seen == RNG_APT_WINDOW)
+		{
+			Apt_Seen = 0U;
+		}
+		if (Apt_Count >= RNG_APT_CUTOFF)
+		{
+			Stats.apt_failures++;
+			Apt_Seen  = 0U;
+			Apt_Count = 0U;
+			pass      = 0U;
+		}
+	}
+
+	/* Enough good words in a row clear the failure streak */
+	if (!pass)
+	{
+		Fail_Streak++;
+		Pass_Run = 0U;
+	}
+	else if ((Fail_Streak != 0U) && (++Pass_Run >= RNG_RECOVER_WORDS))
+	{
+		Fail_Streak = 0U;
+		Pass_Run    = 0U;
+	}
+	return pass;
+}
+
+void RNG_Entropy_IRQHandler(void)
+{
+	uint32_t sr = RNG->SR;
+
+	/* Clock error: rng_clk too slow compared to rng_hclk, Reference Manual, Page 1345
+	 * CEIS and SEIS are cleared by writing 0
+	 */
+	if (sr & RNG_SR_CEIS)
+	{
+		Stats.clock_errors++;
+		RNG->SR = ~ RNG_SR_CEIS ;
+	}
+
+	/* Seed error: clear SEIS, restart the RNG and discard the next words,
+	 * Reference Manual, Page 1346
+	 */
+	if (sr & RNG_SR_SEIS)
+	{
+		Stats.seed_errors++;
+		Fail_Streak++;
+		Pass_Run = 0U;
+		RNG->SR  = ~ RNG_SR_SEIS ;
+		RNG->CR &= ~ RNG_CR_RNGEN ;
+		RNG->CR |=   RNG_CR_RNGEN ;
+		Discard  = RNG_SEED_ERROR_DISCARD;
+		return;
+	}
+
+	if (sr & RNG_SR_DRDY)
+	{
+		uint32_t word = RNG->DR;
+
+		if ((Discard != 0U) || (word == 0U))
+		{
+			/* DR reads 0 when a seed error happened after DRDY */
+			if (Discard != 0U)
+			{
+				Discard--;
+			}
+			Stats.words_dropped++;
+			return;
+		}
+
+		if (!Health_Test(word))
+		{
+			Stats.words_dropped++;
+			return;
+		}
+
+		Pool[Pool_Head & RNG_POOL_MASK] = word;
+		__DMB();
+		Pool_Head = Pool_Head + 1U;
+		Stats.words_produced++;
+
+		/* Full: stop until a reader makes room */
+		if ((Pool_Head - Pool_Tail) >= RNG_POOL_WORDS)
+		{
+			Producer_Stopped = 1U;
+			Stats.pool_full++;
+			NVIC_DisableIRQ(RNG_IRQn);
+		}
+	}
+}
+
+uint32_t RNG_Entropy_Available(void)
+{
+	return (Pool_Head - Pool_Tail) * 4U;
+}
+
+uint8_t RNG_Entropy_Healthy(void)
+{
+	return (Fail_Streak < RNG_UNHEALTHY_STREAK) && ((RNG->SR & RNG_SR_SECS) == 0U);
+}
+
+/* Unmask the interrupt stopped on a full pool */
+static void Restart_Producer(void)
+{
+	if (Producer_Stopped)
+	{
+		Producer_Stopped = 0U;
+		NVIC_EnableIRQ(RNG_IRQn);
+	}
+}
+
+/* Copy up to length bytes of entropy, returns the number of bytes copied.
+ * Never blocks. Bytes left over in the last word are thrown away.
+ */
+uint32_t RNG_Entropy_Read(void *buffer, uint32_t length)
+{
+	uint8_t  *out = (uint8_t *)buffer;
+	uint32_t  tail;
+	uint32_t  words;
+	uint32_t  copied;
+
+	if (length == 0U)
+	{
+		return 0U;
+	}
+
+	/* Unhealthy: empty the pool so the interrupt goes on testing words */
+	if (!RNG_Entropy_Healthy())
+	{
+		do
+		{
+			(void)__LDREXW(&Pool_Tail);
+		} while (__STREXW(Pool_Head, &Pool_Tail) != 0U);
+		Restart_Producer();
+		return 0U;
+	}
+
+	for (;;)
+	{
+		tail  = Pool_Tail;
+		words = Pool_Head - tail;
+		if (words == 0U)
+		{
+			copied = 0U;
+			break;
+		}
+		if (words > ((length + 3U) / 4U))
+		{
+			words = (length + 3U) / 4U;
+		}
+		__DMB();
+
+		/* Copy first, the interrupt never overwrites a word before Pool_Tail moves */
+		copied = 0U;
+		for (uint32_t i = 0U; (i < words) && (copied < length); i++)
+		{
+			uint32_t word = Pool[(tail + i) & RNG_POOL_MASK];
+
+			for (uint32_t b = 0U; (b < 4U) && (copied < length); b++)
+			{
+				out[copied++] = (uint8_t)(word >> (8U * b));
+			}
+		}
+
+		/* Claim the words, start again if another reader was faster */
+		if (__LDREXW(&Pool_Tail) != tail)
+		{
+			__CLREX();
+			continue;
+		}
+		if (__STREXW(tail + words, &Pool_Tail) == 0U)
+		{
+			break;
+		}
+	}
+
+	Restart_Producer();
+	return copied;
+}
+
+/* Words counted by the ISR, read from memory on each call */
+static uint32_t Words_Produced(void)
+{
+	return *(volatile const uint32_t *)&Stats.words_produced;
+}
+
+/* Throughput of the RNG including the health tests, in bytes per second.
+ * Drains the pool while it waits for the given number of words, so call it
+ * at start-up or from a test command, not from a protocol stack.
+ */
+uint32_t RNG_Entropy_Measure_Rate(uint32_t words)
+{
+	uint32_t scratch[8];
+	uint32_t first  = Words_Produced();
+	uint32_t start  = Cycle_Counter_Get();
+	uint32_t cycles;
+
+	while (((Words_Produced() - first) < words) && RNG_Entropy_Healthy())
+	{
+		(void)RNG_Entropy_Read(scratch, sizeof(scratch));
+	}
+	cycles = Cycle_Counter_Get() - start;
+	words  = Words_Produced() - first;
+
+	Stats.bytes_per_s = (uint32_t)(((uint64_t)words * 4U * SystemCoreClock) / cycles);
+	return Stats.bytes_per_s;
+}
+
+const RNG_Entropy_Stats_t *RNG_Entropy_Stats(void)
+{
+	return &Stats;
+}
@@ -0,0 +1,69 @@
+/*
+ ******************************************************************************
+ * File              : rng_entropy.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : True RNG entropy pool with continuous health tests
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 20, 2026
+ ******************************************************************************/
+
+#ifndef _RNG_ENTROPY_H_
+#define _RNG_ENTROPY_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+// Pool size in 32-bit words, must be a power of 2
+#define RNG_POOL_WORDS              ( 64U )
+
+// RNG kernel clock must not exceed 48 MHz, Datasheet DS12110, Table 115
+#define RNG_KERNEL_CLOCK_MAX_HZ     ( 48000000UL )
+
+// RNGSEL[1:0] in RCC_D2CCIP2R, Reference Manual, Page 411
+#define RNG_CLOCK_HSI48             ( 0U )
+#define RNG_CLOCK_PLL1_Q            ( 1U )
+#define RNG_CLOCK_LSE               ( 2U )
+#define RNG_CLOCK_LSI               ( 3U )
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	uint32_t kernel_clock   ;  // RNG_CLOCK_x in use
+	uint32_t words_produced ;  // Words accepted into the pool
+	uint32_t words_dropped  ;  // Words discarded by a health test or a seed error
+	uint32_t rct_failures   ;  // Repetition count test failures
+	uint32_t apt_failures   ;  // Adaptive proportion test failures
+	uint32_t seed_errors    ;  // SEIS, hardware seed error
+	uint32_t clock_errors   ;  // CEIS, RNG clock too slow
+	uint32_t pool_full      ;  // Times the producer stopped because the pool was full
+	uint32_t bytes_per_s    ;  // Last result of RNG_Entropy_Measure_Rate()
+} RNG_Entropy_Stats_t;
+
+/************************ Function prototypes ***************************/
+void     RNG_Entropy_Init(void) ;
+uint32_t RNG_Entropy_Available(void) ;
+uint32_t RNG_Entropy_Read(void *buffer, uint32_t length) ;
+uint8_t  RNG_Entropy_Healthy(void) ;
+uint32_t RNG_Entropy_Measure_Rate(uint32_t words) ;
+const RNG_Entropy_Stats_t *RNG_Entropy_Stats(void) ;
+
+void     RNG_Entropy_IRQHandler(void) ;
+
+#endif /* _RNG_ENTROPY_H_ */
@@ -0,0 +1,654 @@
+/*
+ ******************************************************************************
+ * File              : rtc_service.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : RTC calendar, wake-up timer and alarms on LSE or LSI
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 8, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Chapter 46, Real-time clock (RTC)
+ *
+ * RTC clock: RTC_Service_Init() attaches to lse_clock.c and does not wait
+ * for the crystal. On LSE_CLOCK_READY (lse_clock.c has selected the LSE in
+ * RTCSEL) the calendar starts on the LSE. On LSE_CLOCK_TIMEOUT the LSI is
+ * started and selected instead. On LSE_CLOCK_CSS_FAIL the LSE is switched
+ * off and RTCSEL moved to the LSI: RTCSEL is written once per backup domain
+ * life, a detected LSE failure is the one exception. A backup domain that
+ * kept an LSI selection from an earlier start stays on the LSI.
+ *
+ * Prescalers: ck_apre = RTCCLK / 8 (4096 Hz on the LSE), ck_spre = 1 Hz.
+ * RTC_SSR counts ck_apre down from PREDIV_S, the sub-second resolution is
+ * 244 us (250 us on the LSI). The calendar registers are read through the
+ * shadow registers (BYPSHAD = 0): reading RTC_SSR locks RTC_TR and RTC_DR
+ * until RTC_DR is read, the three are consistent.
+ *
+ * Correlation with the timebase: TIM5 stops in Stop mode and restarts from
+ * 0 after Standby, the RTC counts through both. RTC_Service_Now_Ns() is
+ * Timebase_Now_Ns() plus an offset that only grows:
+ *
+ *   Stop      RTC_Service_Sleep_Begin() before WFI and
+ *             RTC_Service_Sleep_End() after the clocks are back, the RTC
+ *             time elapsed minus the timebase time elapsed is added
+ *   Standby   RTC_Service_Standby() saves the RTC time and the monotonic
+ *             time in RTC_BKP0R..4R, the next RTC_Service_Init() continues
+ *             from them (PWR_CPUCR SBF)
+ *
+ * The offset is known to one ck_apre period. Timestamps taken with the
+ * timebase during a run (capture, DMA) convert with Timebase_Ticks_To_Ns()
+ * plus RTC_Service_Get_Info()->offset_ns of the same run.
+ *
+ * Wake-up timer: periodic, RTCCLK/2 up to RTC_SERVICE_WAKEUP_FINE_MS
+ * (61 us steps on the LSE), then ck_spre in seconds up to 36 hours (WUCKSEL
+ * 11x adds 2^16 to RTC_WUTR). Alarms A and B match day of the month, hour,
+ * minute and second, within the next month, and are one-shot. The three
+ * wake the device from Stop (EXTI lines 17 and 19) and from Standby.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "rtc_service.h"
+#include "lse_clock.h"
+#include "timebase.h"
+
+/*************************** Macros ************************************/
+
+#define BDCR_RTCSEL(sel)            ( ((uint32_t)(sel) << RCC_BDCR_RTCSEL_Pos) & RCC_BDCR_RTCSEL_Msk )
+#define RTCSEL_LSE                  ( 1U )
+#define RTCSEL_LSI                  ( 2U )
+
+#define EXTI_RTC_ALARM              ( 1UL << 17 )    // Reference Manual, EXTI event input mapping
+#define EXTI_RTC_WAKEUP             ( 1UL << 19 )
+
+// Flags of RTC_ISR are cleared by writing 0, INIT is kept
+#define RTC_ISR_CLEAR(flags)        ( RTC->ISR = (~((flags) | RTC_ISR_INIT) & 0x0001FFFFUL) | (RTC->ISR & RTC_ISR_INIT) )
+
+// RTC_TR and RTC_DR fields, BCD, Reference Manual, RTC_TR and RTC_DR
+#define RTC_TR_FIELDS(h, m, s)      ( ((uint32_t)Bcd(h) << 16) | ((uint32_t)Bcd(m) << 8) | Bcd(s) )
+#define RTC_DR_FIELDS(y, wd, m, d)  ( ((uint32_t)Bcd(y) << 16) | ((uint32_t)(wd) << 13) | ((uint32_t)Bcd(m) << 8) | Bcd(d) )
+
+#define NS_PER_S                    ( 1000000000ULL )
+#define S_PER_DAY                   ( 86400ULL )
+
+/************************** Local Variables ****************************/
+
+static volatile uint8_t      State ;
+static uint32_t              Prediv_S ;
+static uint8_t               Standby_Wake ;
+static RTC_Service_Handler_t Handlers[RTC_SERVICE_EVENTS] ;
+static RTC_Service_Info_t    Info ;
+static uint64_t              Anchor_Rtc_Ns ;
+static uint64_t              Anchor_Mono_Ns ;
+
+/****************************** Functions ******************************/
+
+static uint8_t Bcd(uint32_t value)
+{
+	return (uint8_t)(((value / 10U) << 4) | (value % 10U));
+}
+
+static uint32_t Bin(uint32_t bcd)
+{
+	return (bcd >> 4) * 10U + (bcd & 0xFU);
+}
+
+static uint32_t Days_In_Month(uint32_t year, uint32_t month)
+{
+	static const uint8_t Days[12] = { 31U, 28U, 31U, 30U, 31U, 30U, 31U, 31U, 30U, 31U, 30U, 31U };
+
+	return Days[month - 1U] + (((month == 2U) && ((year & 3U) == 0U)) ? 1U : 0U);
+}
+
+/* Days since 2000-01-01, every fourth year is a leap year up to 2099 */
+static uint32_t Days(uint32_t year, uint32_t month, uint32_t day)
+{
+	static const uint16_t Before[12] = { 0U, 31U, 59U, 90U, 120U, 151U, 181U, 212U, 243U, 273U, 304U, 334U };
+	uint32_t y = year - 2000U;
+	uint32_t d = y * 365U + (y + 3U) / 4U + Before[month - 1U] + day - 1U;
+
+	return d + (((month > 2U) && ((y & 3U) == 0U)) ? 1U : 0U);
+}
+
+/* 2000-01-01 was a Saturday, RTC weekday 1 is Monday */
+static uint8_t Weekday(uint32_t days)
+{
+	return (uint8_t)(((days + 5U) % 7U) + 1U);
+}
+
+static uint8_t Valid(const RTC_Service_Time_t *t)
+{
+	return (t->year >= 2000U) && (t->year <= 2099U) && (t->month >= 1U) && (t->month <= 12U) &&
+	       (t->day >= 1U) && (t->day <= Days_In_Month(t->year, t->month)) &&
+	       (t->hour < 24U) && (t->minute < 60U) && (t->second < 60U);
+}
+
+static void Backup_Unlock(void)
+{
+	PWR->CR1 |= PWR_CR1_DBP ;
+	while(! (PWR->CR1 & PWR_CR1_DBP) ) {}
+}
+
+/* RTC registers write protection, Reference Manual, RTC_WPR. The alarm and
+ * wake-up handlers lock WPR again: a thread-level sequence from unlock to
+ * lock runs with interrupts masked.
+ */
+static void Write_Unlock(void)
+{
+	Backup_Unlock();
+	RTC->WPR = 0xCAU ;
+	RTC->WPR = 0x53U ;
+}
+
+static void Write_Lock(void)
+{
+	RTC->WPR = 0xFFU ;
+}
+
+/* Calendar stopped, prescalers and calendar writable */
+static void Init_Mode_Enter(void)
+{
+	RTC->ISR |= RTC_ISR_INIT ;
+	while(! (RTC->ISR & RTC_ISR_INITF) ) {}
+}
+
+static void Init_Mode_Exit(void)
+{
+	RTC->ISR &= ~ RTC_ISR_INIT ;
+}
+
+/* Shadow registers copied again, after init mode or a wake-up from Stop */
+static void Wait_Sync(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	Write_Unlock();
+	RTC_ISR_CLEAR(RTC_ISR_RSF);
+	Write_Lock();
+	__set_PRIMASK(primask);
+	while(! (RTC->ISR & RTC_ISR_RSF) ) {}
+}
+
+/* Calendar registers to ns since 2000-01-01 */
+static uint64_t Read(RTC_Service_Time_t *t)
+{
+	uint32_t ssr = RTC->SSR;
+	uint32_t tr  = RTC->TR;
+	uint32_t dr  = RTC->DR;
+	uint32_t sub = (ssr <= Prediv_S) ? (Prediv_S - ssr) : 0U;   // ck_apre periods into the second
+	uint64_t sub_ns;
+
+	t->year    = (uint16_t)(2000U + Bin((dr >> 16) & 0xFFU));
+	t->month   = (uint8_t)Bin((dr >> 8) & 0x1FU);
+	t->day     = (uint8_t)Bin(dr & 0x3FU);
+	t->weekday = (uint8_t)((dr >> 13) & 0x7U);
+	t->hour    = (uint8_t)Bin((tr >> 16) & 0x3FU);
+	t->minute  = (uint8_t)Bin((tr >> 8) & 0x7FU);
+	t->second  = (uint8_t)Bin(tr & 0x7FU);
+
+	sub_ns = ((uint64_t)sub * NS_PER_S) / (Prediv_S + 1U);
+	t->us  = (uint32_t)(sub_ns / 1000U);
+
+	return ((uint64_t)Days(t->year, t->month, t->day) * S_PER_DAY +
+	        t->hour * 3600UL + t->minute * 60UL + t->second) * NS_PER_S + sub_ns;
+}
+
+/* After Standby: the monotonic clock goes on from the anchor in the backup registers */
+static void Standby_Restore(void)
+{
+	RTC_Service_Time_t t;
+	uint64_t saved_rtc  = ((uint64_t)RTC->BKP2R << 32) | RTC->BKP1R;
+	uint64_t saved_mono = ((uint64_t)RTC->BKP4R << 32) | RTC->BKP3R;
+	uint64_t rtc        = Read(&t);
+	uint64_t mono       = Timebase_Now_Ns();
+	uint64_t slept      = (rtc > saved_rtc) ? (rtc - saved_rtc) : 0U;
+
+	if (saved_mono + slept > mono)
+	{
+		Info.offset_ns = saved_mono + slept - mono;
+	}
+	Info.slept_ns += slept;
+	Info.standby_wakes++;
+
+	Backup_Unlock();
+	RTC->BKP0R = 0U ;
+}
+
+/* RTCSEL already set, from the LSE listener */
+static void Calendar_Start(RTC_Service_State_t state)
+{
+	uint32_t hz   = (state == RTC_SERVICE_LSE) ? LSE_CLOCK_HZ : RTC_SERVICE_LSI_HZ;
+	uint32_t primask = __get_PRIMASK();
+	uint32_t prer;
+
+	Prediv_S = hz / (RTC_SERVICE_PREDIV_A + 1U) - 1U;
+	prer     = (RTC_SERVICE_PREDIV_A << RTC_PRER_PREDIV_A_Pos) | Prediv_S ;
+
+	/* Step 1: RTC kernel and bus clocks */
+	Backup_Unlock();
+	RCC->BDCR    |= RCC_BDCR_RTCEN ;
+	RCC->APB4ENR |= RCC_APB4ENR_RTCAPBEN ;
+
+	/* Step 2: Prescalers in init mode, written in two accesses. A calendar
+	 * kept by the backup domain with the same prescalers is left running.
+	 */
+	if (!(RTC->ISR & RTC_ISR_INITS) || (RTC->PRER != prer))
+	{
+		__disable_irq();
+		Write_Unlock();
+		Init_Mode_Enter();
+		RTC->PRER = Prediv_S ;
+		RTC->PRER = prer ;
+		RTC->CR  &= ~ (RTC_CR_FMT | RTC_CR_BYPSHAD) ;
+		if (!(RTC->ISR & RTC_ISR_INITS))
+		{
+			RTC->TR = RTC_TR_FIELDS(0U, 0U, 0U) ;
+			RTC->DR = RTC_DR_FIELDS(26U, Weekday(Days(2026U, 1U, 1U)), 1U, 1U) ;
+		}
+		Init_Mode_Exit();
+		Write_Lock();
+		__set_PRIMASK(primask);
+	}
+	Wait_Sync();
+
+	/* Step 3: Alarms and wake-up timer on EXTI lines 17 and 19, rising edge */
+	EXTI->RTSR1   |= EXTI_RTC_ALARM | EXTI_RTC_WAKEUP ;
+	EXTI_D1->IMR1 |= EXTI_RTC_ALARM | EXTI_RTC_WAKEUP ;
+	NVIC_SetPriority(RTC_Alarm_IRQn, 14U);
+	NVIC_SetPriority(RTC_WKUP_IRQn, 14U);
+	NVIC_EnableIRQ(RTC_Alarm_IRQn);
+	NVIC_EnableIRQ(RTC_WKUP_IRQn);
+
+	Info.rtcclk_hz     = hz;
+	Info.resolution_ns = (uint32_t)((NS_PER_S * (RTC_SERVICE_PREDIV_A + 1U)) / hz);
+	Info.state         = (uint8_t)state;
+	State              = (uint8_t)state;
+
+	if (Standby_Wake)
+	{
+		Standby_Wake = 0U;
+		Standby_Restore();
+	}
+}
+
+/* LSI as RTC clock. After a CSS failure RTCSEL can be written again, a
+ * timeout on an LSE kept from an earlier start needs a backup domain reset.
+ */
+static void LSI_Fallback(uint8_t css_fail)
+{
+	uint32_t rtcsel;
+
+	/* Step 1: LSI on, it is not in the backup domain */
+	RCC->CSR |= RCC_CSR_LSION ;
+	while(! (RCC->CSR & RCC_CSR_LSIRDY) ) {}
+
+	/* Step 2: Defective LSE off, or backup domain reset */
+	Backup_Unlock();
+	rtcsel = (RCC->BDCR & RCC_BDCR_RTCSEL_Msk) >> RCC_BDCR_RTCSEL_Pos;
+	if (css_fail)
+	{
+		RCC->BDCR &= ~ (RCC_BDCR_LSECSSON | RCC_BDCR_LSEON) ;
+	}
+	else if ((rtcsel != 0U) && (rtcsel != RTCSEL_LSI))
+	{
+		RCC->BDCR |= RCC_BDCR_BDRST ;
+		RCC->BDCR &= ~ RCC_BDCR_BDRST ;
+		Standby_Wake = 0U;   // The anchor went with the backup registers
+	}
+
+	/* Step 3: RTCSEL */
+	RCC->BDCR = (RCC->BDCR & ~ RCC_BDCR_RTCSEL_Msk) | BDCR_RTCSEL(RTCSEL_LSI) ;
+	Calendar_Start(RTC_SERVICE_LSI);
+}
+
+static void LSE_Listener(LSE_Clock_State_t state)
+{
+	uint32_t rtcsel = (RCC->BDCR & RCC_BDCR_RTCSEL_Msk) >> RCC_BDCR_RTCSEL_Pos;
+
+	switch (state)
+	{
+	case LSE_CLOCK_READY:
+		/* RTCSEL kept on LSI by the backup domain: LSION is cleared by
+		 * every reset, the fallback turns the LSI on again
+		 */
+		if (rtcsel == RTCSEL_LSI)
+		{
+			LSI_Fallback(0U);
+		}
+		else
+		{
+			Calendar_Start(RTC_SERVICE_LSE);
+		}
+		break;
+	case LSE_CLOCK_TIMEOUT:
+		LSI_Fallback(0U);
+		break;
+	case LSE_CLOCK_CSS_FAIL:
+		LSI_Fallback(1U);
+		break;
+	default:
+		break;
+	}
+}
+
+/* After LSE_Clock_Start() and Timebase_Init() */
+void RTC_Service_Init(void)
+{
+	if (State != RTC_SERVICE_OFF)
+	{
+		return;
+	}
+
+	/* Step 1: RTC bus clock and backup domain access, both back at reset
+	 * after Standby, before the backup registers are read
+	 */
+	RCC->APB4ENR |= RCC_APB4ENR_RTCAPBEN ;
+	Backup_Unlock();
+
+	/* Step 2: Woken from Standby with an anchor saved by RTC_Service_Standby() */
+	Standby_Wake = ((PWR->CPUCR & PWR_CPUCR_SBF) && (RTC->BKP0R == RTC_SERVICE_BKP_MAGIC)) ? 1U : 0U;
+	PWR->CPUCR  |= PWR_CPUCR_CSSF ;
+
+	/* Step 3: Calendar started by the LSE listener, at once if the LSE runs */
+	State      = RTC_SERVICE_STARTING;
+	Info.state = RTC_SERVICE_STARTING;
+	if (!LSE_Clock_Attach(LSE_Listener))
+	{
+		LSI_Fallback(0U);
+	}
+}
+
+RTC_Service_State_t RTC_Service_State(void)
+{
+	return (RTC_Service_State_t)State;
+}
+
+/* Returns 0 while the calendar is not running or for a date out of range.
+ * The weekday is computed, time->us is ignored.
+ */
+uint8_t RTC_Service_Set(const RTC_Service_Time_t *time)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	if ((State < RTC_SERVICE_LSE) || !Valid(time))
+	{
+		return 0U;
+	}
+
+	__disable_irq();
+	Write_Unlock();
+	Init_Mode_Enter();
+	RTC->TR = RTC_TR_FIELDS(time->hour, time->minute, time->second) ;
+	RTC->DR = RTC_DR_FIELDS(time->year - 2000U, Weekday(Days(time->year, time->month, time->day)),
+	                        time->month, time->day) ;
+	Init_Mode_Exit();
+	Write_Lock();
+	__set_PRIMASK(primask);
+	Wait_Sync();
+
+	return 1U;
+}
+
+uint8_t RTC_Service_Get(RTC_Service_Time_t *time)
+{
+	if (State < RTC_SERVICE_LSE)
+	{
+		return 0U;
+	}
+	Read(time);
+	return 1U;
+}
+
+/* Calendar time in ns since 2000-01-01 00:00:00, 0 while not running */
+uint64_t RTC_Service_Epoch_Ns(void)
+{
+	RTC_Service_Time_t t;
+
+	return (State < RTC_SERVICE_LSE) ? 0U : Read(&t);
+}
+
+/* Monotonic, continuous over Stop and Standby, see the comments on top */
+uint64_t RTC_Service_Now_Ns(void)
+{
+	return Timebase_Now_Ns() + Info.offset_ns;
+}
+
+/* Periodic wake-up every ms, handler from the interrupt (0: wake-up only).
+ * Returns 0 when the calendar is not running or ms is out of range.
+ */
+uint8_t RTC_Service_Wakeup(uint32_t ms, RTC_Service_Handler_t handler)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t wucksel, wut;
+
+	if ((State < RTC_SERVICE_LSE) || (ms == 0U))
+	{
+		return 0U;
+	}
+
+	/* Step 1: Clock of the down counter: RTCCLK/2, or ck_spre in seconds */
+	if (ms <= RTC_SERVICE_WAKEUP_FINE_MS)
+	{
+		uint32_t ticks = (uint32_t)(((uint64_t)ms * (Info.rtcclk_hz / 2U)) / 1000U);
+
+		wucksel = 3U;
+		wut     = (ticks > 0U) ? (ticks - 1U) : 0U;
+	}
+	else
+	{
+		uint32_t s = (ms + 999U) / 1000U;
+
+		if (s > RTC_SERVICE_WAKEUP_MAX_S)
+		{
+			return 0U;
+		}
+		wucksel = (s > 65536UL) ? 6U : 4U;
+		wut     = (s > 65536UL) ? (s - 65537UL) : (s - 1U);
+	}
+
+	/* Step 2: RTC_WUTR and WUCKSEL are written with the timer off */
+	Handlers[RTC_SERVICE_WAKEUP] = handler;
+	__disable_irq();
+	Write_Unlock();
+	RTC->CR &= ~ (RTC_CR_WUTE | RTC_CR_WUTIE) ;
+	while(! (RTC->ISR & RTC_ISR_WUTWF) ) {}
+	RTC->WUTR = wut ;
+	RTC->CR   = (RTC->CR & ~ RTC_CR_WUCKSEL_Msk) | (wucksel << RTC_CR_WUCKSEL_Pos) ;
+	RTC_ISR_CLEAR(RTC_ISR_WUTF);
+	EXTI_D1->PR1 = EXTI_RTC_WAKEUP ;
+	RTC->CR  |= RTC_CR_WUTIE | RTC_CR_WUTE ;
+	Write_Lock();
+	__set_PRIMASK(primask);
+
+	return 1U;
+}
+
+/* One-shot alarm on day, hour, minute and second of at, see the comments on top */
+uint8_t RTC_Service_Alarm(RTC_Service_Event_t alarm, const RTC_Service_Time_t *at, RTC_Service_Handler_t handler)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t enable, wf, flag, value;
+
+	if ((State < RTC_SERVICE_LSE) || ((alarm != RTC_SERVICE_ALARM_A) && (alarm != RTC_SERVICE_ALARM_B)) || !Valid(at))
+	{
+		return 0U;
+	}
+
+	enable = (alarm == RTC_SERVICE_ALARM_A) ? (RTC_CR_ALRAE | RTC_CR_ALRAIE) : (RTC_CR_ALRBE | RTC_CR_ALRBIE);
+	wf     = (alarm == RTC_SERVICE_ALARM_A) ? RTC_ISR_ALRAWF : RTC_ISR_ALRBWF;
+	flag   = (alarm == RTC_SERVICE_ALARM_A) ? RTC_ISR_ALRAF  : RTC_ISR_ALRBF;
+
+	/* MSK1..4 clear: date, hours, minutes and seconds compared, WDSEL clear: day of the month */
+	value  = ((uint32_t)Bcd(at->day) << 24) | RTC_TR_FIELDS(at->hour, at->minute, at->second) ;
+
+	Handlers[alarm] = handler;
+	__disable_irq();
+	Write_Unlock();
+	RTC->CR &= ~ enable ;
+	while(! (RTC->ISR & wf) ) {}
+	if (alarm == RTC_SERVICE_ALARM_A)
+	{
+		RTC->ALRMAR   = value ;
+		RTC->ALRMASSR = 0U ;    // MASKSS = 0: sub-seconds not compared
+	}
+	else
+	{
+		RTC->ALRMBR   = value ;
+		RTC->ALRMBSSR = 0U ;
+	}
+	RTC_ISR_CLEAR(flag);
+	EXTI_D1->PR1 = EXTI_RTC_ALARM ;
+	RTC->CR |= enable ;
+	Write_Lock();
+	__set_PRIMASK(primask);
+
+	return 1U;
+}
+
+void RTC_Service_Cancel(RTC_Service_Event_t event)
+{
+	static const uint32_t Enable[RTC_SERVICE_EVENTS] =
+	{
+		RTC_CR_WUTE | RTC_CR_WUTIE, RTC_CR_ALRAE | RTC_CR_ALRAIE, RTC_CR_ALRBE | RTC_CR_ALRBIE
+	};
+	uint32_t primask = __get_PRIMASK();
+
+	if ((event >= RTC_SERVICE_EVENTS) || (State < RTC_SERVICE_LSE))
+	{
+		return;
+	}
+	__disable_irq();
+	Write_Unlock();
+	RTC->CR &= ~ Enable[event] ;
+	Write_Lock();
+	__set_PRIMASK(primask);
+	Handlers[event] = 0;
+}
+
+/* Just before entering Stop */
+void RTC_Service_Sleep_Begin(void)
+{
+	Anchor_Rtc_Ns  = RTC_Service_Epoch_Ns();
+	Anchor_Mono_Ns = Timebase_Now_Ns();
+}
+
+/* After Stop, with the system clock and the timebase running again */
+void RTC_Service_Sleep_End(void)
+{
+	uint64_t rtc, mono, slept;
+
+	if (State < RTC_SERVICE_LSE)
+	{
+		return;
+	}
+
+	/* Step 1: Shadow registers are stale after Stop */
+	Wait_Sync();
+
+	/* Step 2: RTC time the timebase did not count */
+	rtc   = RTC_Service_Epoch_Ns() - Anchor_Rtc_Ns;
+	mono  = Timebase_Now_Ns() - Anchor_Mono_Ns;
+	slept = (rtc > mono) ? (rtc - mono) : 0U;
+
+	Info.offset_ns += slept;
+	Info.slept_ns  += slept;
+	Info.sleeps++;
+}
+
+/* Standby until the wake-up timer, an alarm or a wake-up pin, does not
+ * return: the device restarts from reset, see RTC_Service_Init()
+ */
+void RTC_Service_Standby(void)
+{
+	uint64_t rtc  = RTC_Service_Epoch_Ns();
+	uint64_t mono = RTC_Service_Now_Ns();
+
+	/* Step 1: Anchor in the backup registers */
+	Backup_Unlock();
+	RTC->BKP1R = (uint32_t)rtc ;
+	RTC->BKP2R = (uint32_t)(rtc >> 32) ;
+	RTC->BKP3R = (uint32_t)mono ;
+	RTC->BKP4R = (uint32_t)(mono >> 32) ;
+	RTC->BKP0R = (State >= RTC_SERVICE_LSE) ? RTC_SERVICE_BKP_MAGIC : 0U ;
+
+	/* Step 2: A pending event would wake at once */
+	__disable_irq();
+	Write_Unlock();
+	RTC_ISR_CLEAR(RTC_ISR_WUTF | RTC_ISR_ALRAF | RTC_ISR_ALRBF);
+	Write_Lock();
+	EXTI_D1->PR1 = EXTI_RTC_ALARM | EXTI_RTC_WAKEUP ;
+	PWR->WKUPCR  = 0x3FUL ;    // WKUPC1..6
+
+	/* Step 3: D1, D2 and D3 in DStandby on deep sleep, Reference Manual, PWR_CPUCR */
+	PWR->CPUCR |= PWR_CPUCR_PDDS_D1 | PWR_CPUCR_PDDS_D2 | PWR_CPUCR_PDDS_D3 | PWR_CPUCR_CSSF ;
+	SCB->SCR   |= SCB_SCR_SLEEPDEEP_Msk ;
+	__DSB();
+	__WFI();
+
+	while (1) {}
+}
+
+const RTC_Service_Info_t *RTC_Service_Get_Info(void)
+{
+	return &Info;
+}
+
+void RTC_Service_Wakeup_IRQHandler(void)
+{
+	if (RTC->ISR & RTC_ISR_WUTF)
+	{
+		Write_Unlock();
+		RTC_ISR_CLEAR(RTC_ISR_WUTF);
+		Write_Lock();
+		if (Handlers[RTC_SERVICE_WAKEUP])
+		{
+			Handlers[RTC_SERVICE_WAKEUP](RTC_SERVICE_WAKEUP);
+		}
+	}
+	EXTI_D1->PR1 = EXTI_RTC_WAKEUP ;
+}
+
+void RTC_Service_Alarm_IRQHandler(void)
+{
+	uint32_t isr = RTC->ISR;
+
+	Write_Unlock();
+	if (isr & RTC_ISR_ALRAF)
+	{
+		RTC->CR &= ~ (RTC_CR_ALRAE | RTC_CR_ALRAIE) ;
+		RTC_ISR_CLEAR(RTC_ISR_ALRAF);
+	}
+	if (isr & RTC_ISR_ALRBF)
+	{
+		RTC->CR &= ~ (RTC_CR_ALRBE | RTC_CR_ALRBIE) ;
+		RTC_ISR_CLEAR(RTC_ISR_ALRBF);
+	}
+	Write_Lock();
+	EXTI_D1->PR1 = EXTI_RTC_ALARM ;
+
+	if ((isr & RTC_ISR_ALRAF) && Handlers[RTC_SERVICE_ALARM_A])
+	{
+		Handlers[RTC_SERVICE_ALARM_A](RTC_SERVICE_ALARM_A);
+	}
+	if ((isr & RTC_ISR_ALRBF) && Handlers[RTC_SERVICE_ALARM_B])
+	{
+		Handlers[RTC_SERVICE_ALARM_B](RTC_SERVICE_ALARM_B);
+	}
+}
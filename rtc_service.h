@@ -0,0 +1,109 @@
+/*
+ ******************************************************************************
+ * File              : rtc_service.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : RTC calendar, wake-up timer and alarms on LSE or LSI
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 8, 2026
+ ******************************************************************************/
+
+#ifndef _RTC_SERVICE_H_
+#define _RTC_SERVICE_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+// ck_apre = RTCCLK / (PREDIV_A + 1), ck_spre = ck_apre / (PREDIV_S + 1) = 1 Hz
+#define RTC_SERVICE_PREDIV_A        ( 7U )
+#define RTC_SERVICE_LSI_HZ          ( 32000UL )   // Datasheet DS12110, LSI typical
+
+// RTC_WUTR is 16 bits: RTCCLK/2 up to this, ck_spre (1 s steps) above
+#define RTC_SERVICE_WAKEUP_FINE_MS  ( 4000UL )
+#define RTC_SERVICE_WAKEUP_MAX_S    ( 131072UL )  // WUCKSEL = 11x, 2^16 added to WUT
+
+// Backup registers RTC_BKP0R..4R: anchor of the monotonic clock over Standby
+#define RTC_SERVICE_BKP_MAGIC       ( 0x52544353UL )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	RTC_SERVICE_OFF = 0   ,
+	RTC_SERVICE_STARTING  ,  // Waiting for the LSE (or its timeout)
+	RTC_SERVICE_LSE       ,  // Calendar running on the LSE
+	RTC_SERVICE_LSI          // Fallback: LSE timeout or clock security failure
+} RTC_Service_State_t;
+
+typedef enum
+{
+	RTC_SERVICE_WAKEUP = 0 ,
+	RTC_SERVICE_ALARM_A    ,
+	RTC_SERVICE_ALARM_B    ,
+	RTC_SERVICE_EVENTS
+} RTC_Service_Event_t;
+
+/* Called from the RTC interrupts */
+typedef void (*RTC_Service_Handler_t)(RTC_Service_Event_t event) ;
+
+/* Years 2000 to 2099, weekday 1 (Monday) to 7, filled in by the service */
+typedef struct
+{
+	uint16_t year    ;
+	uint8_t  month   ;
+	uint8_t  day     ;
+	uint8_t  weekday ;
+	uint8_t  hour    ;
+	uint8_t  minute  ;
+	uint8_t  second  ;
+	uint32_t us      ;  // From the sub-second register, RTC_SERVICE_PREDIV_A + 1 RTCCLK periods
+} RTC_Service_Time_t;
+
+typedef struct
+{
+	uint8_t  state         ;  // RTC_Service_State_t
+	uint32_t rtcclk_hz     ;
+	uint32_t resolution_ns ;  // One ck_apre period
+	uint64_t offset_ns     ;  // Added to the timebase: time it did not count (Stop, Standby)
+	uint32_t sleeps        ;  // RTC_Service_Sleep_End() calls
+	uint32_t standby_wakes ;
+	uint64_t slept_ns      ;
+} RTC_Service_Info_t;
+
+/************************ Function prototypes ***************************/
+void                      RTC_Service_Init(void) ;
+RTC_Service_State_t       RTC_Service_State(void) ;
+uint8_t                   RTC_Service_Set(const RTC_Service_Time_t *time) ;
+uint8_t                   RTC_Service_Get(RTC_Service_Time_t *time) ;
+uint64_t                  RTC_Service_Epoch_Ns(void) ;
+uint64_t                  RTC_Service_Now_Ns(void) ;
+
+uint8_t                   RTC_Service_Wakeup(uint32_t ms, RTC_Service_Handler_t handler) ;
+uint8_t                   RTC_Service_Alarm(RTC_Service_Event_t alarm, const RTC_Service_Time_t *at,
+                                            RTC_Service_Handler_t handler) ;
+void                      RTC_Service_Cancel(RTC_Service_Event_t event) ;
+
+void                      RTC_Service_Sleep_Begin(void) ;
+void                      RTC_Service_Sleep_End(void) ;
+void                      RTC_Service_Standby(void) ;
+const RTC_Service_Info_t *RTC_Service_Get_Info(void) ;
+
+void                      RTC_Service_Wakeup_IRQHandler(void) ;
+void                      RTC_Service_Alarm_IRQHandler(void) ;
+
+#endif /* _RTC_SERVICE_H_ */
@@ -0,0 +1,514 @@
+/*
+ ******************************************************************************
+ * File              : sai_audio.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : SAI1 audio engine, fractional PLL MCLK, DMA ping-pong
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 24, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Reference Manual RM0433 Rev 8, Chapter 51, Serial audio interface (SAI)
+ *
+ * Audio needs MCLK = 256 x fs from the 11.2896 MHz (44.1 kHz) or 12.288 MHz
+ * (48 kHz) families, which no integer divider of PLL1 gives. The SAI kernel
+ * clock is PLL2_P (or PLL3_P), SAI1SEL in RCC_D2CCIP1R:
+ *
+ *   sai_ker_ck = MCLK x MCKDIV       at least SAI_AUDIO_KERNEL_MIN_HZ
+ *   MCLK       = 256 x fs            NODIV = 0, OSR = 0
+ *   SCK        = fs x slots x slot_bits
+ *
+ * PLL_Compute() finds DIVM, DIVN, FRACN and DIVP for sai_ker_ck, the error
+ * left by FRACN is reported in ppm and ppb.
+ *
+ * Block A is master transmitter, block B slave receiver synchronous with A.
+ * DMA1 stream 0 (TX) and stream 1 (RX) run in double buffer mode. When RX
+ * completes buffer k, TX already plays buffer 1-k (it reads ahead by its
+ * FIFO), so the DSP stage reads RX k and writes TX k, one buffer of latency.
+ *
+ * Sample rate changes:
+ *   - same DIVM, DIVN, DIVP and MCKDIV: only FRACN changes, the PLL stays
+ *     locked and the SAI keeps running, Reference Manual, Page 364;
+ *   - otherwise the output is faded out over one buffer, one silent buffer
+ *     is played, the SAI and DMA stop on the silent buffer, the PLL is
+ *     relocked and the stream restarts with a fade in. No step reaches
+ *     the DAC, so no click.
+ * SAI_Audio_Trim_Ppm() moves FRACN alone to follow a remote clock.
+ *
+ * Pins, AF6: PE2 MCLK_A, PE3 SD_B, PE4 FS_A, PE5 SCK_A, PE6 SD_A.
+ * Check the schematic: these are also FMC_A19 to A23.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "sai_audio.h"
+#include "cycle_counter.h"
+#include "dma_alloc.h"
+
+/*************************** Macros ************************************/
+
+#define SAI_DMA_TX                  DMA1_Stream0
+#define SAI_DMA_RX                  DMA1_Stream1
+#define SAI_DMA_HANDLE_TX           DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 0U)
+#define SAI_DMA_HANDLE_RX           DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 1U)
+#define SAI_DMAREQ_A                ( 87U )    // sai1_a_dma, Reference Manual, Page 695
+#define SAI_DMAREQ_B                ( 88U )    // sai1_b_dma
+#define SAI_AF                      ( 6U )
+#define SAI_STOP_TIMEOUT_MS         ( 100U )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	STATE_STOPPED = 0 ,
+	STATE_RUNNING     ,
+	STATE_FADE_IN     ,
+	STATE_FADE_OUT    ,
+	STATE_SILENT      ,   // Fade out written, write one silent buffer
+	STATE_HALT            // Silent buffer on air, stop
+} State_t;
+
+/************************** Local Variables ****************************/
+
+static SAI_Audio_Config_t  Config ;
+static SAI_Audio_Stats_t   Stats ;
+static volatile State_t    State ;
+static int32_t            *Tx_Buf[2] ;
+static int32_t            *Rx_Buf[2] ;
+static uint32_t            Samples ;       // Per buffer, frames x slots
+
+static const DMA_Alloc_Request_t Tx_Request = { "sai1_a", 1U, SAI_DMAREQ_A, DMA_ALLOC_HIGH };
+static const DMA_Alloc_Request_t Rx_Request = { "sai1_b", 1U, SAI_DMAREQ_B, DMA_ALLOC_HIGH };
+
+static void SAI_Pins_Config(void)
+{
+	RCC->AHB4ENR |= RCC_AHB4ENR_GPIOEEN ;
+
+	for (uint32_t pin = 2U; pin <= 6U; pin++)
+	{
+		GPIOE->MODER    = (GPIOE->MODER & ~ (3UL << (2U * pin))) | (2UL << (2U * pin)) ;
+		GPIOE->OSPEEDR |= (2UL << (2U * pin)) ;
+		GPIOE->AFR[0]   = (GPIOE->AFR[0] & ~ (0xFUL << (4U * pin))) | (SAI_AF << (4U * pin)) ;
+	}
+}
+
+/* PLL set-up and MCKDIV for sample_rate, returns 1 when found */
+static uint8_t Compute_Clock(uint32_t sample_rate, PLL_Config_t *pll, uint8_t *mckdiv)
+{
+	uint32_t mclk = 256U * sample_rate;
+	uint32_t div;
+
+	if ((sample_rate < 8000U) || (sample_rate > 192000U))
+	{
+		return 0U;
+	}
+
+	div = (SAI_AUDIO_KERNEL_MIN_HZ + mclk - 1U) / mclk;
+	div = (div > 63U) ? 63U : div;
+	if (!PLL_Compute(PLL_Source_Hz(), mclk * div, PLL_OUTPUT_P, pll))
+	{
+		return 0U;
+	}
+	*mckdiv = (uint8_t)div;
+	return 1U;
+}
+
+static void Record_Clock(uint32_t sample_rate, const PLL_Config_t *pll, uint8_t mckdiv)
+{
+	Stats.sample_rate = sample_rate;
+	Stats.pll         = *pll;
+	Stats.mckdiv      = mckdiv;
+	Stats.mclk_hz     = pll->out_hz / mckdiv;
+	Stats.error_ppb   = pll->error_ppb;
+	Stats.error_ppm   = (pll->error_ppb + ((pll->error_ppb < 0) ? -500 : 500)) / 1000;
+	Stats.trim_ppm    = 0;
+}
+
+/* Lock the PLL and set MCKDIV, SAI blocks disabled */
+static void Apply_Clock(const PLL_Config_t *pll, uint8_t mckdiv)
+{
+	PLL_Enable(Config.pll, pll, PLL_OUTPUT_P);
+
+	RCC->D2CCIP1R = (RCC->D2CCIP1R & ~ RCC_D2CCIP1R_SAI1SEL) |
+	                (((Config.pll == PLL_2) ? 1UL : 2UL) << RCC_D2CCIP1R_SAI1SEL_Pos) ;
+
+	SAI1_Block_A->CR1 = (SAI1_Block_A->CR1 & ~ SAI_xCR1_MCKDIV) |
+	                    ((uint32_t)mckdiv << SAI_xCR1_MCKDIV_Pos) ;
+}
+
+static void Stop_Streams(void)
+{
+	/* Slave first, then the master, SAIEN reads 0 at the end of the frame */
+	SAI1_Block_B->CR1 &= ~ (SAI_xCR1_SAIEN | SAI_xCR1_DMAEN) ;
+	SAI1_Block_A->CR1 &= ~ (SAI_xCR1_SAIEN | SAI_xCR1_DMAEN) ;
+	while( (SAI1_Block_A->CR1 | SAI1_Block_B->CR1) & SAI_xCR1_SAIEN ) {}
+
+	SAI_DMA_TX->CR &= ~ DMA_SxCR_EN ;
+	SAI_DMA_RX->CR &= ~ DMA_SxCR_EN ;
+	while( (SAI_DMA_TX->CR | SAI_DMA_RX->CR) & DMA_SxCR_EN ) {}
+
+	DMA1->LIFCR = 0x00000F7DUL ;   // All flags of streams 0 and 1
+	SAI1_Block_A->CR2 |= SAI_xCR2_FFLUSH ;
+	SAI1_Block_B->CR2 |= SAI_xCR2_FFLUSH ;
+}
+
+static void Start_Streams(void)
+{
+	uint32_t cr = DMA_SxCR_DBM | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 |
+	              DMA_SxCR_MINC | DMA_SxCR_TEIE | DMA_SxCR_DMEIE ;
+
+	/* Step 1: Silence in all four buffers */
+	for (uint32_t i = 0U; i < 4U * Samples; i++)
+	{
+		Tx_Buf[0][i] = 0;
+	}
+	SCB_CleanInvalidateDCache_by_Addr((uint32_t *)Tx_Buf[0], (int32_t)(16U * Samples));
+
+	/* Step 2: TX stream, memory to peripheral, double buffer, Reference Manual, Page 653 */
+	SAI_DMA_TX->PAR  = (uint32_t)&SAI1_Block_A->DR ;
+	SAI_DMA_TX->M0AR = (uint32_t)Tx_Buf[0] ;
+	SAI_DMA_TX->M1AR = (uint32_t)Tx_Buf[1] ;
+	SAI_DMA_TX->NDTR = Samples ;
+	SAI_DMA_TX->FCR  = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH_0 ;
+	SAI_DMA_TX->CR   = cr | DMA_SxCR_DIR_0 ;
+
+	/* Step 3: RX stream, peripheral to memory, interrupt on every buffer */
+	SAI_DMA_RX->PAR  = (uint32_t)&SAI1_Block_B->DR ;
+	SAI_DMA_RX->M0AR = (uint32_t)Rx_Buf[0] ;
+	SAI_DMA_RX->M1AR = (uint32_t)Rx_Buf[1] ;
+	SAI_DMA_RX->NDTR = Samples ;
+	SAI_DMA_RX->FCR  = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH_0 ;
+	SAI_DMA_RX->CR   = cr | DMA_SxCR_TCIE ;
+
+	SAI_DMA_TX->CR |= DMA_SxCR_EN ;
+	SAI_DMA_RX->CR |= DMA_SxCR_EN ;
+
+	/* Step 4: Synchronous slave enabled before the master, Reference Manual, Page 2263 */
+	SAI1_Block_B->CR1 |= SAI_xCR1_DMAEN | SAI_xCR1_SAIEN ;
+	SAI1_Block_A->CR1 |= SAI_xCR1_DMAEN | SAI_xCR1_SAIEN ;
+}
+
+SAI_Audio_Status_t SAI_Audio_Init(const SAI_Audio_Config_t *config)
+{
+	PLL_Config_t pll;
+	uint8_t      mckdiv;
+	uint32_t     frame = (uint32_t)config->slots * config->slot_bits;
+	uint32_t     ds, slotsz, frcr, slotr;
+
+	/* Step 1: Check the format and the buffer size, reserve DMA1 streams 0 and 1 */
+	if (((frame != 32U) && (frame != 64U) && (frame != 128U) && (frame != 256U)) ||
+	    ((config->slot_bits != 16U) && (config->slot_bits != 32U)) ||
+	    (config->data_bits > config->slot_bits) || ((config->frames & 7U) != 0U) || (config->frames == 0U) ||
+	    ((16UL * config->frames * config->slots) > SAI_AUDIO_BUFFER_SIZE) ||
+	    !Compute_Clock(config->sample_rate, &pll, &mckdiv))
+	{
+		return SAI_AUDIO_ERROR;
+	}
+	ds = (config->data_bits == 16U) ? 4U : (config->data_bits == 24U) ? 6U : (config->data_bits == 32U) ? 7U : 0U;
+	if ((ds == 0U) || (DMA_Alloc_Reserve(SAI_DMA_HANDLE_TX, &Tx_Request) != DMA_ALLOC_OK))
+	{
+		return SAI_AUDIO_ERROR;
+	}
+	if (DMA_Alloc_Reserve(SAI_DMA_HANDLE_RX, &Rx_Request) != DMA_ALLOC_OK)
+	{
+		DMA_Alloc_Release(SAI_DMA_HANDLE_TX);
+		return SAI_AUDIO_ERROR;
+	}
+
+	Config    = *config;
+	Samples   = (uint32_t)config->frames * config->slots;
+	Tx_Buf[0] = (int32_t *)SAI_AUDIO_BUFFER_BASE;
+	Tx_Buf[1] = Tx_Buf[0] + Samples;
+	Rx_Buf[0] = Tx_Buf[1] + Samples;
+	Rx_Buf[1] = Rx_Buf[0] + Samples;
+
+	/* Step 2: Bus clocks, SAI1 on APB2, DMA1 on AHB1, D2 SRAM3 on AHB2 */
+	RCC->APB2ENR |= RCC_APB2ENR_SAI1EN ;
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN ;
+	RCC->AHB2ENR |= RCC_AHB2ENR_D2SRAM3EN ;
+	SAI_Pins_Config();
+
+	/* Step 3: Frame, I2S: FS is the channel side, active low, one bit early.
+	 * TDM: one bit FS pulse, active high, one bit early. Reference Manual, Page 2310
+	 */
+	if (config->slots == 2U)
+	{
+		frcr = ((frame - 1U) << SAI_xFRCR_FRL_Pos) | ((frame / 2U - 1U) << SAI_xFRCR_FSALL_Pos) |
+		       SAI_xFRCR_FSDEF | SAI_xFRCR_FSOFF ;
+	}
+	else
+	{
+		frcr = ((frame - 1U) << SAI_xFRCR_FRL_Pos) | SAI_xFRCR_FSPOL | SAI_xFRCR_FSOFF ;
+	}
+	slotsz = (config->slot_bits == 16U) ? 1U : 2U;
+	slotr  = (slotsz << SAI_xSLOTR_SLOTSZ_Pos) | ((config->slots - 1UL) << SAI_xSLOTR_NBSLOT_Pos) |
+	         (((1UL << config->slots) - 1U) << SAI_xSLOTR_SLOTEN_Pos) ;
+
+	/* Step 4: Block A master transmitter with MCLK, block B synchronous slave
+	 * receiver. CKSTR = 1: data out on the falling edge, sampled on the rising
+	 * edge as in I2S. Reference Manual, Page 2305
+	 */
+	SAI1_Block_A->CR1   = (ds << SAI_xCR1_DS_Pos) | SAI_xCR1_CKSTR | SAI_xCR1_MCKEN | SAI_xCR1_OUTDRIV ;
+	SAI1_Block_A->CR2   = SAI_xCR2_FTH_0 ;
+	SAI1_Block_A->FRCR  = frcr ;
+	SAI1_Block_A->SLOTR = slotr ;
+	SAI1_Block_A->IMR   = SAI_xIMR_OVRUDRIE ;
+
+	SAI1_Block_B->CR1   = SAI_xCR1_MODE | (ds << SAI_xCR1_DS_Pos) | SAI_xCR1_CKSTR |
+	                      (1UL << SAI_xCR1_SYNCEN_Pos) ;
+	SAI1_Block_B->CR2   = SAI_xCR2_FTH_0 ;
+	SAI1_Block_B->FRCR  = frcr ;
+	SAI1_Block_B->SLOTR = slotr ;
+	SAI1_Block_B->IMR   = SAI_xIMR_OVRUDRIE ;
+
+	/* Step 5: MCLK */
+	Apply_Clock(&pll, mckdiv);
+	Record_Clock(config->sample_rate, &pll, mckdiv);
+
+	/* Step 6: DMA interrupts, the requests were routed by DMA_Alloc_Reserve() */
+	NVIC_SetPriority(DMA1_Stream1_IRQn, 3U);
+	NVIC_SetPriority(DMA1_Stream0_IRQn, 3U);
+	NVIC_SetPriority(SAI1_IRQn, 4U);
+	NVIC_EnableIRQ(DMA1_Stream1_IRQn);
+	NVIC_EnableIRQ(DMA1_Stream0_IRQn);
+	NVIC_EnableIRQ(SAI1_IRQn);
+
+	/* Step 7: Start on silence and fade in */
+	State = STATE_FADE_IN;
+	Start_Streams();
+
+	return SAI_AUDIO_OK;
+}
+
+/* Change the sample rate, see the comments on top. Blocks up to three
+ * buffers when the PLL has to be relocked.
+ */
+SAI_Audio_Status_t SAI_Audio_Set_Rate(uint32_t sample_rate)
+{
+	PLL_Config_t pll;
+	uint8_t      mckdiv;
+	uint32_t     start;
+
+	if (!Compute_Clock(sample_rate, &pll, &mckdiv))
+	{
+		return SAI_AUDIO_ERROR;
+	}
+
+	/* FRACN only, glitchless while running */
+	if ((State != STATE_STOPPED) && (pll.divm == Stats.pll.divm) && (pll.divn == Stats.pll.divn) &&
+	    (pll.divp == Stats.pll.divp) && (mckdiv == Stats.mckdiv))
+	{
+		PLL_Set_Fracn(Config.pll, pll.fracn);
+		Record_Clock(sample_rate, &pll, mckdiv);
+		Stats.rate_switches++;
+		return SAI_AUDIO_OK;
+	}
+
+	/* Fade out and stop on a silent buffer */
+	if (State != STATE_STOPPED)
+	{
+		State = STATE_FADE_OUT;
+		start = Cycle_Counter_Get();
+		while ((State != STATE_STOPPED) &&
+		       ((Cycle_Counter_Get() - start) < (SystemCoreClock / 1000U) * SAI_STOP_TIMEOUT_MS)) {}
+		if (State != STATE_STOPPED)
+		{
+			Stop_Streams();
+			State = STATE_STOPPED;
+		}
+	}
+
+	Apply_Clock(&pll, mckdiv);
+	Record_Clock(sample_rate, &pll, mckdiv);
+	Stats.rate_switches++;
+
+	State = STATE_FADE_IN;
+	Start_Streams();
+
+	return SAI_AUDIO_OK;
+}
+
+/* Pull MCLK by ppm (+/- 1000) with FRACN alone, the stream is not touched.
+ * Fails when the new value leaves the DIVN step of the nominal setting.
+ */
+SAI_Audio_Status_t SAI_Audio_Trim_Ppm(int32_t ppm)
+{
+	int64_t total = ((int64_t)Stats.pll.divn << 13) + Stats.pll.fracn;
+
+	if ((State == STATE_STOPPED) || (ppm > 1000) || (ppm < -1000))
+	{
+		return SAI_AUDIO_ERROR;
+	}
+
+	total += (total * ppm) / 1000000;
+	if ((uint32_t)(total >> 13) != Stats.pll.divn)
+	{
+		return SAI_AUDIO_ERROR;
+	}
+
+	PLL_Set_Fracn(Config.pll, (uint16_t)(total & 8191));
+	Stats.trim_ppm = ppm;
+
+	return SAI_AUDIO_OK;
+}
+
+void SAI_Audio_Stop(void)
+{
+	Stop_Streams();
+	State = STATE_STOPPED;
+}
+
+void SAI_Audio_Get_Stats(SAI_Audio_Stats_t *stats)
+{
+	*stats = Stats;
+}
+
+/* Linear gain ramp over one buffer, up from 0 or down to 0 */
+static void Ramp(int32_t *out, uint8_t up)
+{
+	for (uint32_t f = 0U; f < Config.frames; f++)
+	{
+		int64_t gain = up ? (int64_t)f : (int64_t)(Config.frames - f);
+
+		for (uint32_t s = 0U; s < Config.slots; s++)
+		{
+			out[f * Config.slots + s] = (int32_t)((out[f * Config.slots + s] * gain) / Config.frames);
+		}
+	}
+}
+
+static void Process_Buffer(uint32_t k)
+{
+	int32_t *in  = Rx_Buf[k];
+	int32_t *out = Tx_Buf[k];
+	uint32_t start, cycles;
+
+	if (State == STATE_HALT)
+	{
+		Stop_Streams();
+		State = STATE_STOPPED;
+		return;
+	}
+
+	SCB_InvalidateDCache_by_Addr((uint32_t *)in, (int32_t)(4U * Samples));
+	start = Cycle_Counter_Get();
+
+	if (State == STATE_SILENT)
+	{
+		for (uint32_t i = 0U; i < Samples; i++)
+		{
+			out[i] = 0;
+		}
+		State = STATE_HALT;
+	}
+	else
+	{
+		if (Config.process != 0)
+		{
+			Config.process(in, out, Config.frames, Config.slots);
+		}
+		else
+		{
+			for (uint32_t i = 0U; i < Samples; i++)
+			{
+				out[i] = in[i];
+			}
+		}
+
+		if (State == STATE_FADE_IN)
+		{
+			Ramp(out, 1U);
+			State = STATE_RUNNING;
+		}
+		else if (State == STATE_FADE_OUT)
+		{
+			Ramp(out, 0U);
+			State = STATE_SILENT;
+		}
+	}
+
+	cycles = Cycle_Counter_Get() - start;
+	if (cycles > Stats.process_cycles)
+	{
+		Stats.process_cycles = cycles;
+	}
+
+	SCB_CleanDCache_by_Addr((uint32_t *)out, (int32_t)(4U * Samples));
+	Stats.buffers++;
+}
+
+/* RX buffer complete: run the DSP stage on it */
+void SAI_Audio_DMA_RX_IRQHandler(void)
+{
+	uint32_t k;
+
+	if (DMA1->LISR & (DMA_LISR_TEIF1 | DMA_LISR_DMEIF1))
+	{
+		DMA1->LIFCR = DMA_LIFCR_CTEIF1 | DMA_LIFCR_CDMEIF1 ;
+		Stats.dma_errors++;
+	}
+
+	if (DMA1->LISR & DMA_LISR_TCIF1)
+	{
+		DMA1->LIFCR = DMA_LIFCR_CTCIF1 ;
+		DMA_Alloc_Account(SAI_DMA_HANDLE_RX, 4U * Samples);
+		DMA_Alloc_Account(SAI_DMA_HANDLE_TX, 4U * Samples);
+
+		/* CT points at the buffer being filled now */
+		k = (SAI_DMA_RX->CR & DMA_SxCR_CT) ? 0U : 1U;
+
+		/* TX should play 1-k while TX k is written */
+		if ((((SAI_DMA_TX->CR & DMA_SxCR_CT) ? 1U : 0U) == k) && (State != STATE_HALT))
+		{
+			Stats.dma_underruns++;
+		}
+
+		Process_Buffer(k);
+
+		/* The next buffer already complete: this one came too late */
+		if ((State != STATE_STOPPED) && (DMA1->LISR & DMA_LISR_TCIF1))
+		{
+			Stats.dma_underruns++;
+		}
+	}
+}
+
+void SAI_Audio_DMA_TX_IRQHandler(void)
+{
+	if (DMA1->LISR & (DMA_LISR_TEIF0 | DMA_LISR_DMEIF0))
+	{
+		DMA1->LIFCR = DMA_LIFCR_CTEIF0 | DMA_LIFCR_CDMEIF0 ;
+		Stats.dma_errors++;
+	}
+}
+
+/* FIFO underrun of the transmitter, overrun of the receiver, Reference Manual, Page 2296 */
+void SAI_Audio_IRQHandler(void)
+{
+	if (SAI1_Block_A->SR & SAI_xSR_OVRUDR)
+	{
+		SAI1_Block_A->CLRFR = SAI_xCLRFR_COVRUDR ;
+		Stats.sai_underruns++;
+	}
+	if (SAI1_Block_B->SR & SAI_xSR_OVRUDR)
+	{
+		SAI1_Block_B->CLRFR = SAI_xCLRFR_COVRUDR ;
+		Stats.sai_overruns++;
+	}
+}
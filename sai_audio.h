@@ -0,0 +1,95 @@
+/*
+ ******************************************************************************
+ * File              : sai_audio.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : SAI1 audio engine, fractional PLL MCLK, DMA ping-pong
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 24, 2026
+ ******************************************************************************/
+
+#ifndef _SAI_AUDIO_H_
+#define _SAI_AUDIO_H_
+
+#include "stm32h7xx.h"
+#include "pll_config.h"
+
+/*************************** Macros ************************************/
+
+/* DMA buffers, TX ping/pong and RX ping/pong, in D2 SRAM3 (32 Kbytes).
+ * DMA1 cannot reach DTCM where the linker script puts the data.
+ */
+#define SAI_AUDIO_BUFFER_BASE       ( 0x30040000UL )
+#define SAI_AUDIO_BUFFER_SIZE       ( 0x00008000UL )
+
+// MCLK = 256 x fs, the SAI kernel clock is MCLK x MCKDIV and at least this
+#define SAI_AUDIO_KERNEL_MIN_HZ     ( 40000000UL )
+
+/*************************** Types *************************************/
+
+typedef enum
+{
+	SAI_AUDIO_OK = 0 ,
+	SAI_AUDIO_ERROR     // No PLL setting, bad frame format, buffers too large
+} SAI_Audio_Status_t;
+
+/* DSP stage, called from the DMA interrupt once per buffer with
+ * frames x slots interleaved samples, data_bits right aligned in int32_t
+ */
+typedef void (*SAI_Audio_Process_t)(const int32_t *in, int32_t *out, uint32_t frames, uint8_t slots) ;
+
+typedef struct
+{
+	uint32_t            sample_rate ;  // 8000..192000 Hz
+	uint8_t             slots       ;  // 2: I2S, 4 or 8: TDM
+	uint8_t             slot_bits   ;  // 16 or 32, slots x slot_bits is 32..256
+	uint8_t             data_bits   ;  // 16, 24 or 32, at most slot_bits
+	uint8_t             pll         ;  // PLL_2, or PLL_3 when the display is not used
+	uint16_t            frames      ;  // Frames per ping or pong buffer, multiple of 8
+	SAI_Audio_Process_t process     ;  // NULL: RX is copied to TX
+} SAI_Audio_Config_t;
+
+typedef struct
+{
+	uint32_t     sample_rate      ;
+	uint32_t     mclk_hz          ;  // Achieved MCLK, 256 x fs
+	uint8_t      mckdiv           ;
+	PLL_Config_t pll              ;  // pll.out_hz is the SAI kernel clock (PLLx_P)
+	int32_t      error_ppm        ;  // MCLK frequency error, rounded
+	int32_t      error_ppb        ;
+	int32_t      trim_ppm         ;  // Last SAI_Audio_Trim_Ppm()
+	uint32_t     buffers          ;  // Buffers processed
+	uint32_t     dma_underruns    ;  // Processing not done before its buffer played
+	uint32_t     sai_underruns    ;  // TX FIFO empty, SAI block A
+	uint32_t     sai_overruns     ;  // RX FIFO full, SAI block B
+	uint32_t     dma_errors       ;
+	uint32_t     rate_switches    ;
+	uint32_t     process_cycles   ;  // Worst case of the DSP stage
+} SAI_Audio_Stats_t;
+
+/************************ Function prototypes ***************************/
+SAI_Audio_Status_t SAI_Audio_Init(const SAI_Audio_Config_t *config) ;
+SAI_Audio_Status_t SAI_Audio_Set_Rate(uint32_t sample_rate) ;
+SAI_Audio_Status_t SAI_Audio_Trim_Ppm(int32_t ppm) ;
+void               SAI_Audio_Stop(void) ;
+void               SAI_Audio_Get_Stats(SAI_Audio_Stats_t *stats) ;
+
+void               SAI_Audio_IRQHandler(void) ;
+void               SAI_Audio_DMA_TX_IRQHandler(void) ;
+void               SAI_Audio_DMA_RX_IRQHandler(void) ;
+
+#endif /* _SAI_AUDIO_H_ */
@@ -0,0 +1,304 @@
+/*
+ ******************************************************************************
+ * File              : stm32h7xx_it.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Interrupt handlers, dispatch to the drivers
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 19, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * The handler names are the ones of the vector table in the ST startup file
+ * startup_stm32h743iitx.s. A handler only finds the source and calls the
+ * driver, the work is done in the driver file.
+ *
+ * The timing critical handlers (timebase, GPIO wave, HRTIM and input
+ * capture DMA) are FPU_FREE_ISR down to the driver, so they never pay for
+ * the FP context of the interrupted code (see fpu_policy.h).
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "crc_engine.h"
+#include "rng_entropy.h"
+#include "ltdc_display.h"
+#include "jpeg_codec.h"
+#include "fdcan.h"
+#include "sai_audio.h"
+#include "dfsdm_mic.h"
+#include "gpio_wave.h"
+#include "hrtim_pwm.h"
+#include "timebase.h"
+#include "input_capture.h"
+#include "fpu_policy.h"
+#include "vector_table.h"
+#include "lse_clock.h"
+#include "i2c_engine.h"
+#include "rtc_service.h"
+#include "tcm_profile.h"
+
+/* MDMA global interrupt, Reference Manual, Table 142
+ * MDMA_GISR0 has one bit per channel
+ */
+void MDMA_IRQHandler(void)
+{
+	if (MDMA->GISR0 & (1UL << 0))
+	{
+		CRC_Engine_MDMA_IRQHandler();
+	}
+	if (MDMA->GISR0 & ((1UL << 1) | (1UL << 2)))
+	{
+		JPEG_Codec_MDMA_IRQHandler();
+	}
+}
+
+/* RNG global interrupt */
+void RNG_IRQHandler(void)
+{
+	RNG_Entropy_IRQHandler();
+}
+
+/* LTDC global interrupt: line and register reload */
+void LTDC_IRQHandler(void)
+{
+	Display_LTDC_IRQHandler();
+}
+
+/* LTDC error interrupt: FIFO underrun and transfer error */
+void LTDC_ER_IRQHandler(void)
+{
+	Display_LTDC_ER_IRQHandler();
+}
+
+/* DMA2D global interrupt */
+void DMA2D_IRQHandler(void)
+{
+	Display_DMA2D_IRQHandler();
+}
+
+/* JPEG codec global interrupt */
+void JPEG_IRQHandler(void)
+{
+	JPEG_Codec_IRQHandler();
+}
+
+/* FDCAN1 interrupt line 0 */
+void FDCAN1_IT0_IRQHandler(void)
+{
+	FDCAN_IRQHandler();
+}
+
+/* SAI1 TX, DMA1 stream 0 */
+void DMA1_Stream0_IRQHandler(void)
+{
+	SAI_Audio_DMA_TX_IRQHandler();
+}
+
+/* SAI1 RX, DMA1 stream 1 */
+void DMA1_Stream1_IRQHandler(void)
+{
+	SAI_Audio_DMA_RX_IRQHandler();
+}
+
+/* SAI1 global interrupt */
+void SAI1_IRQHandler(void)
+{
+	SAI_Audio_IRQHandler();
+}
+
+/* DFSDM microphone 0, DMA1 stream 2 */
+void DMA1_Stream2_IRQHandler(void)
+{
+	DFSDM_Mic_DMA_IRQHandler(0U);
+}
+
+/* DFSDM microphone 1, DMA1 stream 3 */
+void DMA1_Stream3_IRQHandler(void)
+{
+	DFSDM_Mic_DMA_IRQHandler(1U);
+}
+
+/* DFSDM microphone 2, DMA1 stream 4 */
+void DMA1_Stream4_IRQHandler(void)
+{
+	DFSDM_Mic_DMA_IRQHandler(2U);
+}
+
+/* DFSDM microphone 3, DMA1 stream 5 */
+void DMA1_Stream5_IRQHandler(void)
+{
+	DFSDM_Mic_DMA_IRQHandler(3U);
+}
+
+/* DFSDM1 filter 0 */
+void DFSDM1_FLT0_IRQHandler(void)
+{
+	DFSDM_Mic_IRQHandler();
+}
+
+/* DFSDM1 filter 1 */
+void DFSDM1_FLT1_IRQHandler(void)
+{
+	DFSDM_Mic_IRQHandler();
+}
+
+/* DFSDM1 filter 2 */
+void DFSDM1_FLT2_IRQHandler(void)
+{
+	DFSDM_Mic_IRQHandler();
+}
+
+/* DFSDM1 filter 3 */
+void DFSDM1_FLT3_IRQHandler(void)
+{
+	DFSDM_Mic_IRQHandler();
+}
+
+/* GPIO waveform engine, DMA2 stream 0 */
+FPU_FREE_ISR void DMA2_Stream0_IRQHandler(void)
+{
+	FPU_ISR_ENTER();
+
+	GPIO_Wave_DMA_IRQHandler();
+
+	FPU_ISR_EXIT();
+}
+
+/* HRTIM burst DMA updates, DMA2 stream 1 */
+FPU_FREE_ISR void DMA2_Stream1_IRQHandler(void)
+{
+	FPU_ISR_ENTER();
+
+	HRTIM_PWM_DMA_IRQHandler();
+
+	FPU_ISR_EXIT();
+}
+
+/* HRTIM fault interrupt */
+void HRTIM1_FLT_IRQHandler(void)
+{
+	HRTIM_PWM_Fault_IRQHandler();
+}
+
+/* Monotonic timebase, TIM5 wrap */
+FPU_FREE_ISR void TIM5_IRQHandler(void)
+{
+	FPU_ISR_ENTER();
+
+	Timebase_IRQHandler();
+
+	FPU_ISR_EXIT();
+}
+
+/* Input capture channel 1, DMA2 stream 2 */
+FPU_FREE_ISR void DMA2_Stream2_IRQHandler(void)
+{
+	FPU_ISR_ENTER();
+
+	Input_Capture_DMA_IRQHandler(0U);
+
+	FPU_ISR_EXIT();
+}
+
+/* Input capture channel 2, DMA2 stream 3 */
+FPU_FREE_ISR void DMA2_Stream3_IRQHandler(void)
+{
+	FPU_ISR_ENTER();
+
+	Input_Capture_DMA_IRQHandler(1U);
+
+	FPU_ISR_EXIT();
+}
+
+/* Input capture channel 3, DMA2 stream 4 */
+FPU_FREE_ISR void DMA2_Stream4_IRQHandler(void)
+{
+	FPU_ISR_ENTER();
+
+	Input_Capture_DMA_IRQHandler(2U);
+
+	FPU_ISR_EXIT();
+}
+
+/* Input capture channel 4, DMA2 stream 5 */
+FPU_FREE_ISR void DMA2_Stream5_IRQHandler(void)
+{
+	FPU_ISR_ENTER();
+
+	Input_Capture_DMA_IRQHandler(3U);
+
+	FPU_ISR_EXIT();
+}
+
+/* FPU policy benchmark, software triggered */
+void SWPMI1_IRQHandler(void)
+{
+	FPU_Policy_Bench_IRQHandler();
+}
+
+/* Vector table benchmark, software triggered */
+void CRS_IRQHandler(void)
+{
+	Vector_Table_Bench_IRQHandler();
+}
+
+/* RCC global interrupt: LSE ready and LSE clock security system */
+void RCC_IRQHandler(void)
+{
+	LSE_Clock_IRQHandler();
+}
+
+/* I2C1 event: NACK, transfer complete (repeated START), STOP */
+void I2C1_EV_IRQHandler(void)
+{
+	I2C_Engine_EV_IRQHandler();
+}
+
+/* I2C1 error: bus error, arbitration lost, SCL low timeout */
+void I2C1_ER_IRQHandler(void)
+{
+	I2C_Engine_ER_IRQHandler();
+}
+
+/* RTC wake-up timer, EXTI line 19 */
+void RTC_WKUP_IRQHandler(void)
+{
+	RTC_Service_Wakeup_IRQHandler();
+}
+
+/* RTC alarms A and B, EXTI line 17 */
+void RTC_Alarm_IRQHandler(void)
+{
+	RTC_Service_Alarm_IRQHandler();
+}
+
+/* TCM profiler sample: the frame of the interrupted code is on MSP from a
+ * handler, on PSP from a thread using it (EXC_RETURN bit 2)
+ */
+__attribute__((naked)) void TIM7_IRQHandler(void)
+{
+	__asm volatile
+	(
+		"tst   lr, #4              \n"
+		"ite   eq                  \n"
+		"mrseq r0, msp             \n"
+		"mrsne r0, psp             \n"
+		"b     TCM_Profile_Record  \n"
+	);
+}
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "stm32h7xx.h"
+#include "clock_profile.h"
 
 /*************************** Macros ************************************/
 
@@ -100,11 +101,10 @@ void SystemClock_Config(void)
    // Wait  for VOSRDY to be set (VOS to be ready)
    while(! (PWR->D3CR & PWR_D3CR_VOSRDY) ) {}
 
-   /* Step 7: Enable HSE clock   */
-   RCC->CR |= RCC_CR_HSEON;
-
-   // Wait for HSE to be ready
-   while(! (RCC->CR & RCC_CR_HSERDY) );
+   /* Step 7: Enable HSE clock, crystal or bypass per CLOCK_PROFILE_HSE_BOARD,
+    * returns once HSE is ready
+    */
+   Clock_Profile_HSE_On(CLOCK_PROFILE_HSE_BOARD);
 
    /* Step 8: Select HSE temporarily using clock configuration register */
    RCC->CFGR |= RCC_CFGR_SW_HSE ;
@@ -0,0 +1,199 @@
+/*
+ ******************************************************************************
+ * File              : tcm_profile.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : PC sampling profiler and boot copy of the TCM placement
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 10, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Profile-guided placement, one round:
+ *
+ *   1. build with -ffunction-sections -fdata-sections, every function and
+ *      object in its own input section (.text.<name>, .bss.<name>, ...)
+ *   2. TCM_Profile_Run() runs the benchmark suite with TIM7 sampling the
+ *      interrupted PC at TCM_PROFILE_HZ, the elapsed time is the baseline
+ *   3. the debugger dumps TCM_Profile_Table, arm-none-eabi-nm -S lists the
+ *      symbols, tools/tcm_placement_tool.c ranks the functions by samples,
+ *      solves the knapsack for the ITCM size (the DTCM one with a data
+ *      access profile) and writes the linker script fragment
+ *   4. the next build includes the fragment, TCM_Placement_Init() copies
+ *      the ITCM code and the data moved out of DTCM at boot
+ *   5. TCM_Profile_Run() again: the tool compares the measured speedup
+ *      with the predicted one
+ *
+ * The TIM7 vector (stm32h7xx_it.c) passes the stacked frame of the
+ * interrupted code, thread or handler, to TCM_Profile_Record(). The PC is
+ * word 6 of the frame with or without the FP registers. At priority 1 the
+ * samples cover every handler but the HRTIM fault.
+ *
+ * The table is an open addressing hash of 32-byte code granules in DTCM,
+ * insertion probes at most 8 entries. The rate follows the TIM7 kernel
+ * clock at start, a throttle level change during a run changes it: the
+ * tool only uses the shares of the samples.
+ *
+ * TCM_Placement_Init() uses the symbols of the fragment, declared weak:
+ * without the fragment they are 0 and there is nothing to copy.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "tcm_profile.h"
+#include "kernel_clock.h"
+#include "timebase.h"
+
+/*************************** Macros ************************************/
+
+#define TCM_PROFILE_MASK            ( TCM_PROFILE_ENTRIES - 1U )
+#define TCM_PROFILE_PROBES          ( 8U )
+
+/************************** Local Variables ****************************/
+
+TCM_Profile_Entry_t TCM_Profile_Table[TCM_PROFILE_ENTRIES] ;
+
+static volatile uint32_t Samples ;
+static volatile uint32_t Dropped ;
+
+/* Linker script fragment of tools/tcm_placement_tool.c */
+extern uint32_t _sitcm_text[]  __attribute__((weak)) ;   // ITCM, run address
+extern uint32_t _eitcm_text[]  __attribute__((weak)) ;
+extern uint32_t _siitcm_text[] __attribute__((weak)) ;   // Flash, load address
+extern uint32_t _sd2_data[]    __attribute__((weak)) ;
+extern uint32_t _ed2_data[]    __attribute__((weak)) ;
+extern uint32_t _sid2_data[]   __attribute__((weak)) ;
+extern uint32_t _sd2_bss[]     __attribute__((weak)) ;
+extern uint32_t _ed2_bss[]     __attribute__((weak)) ;
+
+/****************************** Functions ******************************/
+
+static void Copy_Words(uint32_t *dst, const uint32_t *end, const uint32_t *src)
+{
+	while (dst < end)
+	{
+		*dst++ = *src++;
+	}
+}
+
+/* Right after SystemInit(), before any placed function or object is used */
+void TCM_Placement_Init(void)
+{
+	/* Step 1: Hot code into ITCM, not cached, no maintenance after */
+	Copy_Words(_sitcm_text, _eitcm_text, _siitcm_text);
+	__DSB();
+	__ISB();
+
+	/* Step 2: Cold data out of DTCM, into D2 SRAM2 (TCM_PLACEMENT_D2_BASE) */
+	RCC->AHB2ENR |= RCC_AHB2ENR_D2SRAM2EN ;
+	__DSB();
+	Copy_Words(_sd2_data, _ed2_data, _sid2_data);
+	for (uint32_t *p = _sd2_bss; p < _ed2_bss; p++)
+	{
+		*p = 0U;
+	}
+}
+
+void TCM_Profile_Clear(void)
+{
+	for (uint32_t i = 0U; i < TCM_PROFILE_ENTRIES; i++)
+	{
+		TCM_Profile_Table[i].pc    = 0U;
+		TCM_Profile_Table[i].count = 0U;
+	}
+	Samples = 0U;
+	Dropped = 0U;
+}
+
+void TCM_Profile_Start(void)
+{
+	uint32_t hz = Kernel_Clock_Hz(KERNEL_CLOCK_TIMX);
+
+	/* Step 1: TIM7 on APB1, update interrupt at TCM_PROFILE_HZ */
+	RCC->APB1LENR |= RCC_APB1LENR_TIM7EN ;
+
+	TCM_PROFILE_TIM->CR1  = TIM_CR1_URS ;
+	TCM_PROFILE_TIM->PSC  = (hz / TCM_PROFILE_HZ) >> 16 ;
+	TCM_PROFILE_TIM->ARR  = hz / TCM_PROFILE_HZ / (TCM_PROFILE_TIM->PSC + 1U) - 1U ;
+	TCM_PROFILE_TIM->EGR  = TIM_EGR_UG ;
+	TCM_PROFILE_TIM->SR   = 0U ;
+	TCM_PROFILE_TIM->DIER = TIM_DIER_UIE ;
+
+	/* Step 2: Above the drivers, so their handlers are sampled too */
+	NVIC_SetPriority(TIM7_IRQn, 1U);
+	NVIC_ClearPendingIRQ(TIM7_IRQn);
+	NVIC_EnableIRQ(TIM7_IRQn);
+
+	TCM_PROFILE_TIM->CR1 |= TIM_CR1_CEN ;
+}
+
+void TCM_Profile_Stop(void)
+{
+	TCM_PROFILE_TIM->CR1 &= ~ TIM_CR1_CEN ;
+	NVIC_DisableIRQ(TIM7_IRQn);
+}
+
+/* suite runs times with the sampler, table cleared first */
+void TCM_Profile_Run(void (*suite)(void), uint32_t runs, TCM_Profile_Result_t *result)
+{
+	uint64_t t0;
+
+	TCM_Profile_Clear();
+	TCM_Profile_Start();
+	t0 = Timebase_Now_Ns();
+
+	for (uint32_t r = 0U; r < runs; r++)
+	{
+		suite();
+	}
+
+	result->elapsed_ns = Timebase_Now_Ns() - t0;
+	TCM_Profile_Stop();
+
+	result->samples = Samples;
+	result->dropped = Dropped;
+	result->runs    = runs;
+}
+
+/* frame: stacked R0..R3, R12, LR, PC, xPSR of the interrupted code */
+void TCM_Profile_Record(const uint32_t *frame)
+{
+	uint32_t pc   = frame[6] & ~ (TCM_PROFILE_GRANULE - 1U);
+	uint32_t slot = (pc / TCM_PROFILE_GRANULE) * 2654435761UL;   // Knuth multiplicative hash
+
+	TCM_PROFILE_TIM->SR = ~ TIM_SR_UIF ;
+	Samples++;
+
+	for (uint32_t probe = 0U; probe < TCM_PROFILE_PROBES; probe++)
+	{
+		TCM_Profile_Entry_t *e = &TCM_Profile_Table[((slot >> 16) + probe) & TCM_PROFILE_MASK];
+
+		if (e->pc == pc)
+		{
+			e->count++;
+			return;
+		}
+		if (e->pc == 0U)
+		{
+			e->pc    = pc;
+			e->count = 1U;
+			return;
+		}
+	}
+	Dropped++;
+}
@@ -0,0 +1,73 @@
+/*
+ ******************************************************************************
+ * File              : tcm_profile.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : PC sampling profiler and boot copy of the TCM placement
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 10, 2026
+ ******************************************************************************/
+
+#ifndef _TCM_PROFILE_H_
+#define _TCM_PROFILE_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+#define TCM_PROFILE_TIM             TIM7
+#define TCM_PROFILE_HZ              ( 9973UL )  // Prime, no lock step with periodic tasks
+#define TCM_PROFILE_ENTRIES         ( 1024U )   // Power of 2
+#define TCM_PROFILE_GRANULE         ( 32U )     // Bytes of code per entry
+
+/* Data moved out of DTCM by the fragment: the top 32 Kbytes of D2 SRAM2,
+ * above the JPEG MCU buffer. AXI SRAM is held by the framebuffers.
+ */
+#define TCM_PLACEMENT_D2_BASE       ( 0x30038000UL )
+#define TCM_PLACEMENT_D2_SIZE       ( 0x00008000UL )
+
+/*************************** Types *************************************/
+
+/* Sample table as dumped by the debugger for tools/tcm_placement_tool.c:
+ *    dump binary value samples.bin TCM_Profile_Table
+ */
+typedef struct
+{
+	uint32_t pc    ;  // First address of the granule, 0: free entry
+	uint32_t count ;
+} TCM_Profile_Entry_t;
+
+typedef struct
+{
+	uint32_t samples    ;
+	uint32_t dropped    ;  // Table full, the granule was not recorded
+	uint64_t elapsed_ns ;  // Of the runs, -m option of the tool
+	uint32_t runs       ;
+} TCM_Profile_Result_t;
+
+/************************ Function prototypes ***************************/
+extern TCM_Profile_Entry_t TCM_Profile_Table[TCM_PROFILE_ENTRIES] ;
+
+void TCM_Placement_Init(void) ;
+void TCM_Profile_Start(void) ;
+void TCM_Profile_Stop(void) ;
+void TCM_Profile_Clear(void) ;
+void TCM_Profile_Run(void (*suite)(void), uint32_t runs, TCM_Profile_Result_t *result) ;
+
+void TCM_Profile_Record(const uint32_t *frame) ;
+
+#endif /* _TCM_PROFILE_H_ */
@@ -0,0 +1,184 @@
+/*
+ ******************************************************************************
+ * File              : timebase.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : 64-bit monotonic timebase on TIM5, continuous across
+ *                     clock profile switches
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 28, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * TIM5 is a 32-bit timer on APB1. It counts rcc_timx_ker_ck with no
+ * prescaler and ARR = 0xFFFFFFFF, so it wraps every 2^32 ticks (17.9 s at
+ * 240 MHz). The update interrupt counts the wraps, the wrap count and CNT
+ * give a 64-bit tick count that never goes back.
+ *
+ * The tick rate depends on the clock profile (D2PPRE1 and TIMPRE). The
+ * nanosecond value is computed per segment: a segment starts at a tick
+ * count, a nanosecond value and a rate. Timebase_Clock_Changed(), called
+ * after the new profile is applied, closes the current segment and opens a
+ * new one with the new rate. The last TIMEBASE_SEGMENTS segments are kept,
+ * so ticks captured before a switch and converted after it still use the
+ * old rate. The switch window itself (PLL1 relock) is counted at the old
+ * rate, the error is bounded by the length of the window.
+ *
+ * A 32-bit value latched by the counter (a capture register) is extended to
+ * 64 bits against the current tick count, which is correct as long as the
+ * value is less than 2^32 ticks old.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "timebase.h"
+#include "kernel_clock.h"
+#include "fpu_policy.h"
+
+/************************** Local Variables ****************************/
+
+static volatile uint32_t  Wraps ;
+static Timebase_Segment_t Segments[TIMEBASE_SEGMENTS] ;
+static volatile uint32_t  Segment_Count ;
+
+/* (ticks - start) x 10^9 / hz without overflowing 64 bits */
+static uint64_t Segment_Ns(const Timebase_Segment_t *seg, uint64_t ticks)
+{
+	uint64_t delta = ticks - seg->ticks;
+	uint64_t sec   = delta / seg->hz;
+	uint64_t rem   = delta % seg->hz;
+
+	return seg->ns + sec * 1000000000ULL + (rem * 1000000000ULL) / seg->hz;
+}
+
+void Timebase_Init(void)
+{
+	/* Step 1: TIM5 clock on APB1, Reference Manual, Page 458 */
+	RCC->APB1LENR |= RCC_APB1LENR_TIM5EN ;
+
+	/* Step 2: Free running up counter, full 32-bit range, update interrupt
+	 * only on overflow (URS), Reference Manual, Page 1808
+	 */
+	TIMEBASE_TIM->CR1  = TIM_CR1_URS ;
+	TIMEBASE_TIM->PSC  = 0U ;
+	TIMEBASE_TIM->ARR  = 0xFFFFFFFFUL ;
+	TIMEBASE_TIM->EGR  = TIM_EGR_UG ;
+	TIMEBASE_TIM->SR   = 0U ;
+	TIMEBASE_TIM->DIER = TIM_DIER_UIE ;
+
+	Wraps         = 0U;
+	Segment_Count = 1U;
+	Segments[0].ticks = 0U;
+	Segments[0].ns    = 0U;
+	Segments[0].hz    = Kernel_Clock_Hz(KERNEL_CLOCK_TIMX);
+
+	/* Step 3: The wrap count must never lag, highest priority in the project */
+	NVIC_SetPriority(TIM5_IRQn, 1U);
+	NVIC_EnableIRQ(TIM5_IRQn);
+
+	TIMEBASE_TIM->CR1 |= TIM_CR1_CEN ;
+}
+
+/* Wrap count and CNT read consistently. When the update interrupt is pending
+ * but not yet serviced (masked, or called from a higher priority), a small
+ * CNT belongs to the next wrap.
+ */
+uint64_t Timebase_Ticks(void)
+{
+	uint32_t hi, lo, sr;
+
+	/* UIF read before Wraps is checked again: an update serviced in
+	 * between changes Wraps and the three are read again
+	 */
+	do
+	{
+		hi = Wraps;
+		lo = TIMEBASE_TIM->CNT;
+		sr = TIMEBASE_TIM->SR;
+	} while (hi != Wraps);
+
+	if ((sr & TIM_SR_UIF) && (lo < 0x80000000UL))
+	{
+		hi++;
+	}
+	return ((uint64_t)hi << 32) | lo;
+}
+
+/* Latest tick count whose low 32 bits are counter */
+uint64_t Timebase_Extend(uint32_t counter)
+{
+	uint64_t now = Timebase_Ticks();
+
+	return now - (uint32_t)((uint32_t)now - counter);
+}
+
+uint64_t Timebase_Ticks_To_Ns(uint64_t ticks)
+{
+	uint32_t n = Segment_Count;
+	uint32_t i = (n - 1U) % TIMEBASE_SEGMENTS;
+
+	/* Newest segment that started at or before ticks */
+	for (uint32_t k = 1U; (k < n) && (k < TIMEBASE_SEGMENTS) && (ticks < Segments[i].ticks); k++)
+	{
+		i = (i + TIMEBASE_SEGMENTS - 1U) % TIMEBASE_SEGMENTS;
+	}
+	return Segment_Ns(&Segments[i], ticks);
+}
+
+uint64_t Timebase_Now_Ns(void)
+{
+	return Timebase_Ticks_To_Ns(Timebase_Ticks());
+}
+
+uint32_t Timebase_Hz(void)
+{
+	return Segments[(Segment_Count - 1U) % TIMEBASE_SEGMENTS].hz;
+}
+
+/* Call after every clock profile switch, see the comments on top */
+void Timebase_Clock_Changed(void)
+{
+	uint32_t hz = Kernel_Clock_Hz(KERNEL_CLOCK_TIMX);
+	uint32_t primask;
+	Timebase_Segment_t seg;
+
+	if (hz == Timebase_Hz())
+	{
+		return;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	seg.ticks = Timebase_Ticks();
+	seg.ns    = Timebase_Ticks_To_Ns(seg.ticks);
+	seg.hz    = hz;
+	Segments[Segment_Count % TIMEBASE_SEGMENTS] = seg;
+	Segment_Count++;
+
+	__set_PRIMASK(primask);
+}
+
+FPU_FREE_ISR void Timebase_IRQHandler(void)
+{
+	if (TIMEBASE_TIM->SR & TIM_SR_UIF)
+	{
+		TIMEBASE_TIM->SR = ~ TIM_SR_UIF ;
+		Wraps++;
+	}
+}
@@ -0,0 +1,57 @@
+/*
+ ******************************************************************************
+ * File              : timebase.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : 64-bit monotonic timebase on TIM5, continuous across
+ *                     clock profile switches
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : October 28, 2026
+ ******************************************************************************/
+
+#ifndef _TIMEBASE_H_
+#define _TIMEBASE_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+#define TIMEBASE_TIM                TIM5
+#define TIMEBASE_SEGMENTS           ( 4U )      // Clock rates remembered for late conversions
+
+/*************************** Types *************************************/
+
+/* From ticks onwards the counter runs at hz, ticks is ns on the monotonic clock */
+typedef struct
+{
+	uint64_t ticks ;
+	uint64_t ns    ;
+	uint32_t hz    ;
+} Timebase_Segment_t;
+
+/************************ Function prototypes ***************************/
+void     Timebase_Init(void) ;
+uint64_t Timebase_Ticks(void) ;
+uint64_t Timebase_Extend(uint32_t counter) ;
+uint64_t Timebase_Ticks_To_Ns(uint64_t ticks) ;
+uint64_t Timebase_Now_Ns(void) ;
+uint32_t Timebase_Hz(void) ;
+void     Timebase_Clock_Changed(void) ;
+
+void     Timebase_IRQHandler(void) ;
+
+#endif /* _TIMEBASE_H_ */
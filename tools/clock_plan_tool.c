@@ -0,0 +1,424 @@
+/*
+ ******************************************************************************
+ * File              : clock_plan_tool.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Host PC (Windows, Linux)
+ * Description       : Check the clock transition planner on a register model
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * Date              : November 2, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Build on the host, the planner is the same source as on the board:
+ *    gcc -I.. -o clock_plan_tool clock_plan_tool.c ../clock_plan.c ../clock_profile_blob.c
+ *
+ * Without argument, every legal profile of a grid (PLL1 source, sys_ck,
+ * FRACN1, D1CPRE, HPRE, VOS, with the fewest flash wait states) is planned
+ * against every other one. Each plan is replayed on a model of the RCC, PWR
+ * and FLASH registers that does what Clock_Profile_Transition() writes,
+ * including the intermediate values (prescalers through the slower of both,
+ * VOS through VOS1 with ODEN). The model checks after every write:
+ *
+ *   - sys_ck never from PLL1 while PLL1 is off
+ *   - PLL1 dividers only written with PLL1 off, FRACN1 alone otherwise
+ *   - clocks within the VOS limits, flash wait states for hclk
+ *   - the end state is the target profile
+ *
+ * A depth first search over every order of the same steps then confirms
+ * that no legal sequence is cheaper than the plan. The exit code is the
+ * number of failed pairs.
+ *
+ * With two profile blobs, print the plan from the first to the second:
+ *    clock_plan_tool from.bin to.bin
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "clock_plan.h"
+
+#define MAX_PROFILES   512
+
+typedef struct
+{
+	ClockProfile_t regs   ;  // Every clock field as written in the registers
+	uint8_t        sw_pll ;  // sys_ck from PLL1
+	uint8_t        pll_on ;
+	uint32_t       osc_hz ;
+} Sim_t;
+
+static ClockProfile_t Profiles[MAX_PROFILES];
+static unsigned       Profile_Count;
+
+/* Register model ---------------------------------------------------------*/
+
+static int Sim_Legal(const Sim_t *sim)
+{
+	ClockProfile_Freq_t freq;
+	uint32_t            sys_hz = sim->osc_hz;
+
+	if (sim->sw_pll)
+	{
+		if (!sim->pll_on || (Clock_Profile_Frequencies(&sim->regs, &freq) != CLOCK_PROFILE_OK))
+		{
+			return 0;
+		}
+		sys_hz = freq.pll1_p_hz;
+	}
+	freq.sysclk_hz = sys_hz         / sim->regs.d1cpre;
+	freq.hclk_hz   = freq.sysclk_hz / sim->regs.hpre;
+	freq.pclk3_hz  = freq.hclk_hz   / sim->regs.d1ppre;
+	freq.pclk1_hz  = freq.hclk_hz   / sim->regs.d2ppre1;
+	freq.pclk2_hz  = freq.hclk_hz   / sim->regs.d2ppre2;
+	freq.pclk4_hz  = freq.hclk_hz   / sim->regs.d3ppre;
+	return Clock_Profile_Check_Limits(&sim->regs, &freq) == CLOCK_PROFILE_OK;
+}
+
+static void Set_Prescalers(ClockProfile_t *regs, uint16_t d1cpre, uint16_t hpre, uint8_t d1ppre,
+                           uint8_t d2ppre1, uint8_t d2ppre2, uint8_t d3ppre)
+{
+	regs->d1cpre = d1cpre; regs->hpre = hpre; regs->d1ppre = d1ppre;
+	regs->d2ppre1 = d2ppre1; regs->d2ppre2 = d2ppre2; regs->d3ppre = d3ppre;
+}
+
+#define MAX(a, b)   (((a) > (b)) ? (a) : (b))
+
+/* One step as the firmware writes it, 0 if a write breaks a rule */
+static int Sim_Step(Sim_t *sim, uint8_t step, const ClockProfile_t *to)
+{
+	ClockProfile_t *r = &sim->regs;
+
+	switch (step)
+	{
+		case CLOCK_STEP_SYSCLK_OSC:
+			if (!sim->sw_pll) return 0;
+			sim->osc_hz = (to->pll_src == CLOCK_PROFILE_PLLSRC_HSE) ? to->hse_hz : 64000000UL;
+			sim->sw_pll = 0;
+			return Sim_Legal(sim);
+
+		case CLOCK_STEP_PLL1_OFF:
+			if (sim->sw_pll || !sim->pll_on) return 0;
+			sim->pll_on = 0;
+			return 1;
+
+		case CLOCK_STEP_PLL1_ON:
+			if (sim->pll_on) return 0;
+			r->pll_src = to->pll_src; r->hse_hz = to->hse_hz; r->divm1 = to->divm1;
+			r->divn1 = to->divn1; r->fracn1 = to->fracn1; r->divp1 = to->divp1;
+			r->divq1 = to->divq1; r->divr1 = to->divr1; r->pll1rge = to->pll1rge;
+			r->pll1vcosel = to->pll1vcosel;
+			sim->pll_on = 1;
+			return Sim_Legal(sim);
+
+		case CLOCK_STEP_SYSCLK_PLL1:
+			if (sim->sw_pll || !sim->pll_on) return 0;
+			sim->sw_pll = 1;
+			return Sim_Legal(sim);
+
+		case CLOCK_STEP_FRACN:
+			if (!sim->pll_on || (r->fracn1 == to->fracn1) ||
+			    (r->pll_src != to->pll_src) || (r->divm1 != to->divm1) || (r->divn1 != to->divn1) ||
+			    (r->divp1 != to->divp1) || (r->divq1 != to->divq1) || (r->divr1 != to->divr1) ||
+			    (r->pll1rge != to->pll1rge) || (r->pll1vcosel != to->pll1vcosel) || (r->hse_hz != to->hse_hz))
+			{
+				return 0;
+			}
+			r->fracn1 = to->fracn1;
+			return Sim_Legal(sim);
+
+		case CLOCK_STEP_VOS:
+			if (r->vos == to->vos) return 1;
+			/* VOS0 <-> other levels goes through VOS1: ODEN is cleared first or set last */
+			if (((r->vos == 0U) || (to->vos == 0U)) && (r->vos != 1U) && (to->vos != 1U))
+			{
+				r->vos = 1U;
+				if (!Sim_Legal(sim)) return 0;
+			}
+			r->vos = to->vos;
+			return Sim_Legal(sim);
+
+		case CLOCK_STEP_FLASH:
+			if ((r->flash_latency == to->flash_latency) && (r->flash_wrhighfreq == to->flash_wrhighfreq)) return 1;
+			r->flash_latency    = to->flash_latency;
+			r->flash_wrhighfreq = to->flash_wrhighfreq;
+			return Sim_Legal(sim);
+
+		case CLOCK_STEP_PRESCALERS:
+			if (Clock_Plan_Same_Prescalers(r, to)) return 1;
+			Set_Prescalers(r, MAX(r->d1cpre, to->d1cpre), MAX(r->hpre, to->hpre), MAX(r->d1ppre, to->d1ppre),
+			               MAX(r->d2ppre1, to->d2ppre1), MAX(r->d2ppre2, to->d2ppre2), MAX(r->d3ppre, to->d3ppre));
+			if (!Sim_Legal(sim)) return 0;
+			Set_Prescalers(r, to->d1cpre, to->hpre, to->d1ppre, to->d2ppre1, to->d2ppre2, to->d3ppre);
+			return Sim_Legal(sim);
+
+		default:
+			return 0;
+	}
+}
+
+static int Sim_At(const Sim_t *sim, const ClockProfile_t *to)
+{
+	const ClockProfile_t *r = &sim->regs;
+
+	return sim->sw_pll && sim->pll_on && Clock_Plan_Same_PLL1(r, to, 0U) && Clock_Plan_Same_Prescalers(r, to) &&
+	       (r->vos == to->vos) && (r->flash_latency == to->flash_latency) &&
+	       (r->flash_wrhighfreq == to->flash_wrhighfreq);
+}
+
+static void Sim_Init(Sim_t *sim, const ClockProfile_t *from)
+{
+	memset(sim, 0, sizeof(*sim));
+	sim->regs   = *from;
+	sim->sw_pll = 1;
+	sim->pll_on = 1;
+}
+
+/* 1 if the plan is legal at every write and ends on the target */
+static int Replay(const ClockProfile_t *from, const ClockProfile_t *to, const ClockPlan_t *plan)
+{
+	Sim_t sim;
+
+	Sim_Init(&sim, from);
+	for (unsigned i = 0; i < plan->count; i++)
+	{
+		if (!Sim_Step(&sim, plan->steps[i], to))
+		{
+			return 0;
+		}
+	}
+	return Sim_At(&sim, to);
+}
+
+/* Cheapest legal order of the steps, each used at most once */
+static void Search(const Sim_t *sim, const ClockProfile_t *from, const ClockProfile_t *to, unsigned used,
+                   uint32_t cost, uint32_t *best)
+{
+	if (cost >= *best)
+	{
+		return;
+	}
+	if (Sim_At(sim, to))
+	{
+		*best = cost;
+		return;
+	}
+	for (uint8_t step = 0; step < CLOCK_STEP_COUNT; step++)
+	{
+		Sim_t next = *sim;
+
+		if ((used & (1U << step)) || !Sim_Step(&next, step, to))
+		{
+			continue;
+		}
+		Search(&next, from, to, used | (1U << step), cost + Clock_Plan_Step_Cost(step, from, to), best);
+	}
+}
+
+/* Profiles -------------------------------------------------------------*/
+
+/* Fewest flash wait states that pass the validator */
+static int Add_Profile(ClockProfile_t p)
+{
+	for (uint8_t ws = 0; ws <= 7U; ws++)
+	{
+		for (uint8_t wr = 0; wr <= 2U; wr++)
+		{
+			p.flash_latency    = ws;
+			p.flash_wrhighfreq = wr;
+			Clock_Profile_Seal(&p);
+			if (Clock_Profile_Validate(&p) == CLOCK_PROFILE_OK)
+			{
+				if (Profile_Count < MAX_PROFILES)
+				{
+					Profiles[Profile_Count++] = p;
+				}
+				return 1;
+			}
+			if (Clock_Profile_Validate(&p) != CLOCK_PROFILE_ERR_FLASH)
+			{
+				return 0;
+			}
+		}
+	}
+	return 0;
+}
+
+static void Build_Grid(void)
+{
+	static const uint16_t Divn[]   = { 192U, 160U, 120U, 80U };    // VCO 960, 800, 600, 400 MHz from 5 MHz
+	static const uint16_t Fracn[]  = { 0U, 4096U };
+	static const uint8_t  Divp[]   = { 2U, 4U };
+	static const uint16_t D1cpre[] = { 1U, 2U };
+	static const uint16_t Hpre[]   = { 1U, 2U, 4U };
+
+	for (uint8_t src = 0; src < 2U; src++)
+	for (unsigned n = 0; n < sizeof(Divn) / sizeof(Divn[0]); n++)
+	for (unsigned f = 0; f < sizeof(Fracn) / sizeof(Fracn[0]); f++)
+	for (unsigned pp = 0; pp < sizeof(Divp); pp++)
+	for (unsigned c = 0; c < sizeof(D1cpre) / sizeof(D1cpre[0]); c++)
+	for (unsigned h = 0; h < sizeof(Hpre) / sizeof(Hpre[0]); h++)
+	for (uint8_t vos = 0; vos <= 3U; vos++)
+	{
+		ClockProfile_t p = Clock_Profile_Default;
+
+		if (src == 1U)  // HSI 64 MHz / 32 = 2 MHz, N doubled to keep the VCO
+		{
+			p.pll_src = CLOCK_PROFILE_PLLSRC_HSI;
+			p.divm1   = 32U;
+			p.pll1rge = 1U;
+			p.divn1   = (uint16_t)(Divn[n] * 5U / 2U);
+		}
+		else
+		{
+			p.divn1 = Divn[n];
+		}
+		p.fracn1 = Fracn[f];
+		p.divp1  = Divp[pp];
+		p.d1cpre = D1cpre[c];
+		p.hpre   = Hpre[h];
+		p.vos    = vos;
+		p.profile_id = Profile_Count;
+		Add_Profile(p);
+	}
+}
+
+static void Print_Plan(const ClockPlan_t *plan)
+{
+	for (unsigned i = 0; i < plan->count; i++)
+	{
+		printf("%s%s", i ? ", " : "  ", Clock_Plan_Step_Name(plan->steps[i]));
+	}
+	printf("%s  (%lu us)\n", plan->count ? "" : "  nothing to do", (unsigned long)plan->cost_us);
+}
+
+/* prescalers/flash/VOS only, FRACN, new PLL1 with VOS before, after or unchanged */
+static unsigned Kind(const ClockPlan_t *plan)
+{
+	int vos = -1, lock = -1, fracn = 0;
+
+	for (unsigned i = 0; i < plan->count; i++)
+	{
+		if (plan->steps[i] == CLOCK_STEP_VOS)     vos   = (int)i;
+		if (plan->steps[i] == CLOCK_STEP_PLL1_ON) lock  = (int)i;
+		if (plan->steps[i] == CLOCK_STEP_FRACN)   fracn = 1;
+	}
+	if (plan->count == 0U) return 0;
+	if (fracn)             return 2;
+	if (lock < 0)          return 1;
+	if (vos < 0)           return 5;
+	return (vos < lock) ? 3 : 4;
+}
+
+static int Check_All(void)
+{
+	static const char *Kinds[] =
+	{
+		"unchanged", "prescalers/flash/VOS", "FRACN only", "VOS then PLL1", "PLL1 then VOS", "PLL1, same VOS"
+	};
+	unsigned long kinds[6] = { 0 }, pairs = 0, failed = 0, full_illegal = 0;
+	unsigned long long plan_us = 0, full_us = 0;
+
+	for (unsigned a = 0; a < Profile_Count; a++)
+	{
+		for (unsigned b = 0; b < Profile_Count; b++)
+		{
+			const ClockProfile_t *from = &Profiles[a], *to = &Profiles[b];
+			ClockPlan_t           plan, full;
+			ClockPlan_Status_t    status = Clock_Plan_Compute(from, to, &plan);
+			uint32_t              best = UINT32_MAX;
+			Sim_t                 sim;
+
+			pairs++;
+			if ((status != CLOCK_PLAN_OK) || !Replay(from, to, &plan))
+			{
+				if (failed++ < 10U)
+				{
+					printf("FAIL %u -> %u: %s\n", a, b, Clock_Plan_Status_Name(status));
+					Print_Plan(&plan);
+				}
+				continue;
+			}
+
+			Sim_Init(&sim, from);
+			Search(&sim, from, to, 0U, 0U, &best);
+			if (best < plan.cost_us)
+			{
+				if (failed++ < 10U)
+				{
+					printf("FAIL %u -> %u: %lu us possible, plan\n", a, b, (unsigned long)best);
+					Print_Plan(&plan);
+				}
+				continue;
+			}
+
+			Clock_Plan_Full(from, to, &full);
+			full_illegal += !Replay(from, to, &full);
+			plan_us += plan.cost_us;
+			full_us += full.cost_us;
+			kinds[Kind(&plan)]++;
+		}
+	}
+
+	printf("%u profiles, %lu pairs, %lu failed\n", Profile_Count, pairs, failed);
+	for (unsigned k = 0; k < 6U; k++)
+	{
+		printf("  %-22s %lu\n", Kinds[k], kinds[k]);
+	}
+	printf("mean cost %llu us, full sequence %llu us, full sequence illegal %lu\n",
+	       plan_us / (pairs - failed ? pairs - failed : 1), full_us / (pairs - failed ? pairs - failed : 1), full_illegal);
+	printf("%s\n", failed ? "FAILED" : "PASSED");
+	return (int)failed;
+}
+
+static int Load(const char *path, ClockProfile_t *profile)
+{
+	FILE *in = fopen(path, "rb");
+	int   ok = (in != NULL) && (fread(profile, sizeof(*profile), 1, in) == 1);
+
+	if (in != NULL)
+	{
+		fclose(in);
+	}
+	if (!ok)
+	{
+		fprintf(stderr, "cannot read %u bytes from %s\n", CLOCK_PROFILE_SIZE, path);
+	}
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 3)
+	{
+		ClockProfile_t     from, to;
+		ClockPlan_t        plan, full;
+		ClockPlan_Status_t status;
+
+		if (!Load(argv[1], &from) || !Load(argv[2], &to))
+		{
+			return 1;
+		}
+		status = Clock_Plan_Compute(&from, &to, &plan);
+		if (status != CLOCK_PLAN_OK)
+		{
+			printf("%s\n", Clock_Plan_Status_Name(status));
+			return 1;
+		}
+		Clock_Plan_Full(&from, &to, &full);
+		printf("plan:%s\n", plan.pll_src_change ? " (PLLSRC change, PLL2 and PLL3 off)" : "");
+		Print_Plan(&plan);
+		printf("full sequence:\n");
+		Print_Plan(&full);
+		return Replay(&from, &to, &plan) ? 0 : 1;
+	}
+
+	Build_Grid();
+	return Check_All();
+}
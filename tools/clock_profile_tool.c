@@ -0,0 +1,181 @@
+/*
+ ******************************************************************************
+ * File              : clock_profile_tool.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Host PC (Windows, Linux)
+ * Description       : Generate and verify clock profile blobs
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * Date              : October 18, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Build on the host, the validator is the same source as on the board:
+ *    gcc -I.. -o clock_profile_tool clock_profile_tool.c ../clock_profile_blob.c
+ *
+ * Generate a blob, every field not given keeps the built-in default value:
+ *    clock_profile_tool gen profile.bin id=2 divn1=160 hpre=2 flash_latency=3
+ *
+ * Verify a blob and print its clock tree:
+ *    clock_profile_tool verify profile.bin
+ *
+ * Program it into the profile sector (bank 2, sector 7):
+ *    STM32_Programmer_CLI -c port=SWD -w profile.bin 0x081E0000
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "clock_profile.h"
+
+typedef struct
+{
+	const char *name;
+	size_t      offset;
+	size_t      size;
+} Field_t;
+
+#define FIELD(f)   { #f, offsetof(ClockProfile_t, f), sizeof(((ClockProfile_t *)0)->f) }
+
+static const Field_t Fields[] =
+{
+	{ "id", offsetof(ClockProfile_t, profile_id), sizeof(uint32_t) },
+	FIELD(hse_hz), FIELD(vos), FIELD(pll_src), FIELD(divm1), FIELD(pll1rge),
+	FIELD(divn1), FIELD(fracn1), FIELD(divp1), FIELD(divq1), FIELD(divr1),
+	FIELD(pll1vcosel), FIELD(d1cpre), FIELD(hpre), FIELD(d1ppre), FIELD(d2ppre1),
+	FIELD(d2ppre2), FIELD(d3ppre), FIELD(flash_latency), FIELD(flash_wrhighfreq),
+	FIELD(hse_mode)
+};
+
+static int Set_Field(ClockProfile_t *profile, const char *arg)
+{
+	const char   *eq = strchr(arg, '=');
+	unsigned long value;
+
+	if (eq == NULL)
+	{
+		return -1;
+	}
+	value = strtoul(eq + 1, NULL, 0);
+
+	for (size_t i = 0; i < sizeof(Fields) / sizeof(Fields[0]); i++)
+	{
+		if ((strlen(Fields[i].name) == (size_t)(eq - arg)) &&
+		    (strncmp(Fields[i].name, arg, (size_t)(eq - arg)) == 0))
+		{
+			uint8_t *dst = (uint8_t *)profile + Fields[i].offset;
+
+			/* The host is little-endian like the Cortex-M7 */
+			for (size_t b = 0; b < Fields[i].size; b++)
+			{
+				dst[b] = (uint8_t)(value >> (8U * b));
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+static void Print_Profile(const ClockProfile_t *profile)
+{
+	ClockProfile_Freq_t freq;
+
+	printf("profile id  : %lu\n", (unsigned long)profile->profile_id);
+	printf("PLL1        : M=%u N=%u FRACN=%u P=%u Q=%u R=%u RGE=%u VCOSEL=%u\n",
+	       profile->divm1, profile->divn1, profile->fracn1, profile->divp1,
+	       profile->divq1, profile->divr1, profile->pll1rge, profile->pll1vcosel);
+	printf("prescalers  : D1CPRE=%u HPRE=%u D1PPRE=%u D2PPRE1=%u D2PPRE2=%u D3PPRE=%u\n",
+	       profile->d1cpre, profile->hpre, profile->d1ppre, profile->d2ppre1,
+	       profile->d2ppre2, profile->d3ppre);
+	printf("VOS%u, flash: %u WS, WRHIGHFREQ=%u\n",
+	       profile->vos, profile->flash_latency, profile->flash_wrhighfreq);
+
+	if (Clock_Profile_Frequencies(profile, &freq) == CLOCK_PROFILE_OK)
+	{
+		printf("VCO %lu Hz, sys_ck %lu Hz, hclk %lu Hz\n",
+		       (unsigned long)freq.vco_hz, (unsigned long)freq.sysclk_hz, (unsigned long)freq.hclk_hz);
+		printf("pll1_q %lu Hz, pll1_r %lu Hz\n",
+		       (unsigned long)freq.pll1_q_hz, (unsigned long)freq.pll1_r_hz);
+		printf("pclk1 %lu Hz, pclk2 %lu Hz, pclk3 %lu Hz, pclk4 %lu Hz\n",
+		       (unsigned long)freq.pclk1_hz, (unsigned long)freq.pclk2_hz,
+		       (unsigned long)freq.pclk3_hz, (unsigned long)freq.pclk4_hz);
+	}
+}
+
+static int Generate(const char *path, int argc, char **argv)
+{
+	ClockProfile_t        profile = Clock_Profile_Default;
+	ClockProfile_Status_t status;
+	FILE                 *out;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (Set_Field(&profile, argv[i]) != 0)
+		{
+			fprintf(stderr, "unknown field: %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	Clock_Profile_Seal(&profile);
+	status = Clock_Profile_Validate(&profile);
+	Print_Profile(&profile);
+	if (status != CLOCK_PROFILE_OK)
+	{
+		fprintf(stderr, "rejected: %s\n", Clock_Profile_Status_Name(status));
+		return 1;
+	}
+
+	out = fopen(path, "wb");
+	if ((out == NULL) || (fwrite(&profile, sizeof(profile), 1, out) != 1))
+	{
+		fprintf(stderr, "cannot write %s\n", path);
+		return 1;
+	}
+	fclose(out);
+	printf("written %s, CRC 0x%08lX\n", path, (unsigned long)profile.crc);
+	return 0;
+}
+
+static int Verify(const char *path)
+{
+	ClockProfile_t        profile;
+	ClockProfile_Status_t status;
+	FILE                 *in = fopen(path, "rb");
+
+	if ((in == NULL) || (fread(&profile, sizeof(profile), 1, in) != 1))
+	{
+		fprintf(stderr, "cannot read %u bytes from %s\n", CLOCK_PROFILE_SIZE, path);
+		return 1;
+	}
+	fclose(in);
+
+	status = Clock_Profile_Validate(&profile);
+	Print_Profile(&profile);
+	printf("%s: %s\n", path, Clock_Profile_Status_Name(status));
+	return (status == CLOCK_PROFILE_OK) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	if ((argc >= 3) && (strcmp(argv[1], "gen") == 0))
+	{
+		return Generate(argv[2], argc - 3, argv + 3);
+	}
+	if ((argc == 3) && (strcmp(argv[1], "verify") == 0))
+	{
+		return Verify(argv[2]);
+	}
+
+	fprintf(stderr, "usage: %s gen <file> [field=value ...]\n", argv[0]);
+	fprintf(stderr, "       %s verify <file>\n", argv[0]);
+	return 2;
+}
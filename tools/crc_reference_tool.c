@@ -0,0 +1,86 @@
+/*
+ ******************************************************************************
+ * File              : crc_reference_tool.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Host PC (Windows, Linux)
+ * Description       : Host reference CRC for the CRC unit of the board
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * Date              : October 19, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Build on the host, the CRC code is the same source as on the board:
+ *    gcc -I.. -o crc_reference_tool crc_reference_tool.c ../crc_soft.c
+ *
+ * Without argument, check all presets on "123456789" and print the CRCs of
+ * the 1031-byte pattern used by CRC_Engine_Self_Test(). With a file name,
+ * print the CRC of the file for every preset (firmware images, log files).
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "crc_soft.h"
+
+static CRC_Soft_t Soft;
+
+int main(int argc, char **argv)
+{
+	static uint8_t buffer[1040];
+	uint8_t       *data   = buffer;
+	long           length = 0;
+	int            failures = 0;
+
+	if (argc == 2)
+	{
+		FILE *in = fopen(argv[1], "rb");
+
+		if ((in == NULL) || (fseek(in, 0, SEEK_END) != 0) || ((length = ftell(in)) < 0))
+		{
+			fprintf(stderr, "cannot read %s\n", argv[1]);
+			return 1;
+		}
+		data = malloc((size_t)length + 1U);
+		rewind(in);
+		if ((data == NULL) || (fread(data, 1, (size_t)length, in) != (size_t)length))
+		{
+			fprintf(stderr, "cannot read %s\n", argv[1]);
+			return 1;
+		}
+		fclose(in);
+	}
+	else
+	{
+		/* Same pattern as CRC_Engine_Self_Test(), from byte 1, 1031 bytes */
+		for (unsigned i = 0; i < sizeof(buffer); i++)
+		{
+			buffer[i] = (uint8_t)((i * 131U) ^ (i >> 3));
+		}
+		data   = &buffer[1];
+		length = 1031;
+	}
+
+	for (uint32_t i = 0U; i < CRC_Preset_Count; i++)
+	{
+		const CRC_Params_t *params = CRC_Presets[i];
+		uint32_t            check;
+
+		CRC_Soft_Init(&Soft, params);
+		check = CRC_Soft_Compute(&Soft, "123456789", 9U);
+		if (check != params->check)
+		{
+			failures++;
+		}
+		printf("%-14s check 0x%08lX %s  data 0x%08lX\n", params->name, (unsigned long)check,
+		       (check == params->check) ? "ok  " : "FAIL",
+		       (unsigned long)CRC_Soft_Compute(&Soft, data, (uint32_t)length));
+	}
+	return failures ? 1 : 0;
+}
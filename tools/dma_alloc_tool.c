@@ -0,0 +1,160 @@
+/*
+ ******************************************************************************
+ * File              : dma_alloc_tool.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Host PC (Windows, Linux)
+ * Description       : Check the DMA stream allocation rules on the host
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * Date              : October 29, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Build on the host, the allocator is the same source as on the board:
+ *    gcc -I.. -o dma_alloc_tool dma_alloc_tool.c ../dma_alloc_table.c
+ *
+ * Without argument, run the checks on the boot reservations of the firmware
+ * (see dma_alloc.c) and print the resulting table. The exit code is the
+ * number of failed checks.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include "dma_alloc_table.h"
+
+static int Failures;
+
+#define CHECK(cond)   Check((cond), #cond, __LINE__)
+
+static void Check(int cond, const char *text, int line)
+{
+	if (!cond)
+	{
+		printf("FAIL line %d: %s\n", line, text);
+		Failures++;
+	}
+}
+
+/* Same streams as the drivers reserve on the board */
+static void Boot_Reservations(DMA_Alloc_Table_t *table)
+{
+	static const struct { uint8_t handle; DMA_Alloc_Request_t req; } Boot[] =
+	{
+		{ DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 0), { "sai_tx",  1U,  87U, DMA_ALLOC_HIGH } },
+		{ DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 1), { "sai_rx",  1U,  88U, DMA_ALLOC_HIGH } },
+		{ DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 2), { "dfsdm0",  1U, 101U, DMA_ALLOC_HIGH } },
+		{ DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 3), { "dfsdm1",  1U, 102U, DMA_ALLOC_HIGH } },
+		{ DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 0), { "wave",    1U,  51U, DMA_ALLOC_VERY_HIGH } },
+		{ DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 1), { "hrtim",   1U,  95U, DMA_ALLOC_HIGH } },
+		{ DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 2), { "capture", 1U,  55U, DMA_ALLOC_HIGH } },
+	};
+
+	for (unsigned i = 0; i < sizeof(Boot) / sizeof(Boot[0]); i++)
+	{
+		CHECK(DMA_Alloc_Table_Reserve(table, Boot[i].handle, &Boot[i].req) == DMA_ALLOC_OK);
+	}
+}
+
+static void Print(const DMA_Alloc_Table_t *table)
+{
+	static const char *Names[DMA_ALLOC_CONTROLLERS] = { "DMA1", "DMA2", "BDMA" };
+	DMA_Alloc_Contention_t cont;
+
+	DMA_Alloc_Table_Contention(table, &cont);
+
+	for (unsigned c = 0; c < DMA_ALLOC_CONTROLLERS; c++)
+	{
+		for (unsigned s = 0; s < DMA_ALLOC_STREAMS; s++)
+		{
+			const DMA_Alloc_Entry_t *e = &table->entry[c][s];
+
+			if (e->used)
+			{
+				printf("%s S%u  %-10s req %3u  class %u  contenders %u  bytes %lu\n", Names[c], s,
+				       e->req.owner, e->req.request, e->req.prio, cont.contenders[c][s], (unsigned long)e->bytes);
+			}
+		}
+	}
+	printf("active %u/%u/%u  failures %lu\n", cont.active[0], cont.active[1], cont.active[2],
+	       (unsigned long)cont.failures);
+}
+
+int main(void)
+{
+	static DMA_Alloc_Table_t table;
+	DMA_Alloc_Request_t req;
+	DMA_Alloc_Contention_t cont;
+	uint8_t h, h2;
+
+	DMA_Alloc_Table_Init(&table);
+	Boot_Reservations(&table);
+
+	/* A second driver on a reserved stream is refused, the owner may reserve again */
+	req = (DMA_Alloc_Request_t){ "spi1_rx", 1U, 37U, DMA_ALLOC_HIGH };
+	CHECK(DMA_Alloc_Table_Reserve(&table, DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 0), &req) == DMA_ALLOC_ERR_BUSY);
+	req = (DMA_Alloc_Request_t){ "sai_tx", 1U, 87U, DMA_ALLOC_HIGH };
+	CHECK(DMA_Alloc_Table_Reserve(&table, DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 0), &req) == DMA_ALLOC_OK);
+
+	/* DMAMUX2 requests only go to the BDMA, and the other way round */
+	req = (DMA_Alloc_Request_t){ "spi6_rx", 2U, 11U, DMA_ALLOC_MEDIUM };
+	CHECK(DMA_Alloc_Table_Reserve(&table, DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 7), &req) == DMA_ALLOC_ERR_PARAM);
+	CHECK(DMA_Alloc_Table_Allocate(&table, &req, &h) == DMA_ALLOC_OK);
+	CHECK(DMA_ALLOC_CONTROLLER(h) == DMA_ALLOC_BDMA);
+	CHECK(DMA_ALLOC_STREAM(h) == 7U);  // MEDIUM takes the highest number
+	req = (DMA_Alloc_Request_t){ "lpuart_rx", 2U, 9U, DMA_ALLOC_VERY_HIGH };
+	CHECK(DMA_Alloc_Table_Allocate(&table, &req, &h) == DMA_ALLOC_OK);
+	CHECK(h == DMA_ALLOC_HANDLE(DMA_ALLOC_BDMA, 0));
+
+	/* Bad requests */
+	req = (DMA_Alloc_Request_t){ "bad", 1U, 0U, DMA_ALLOC_LOW };
+	CHECK(DMA_Alloc_Table_Allocate(&table, &req, &h) == DMA_ALLOC_ERR_PARAM);
+	req = (DMA_Alloc_Request_t){ "bad", 2U, DMA_ALLOC_DMAMUX2_MAX + 1U, DMA_ALLOC_LOW };
+	CHECK(DMA_Alloc_Table_Allocate(&table, &req, &h) == DMA_ALLOC_ERR_PARAM);
+	req = (DMA_Alloc_Request_t){ "bad", 1U, 37U, 4U };
+	CHECK(DMA_Alloc_Table_Allocate(&table, &req, &h) == DMA_ALLOC_ERR_PARAM);
+
+	/* An urgent request goes where the fewest streams win against it:
+	 * DMA2 S0 (GPIO wave) is VERY_HIGH, DMA1 has none, so DMA1 S4 wins every tie
+	 */
+	req = (DMA_Alloc_Request_t){ "spi1_rx", 1U, 37U, DMA_ALLOC_VERY_HIGH };
+	CHECK(DMA_Alloc_Table_Allocate(&table, &req, &h) == DMA_ALLOC_OK);
+	CHECK(h == DMA_ALLOC_HANDLE(DMA_ALLOC_DMA1, 4));
+	CHECK(DMA_Alloc_Table_Contenders(&table, h, DMA_ALLOC_VERY_HIGH) == 0U);
+
+	/* A background request takes the highest free number */
+	req = (DMA_Alloc_Request_t){ "uart7_tx", 1U, 80U, DMA_ALLOC_LOW };
+	CHECK(DMA_Alloc_Table_Allocate(&table, &req, &h2) == DMA_ALLOC_OK);
+	CHECK(DMA_ALLOC_STREAM(h2) == 7U);
+
+	/* Release gives the stream back */
+	DMA_Alloc_Table_Release(&table, h2);
+	CHECK(!table.entry[DMA_ALLOC_CONTROLLER(h2)][7].used);
+
+	/* Bytes and contention */
+	DMA_Alloc_Table_Account(&table, h, 4096U);
+	DMA_Alloc_Table_Account(&table, h, 4096U);
+	DMA_Alloc_Table_Account(&table, DMA_ALLOC_HANDLE(DMA_ALLOC_DMA2, 6), 100U);  // Not allocated, ignored
+	DMA_Alloc_Table_Contention(&table, &cont);
+	CHECK(cont.busiest == h);
+	CHECK(cont.bytes[DMA_ALLOC_DMA1] == 8192U);
+	CHECK(table.entry[DMA_ALLOC_DMA1][4].transfers == 2U);
+
+	/* Fill every DMAMUX1 stream, the next request fails and is counted */
+	while (DMA_Alloc_Table_Allocate(&table, &req, &h2) == DMA_ALLOC_OK) {}
+	DMA_Alloc_Table_Contention(&table, &cont);
+	CHECK(cont.active[DMA_ALLOC_DMA1] == DMA_ALLOC_STREAMS);
+	CHECK(cont.active[DMA_ALLOC_DMA2] == DMA_ALLOC_STREAMS);
+	CHECK(cont.failures == 2U);  // One BUSY reservation, one FULL allocation
+	CHECK(cont.contenders[DMA_ALLOC_DMA1][4] == 0U);  // VERY_HIGH beats the earlier HIGH streams
+	CHECK(cont.contenders[DMA_ALLOC_DMA1][7] == 7U);
+
+	Print(&table);
+	printf("%s, %d failed checks\n", Failures ? "FAILED" : "PASSED", Failures);
+	return Failures;
+}
@@ -0,0 +1,205 @@
+/*
+ ******************************************************************************
+ * File              : i2c_timing_tool.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Host PC (Windows, Linux)
+ * Description       : Check I2C_TIMINGR over the kernel clock range on the host
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * Date              : November 7, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Build on the host, the computation is the same source as on the board:
+ *    gcc -I.. -o i2c_timing_tool i2c_timing_tool.c ../i2c_timing.c
+ *
+ * Every kernel clock from 4 to 150 MHz (250 kHz steps) and every speed is
+ * computed with the worst rise and fall times of the specification, then
+ * checked again from the register fields: tLOW, tHIGH, tSU;DAT, tHD;DAT
+ * and an SCL frequency between I2C_TIMING_MIN_PERCENT of the speed and the
+ * speed. A setting must exist from 4 MHz (100 kHz), 5 MHz (400 kHz) and
+ * 13 MHz (1 MHz) up. The kernel clocks where tVD;DAT(max) is exceeded are
+ * counted, see i2c_timing.c: with the worst edges at 1 MHz, all of them.
+ *
+ * The table shows the kernel clocks of the board: rcc_pclk1 at the three
+ * throttle levels of the default profile, HSI and CSI, with the rise and
+ * fall times of the main.c configuration (100 ns and 20 ns).
+ *
+ * The Fast-mode Plus bus utilisation is a model of the master: START hold
+ * and STOP setup of one high phase, a repeated START of one SCL period, the
+ * bus free time of one low phase before the next START. Utilisation is the
+ * payload bits over the bus time at 1 Mbit/s, without the gap the
+ * software leaves between transactions (measured by I2C_Engine_Benchmark()
+ * on the board). The exit code is the number of failed checks.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include "i2c_timing.h"
+
+#define BOARD_RISE_NS   ( 100U )
+#define BOARD_FALL_NS   ( 20U )
+
+static int Failures;
+
+#define CHECK(cond)   Check((cond), #cond, __LINE__)
+
+static void Check(int cond, const char *text, int line)
+{
+	if (!cond)
+	{
+		printf("FAIL line %d: %s\n", line, text);
+		Failures++;
+	}
+}
+
+/* Every kernel clock from this one up must give a setting, worst tr and tf */
+static const uint32_t Min_Kernel_Hz[I2C_TIMING_SPEEDS] = { 4000000UL, 5000000UL, 13000000UL };
+
+/* Limits again from the register fields, in ps */
+static void Verify(uint32_t kernel_hz, I2C_Timing_Speed_t speed, uint16_t rise, uint16_t fall, const I2C_Timing_t *t)
+{
+	const I2C_Timing_Spec_t *spec = I2C_Timing_Spec(speed);
+	double tclk   = 1e12 / kernel_hz;
+	double tpresc = (t->presc + 1U) * tclk;
+	double tsync  = I2C_TIMING_AF_MIN_NS * 1e3 + 2.0 * tclk;
+	double low    = tsync + (t->scll + 1U) * tpresc;
+	double high   = tsync + (t->sclh + 1U) * tpresc;
+	double scl_hz = 1e12 / (low + high + (rise + fall) * 1e3);
+
+	CHECK(t->timingr == I2C_TIMING_TIMINGR(t->presc, t->scldel, t->sdadel, t->sclh, t->scll));
+	CHECK((t->presc <= 15U) && (t->scldel <= 15U) && (t->sdadel <= 15U));
+	CHECK(low  >= spec->low_min  * 1e3);
+	CHECK(high >= spec->high_min * 1e3);
+	CHECK((t->scldel + 1U) * tpresc - rise * 1e3 >= spec->su_dat_min * 1e3);
+	CHECK(t->sdadel * tpresc >= (fall + spec->hd_dat_min - (double)I2C_TIMING_AF_MIN_NS) * 1e3 - 3.0 * tclk);
+	CHECK(scl_hz <= spec->scl_hz * 1.000001);
+	CHECK((scl_hz - t->scl_hz < scl_hz * 1e-3) && (t->scl_hz - scl_hz < scl_hz * 1e-3));
+	CHECK(scl_hz * 100.0 >= (double)I2C_TIMING_MIN_PERCENT * spec->scl_hz);
+}
+
+static void Sweep(void)
+{
+	for (unsigned s = 0; s < I2C_TIMING_SPEEDS; s++)
+	{
+		const I2C_Timing_Spec_t *spec = I2C_Timing_Spec((I2C_Timing_Speed_t)s);
+		uint32_t lowest = 0U, fits = 0U, tried = 0U, vd_miss = 0U;
+		double   worst = 1.0;
+
+		for (uint32_t hz = 4000000UL; hz <= 150000000UL; hz += 250000UL)
+		{
+			I2C_Timing_t t;
+
+			tried++;
+			if (!I2C_Timing_Compute(hz, (I2C_Timing_Speed_t)s, spec->rise_max, spec->fall_max, &t))
+			{
+				CHECK(hz < Min_Kernel_Hz[s]);
+				continue;
+			}
+			lowest = lowest ? lowest : hz;
+			fits++;
+			Verify(hz, (I2C_Timing_Speed_t)s, spec->rise_max, spec->fall_max, &t);
+			vd_miss += (t.sdadel * (t.presc + 1U) * (1e9 / hz) >
+			            (double)spec->vd_dat_max - spec->rise_max - I2C_TIMING_AF_MAX_NS - 4.0 * (1e9 / hz));
+			worst = (t.scl_hz < worst * spec->scl_hz) ? (double)t.scl_hz / spec->scl_hz : worst;
+		}
+		printf("%-8s worst tr/tf: %3u of %3u kernel clocks from %5.2f MHz, SCL >= %4.1f %%, tVD;DAT over on %3u\n",
+		       I2C_Timing_Name((I2C_Timing_Speed_t)s), fits, tried, lowest / 1e6, 100.0 * worst, vd_miss);
+	}
+}
+
+static void Board_Table(void)
+{
+	static const struct { const char *name; uint32_t hz; } Clocks[] =
+	{
+		{ "pclk1 full",    120000000UL },
+		{ "pclk1 half",     60000000UL },
+		{ "pclk1 quarter",  30000000UL },
+		{ "hsi_ker",        64000000UL },
+		{ "csi_ker",         4000000UL },
+	};
+
+	printf("\nkernel clock          speed     TIMINGR     PRESC SCLDEL SDADEL SCLH SCLL  tLOW  tHIGH  SCL\n");
+	for (unsigned c = 0; c < sizeof(Clocks) / sizeof(Clocks[0]); c++)
+	{
+		for (unsigned s = 0; s < I2C_TIMING_SPEEDS; s++)
+		{
+			I2C_Timing_t t;
+
+			if (!I2C_Timing_Compute(Clocks[c].hz, (I2C_Timing_Speed_t)s, BOARD_RISE_NS, BOARD_FALL_NS, &t))
+			{
+				printf("%-13s %3u MHz %-8s  none\n", Clocks[c].name, Clocks[c].hz / 1000000U,
+				       I2C_Timing_Name((I2C_Timing_Speed_t)s));
+				continue;
+			}
+			Verify(Clocks[c].hz, (I2C_Timing_Speed_t)s, BOARD_RISE_NS, BOARD_FALL_NS, &t);
+			printf("%-13s %3u MHz %-8s  0x%08lX  %5u %6u %6u %4u %4u  %4lu  %5lu  %7.1f kHz\n",
+			       Clocks[c].name, Clocks[c].hz / 1000000U, I2C_Timing_Name((I2C_Timing_Speed_t)s),
+			       (unsigned long)t.timingr, t.presc, t.scldel, t.sdadel, t.sclh, t.scll,
+			       (unsigned long)t.low_ns, (unsigned long)t.high_ns, t.scl_hz / 1000.0);
+		}
+	}
+}
+
+/* Bus time of one transaction in ns, see the comments on top */
+static double Transaction_Ns(const I2C_Timing_t *t, unsigned tx, unsigned rx)
+{
+	double period = 1e9 / t->scl_hz;
+	double ns     = t->high_ns;
+
+	if (tx != 0U)
+	{
+		ns += 9.0 * (1U + tx) * period;
+	}
+	if (rx != 0U)
+	{
+		ns += ((tx != 0U) ? period : 0.0) + 9.0 * (1U + rx) * period;
+	}
+	return ns + t->high_ns + t->low_ns;
+}
+
+static void Utilisation(void)
+{
+	static const struct { const char *name; unsigned tx, rx, payload; } Shapes[] =
+	{
+		{ "register read 2 B",  1U,   2U,   2U },
+		{ "register read 6 B",  1U,   6U,   6U },
+		{ "block read 32 B",    1U,  32U,  32U },
+		{ "block write 32 B",  33U,   0U,  32U },
+		{ "read 255 B",         0U, 255U, 255U },
+	};
+	static const uint32_t Clocks[] = { 120000000UL, 30000000UL };
+
+	for (unsigned c = 0; c < sizeof(Clocks) / sizeof(Clocks[0]); c++)
+	{
+		I2C_Timing_t t;
+
+		CHECK(I2C_Timing_Compute(Clocks[c], I2C_TIMING_FAST_PLUS, BOARD_RISE_NS, BOARD_FALL_NS, &t));
+		printf("\nFast-mode Plus, kernel %u MHz, SCL %.1f kHz\n", Clocks[c] / 1000000U, t.scl_hz / 1000.0);
+		for (unsigned i = 0; i < sizeof(Shapes) / sizeof(Shapes[0]); i++)
+		{
+			double ns   = Transaction_Ns(&t, Shapes[i].tx, Shapes[i].rx);
+			double util = 8.0 * Shapes[i].payload * 1000.0 / ns;   // Payload bits at 1 Mbit/s
+
+			printf("  %-18s %8.1f us  payload %6.1f kbit/s  utilisation %5.1f %%\n",
+			       Shapes[i].name, ns / 1000.0, 8e6 * Shapes[i].payload / ns, 100.0 * util);
+			CHECK(util < 1.0);
+		}
+	}
+}
+
+int main(void)
+{
+	Sweep();
+	Board_Table();
+	Utilisation();
+
+	printf("\n%s\n", Failures ? "FAILED" : "PASSED");
+	return Failures;
+}
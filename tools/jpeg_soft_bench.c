@@ -0,0 +1,603 @@
+/*
+ ******************************************************************************
+ * File              : jpeg_soft_bench.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Host PC (Windows, Linux)
+ * Description       : Software baseline JPEG decoder, reference for the codec
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * Date              : October 22, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Build on the host, the tables are the same source as on the board:
+ *    gcc -O2 -I.. -o jpeg_soft_bench jpeg_soft_bench.c ../jpeg_tables.c -lm
+ *
+ *    jpeg_soft_bench <file.jpg> [runs] [out.ppm]
+ *
+ * Decodes a baseline JPEG (the format of the hardware codec: 8-bit,
+ * Huffman, 1 or 3 components, 4:4:4, 4:2:2 or 4:2:0) the given number of
+ * times and prints frames/s of the software path, one core at 100 % load.
+ * Compare with JPEG_Codec_Stats() on the board for the same file, where the
+ * codec does the work and the CPU load is the interrupt time only.
+ * With out.ppm the image is written, to check a file encoded on the board.
+ *
+ * Without argument, check the HUFFENC words that jpeg_codec.c loads for the
+ * Annex K tables against codes taken from Tables K.3 and K.5. The exit code
+ * is the number of failed checks.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "jpeg_tables.h"
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	int32_t  maxcode[18] ;  // Largest code of each length, -1 if none
+	int32_t  valptr[17]  ;
+	uint16_t mincode[17] ;
+	uint8_t  vals[256]   ;
+} Huff_t;
+
+typedef struct
+{
+	uint8_t  id, h, v, tq, td, ta ;
+	int32_t  pred   ;
+	int32_t  stride ;
+	uint8_t *plane  ;
+} Comp_t;
+
+typedef struct
+{
+	const uint8_t *p, *end ;
+	uint32_t       bits    ;
+	int32_t        count   ;
+	uint16_t       qt[4][64] ;   // Natural order
+	Huff_t         dc[4], ac[4] ;
+	int32_t        width, height, ncomp, hmax, vmax, restart ;
+	Comp_t         comp[3] ;
+	uint8_t       *rgb ;
+} Dec_t;
+
+static float Idct_Cos[8][8];
+
+/************************ Bit reader ***********************************/
+
+static uint32_t Get_Bit(Dec_t *d)
+{
+	if (d->count == 0)
+	{
+		uint32_t byte = 0U;
+
+		/* 0xFF 0x00 is a stuffed 0xFF, any other marker ends the data */
+		if ((d->p < d->end) && !((d->p[0] == 0xFFU) && (d->p + 1 < d->end) && (d->p[1] != 0x00U)))
+		{
+			byte = *d->p++;
+			if (byte == 0xFFU)
+			{
+				d->p++;
+			}
+		}
+		d->bits  = byte;
+		d->count = 8;
+	}
+	d->count--;
+	return (d->bits >> d->count) & 1U;
+}
+
+static int32_t Get_Bits(Dec_t *d, int32_t n)
+{
+	int32_t v = 0;
+
+	while (n-- > 0)
+	{
+		v = (v << 1) | (int32_t)Get_Bit(d);
+	}
+	return v;
+}
+
+/* Figure F.12, EXTEND */
+static int32_t Extend(int32_t v, int32_t s)
+{
+	return (v < (1 << (s - 1))) ? (v - (1 << s) + 1) : v;
+}
+
+/* Figure F.16, DECODE */
+static int32_t Huff_Decode(Dec_t *d, const Huff_t *h)
+{
+	int32_t code = (int32_t)Get_Bit(d);
+	int32_t l    = 1;
+
+	while (code > h->maxcode[l])
+	{
+		code = (code << 1) | (int32_t)Get_Bit(d);
+		if (++l > 16)
+		{
+			return 0;
+		}
+	}
+	return h->vals[h->valptr[l] + code - h->mincode[l]];
+}
+
+/************************ Segments *************************************/
+
+static int Huff_Build(Huff_t *h, const uint8_t *bits, const uint8_t *vals)
+{
+	uint8_t  sizes[256];
+	uint16_t codes[256];
+	uint16_t n = JPEG_Huff_Codes(bits, sizes, codes);
+	int32_t  k = 0;
+
+	if (n == 0U)
+	{
+		return 0;
+	}
+	memcpy(h->vals, vals, n);
+	for (int32_t l = 1; l <= 16; l++)
+	{
+		if (bits[l - 1] != 0U)
+		{
+			h->valptr[l]  = k;
+			h->mincode[l] = codes[k];
+			k            += bits[l - 1];
+			h->maxcode[l] = codes[k - 1];
+		}
+		else
+		{
+			h->maxcode[l] = -1;
+		}
+	}
+	h->maxcode[17] = 0x7FFFFFFF;
+	return 1;
+}
+
+static int Parse_Segment(Dec_t *d, uint8_t marker, const uint8_t *s, uint32_t len)
+{
+	const uint8_t *end = s + len;
+
+	switch (marker)
+	{
+		case 0xDB:  /* DQT */
+			while (s < end)
+			{
+				uint8_t pq = s[0] >> 4, tq = s[0] & 3U;
+
+				if (pq != 0U)
+				{
+					return 0;
+				}
+				for (int i = 0; i < 64; i++)
+				{
+					d->qt[tq][JPEG_Zigzag[i]] = s[1 + i];
+				}
+				s += 65;
+			}
+			return 1;
+
+		case 0xC4:  /* DHT */
+			while (s < end)
+			{
+				uint8_t  tc = s[0] >> 4, th = s[0] & 3U;
+				uint32_t n  = 0U;
+
+				for (int i = 0; i < 16; i++)
+				{
+					n += s[1 + i];
+				}
+				if ((n > 256U) || !Huff_Build(tc ? &d->ac[th] : &d->dc[th], s + 1, s + 17))
+				{
+					return 0;
+				}
+				s += 17 + n;
+			}
+			return 1;
+
+		case 0xC0:  /* SOF0 and SOF1, baseline and extended sequential */
+		case 0xC1:
+			if (s[0] != 8U)
+			{
+				return 0;
+			}
+			d->height = (s[1] << 8) | s[2];
+			d->width  = (s[3] << 8) | s[4];
+			d->ncomp  = s[5];
+			if ((d->ncomp != 1) && (d->ncomp != 3))
+			{
+				return 0;
+			}
+			for (int i = 0; i < d->ncomp; i++)
+			{
+				d->comp[i].id = s[6 + 3 * i];
+				d->comp[i].h  = s[7 + 3 * i] >> 4;
+				d->comp[i].v  = s[7 + 3 * i] & 15U;
+				d->comp[i].tq = s[8 + 3 * i] & 3U;
+				if (d->comp[i].h > d->hmax) d->hmax = d->comp[i].h;
+				if (d->comp[i].v > d->vmax) d->vmax = d->comp[i].v;
+			}
+			return 1;
+
+		case 0xDD:  /* DRI */
+			d->restart = (s[0] << 8) | s[1];
+			return 1;
+
+		default:
+			/* SOF2 and above: progressive, lossless, arithmetic */
+			return !((marker >= 0xC2U) && (marker <= 0xCFU) && (marker != 0xC4U) && (marker != 0xC8U) && (marker != 0xCCU));
+	}
+}
+
+/************************ Decoding *************************************/
+
+static void Idct_Init(void)
+{
+	for (int x = 0; x < 8; x++)
+	{
+		for (int u = 0; u < 8; u++)
+		{
+			Idct_Cos[x][u] = (float)(((u == 0) ? sqrt(0.5) : 1.0) * cos((2 * x + 1) * u * M_PI / 16.0) / 2.0);
+		}
+	}
+}
+
+static void Idct_Block(const int32_t *coef, uint8_t *out, int32_t stride)
+{
+	float tmp[64];
+
+	for (int y = 0; y < 8; y++)
+	{
+		for (int x = 0; x < 8; x++)
+		{
+			float sum = 0.0f;
+
+			for (int u = 0; u < 8; u++)
+			{
+				sum += Idct_Cos[x][u] * (float)coef[y * 8 + u];
+			}
+			tmp[y * 8 + x] = sum;
+		}
+	}
+	for (int x = 0; x < 8; x++)
+	{
+		for (int y = 0; y < 8; y++)
+		{
+			float   sum = 128.5f;
+			int32_t v;
+
+			for (int u = 0; u < 8; u++)
+			{
+				sum += Idct_Cos[y][u] * tmp[u * 8 + x];
+			}
+			v = (int32_t)floorf(sum);
+			out[y * stride + x] = (uint8_t)((v < 0) ? 0 : (v > 255) ? 255 : v);
+		}
+	}
+}
+
+static void Decode_Block(Dec_t *d, Comp_t *c, uint8_t *out)
+{
+	int32_t         coef[64] = { 0 };
+	const uint16_t *q        = d->qt[c->tq];
+	int32_t         t        = Huff_Decode(d, &d->dc[c->td]);
+
+	c->pred += t ? Extend(Get_Bits(d, t), t) : 0;
+	coef[0]  = c->pred * q[0];
+
+	for (int32_t k = 1; k < 64; k++)
+	{
+		int32_t rs = Huff_Decode(d, &d->ac[c->ta]);
+		int32_t r  = rs >> 4, s = rs & 15;
+
+		if (s == 0)
+		{
+			if (r != 15)
+			{
+				break;     // EOB
+			}
+			k += 15;       // ZRL
+			continue;
+		}
+		k += r;
+		if (k > 63)
+		{
+			break;
+		}
+		coef[JPEG_Zigzag[k]] = Extend(Get_Bits(d, s), s) * q[JPEG_Zigzag[k]];
+	}
+	Idct_Block(coef, out, c->stride);
+}
+
+static int Decode_Scan(Dec_t *d)
+{
+	int32_t mcu_w  = 8 * d->hmax, mcu_h = 8 * d->vmax;
+	int32_t mcus_x = (d->width + mcu_w - 1) / mcu_w;
+	int32_t mcus_y = (d->height + mcu_h - 1) / mcu_h;
+	int32_t n      = 0;
+
+	for (int i = 0; i < d->ncomp; i++)
+	{
+		d->comp[i].pred = 0;
+	}
+
+	for (int32_t my = 0; my < mcus_y; my++)
+	{
+		for (int32_t mx = 0; mx < mcus_x; mx++)
+		{
+			/* Restart marker: byte align, skip RSTn, reset the predictors */
+			if ((d->restart != 0) && (n != 0) && ((n % d->restart) == 0))
+			{
+				d->count = 0;
+				while ((d->p + 1 < d->end) && !((d->p[0] == 0xFFU) && (d->p[1] >= 0xD0U) && (d->p[1] <= 0xD7U)))
+				{
+					d->p++;
+				}
+				d->p += 2;
+				for (int i = 0; i < d->ncomp; i++)
+				{
+					d->comp[i].pred = 0;
+				}
+			}
+			for (int i = 0; i < d->ncomp; i++)
+			{
+				Comp_t *c = &d->comp[i];
+
+				for (int by = 0; by < c->v; by++)
+				{
+					for (int bx = 0; bx < c->h; bx++)
+					{
+						int32_t x = (mx * c->h + bx) * 8, y = (my * c->v + by) * 8;
+
+						Decode_Block(d, c, c->plane + y * c->stride + x);
+					}
+				}
+			}
+			n++;
+		}
+	}
+	return 1;
+}
+
+/* Chroma is replicated, no smoothing: the same as DMA2D on the board */
+static void To_RGB(Dec_t *d)
+{
+	for (int32_t y = 0; y < d->height; y++)
+	{
+		for (int32_t x = 0; x < d->width; x++)
+		{
+			uint8_t *o  = d->rgb + 3 * (y * d->width + x);
+			float    Y  = d->comp[0].plane[y * d->comp[0].v / d->vmax * d->comp[0].stride + x * d->comp[0].h / d->hmax];
+			float    cb = 0.0f, cr = 0.0f, rgb[3];
+
+			if (d->ncomp == 3)
+			{
+				cb = d->comp[1].plane[(y * d->comp[1].v / d->vmax) * d->comp[1].stride + x * d->comp[1].h / d->hmax] - 128.0f;
+				cr = d->comp[2].plane[(y * d->comp[2].v / d->vmax) * d->comp[2].stride + x * d->comp[2].h / d->hmax] - 128.0f;
+			}
+			rgb[0] = Y + 1.402f * cr;
+			rgb[1] = Y - 0.344136f * cb - 0.714136f * cr;
+			rgb[2] = Y + 1.772f * cb;
+			for (int i = 0; i < 3; i++)
+			{
+				o[i] = (uint8_t)((rgb[i] < 0.0f) ? 0 : (rgb[i] > 255.0f) ? 255 : (int)(rgb[i] + 0.5f));
+			}
+		}
+	}
+}
+
+static void Free_Planes(Dec_t *d)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		free(d->comp[i].plane);
+		d->comp[i].plane = NULL;
+	}
+	free(d->rgb);
+	d->rgb = NULL;
+}
+
+/* Returns 1 and d->rgb on success */
+static int Decode(Dec_t *d, const uint8_t *data, size_t size)
+{
+	const uint8_t *p = data, *end = data + size;
+
+	memset(d, 0, sizeof(*d));
+	if ((size < 4U) || (p[0] != 0xFFU) || (p[1] != 0xD8U))
+	{
+		return 0;
+	}
+	p += 2;
+
+	while (p + 4 <= end)
+	{
+		uint8_t  marker;
+		uint32_t len;
+
+		if (p[0] != 0xFFU)
+		{
+			return 0;
+		}
+		marker = p[1];
+		if (marker == 0xD9U)
+		{
+			break;
+		}
+		len = ((uint32_t)p[2] << 8) | p[3];
+		if ((len < 2U) || (p + 2 + len > end))
+		{
+			return 0;
+		}
+
+		if (marker == 0xDAU)
+		{
+			/* SOS: table selectors, then the entropy-coded data */
+			uint8_t ns = p[4];
+
+			if ((ns != d->ncomp) || (d->width == 0))
+			{
+				return 0;   // Only interleaved single-scan images
+			}
+			for (int i = 0; i < ns; i++)
+			{
+				for (int j = 0; j < d->ncomp; j++)
+				{
+					if (d->comp[j].id == p[5 + 2 * i])
+					{
+						d->comp[j].td = p[6 + 2 * i] >> 4;
+						d->comp[j].ta = p[6 + 2 * i] & 15U;
+					}
+				}
+			}
+			for (int i = 0; i < d->ncomp; i++)
+			{
+				Comp_t *c  = &d->comp[i];
+				int32_t mx = (d->width  + 8 * d->hmax - 1) / (8 * d->hmax);
+				int32_t my = (d->height + 8 * d->vmax - 1) / (8 * d->vmax);
+
+				c->stride = mx * c->h * 8;
+				c->plane  = malloc((size_t)c->stride * my * c->v * 8);
+			}
+			d->rgb = malloc((size_t)d->width * d->height * 3U);
+			d->p   = p + 2 + len;
+			d->end = end;
+			if ((d->rgb == NULL) || (d->comp[0].plane == NULL) || !Decode_Scan(d))
+			{
+				return 0;
+			}
+			To_RGB(d);
+			return 1;
+		}
+
+		if (!Parse_Segment(d, marker, p + 4, len - 2U))
+		{
+			fprintf(stderr, "unsupported segment FF%02X\n", marker);
+			return 0;
+		}
+		p += 2 + len;
+	}
+	return 0;
+}
+
+/* (length - 1) << 8 | low byte of the code, Annex K */
+static int Check_Huff_Enc(void)
+{
+	static const struct { const JPEG_Huff_Table_t *table; uint8_t ac; uint8_t index; uint16_t word; } Expect[] =
+	{
+		{ &JPEG_Huff_DC_Luma,   0U,   0U, 0x0100U },  // 00
+		{ &JPEG_Huff_DC_Luma,   0U,   1U, 0x0202U },  // 010
+		{ &JPEG_Huff_DC_Luma,   0U,   6U, 0x030EU },  // 1110
+		{ &JPEG_Huff_DC_Luma,   0U,  11U, 0x08FEU },  // 111111110
+		{ &JPEG_Huff_DC_Luma,   0U,  12U, 0x0FFFU },
+		{ &JPEG_Huff_DC_Chroma, 0U,   0U, 0x0100U },  // 00
+		{ &JPEG_Huff_DC_Chroma, 0U,  11U, 0x0AFEU },  // 11111111110
+		{ &JPEG_Huff_AC_Luma,   1U,   0U, 0x0100U },  // 0/1: 00
+		{ &JPEG_Huff_AC_Luma,   1U,   2U, 0x0204U },  // 0/3: 100
+		{ &JPEG_Huff_AC_Luma,   1U,  10U, 0x030CU },  // 1/1: 1100
+		{ &JPEG_Huff_AC_Luma,   1U, 159U, 0x0FFEU },  // F/A: 1111111111111110
+		{ &JPEG_Huff_AC_Luma,   1U, 160U, 0x030AU },  // EOB: 1010
+		{ &JPEG_Huff_AC_Luma,   1U, 161U, 0x0AF9U },  // ZRL: 11111111001
+		{ &JPEG_Huff_AC_Luma,   1U, 162U, 0x0FFFU },
+		{ &JPEG_Huff_AC_Luma,   1U, 168U, 0x0FD0U },
+		{ &JPEG_Huff_AC_Luma,   1U, 175U, 0x0FD7U },
+		{ &JPEG_Huff_AC_Chroma, 1U,   0U, 0x0101U },  // 0/1: 01
+		{ &JPEG_Huff_AC_Chroma, 1U, 160U, 0x0100U },  // EOB: 00
+		{ &JPEG_Huff_AC_Chroma, 1U, 161U, 0x09FAU },  // ZRL: 1111111010
+	};
+	uint16_t entry[JPEG_HUFFENC_AC_ENTRIES];
+	int      failures = 0;
+
+	for (size_t i = 0; i < sizeof(Expect) / sizeof(Expect[0]); i++)
+	{
+		uint32_t n = JPEG_Huff_Enc_Entries(Expect[i].table, Expect[i].ac, entry);
+
+		if ((n != (Expect[i].ac ? JPEG_HUFFENC_AC_ENTRIES : JPEG_HUFFENC_DC_ENTRIES)) ||
+		    (entry[Expect[i].index] != Expect[i].word))
+		{
+			printf("FAIL %s table, entry %u: 0x%04X, expected 0x%04X\n", Expect[i].ac ? "AC" : "DC",
+			       Expect[i].index, entry[Expect[i].index], Expect[i].word);
+			failures++;
+		}
+	}
+	printf("%s\n", failures ? "FAILED" : "PASSED");
+	return failures;
+}
+
+int main(int argc, char **argv)
+{
+	static Dec_t dec;
+	FILE        *in;
+	uint8_t     *data;
+	long         size;
+	int          runs = (argc > 2) ? atoi(argv[2]) : 20;
+	clock_t      start;
+	double       seconds;
+
+	if (argc < 2)
+	{
+		return Check_Huff_Enc();
+	}
+	in = fopen(argv[1], "rb");
+	if ((in == NULL) || (fseek(in, 0, SEEK_END) != 0) || ((size = ftell(in)) <= 0))
+	{
+		fprintf(stderr, "cannot read %s\n", argv[1]);
+		return 1;
+	}
+	data = malloc((size_t)size);
+	rewind(in);
+	if ((data == NULL) || (fread(data, 1, (size_t)size, in) != (size_t)size))
+	{
+		fprintf(stderr, "cannot read %s\n", argv[1]);
+		return 1;
+	}
+	fclose(in);
+
+	Idct_Init();
+	if (runs < 1)
+	{
+		runs = 1;
+	}
+
+	start = clock();
+	for (int i = 0; i < runs; i++)
+	{
+		Free_Planes(&dec);
+		if (!Decode(&dec, data, (size_t)size))
+		{
+			fprintf(stderr, "%s: not a baseline JPEG this decoder handles\n", argv[1]);
+			return 1;
+		}
+	}
+	seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("%s: %d x %d, %d component(s), sampling %dx%d, %ld bytes\n",
+	       argv[1], dec.width, dec.height, dec.ncomp, dec.hmax, dec.vmax, size);
+	printf("software decode: %.3f ms/frame, %.1f frames/s, %.2f Mpixel/s, CPU load 100 %%\n",
+	       1000.0 * seconds / runs, runs / seconds, (double)dec.width * dec.height * runs / seconds / 1e6);
+
+	if (argc > 3)
+	{
+		FILE *out = fopen(argv[3], "wb");
+
+		if (out == NULL)
+		{
+			fprintf(stderr, "cannot write %s\n", argv[3]);
+			return 1;
+		}
+		fprintf(out, "P6\n%d %d\n255\n", dec.width, dec.height);
+		fwrite(dec.rgb, 3, (size_t)dec.width * dec.height, out);
+		fclose(out);
+	}
+	Free_Planes(&dec);
+	free(data);
+	return 0;
+}
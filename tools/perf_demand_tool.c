@@ -0,0 +1,301 @@
+/*
+ ******************************************************************************
+ * File              : perf_demand_tool.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Host PC (Windows, Linux)
+ * Description       : Replay a work load on the performance demand policies
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * Date              : November 4, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Build on the host, the policy is the same source as on the board:
+ *    gcc -I.. -o perf_demand_tool perf_demand_tool.c ../perf_demand_policy.c ../clock_plan.c ../clock_profile_blob.c
+ *
+ * Five points from two profiles: 480 MHz at VOS0 (the default profile) and
+ * 200 MHz at VOS3, each with its throttle levels. Transition times come from
+ * clock_plan.c. The powers are a model (C V^2 f plus leakage at the middle
+ * of the VOS voltage range of the datasheet), good to compare policies, not
+ * to predict a board.
+ *
+ * The work load runs for 10 s of simulated time:
+ *
+ *   control   every 2 ms, 40 k cycles, deadline 4 ms
+ *   display   every 16.7 ms, 4 items of 400 k cycles, deadline 16.7 ms
+ *   dsp       every 40 to 80 ms, 6 items of 1 M cycles, at least 400 MHz,
+ *             deadline 25 ms
+ *   log       every 100 ms, 1 M cycles, no deadline
+ *
+ * Items run to completion, so no item is longer than the shortest deadline
+ * allows at 480 MHz.
+ *
+ * Actual cycles vary by +-10 % around the declared estimate. Each policy
+ * gets the same trace. Printed per policy: energy, mean power, deadline
+ * misses, transitions and the time at each point. The exit code is the
+ * number of failed checks. With the defaults of perf_demand_policy.c:
+ *
+ *   max        3560 mJ   0 misses      0 transitions
+ *   per-item   2534 mJ   0 misses   4832 transitions (403 ms)
+ *   batch      2447 mJ   0 misses   3525 transitions (174 ms)
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "perf_demand.h"
+
+#define SIM_END_NS      ( 10000000000ULL )
+#define MS              ( 1000000ULL )
+#define SOURCES         ( 4U )
+
+typedef struct
+{
+	const char *name     ;
+	uint64_t    period_ns ;  // 0: random between 40 and 80 ms
+	uint32_t    items    ;  // Released together
+	uint32_t    cycles   ;  // Per item
+	uint32_t    min_hz   ;
+	uint64_t    relative_deadline_ns ;
+} Source_t;
+
+static const Source_t Sources[SOURCES] =
+{
+	{ "control",  2U * MS,      1U,    40000U,         0U,  4U * MS },
+	{ "display",  16666667ULL,  4U,   400000U,         0U,  16666667ULL },
+	{ "dsp",      0U,           6U,  1000000U, 400000000U, 25U * MS },
+	{ "log",      100U * MS,    1U,  1000000U,         0U,  0U },
+};
+
+static int Failures;
+
+#define CHECK(cond)   Check((cond), #cond, __LINE__)
+
+static void Check(int cond, const char *text, int line)
+{
+	if (!cond)
+	{
+		printf("FAIL line %d: %s\n", line, text);
+		Failures++;
+	}
+}
+
+/* Two streams, release times and cycle spread: every policy sees the same trace */
+static uint32_t Lcg[2];
+
+static uint32_t Random(unsigned stream, uint32_t range)
+{
+	Lcg[stream] = Lcg[stream] * 1664525U + 1013904223U;
+	return (Lcg[stream] >> 8) % range;
+}
+
+/* Fewest flash wait states that pass the validator */
+static int Make_Profile(ClockProfile_t *p)
+{
+	for (uint8_t ws = 0U; ws <= 7U; ws++)
+	{
+		for (uint8_t wr = 0U; wr <= 2U; wr++)
+		{
+			p->flash_latency    = ws;
+			p->flash_wrhighfreq = wr;
+			Clock_Profile_Seal(p);
+			if (Clock_Profile_Validate(p) == CLOCK_PROFILE_OK)
+			{
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/* C V^2 f plus leakage, idle keeps the buses and 30 % of the dynamic power */
+static void Power(Perf_Point_t *point, double volt)
+{
+	double dyn  = 0.514 * volt * volt * (point->hz / 1e6);
+	double leak = 40.0 * volt * volt;
+
+	point->run_mw  = (uint32_t)(dyn + leak);
+	point->idle_mw = (uint32_t)(0.3 * dyn + leak);
+}
+
+static ClockProfile_t Profile_480, Profile_200;
+static Perf_Point_t   Points[5];
+
+static void Build_Points(void)
+{
+	static const double Volt[4] = { 1.35, 1.20, 1.10, 1.00 };  // DS12110, middle of each VOS range
+
+	Profile_480 = Clock_Profile_Default;
+	CHECK(Make_Profile(&Profile_480));
+
+	Profile_200        = Clock_Profile_Default;
+	Profile_200.divn1  = 160U;   // 5 MHz x 160 = 800 MHz VCO, / 4
+	Profile_200.divp1  = 4U;
+	Profile_200.vos    = 3U;
+	Profile_200.profile_id = 200U;
+	CHECK(Make_Profile(&Profile_200));
+
+	Points[0] = (Perf_Point_t){ "200/4 VOS3", &Profile_200, 2U,  50000000UL, 0U, 0U };
+	Points[1] = (Perf_Point_t){ "200/2 VOS3", &Profile_200, 1U, 100000000UL, 0U, 0U };
+	Points[2] = (Perf_Point_t){ "200 VOS3",   &Profile_200, 0U, 200000000UL, 0U, 0U };
+	Points[3] = (Perf_Point_t){ "480/2 VOS0", &Profile_480, 1U, 240000000UL, 0U, 0U };
+	Points[4] = (Perf_Point_t){ "480 VOS0",   &Profile_480, 0U, 480000000UL, 0U, 0U };
+	for (unsigned i = 0; i < 5U; i++)
+	{
+		Power(&Points[i], Volt[Points[i].profile->vos]);
+	}
+}
+
+/* Items of one release, returns the number refused */
+static uint32_t Release(Perf_Demand_t *d, const Source_t *src, uint64_t at_ns)
+{
+	uint32_t refused = 0U;
+
+	for (uint32_t k = 0U; k < src->items; k++)
+	{
+		Perf_Work_t w = { 0 };
+
+		w.min_hz      = src->min_hz;
+		w.cycles      = src->cycles;
+		w.deadline_ns = src->relative_deadline_ns ? at_ns + src->relative_deadline_ns : PERF_DEADLINE_NONE;
+		refused      += (Perf_Demand_Push(d, &w) != PERF_DEMAND_OK);
+	}
+	return refused;
+}
+
+static void Replay(Perf_Policy_t policy, Perf_Demand_t *d)
+{
+	uint64_t next[SOURCES], now = 0U;
+	uint32_t released = 0U, overflow = 0U, under_min = 0U;
+
+	Lcg[0] = 12345U;
+	Lcg[1] = 54321U;
+	CHECK(Perf_Demand_Init(d, Points, 5U, 4U, policy) == PERF_DEMAND_OK);
+	for (unsigned s = 0; s < SOURCES; s++)
+	{
+		next[s] = 0U;
+	}
+
+	while ((now < SIM_END_NS) || (d->count != 0U))
+	{
+		Perf_Work_t work;
+		uint64_t    wake = UINT64_MAX;
+		uint8_t     point;
+		int32_t     index;
+
+		/* Step 1: Items released so far */
+		for (unsigned s = 0; s < SOURCES; s++)
+		{
+			while ((next[s] <= now) && (next[s] < SIM_END_NS))
+			{
+				overflow += Release(d, &Sources[s], next[s]);
+				released += Sources[s].items;
+				next[s]  += Sources[s].period_ns ? Sources[s].period_ns : (40U + Random(0U, 41U)) * MS;
+			}
+			if ((next[s] < SIM_END_NS) && (next[s] < wake))
+			{
+				wake = next[s];
+			}
+		}
+
+		/* Step 2: Nothing queued, wait at the point in force */
+		index = Perf_Demand_Choose(d, now, &point);
+		if (index < 0)
+		{
+			if (wake == UINT64_MAX)
+			{
+				break;
+			}
+			Perf_Demand_Idled(d, wake - now);
+			now = wake;
+			continue;
+		}
+
+		/* Step 3: Transition, then the item with +-10 % on its cycles */
+		Perf_Demand_Take(d, index, &work);
+		if (point != d->point)
+		{
+			uint64_t sw = d->switch_ns[d->point][point];
+
+			Perf_Demand_Switched(d, point, sw);
+			now += sw;
+		}
+		under_min += (d->points[d->point].hz < work.min_hz);
+		{
+			uint64_t cycles = (uint64_t)work.cycles * (90U + Random(1U, 21U)) / 100U;
+			uint64_t run    = (cycles * 1000000000ULL) / d->points[d->point].hz;
+
+			Perf_Demand_Ran(d, &work, now, now + run);
+			now += run;
+		}
+	}
+
+	CHECK(overflow == 0U);
+	CHECK(under_min == 0U);
+	CHECK(d->stats.runs == released - overflow);
+	{
+		uint64_t total = d->stats.switch_ns;
+
+		for (unsigned i = 0; i < d->point_count; i++)
+		{
+			total += d->stats.busy_ns[i] + d->stats.idle_ns[i];
+		}
+		CHECK(total == now);
+	}
+}
+
+static void Print(const Perf_Demand_t *d, Perf_Policy_t policy)
+{
+	uint64_t elapsed = d->stats.switch_ns;
+	uint64_t uj      = Perf_Demand_Energy_uJ(d);
+
+	for (unsigned i = 0; i < d->point_count; i++)
+	{
+		elapsed += d->stats.busy_ns[i] + d->stats.idle_ns[i];
+	}
+
+	printf("%-9s %8.1f mJ %6.1f mW  runs %6u  misses %4u (max late %6.3f ms)  transitions %5u (%6.2f ms)\n",
+	       Perf_Policy_Name(policy), uj / 1000.0, (double)uj * 1e6 / (double)elapsed,
+	       d->stats.runs, d->stats.misses, d->stats.late_ns_max / 1e6,
+	       d->stats.switches, d->stats.switch_ns / 1e6);
+	for (unsigned i = 0; i < d->point_count; i++)
+	{
+		printf("          %-11s %3u/%3u mW  busy %5.1f %%  idle %5.1f %%\n", d->points[i].name,
+		       d->points[i].run_mw, d->points[i].idle_mw,
+		       100.0 * d->stats.busy_ns[i] / elapsed, 100.0 * d->stats.idle_ns[i] / elapsed);
+	}
+}
+
+int main(void)
+{
+	static Perf_Demand_t Demand[PERF_POLICY_COUNT];
+
+	Build_Points();
+
+	for (unsigned p = 0; p < PERF_POLICY_COUNT; p++)
+	{
+		Replay((Perf_Policy_t)p, &Demand[p]);
+		if (p == 0U)
+		{
+			printf("transitions 480 VOS0 -> 200 VOS3 %u us, back %u us, throttle %u us\n\n",
+			       Demand[0].switch_ns[4][2] / 1000U, Demand[0].switch_ns[2][4] / 1000U,
+			       Demand[0].switch_ns[4][3] / 1000U);
+		}
+		Print(&Demand[p], (Perf_Policy_t)p);
+	}
+
+	/* The reference meets every deadline, batching saves transitions */
+	CHECK(Demand[PERF_POLICY_MAX].stats.misses == 0U);
+	CHECK(Demand[PERF_POLICY_BATCH].stats.switches <= Demand[PERF_POLICY_ITEM].stats.switches);
+	CHECK(Demand[PERF_POLICY_BATCH].stats.misses <= Demand[PERF_POLICY_ITEM].stats.misses);
+	CHECK(Perf_Demand_Energy_uJ(&Demand[PERF_POLICY_BATCH]) < Perf_Demand_Energy_uJ(&Demand[PERF_POLICY_MAX]));
+
+	printf("\n%s\n", Failures ? "FAILED" : "PASSED");
+	return Failures;
+}
@@ -0,0 +1,913 @@
+/*
+ ******************************************************************************
+ * File              : tcm_placement_tool.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Host PC (Windows, Linux)
+ * Description       : Profile-guided ITCM/DTCM placement from PC samples
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * Date              : November 10, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Build on the host:
+ *    gcc -I.. -o tcm_placement_tool tcm_placement_tool.c
+ *
+ * Without argument, check the knapsack against a brute force search and the
+ * sample attribution on a synthetic profile. The exit code is the number of
+ * failed checks. With arguments (see tcm_profile.c for the round):
+ *
+ *    tcm_placement_tool symbols.txt samples.bin [options]
+ *
+ *    symbols.txt   arm-none-eabi-nm -S -l --defined-only firmware.elf
+ *    samples.bin   dump binary value samples.bin TCM_Profile_Table
+ *    -i bytes      ITCM for the placed code, default 4096: the 4 KB above
+ *                  the overlay slots of itcm_overlay.h
+ *    -D bytes      DTCM for the data, default 114688 (16 KB left to the
+ *                  stack and the heap)
+ *    -d file       data access profile, "name accesses [file.o]" per line
+ *    -s percent    share of the time of a function in flash lost to
+ *                  instruction fetch, default 10. The polluted row of
+ *                  ITCM_Overlay_Benchmark() gives it for the board:
+ *                  100 x (1 - overlay_cycles / xip_cycles).
+ *    -m base new   elapsed_ns of TCM_Profile_Run() before and after the
+ *                  placement, the measured speedup is printed with the
+ *                  predicted one
+ *    -o file       linker script fragment, default tcm_placement.ld
+ *
+ * Functions: the samples of each 32-byte granule go to the function that
+ * holds it. Value of a function in ITCM = its samples x the stall share,
+ * weight = its size. The 0/1 knapsack (dynamic programming over 4-byte
+ * units) gives the set with the most samples saved in the ITCM size.
+ * Predicted speedup = 1 / (1 - saved samples / all samples).
+ *
+ * Data: the ST linker script already puts .data and .bss in DTCM. With a
+ * data access profile the knapsack keeps the most accessed objects in the
+ * DTCM size, the others go to the top 32 Kbytes of D2 SRAM2
+ * (TCM_PLACEMENT_D2_BASE of tcm_profile.h, AXI SRAM holds the framebuffers).
+ * The kept set must leave at most 32 Kbytes to move. PC samples say nothing
+ * of the data, without -d the data placement is left as it is.
+ *
+ * The fragment goes in SECTIONS before .text and .data: ld places an input
+ * section by the first rule that matches it. A rule names the object file
+ * too, in any directory, then rtc_service.o(.text.Read): the file-local
+ * functions and objects of the tree share names (Read, State, Stats, ...). The file comes from the
+ * source line of nm -l, so the objects must be built in a directory, as
+ * STM32CubeIDE and make do. A name found twice without telling the files
+ * apart is not placed: the code stays in flash, the data in DTCM.
+ *
+ * The boot path runs before TCM_Placement_Init() has copied anything:
+ * Reset_Handler, SystemInit, main (its loop is sampled), TCM_Placement_Init
+ * and Copy_Words stay in flash, SystemCoreClock and SystemD2Clock in DTCM.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define GRANULE         ( 32U )       // TCM_PROFILE_GRANULE
+#define UNIT            ( 4U )        // Knapsack weight unit, bytes
+#define ITCM_END        ( 0x00010000UL )
+#define DTCM_START      ( 0x20000000UL )
+#define DTCM_END        ( 0x20020000UL )
+#define D2_DATA_BASE    ( 0x30038000UL )  // TCM_PLACEMENT_D2_BASE
+#define D2_DATA_SIZE    ( 0x00008000UL )
+#define KNAPSACK_NONE   ( UINT64_MAX )
+#define MAX_ITEMS       ( 512U )
+#define NAME_LEN        ( 96U )
+
+typedef struct
+{
+	char     name[NAME_LEN] ;
+	uint32_t addr     ;
+	uint32_t size     ;
+	char     type     ;  // nm letter
+	uint64_t samples  ;
+	uint64_t accesses ;
+	uint8_t  chosen   ;
+	uint8_t  ambiguous;  // Same name and object as another symbol
+	char     object[NAME_LEN] ;  // file.o from nm -l, empty if unknown
+} Symbol_t;
+
+typedef struct
+{
+	uint32_t itcm_bytes ;
+	uint32_t dtcm_bytes ;
+	uint32_t stall_pct  ;
+	double   base       ;
+	double   now        ;
+	const char *data    ;
+	const char *out     ;
+} Options_t;
+
+static int Failures;
+
+#define CHECK(cond)   Check((cond), #cond, __LINE__)
+
+static void Check(int cond, const char *text, int line)
+{
+	if (!cond)
+	{
+		printf("FAIL line %d: %s\n", line, text);
+		Failures++;
+	}
+}
+
+/************************** Symbols and samples ************************/
+
+static Symbol_t *Syms;
+static uint32_t  Sym_Count;
+static uint32_t  Sym_Cap;
+
+static Symbol_t *Add_Symbol(const char *name, uint32_t addr, uint32_t size, char type)
+{
+	Symbol_t *s;
+
+	if (Sym_Count == Sym_Cap)
+	{
+		Sym_Cap = Sym_Cap ? 2U * Sym_Cap : 256U;
+		Syms    = realloc(Syms, Sym_Cap * sizeof(Symbol_t));
+		if (Syms == NULL)
+		{
+			fprintf(stderr, "out of memory\n");
+			exit(1);
+		}
+	}
+	s = &Syms[Sym_Count++];
+	memset(s, 0, sizeof(*s));
+	snprintf(s->name, NAME_LEN, "%s", name);
+	s->addr = addr;
+	s->size = size;
+	s->type = type;
+	return s;
+}
+
+static int Is_Code(const Symbol_t *s)
+{
+	return (s->type == 'T') || (s->type == 't') || (s->type == 'W') || (s->type == 'w');
+}
+
+static int Is_Data(const Symbol_t *s)
+{
+	return ((s->type == 'D') || (s->type == 'd') || (s->type == 'B') || (s->type == 'b')) &&
+	       (s->addr >= DTCM_START) && (s->addr < DTCM_END);
+}
+
+/* Run or read before TCM_Placement_Init() copies the placed sections */
+static int Is_Boot(const Symbol_t *s)
+{
+	static const char * const Boot[] =
+	{
+		"Reset_Handler", "SystemInit", "__libc_init_array", "main", "TCM_Placement_Init", "Copy_Words",
+		"SystemCoreClock", "SystemD2Clock",
+	};
+
+	for (size_t i = 0; i < sizeof(Boot) / sizeof(Boot[0]); i++)
+	{
+		if (strcmp(s->name, Boot[i]) == 0)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int By_Address(const void *a, const void *b)
+{
+	const Symbol_t *x = a, *y = b;
+
+	return (x->addr > y->addr) - (x->addr < y->addr);
+}
+
+/* Object file of the source file of nm -l: "...\dir/file.c:42" -> file.o */
+static void Object_Name(const char *location, char *object)
+{
+	const char *base = location, *colon;
+	const char *dot  = NULL;
+
+	for (const char *p = location; *p; p++)
+	{
+		base = ((*p == '/') || (*p == '\\')) ? p + 1 : base;
+	}
+	colon = strrchr(base, ':');
+	for (const char *p = base; *p && (p != colon); p++)
+	{
+		dot = (*p == '.') ? p : dot;
+	}
+	object[0] = '\0';
+	if ((dot != NULL) && (dot > base))
+	{
+		snprintf(object, NAME_LEN, "%.*s.o", (int)(dot - base), base);
+	}
+}
+
+static int Same_Place(const Symbol_t *a, const Symbol_t *b)
+{
+	return (strcmp(a->name, b->name) == 0) &&
+	       ((a->object[0] == '\0') || (b->object[0] == '\0') || (strcmp(a->object, b->object) == 0));
+}
+
+/* Names no rule can tell apart */
+static void Mark_Ambiguous(void)
+{
+	for (uint32_t i = 0U; i < Sym_Count; i++)
+	{
+		for (uint32_t j = i + 1U; j < Sym_Count; j++)
+		{
+			if ((Is_Code(&Syms[i]) == Is_Code(&Syms[j])) && Same_Place(&Syms[i], &Syms[j]))
+			{
+				Syms[i].ambiguous = 1U;
+				Syms[j].ambiguous = 1U;
+			}
+		}
+	}
+}
+
+/* nm -S -l lines: address size type name, then a tab and the source line.
+ * Symbols without a size are skipped.
+ */
+static int Read_Symbols(const char *path)
+{
+	char  line[512], name[NAME_LEN];
+	FILE *f = fopen(path, "r");
+
+	if (f == NULL)
+	{
+		return 0;
+	}
+	while (fgets(line, sizeof(line), f))
+	{
+		unsigned long addr, size;
+		char          type;
+
+		if (sscanf(line, "%lx %lx %c %95s", &addr, &size, &type, name) == 4)
+		{
+			Symbol_t *s = Add_Symbol(name, (uint32_t)addr, (uint32_t)size, type);
+
+			if (Is_Code(s))
+			{
+				s->addr &= ~ 1UL;   // Thumb bit
+			}
+			if (strchr(line, '\t') != NULL)
+			{
+				line[strcspn(line, "\r\n")] = '\0';
+				Object_Name(strchr(line, '\t') + 1, s->object);
+			}
+		}
+	}
+	fclose(f);
+	qsort(Syms, Sym_Count, sizeof(Symbol_t), By_Address);
+	Mark_Ambiguous();
+	return 1;
+}
+
+static Symbol_t *Code_At(uint32_t pc)
+{
+	uint32_t lo = 0U, hi = Sym_Count;
+
+	while (lo < hi)
+	{
+		uint32_t mid = (lo + hi) / 2U;
+
+		if (Syms[mid].addr <= pc)
+		{
+			lo = mid + 1U;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	for (uint32_t i = lo; i-- > 0U; )
+	{
+		if (Is_Code(&Syms[i]) && (pc >= Syms[i].addr) && (pc < Syms[i].addr + Syms[i].size))
+		{
+			return &Syms[i];
+		}
+		if (Syms[i].addr + 0x10000UL < pc)
+		{
+			break;
+		}
+	}
+	return NULL;
+}
+
+/* Granule start, or its last byte when the start is padding. Returns the
+ * samples not attributed.
+ */
+static uint64_t Attribute(uint32_t pc, uint32_t count)
+{
+	Symbol_t *s = Code_At(pc);
+
+	s = s ? s : Code_At(pc + GRANULE - 2U);
+	if (s == NULL)
+	{
+		return count;
+	}
+	s->samples += count;
+	return 0U;
+}
+
+static uint64_t Read_Samples(const char *path, uint64_t *unmapped)
+{
+	uint8_t  raw[8];
+	uint64_t total = 0U;
+	FILE    *f = fopen(path, "rb");
+
+	if (f == NULL)
+	{
+		return 0U;
+	}
+	while (fread(raw, 1, sizeof(raw), f) == sizeof(raw))
+	{
+		uint32_t pc    = raw[0] | (raw[1] << 8) | (raw[2] << 16) | ((uint32_t)raw[3] << 24);
+		uint32_t count = raw[4] | (raw[5] << 8) | (raw[6] << 16) | ((uint32_t)raw[7] << 24);
+
+		if ((pc != 0U) && (count != 0U))
+		{
+			total     += count;
+			*unmapped += Attribute(pc, count);
+		}
+	}
+	fclose(f);
+	return total;
+}
+
+static void Read_Accesses(const char *path)
+{
+	char  line[256], name[NAME_LEN], object[NAME_LEN];
+	FILE *f = fopen(path, "r");
+
+	if (f == NULL)
+	{
+		fprintf(stderr, "cannot read %s\n", path);
+		return;
+	}
+	while (fgets(line, sizeof(line), f))
+	{
+		unsigned long long accesses;
+
+		int fields = sscanf(line, "%95s %llu %95s", name, &accesses, object);
+
+		if (fields < 2)
+		{
+			continue;
+		}
+		for (uint32_t i = 0U; i < Sym_Count; i++)
+		{
+			if (Is_Data(&Syms[i]) && (strcmp(Syms[i].name, name) == 0) &&
+			    ((fields < 3) || (strcmp(Syms[i].object, object) == 0)))
+			{
+				Syms[i].accesses = accesses;
+			}
+		}
+	}
+	fclose(f);
+}
+
+/****************************** Knapsack *******************************/
+
+/* 0/1 knapsack, weights in units, total weight from min to cap. Returns
+ * the best value, KNAPSACK_NONE if no set weighs at least min, take[i] set
+ * for the items of the best set.
+ */
+static uint64_t Knapsack(const uint32_t *weight, const uint64_t *value, uint32_t n,
+                         uint32_t min, uint32_t cap, uint8_t *take)
+{
+	uint64_t *best = malloc((cap + 1U) * sizeof(uint64_t));  // Best value of exactly w units
+	uint8_t  *keep = calloc((size_t)n * (cap + 1U), 1U);
+	uint64_t  result = KNAPSACK_NONE;
+	uint32_t  at     = 0U;
+
+	if ((best == NULL) || (keep == NULL))
+	{
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+	for (uint32_t w = 0U; w <= cap; w++)
+	{
+		best[w] = (w == 0U) ? 0U : KNAPSACK_NONE;
+	}
+
+	for (uint32_t i = 0U; i < n; i++)
+	{
+		for (uint32_t w = cap + 1U; w-- > weight[i]; )
+		{
+			uint64_t from = best[w - weight[i]];
+
+			if ((from != KNAPSACK_NONE) && ((best[w] == KNAPSACK_NONE) || (from + value[i] > best[w])))
+			{
+				best[w] = from + value[i];
+				keep[(size_t)i * (cap + 1U) + w] = 1U;
+			}
+		}
+	}
+
+	for (uint32_t w = min; w <= cap; w++)
+	{
+		if ((best[w] != KNAPSACK_NONE) && ((result == KNAPSACK_NONE) || (best[w] > result)))
+		{
+			result = best[w];
+			at     = w;
+		}
+	}
+	for (uint32_t i = n; i-- > 0U; )
+	{
+		take[i] = (result != KNAPSACK_NONE) ? keep[(size_t)i * (cap + 1U) + at] : 0U;
+		at     -= take[i] ? weight[i] : 0U;
+	}
+
+	free(best);
+	free(keep);
+	return result;
+}
+
+static uint32_t Units(uint32_t bytes)
+{
+	return (bytes + UNIT - 1U) / UNIT;
+}
+
+static int By_Samples(const void *a, const void *b)
+{
+	const Symbol_t *x = *(Symbol_t * const *)a, *y = *(Symbol_t * const *)b;
+
+	return (x->samples < y->samples) - (x->samples > y->samples);
+}
+
+/* Code into ITCM, returns the samples saved */
+static uint64_t Place_Code(uint32_t itcm_bytes, uint32_t *used)
+{
+	Symbol_t *item[MAX_ITEMS];
+	uint32_t  weight[MAX_ITEMS] = { 0U }, n = 0U;
+	uint64_t  value[MAX_ITEMS] = { 0U }, saved;
+	uint8_t   take[MAX_ITEMS];
+
+	for (uint32_t i = 0U; (i < Sym_Count) && (n < MAX_ITEMS); i++)
+	{
+		if (Is_Code(&Syms[i]) && !Syms[i].ambiguous && !Is_Boot(&Syms[i]) && (Syms[i].samples != 0U) && (Syms[i].size != 0U) &&
+		    (Syms[i].size <= itcm_bytes))
+		{
+			item[n++] = &Syms[i];
+		}
+	}
+	qsort(item, n, sizeof(item[0]), By_Samples);
+	for (uint32_t i = 0U; i < n; i++)
+	{
+		weight[i] = Units(item[i]->size);
+		value[i]  = item[i]->samples;
+	}
+
+	saved = Knapsack(weight, value, n, 0U, itcm_bytes / UNIT, take);
+	*used = 0U;
+	for (uint32_t i = 0U; i < n; i++)
+	{
+		item[i]->chosen = take[i];
+		*used          += take[i] ? weight[i] * UNIT : 0U;
+	}
+	return saved;
+}
+
+/* Data kept in DTCM, the others (chosen = 0) move to D2 SRAM2. Ambiguous
+ * names and the boot path data stay in DTCM. Returns the accesses kept, KNAPSACK_NONE when the
+ * data fit neither way.
+ */
+static uint64_t Place_Data(uint32_t dtcm_bytes, uint64_t *all, uint32_t *moved)
+{
+	uint32_t  n = 0U, total = 0U, fixed = 0U;
+	uint32_t *weight;
+	uint64_t *value, kept, fixed_accesses = 0U;
+	uint8_t  *take;
+	Symbol_t **item;
+
+	*all   = 0U;
+	*moved = 0U;
+	for (uint32_t i = 0U; i < Sym_Count; i++)
+	{
+		if (Is_Data(&Syms[i]))
+		{
+			Syms[i].chosen = 1U;
+			*all          += Syms[i].accesses;
+			if (Syms[i].ambiguous || Is_Boot(&Syms[i]))
+			{
+				fixed          += Units(Syms[i].size) * UNIT;
+				fixed_accesses += Syms[i].accesses;
+			}
+			else
+			{
+				n++;
+				total += Units(Syms[i].size) * UNIT;
+			}
+		}
+	}
+	if (fixed + total <= dtcm_bytes)
+	{
+		return *all;
+	}
+	if (fixed > dtcm_bytes)
+	{
+		return KNAPSACK_NONE;
+	}
+
+	weight = malloc(n * sizeof(uint32_t));
+	value  = malloc(n * sizeof(uint64_t));
+	take   = malloc(n);
+	item   = malloc(n * sizeof(Symbol_t *));
+	n = 0U;
+	for (uint32_t i = 0U; i < Sym_Count; i++)
+	{
+		if (Is_Data(&Syms[i]) && !Syms[i].ambiguous && !Is_Boot(&Syms[i]))
+		{
+			item[n]   = &Syms[i];
+			weight[n] = Units(Syms[i].size);
+			value[n]  = Syms[i].accesses;
+			n++;
+		}
+	}
+
+	/* At most D2_DATA_SIZE moved: at least total - D2_DATA_SIZE kept */
+	kept = Knapsack(weight, value, n, (total > D2_DATA_SIZE) ? Units(total - D2_DATA_SIZE) : 0U,
+	                (dtcm_bytes - fixed) / UNIT, take);
+	for (uint32_t i = 0U; (kept != KNAPSACK_NONE) && (i < n); i++)
+	{
+		item[i]->chosen = take[i];
+		*moved         += take[i] ? 0U : 1U;
+	}
+
+	free(weight);
+	free(value);
+	free(take);
+	free(item);
+	return (kept != KNAPSACK_NONE) ? kept + fixed_accesses : KNAPSACK_NONE;
+}
+
+/**************************** Linker fragment **************************/
+
+/* Input section of one symbol, in its object file when known */
+static void Rule(FILE *f, const char *prefix, const Symbol_t *s)
+{
+	if (s->object[0] != '\0')
+	{
+		fprintf(f, "    */%s(%s.%s)\n", s->object, prefix, s->name);
+	}
+	else
+	{
+		fprintf(f, "    *(%s.%s)\n", prefix, s->name);
+	}
+}
+
+static void Emit(FILE *f, uint32_t itcm_bytes, int data)
+{
+	fprintf(f, "/* Generated by tools/tcm_placement_tool.c, goes before .text and .data */\n");
+	fprintf(f, "  .itcm_text 0x%08lX :\n  {\n    . = ALIGN(4);\n    _sitcm_text = .;\n",
+	        (unsigned long)(ITCM_END - itcm_bytes));
+	for (uint32_t i = 0U; i < Sym_Count; i++)
+	{
+		if (Is_Code(&Syms[i]) && Syms[i].chosen)
+		{
+			Rule(f, ".text", &Syms[i]);
+		}
+	}
+	fprintf(f, "    . = ALIGN(4);\n    _eitcm_text = .;\n  } AT> FLASH\n  _siitcm_text = LOADADDR(.itcm_text);\n");
+	fprintf(f, "  ASSERT(_eitcm_text <= 0x%08lX, \"ITCM placement past the end of ITCM\")\n\n", (unsigned long)ITCM_END);
+
+	fprintf(f, "  .d2_data 0x%08lX :\n  {\n    . = ALIGN(4);\n    _sd2_data = .;\n", (unsigned long)D2_DATA_BASE);
+	for (uint32_t i = 0U; data && (i < Sym_Count); i++)
+	{
+		if (Is_Data(&Syms[i]) && !Syms[i].chosen && ((Syms[i].type == 'D') || (Syms[i].type == 'd')))
+		{
+			Rule(f, ".data", &Syms[i]);
+		}
+	}
+	fprintf(f, "    . = ALIGN(4);\n    _ed2_data = .;\n  } AT> FLASH\n  _sid2_data = LOADADDR(.d2_data);\n\n");
+
+	fprintf(f, "  .d2_bss (ADDR(.d2_data) + SIZEOF(.d2_data)) (NOLOAD) :\n  {\n    . = ALIGN(4);\n    _sd2_bss = .;\n");
+	for (uint32_t i = 0U; data && (i < Sym_Count); i++)
+	{
+		if (Is_Data(&Syms[i]) && !Syms[i].chosen && ((Syms[i].type == 'B') || (Syms[i].type == 'b')))
+		{
+			Rule(f, ".bss", &Syms[i]);
+		}
+	}
+	fprintf(f, "    . = ALIGN(4);\n    _ed2_bss = .;\n  }\n");
+	fprintf(f, "  ASSERT(_ed2_bss <= 0x%08lX, \"data moved out of DTCM past D2 SRAM2\")\n",
+	        (unsigned long)(D2_DATA_BASE + D2_DATA_SIZE));
+}
+
+/****************************** Self test ******************************/
+
+static uint32_t Lcg(uint32_t *seed)
+{
+	*seed = *seed * 1664525UL + 1013904223UL;
+	return *seed >> 8;
+}
+
+static void Test_Knapsack(void)
+{
+	uint32_t seed = 12345U;
+
+	for (unsigned t = 0; t < 200; t++)
+	{
+		uint32_t n = 1U + Lcg(&seed) % 12U, cap = Lcg(&seed) % 64U, min = Lcg(&seed) % 48U;
+		uint32_t weight[12];
+		uint64_t value[12], dp, brute = KNAPSACK_NONE, check = 0U;
+		uint8_t  take[12];
+		uint32_t used = 0U;
+
+		for (uint32_t i = 0U; i < n; i++)
+		{
+			weight[i] = 1U + Lcg(&seed) % 24U;
+			value[i]  = Lcg(&seed) % 1000U;
+		}
+		dp = Knapsack(weight, value, n, min, cap, take);
+
+		for (uint32_t mask = 0U; mask < (1U << n); mask++)
+		{
+			uint32_t w = 0U;
+			uint64_t v = 0U;
+
+			for (uint32_t i = 0U; i < n; i++)
+			{
+				w += (mask >> i & 1U) ? weight[i] : 0U;
+				v += (mask >> i & 1U) ? value[i]  : 0U;
+			}
+			brute = ((w >= min) && (w <= cap) && ((brute == KNAPSACK_NONE) || (v > brute))) ? v : brute;
+		}
+		for (uint32_t i = 0U; i < n; i++)
+		{
+			used  += take[i] ? weight[i] : 0U;
+			check += take[i] ? value[i]  : 0U;
+		}
+		CHECK(dp == brute);
+		CHECK((dp == KNAPSACK_NONE) || ((check == dp) && (used >= min) && (used <= cap)));
+	}
+}
+
+/* Three functions, a sample in padding, one outside any function, a
+ * 2 KB ITCM: the two hottest that fit are placed, main never
+ */
+static void Test_Profile(void)
+{
+	Symbol_t *hot, *warm, *big, *cold, *boot;
+	uint64_t  unmapped = 0U, saved;
+	uint32_t  used;
+	char      text[4096];
+	size_t    length;
+	FILE     *f;
+
+	Sym_Count = 0U;
+	hot  = Add_Symbol("Fir_Block",    0x08001000UL,  256U, 'T');
+	warm = Add_Symbol("Crc_Update",   0x08001110UL,  512U, 't');
+	big  = Add_Symbol("Jpeg_Huffman", 0x08002000UL, 4096U, 'T');
+	cold = Add_Symbol("Idle_Hook",    0x08004000UL,   64U, 'T');
+	boot = Add_Symbol("main",         0x08003000UL,  128U, 'T');
+	Add_Symbol("Buffer", 0x20000100UL, 1024U, 'B');
+	qsort(Syms, Sym_Count, sizeof(Symbol_t), By_Address);
+
+	unmapped += Attribute(0x08001000UL, 500U);   // Fir_Block
+	unmapped += Attribute(0x080010E0UL, 300U);   // Fir_Block
+	unmapped += Attribute(0x08001100UL,  20U);   // Padding, end of the granule in Crc_Update
+	unmapped += Attribute(0x08001200UL, 200U);   // Crc_Update
+	unmapped += Attribute(0x08002400UL, 900U);   // Jpeg_Huffman, too big
+	unmapped += Attribute(0x08003000UL, 1000U);  // main, boot path
+	unmapped += Attribute(0x08009000UL,  40U);   // No function
+
+	hot  = Code_At(0x08001000UL);
+	warm = Code_At(0x08001200UL);
+	big  = Code_At(0x08002000UL);
+	cold = Code_At(0x08004000UL);
+	boot = Code_At(0x08003000UL);
+	CHECK((boot != NULL) && (boot->samples == 1000U));
+	CHECK((hot != NULL) && (hot->samples == 800U));
+	CHECK((warm != NULL) && (warm->samples == 220U));
+	CHECK((big != NULL) && (big->samples == 900U));
+	CHECK((cold != NULL) && (cold->samples == 0U));
+	CHECK(unmapped == 40U);
+
+	saved = Place_Code(2048U, &used);
+	CHECK(saved == 1020U);
+	CHECK(hot->chosen && warm->chosen && !big->chosen && !cold->chosen && !boot->chosen);
+	CHECK(used == 768U);
+
+	f = tmpfile();
+	CHECK(f != NULL);
+	if (f != NULL)
+	{
+		Emit(f, 2048U, 0);
+		rewind(f);
+		length       = fread(text, 1, sizeof(text) - 1U, f);
+		text[length] = '\0';
+		fclose(f);
+		CHECK(strstr(text, ".itcm_text 0x0000F800") != NULL);
+		CHECK(strstr(text, "*(.text.Fir_Block)") != NULL);
+		CHECK(strstr(text, "*(.text.Crc_Update)") != NULL);
+		CHECK(strstr(text, "Jpeg_Huffman") == NULL);
+		CHECK(strstr(text, "(.text.main)") == NULL);
+		CHECK(strstr(text, "*(.bss.") == NULL);
+	}
+}
+
+/* File-local functions of the same name: placed by object file when nm -l
+ * gives it, left in flash otherwise
+ */
+static void Test_Duplicates(void)
+{
+	static const struct { const char *name; uint32_t addr; const char *location; } Code[] =
+	{
+		{ "Read",  0x08005000UL, "C:\\work\\Core\\Src/rtc_service.c:142" },
+		{ "Read",  0x08005100UL, "/work/Core/Src/fdcan.c:88" },
+		{ "Stats", 0x08005200UL, NULL },
+		{ "Stats", 0x08005300UL, NULL },
+	};
+	char   text[4096], object[NAME_LEN];
+	size_t length;
+	FILE  *f;
+
+	Object_Name("C:\\work\\Core\\Src/rtc_service.c:142", object);
+	CHECK(strcmp(object, "rtc_service.o") == 0);
+	Object_Name("??:?", object);
+	CHECK(object[0] == '\0');
+
+	Sym_Count = 0U;
+	for (size_t i = 0; i < sizeof(Code) / sizeof(Code[0]); i++)
+	{
+		Symbol_t *s = Add_Symbol(Code[i].name, Code[i].addr, 64U, 't');
+
+		if (Code[i].location != NULL)
+		{
+			Object_Name(Code[i].location, s->object);
+		}
+		s->samples = 100U;
+	}
+	Mark_Ambiguous();
+	CHECK(!Syms[0].ambiguous && !Syms[1].ambiguous && Syms[2].ambiguous && Syms[3].ambiguous);
+
+	Place_Code(4096U, (uint32_t[1]){ 0U });
+	CHECK(Syms[0].chosen && Syms[1].chosen && !Syms[2].chosen && !Syms[3].chosen);
+
+	f = tmpfile();
+	CHECK(f != NULL);
+	if (f != NULL)
+	{
+		Emit(f, 4096U, 0);
+		rewind(f);
+		length       = fread(text, 1, sizeof(text) - 1U, f);
+		text[length] = '\0';
+		fclose(f);
+		CHECK(strstr(text, "*/rtc_service.o(.text.Read)") != NULL);
+		CHECK(strstr(text, "*/fdcan.o(.text.Read)") != NULL);
+		CHECK(strstr(text, ".text.Stats") == NULL);
+		CHECK(strstr(text, "ASSERT(_eitcm_text <= 0x00010000") != NULL);
+	}
+}
+
+/******************************** Report *******************************/
+
+static int Run(const char *symbols, const char *samples, const Options_t *opt)
+{
+	Symbol_t *rank[20];
+	uint32_t  n = 0U, used = 0U, moved = 0U;
+	uint64_t  unmapped = 0U, total, saved, all = 0U, kept = 0U;
+	double    predicted;
+	FILE     *f;
+
+	if (!Read_Symbols(symbols) || ((total = Read_Samples(samples, &unmapped)) == 0U))
+	{
+		fprintf(stderr, "cannot read %s or %s, or no samples\n", symbols, samples);
+		return 1;
+	}
+	if (opt->data)
+	{
+		Read_Accesses(opt->data);
+		kept = Place_Data(opt->dtcm_bytes, &all, &moved);
+		if (kept == KNAPSACK_NONE)
+		{
+			fprintf(stderr, "data over DTCM (%lu bytes) and D2 SRAM2 (%lu bytes) together\n",
+			        (unsigned long)opt->dtcm_bytes, (unsigned long)D2_DATA_SIZE);
+			return 1;
+		}
+	}
+	saved     = Place_Code(opt->itcm_bytes, &used);
+	predicted = 1.0 / (1.0 - (opt->stall_pct / 100.0) * (double)saved / (double)total);
+
+	/* Hottest functions */
+	for (uint32_t i = 0U; i < Sym_Count; i++)
+	{
+		if (Is_Code(&Syms[i]) && Syms[i].samples)
+		{
+			uint32_t j = (n < 20U) ? n++ : 20U;
+
+			while ((j > 0U) && (rank[j - 1U]->samples < Syms[i].samples))
+			{
+				if (j < 20U)
+				{
+					rank[j] = rank[j - 1U];
+				}
+				j--;
+			}
+			if (j < 20U)
+			{
+				rank[j] = &Syms[i];
+			}
+		}
+	}
+	printf("%llu samples, %llu outside the functions\n\n", (unsigned long long)total, (unsigned long long)unmapped);
+	printf("function                       object                size  samples  share   ITCM\n");
+	for (uint32_t i = 0U; i < n; i++)
+	{
+		printf("%-30.30s %-18.18s %7lu %8llu %5.1f %%  %s\n", rank[i]->name, rank[i]->object,
+		       (unsigned long)rank[i]->size, (unsigned long long)rank[i]->samples, 100.0 * rank[i]->samples / total,
+		       rank[i]->chosen ? "yes" : (rank[i]->ambiguous ? "same name" : ""));
+	}
+
+	printf("\nITCM %lu of %lu bytes at 0x%08lX, %.1f %% of the samples\n", (unsigned long)used,
+	       (unsigned long)opt->itcm_bytes, (unsigned long)(ITCM_END - opt->itcm_bytes), 100.0 * saved / total);
+	if (opt->itcm_bytes > 0x1000UL)
+	{
+		printf("itcm_overlay.h: ITCM_OVERLAY_SLOTS at most %lu\n",
+		       (unsigned long)((ITCM_END - opt->itcm_bytes - 0x1000UL) / 0x1000UL));
+	}
+	if (opt->data)
+	{
+		printf("DTCM: %lu objects moved to D2 SRAM2, %.1f %% of the accesses kept in DTCM\n",
+		       (unsigned long)moved, all ? 100.0 * kept / all : 100.0);
+	}
+	printf("predicted speedup %.3f (stall share %u %%)\n", predicted, opt->stall_pct);
+	if ((opt->base > 0.0) && (opt->now > 0.0))
+	{
+		printf("measured  speedup %.3f, %+.1f %% from the prediction\n", opt->base / opt->now,
+		       100.0 * (opt->base / opt->now - predicted) / predicted);
+	}
+
+	f = fopen(opt->out, "w");
+	if (f == NULL)
+	{
+		fprintf(stderr, "cannot write %s\n", opt->out);
+		return 1;
+	}
+	Emit(f, opt->itcm_bytes, opt->data != NULL);
+	fclose(f);
+	printf("\nlinker script fragment: %s\n", opt->out);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	Options_t opt = { 4096U, 114688U, 10U, 0.0, 0.0, NULL, "tcm_placement.ld" };
+
+	if (argc < 3)
+	{
+		Test_Knapsack();
+		Test_Profile();
+		Test_Duplicates();
+		printf("%s\n", Failures ? "FAILED" : "PASSED");
+		return Failures;
+	}
+
+	for (int i = 3; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-i") && (i + 1 < argc))
+		{
+			opt.itcm_bytes = (uint32_t)strtoul(argv[++i], NULL, 0) & ~ (UNIT - 1U);
+		}
+		else if (!strcmp(argv[i], "-D") && (i + 1 < argc))
+		{
+			opt.dtcm_bytes = (uint32_t)strtoul(argv[++i], NULL, 0);
+		}
+		else if (!strcmp(argv[i], "-d") && (i + 1 < argc))
+		{
+			opt.data = argv[++i];
+		}
+		else if (!strcmp(argv[i], "-s") && (i + 1 < argc))
+		{
+			opt.stall_pct = (uint32_t)strtoul(argv[++i], NULL, 0);
+		}
+		else if (!strcmp(argv[i], "-m") && (i + 2 < argc))
+		{
+			opt.base = strtod(argv[++i], NULL);
+			opt.now  = strtod(argv[++i], NULL);
+		}
+		else if (!strcmp(argv[i], "-o") && (i + 1 < argc))
+		{
+			opt.out = argv[++i];
+		}
+		else
+		{
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 1;
+		}
+	}
+	if ((opt.itcm_bytes > ITCM_END - 0x1000UL) || (opt.stall_pct >= 100U))
+	{
+		fprintf(stderr, "ITCM at most %lu bytes, stall share below 100 %%\n", (unsigned long)(ITCM_END - 0x1000UL));
+		return 1;
+	}
+	return Run(argv[1], argv[2], &opt);
+}
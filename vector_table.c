@@ -0,0 +1,270 @@
+/*
+ ******************************************************************************
+ * File              : vector_table.c
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Vector table in DTCM with run time handler registration
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 1, 2026
+ ******************************************************************************
+ *
+ * Comments/Explanations:
+ *
+ * Vector_Table_Init() copies the flash table of the startup file into a
+ * 1 KB aligned array and moves VTOR onto it. The ST linker script puts .bss
+ * in DTCM: the vector fetch on exception entry is a zero wait state TCM read
+ * instead of a flash read through the AXI, and a new handler is one store,
+ * no cache maintenance (DTCM is not cached).
+ *
+ * Two kinds of handlers:
+ *
+ *   Vector_Table_Set()      void f(void) written in the vector itself, the
+ *                           same cost as a handler linked in the flash table
+ *   VECTOR_TABLE_SET_CTX()  void f(T *ctx), the vector points to a common
+ *                           dispatcher, which indexes fn and ctx with the
+ *                           active exception number from IPSR: two loads,
+ *                           no search
+ *
+ * The handlers of stm32h7xx_it.c are in the copy, so existing drivers run
+ * unchanged. Vector_Table_Benchmark() uses the CRS vector, not used by the
+ * project. For the flash table rows VTOR points back to flash, and BASEPRI
+ * masks every interrupt but priority 0: handlers registered at run time are
+ * not in the flash table and must not be at priority 0.
+ *
+ ******************************************************************************/
+
+#include "stm32h7xx.h"
+#include "vector_table.h"
+#include "cycle_counter.h"
+
+/*************************** Macros ************************************/
+
+#define VECTOR_INDEX(irqn)          ( (int32_t)(irqn) + 16 )
+#define VECTOR_FIRST_IRQN           ( -14 )     // NMI, reset and initial SP are not handlers
+#define VECTOR_BENCH_IRQ            ( CRS_IRQn )
+
+/*************************** Types *************************************/
+
+typedef struct
+{
+	Vector_Ctx_Handler_t fn  ;
+	void                *ctx ;
+} Vector_Slot_t;
+
+/************************** Local Variables ****************************/
+
+static uint32_t        Table[VECTOR_TABLE_ENTRIES] __attribute__((aligned(VECTOR_TABLE_ALIGN))) ;
+static Vector_Slot_t   Slots[VECTOR_TABLE_ENTRIES] ;
+static const uint32_t *Flash_Table ;
+
+static volatile uint32_t Bench_Entry ;
+
+/****************************** Functions ******************************/
+
+/* Vector of every handler registered with a context */
+static void Dispatch(void)
+{
+	const Vector_Slot_t *slot = &Slots[__get_IPSR() & 0x1FFUL];
+
+	slot->fn(slot->ctx);
+}
+
+static uint8_t Valid(IRQn_Type irqn)
+{
+	return ((int32_t)irqn >= VECTOR_FIRST_IRQN) && ((int32_t)irqn < (int32_t)VECTOR_TABLE_IRQS);
+}
+
+void Vector_Table_Init(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	if (Flash_Table != 0)
+	{
+		return;
+	}
+
+	__disable_irq();
+
+	/* Step 1: Copy of the table in force, the startup file one */
+	Flash_Table = (const uint32_t *)SCB->VTOR;
+	for (uint32_t i = 0U; i < VECTOR_TABLE_ENTRIES; i++)
+	{
+		Table[i] = Flash_Table[i];
+	}
+
+	/* Step 2: Move VTOR, Cortex-M7 Programming Manual PM0253, 4.3.4 */
+	__DSB();
+	SCB->VTOR = (uint32_t)Table ;
+	__DSB();
+	__ISB();
+
+	__set_PRIMASK(primask);
+}
+
+/* Handler without context, written in the vector */
+Vector_Table_Status_t Vector_Table_Set(IRQn_Type irqn, Vector_Handler_t handler)
+{
+	if (!Valid(irqn))
+	{
+		return VECTOR_TABLE_ERR_IRQN;
+	}
+	if (Flash_Table == 0)
+	{
+		return VECTOR_TABLE_ERR_INIT;
+	}
+	Table[VECTOR_INDEX(irqn)] = (uint32_t)handler ;
+	__DSB();
+	return VECTOR_TABLE_OK;
+}
+
+/* Handler with context through the dispatcher, use VECTOR_TABLE_SET_CTX()
+ * for the type check
+ */
+Vector_Table_Status_t Vector_Table_Set_Ctx(IRQn_Type irqn, Vector_Ctx_Handler_t fn, void *ctx)
+{
+	uint32_t primask = __get_PRIMASK();
+	int32_t  index   = VECTOR_INDEX(irqn);
+
+	if (!Valid(irqn))
+	{
+		return VECTOR_TABLE_ERR_IRQN;
+	}
+	if (Flash_Table == 0)
+	{
+		return VECTOR_TABLE_ERR_INIT;
+	}
+
+	/* fn and ctx change together, the vector last */
+	__disable_irq();
+	Slots[index].fn  = fn;
+	Slots[index].ctx = ctx;
+	Table[index]     = (uint32_t)Dispatch ;
+	__DSB();
+	__set_PRIMASK(primask);
+
+	return VECTOR_TABLE_OK;
+}
+
+/* Back to the handler of the flash table */
+Vector_Table_Status_t Vector_Table_Restore(IRQn_Type irqn)
+{
+	if (!Valid(irqn))
+	{
+		return VECTOR_TABLE_ERR_IRQN;
+	}
+	if (Flash_Table == 0)
+	{
+		return VECTOR_TABLE_ERR_INIT;
+	}
+	Table[VECTOR_INDEX(irqn)] = Flash_Table[VECTOR_INDEX(irqn)] ;
+	__DSB();
+	return VECTOR_TABLE_OK;
+}
+
+Vector_Handler_t Vector_Table_Get(IRQn_Type irqn)
+{
+	const uint32_t *table = (Flash_Table != 0) ? Table : (const uint32_t *)SCB->VTOR;
+
+	return Valid(irqn) ? (Vector_Handler_t)table[VECTOR_INDEX(irqn)] : 0;
+}
+
+/* Benchmark handler, CRS vector of both tables */
+void Vector_Table_Bench_IRQHandler(void)
+{
+	Bench_Entry = DWT->CYCCNT;
+}
+
+static void Bench_Ctx_Handler(volatile uint32_t *entry)
+{
+	*entry = DWT->CYCCNT;
+}
+
+static void Measure(uint32_t runs, uint8_t cold, Vector_Latency_t *lat)
+{
+	uint64_t sum = 0U;
+
+	lat->min = UINT32_MAX;
+
+	for (uint32_t run = 0U; run < runs; run++)
+	{
+		uint32_t t0, cycles;
+
+		if (cold)
+		{
+			SCB_CleanInvalidateDCache();
+			SCB_InvalidateICache();
+		}
+
+		t0 = DWT->CYCCNT;
+		NVIC->STIR = VECTOR_BENCH_IRQ ;
+		__DSB();
+		__ISB();
+
+		cycles = Bench_Entry - t0;
+		sum   += cycles;
+		if (cycles < lat->min)
+		{
+			lat->min = cycles;
+		}
+	}
+	lat->avg = runs ? (uint32_t)(sum / runs) : 0U;
+	if (runs == 0U)
+	{
+		lat->min = 0U;
+	}
+}
+
+/* Entry latency of the flash and the DTCM table, runs interrupts per row.
+ * Vector_Table_Init() and Cycle_Counter_Init() must have been called.
+ */
+void Vector_Table_Benchmark(uint32_t runs, Vector_Table_Bench_t *result)
+{
+	uint32_t basepri = __get_BASEPRI();
+
+	if (Flash_Table == 0)
+	{
+		return;
+	}
+
+	/* Step 1: Only priority 0 can interrupt, the benchmark vector included */
+	__set_BASEPRI(1UL << (8U - __NVIC_PRIO_BITS));
+	NVIC_SetPriority(VECTOR_BENCH_IRQ, 0U);
+	NVIC_ClearPendingIRQ(VECTOR_BENCH_IRQ);
+	NVIC_EnableIRQ(VECTOR_BENCH_IRQ);
+
+	/* Step 2: Flash table */
+	SCB->VTOR = (uint32_t)Flash_Table ;
+	__DSB();
+	__ISB();
+	Measure(runs, 0U, &result->flash_warm);
+	Measure(runs, 1U, &result->flash_cold);
+
+	/* Step 3: DTCM table, same handler */
+	SCB->VTOR = (uint32_t)Table ;
+	__DSB();
+	__ISB();
+	Measure(runs, 0U, &result->dtcm_warm);
+	Measure(runs, 1U, &result->dtcm_cold);
+
+	/* Step 4: DTCM table, handler with context */
+	VECTOR_TABLE_SET_CTX(VECTOR_BENCH_IRQ, Bench_Ctx_Handler, &Bench_Entry);
+	Measure(runs, 0U, &result->dtcm_ctx);
+	Vector_Table_Restore(VECTOR_BENCH_IRQ);
+
+	NVIC_DisableIRQ(VECTOR_BENCH_IRQ);
+	__set_BASEPRI(basepri);
+}
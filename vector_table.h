@@ -0,0 +1,82 @@
+/*
+ ******************************************************************************
+ * File              : vector_table.h
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Embedded Software & Systems LLC
+ * MCU/Board         : Waveshare OpenH743-C STM32H743IIT6 Development Board
+ * Description       : Vector table in DTCM with run time handler registration
+ * Datasheet         : DS12110 Rev March 2023  STM32H742xI/G STM32H743xI/G
+ * Reference Manual  : RM0433 Reference Manual Rev 8, January 2023
+ *
+ * Key Features      : 32-bit Arm® Cortex®-M7 core with double precision
+ *                     FPU and L1 cache: 16 Kbytes of data
+ *                     and 16 Kbytes of instruction cache; frequency
+ *                     up to 480 MHz, MPU, 1027 DMIPS/
+ *                     2.14 DMIPS/MHz (Dhrystone 2.1), and DSP instructions
+ *
+ * Author            : Philip Zatta, PhD, Software Consultant
+ * Company           : Emebedded Software & Systems LLC
+ *                     Embedded Software & LabView
+ * IDE               : STM32CUBE Version 1.12
+ * Windows OS        : WIndows 11
+ * Date              : November 1, 2026
+ ******************************************************************************/
+
+#ifndef _VECTOR_TABLE_H_
+#define _VECTOR_TABLE_H_
+
+#include "stm32h7xx.h"
+
+/*************************** Macros ************************************/
+
+#define VECTOR_TABLE_IRQS           ( 150U )    // WWDG_IRQn .. WAKEUP_PIN_IRQn, Reference Manual, Table 142
+#define VECTOR_TABLE_ENTRIES        ( 16U + VECTOR_TABLE_IRQS )
+#define VECTOR_TABLE_ALIGN          ( 1024U )   // VTOR: power of two at least the table size
+
+/* Typed registration: fn must take a pointer of the type of ctx,
+ * a mismatch is a compiler warning instead of a cast
+ */
+#define VECTOR_TABLE_SET_CTX(irqn, fn, ctx)                                             \
+	({                                                                                  \
+		void (*vector_fn_)(__typeof__(ctx)) = (fn);                                     \
+		Vector_Table_Set_Ctx((irqn), (Vector_Ctx_Handler_t)vector_fn_, (void *)(ctx));  \
+	})
+
+/*************************** Types *************************************/
+
+typedef void (*Vector_Handler_t)(void);
+typedef void (*Vector_Ctx_Handler_t)(void *ctx);
+
+typedef enum
+{
+	VECTOR_TABLE_OK = 0   ,
+	VECTOR_TABLE_ERR_IRQN ,   // Reset, stack pointer or above WAKEUP_PIN_IRQn
+	VECTOR_TABLE_ERR_INIT     // Vector_Table_Init() not called
+} Vector_Table_Status_t;
+
+typedef struct
+{
+	uint32_t min ;  // CPU cycles, NVIC_STIR write to first handler instruction
+	uint32_t avg ;
+} Vector_Latency_t;
+
+typedef struct
+{
+	Vector_Latency_t flash_warm ;  // VTOR on the flash table
+	Vector_Latency_t flash_cold ;  // Same, D-cache and I-cache emptied before each interrupt
+	Vector_Latency_t dtcm_warm  ;  // VTOR on the DTCM table, same handler
+	Vector_Latency_t dtcm_cold  ;
+	Vector_Latency_t dtcm_ctx   ;  // DTCM table, handler with context through the dispatcher
+} Vector_Table_Bench_t;
+
+/************************ Function prototypes ***************************/
+void                  Vector_Table_Init(void) ;
+Vector_Table_Status_t Vector_Table_Set(IRQn_Type irqn, Vector_Handler_t handler) ;
+Vector_Table_Status_t Vector_Table_Set_Ctx(IRQn_Type irqn, Vector_Ctx_Handler_t fn, void *ctx) ;
+Vector_Table_Status_t Vector_Table_Restore(IRQn_Type irqn) ;
+Vector_Handler_t      Vector_Table_Get(IRQn_Type irqn) ;
+void                  Vector_Table_Benchmark(uint32_t runs, Vector_Table_Bench_t *result) ;
+
+void                  Vector_Table_Bench_IRQHandler(void) ;
+
+#endif /* _VECTOR_TABLE_H_ */